@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace lible::benchmarks
+{
+    /// Settings shared by all the benchmarks.
+    struct BenchmarkSettings
+    {
+        /// Highest angular momentum of the benchmarked shells.
+        int l_max_{2};
+        /// Contraction depths of the benchmarked shells.
+        std::vector<int> cdepths_{1, 3, 6};
+        /// Minimal wall time (s) spent on every run. The run is repeated until reached.
+        double min_time_{0.05};
+        /// Only the benchmarks whose name contains this string are run.
+        std::string filter_;
+    };
+
+    /// Result of one benchmark run, i.e., one kernel for one L class and contraction depth.
+    struct BenchmarkResult
+    {
+        /// Name of the benchmark.
+        std::string name_;
+        /// Angular momenta of the L class, empty if not applicable.
+        std::vector<int> ls_;
+        /// Contraction depth of the shells, 0 if not applicable.
+        int cdepth_{};
+        /// Number of kernel calls.
+        size_t n_calls_{};
+        /// Number of evaluated shell tuples (pairs, triples or quartets).
+        size_t n_shell_tuples_{};
+        /// Number of evaluated primitive tuples.
+        size_t n_prim_tuples_{};
+        /// Floating-point operations from the analytic model.
+        double flops_{};
+        /// Wall time (s).
+        double time_{};
+        /// Sum of the kernel results from a single evaluation of all the calls, for comparing
+        /// the runs.
+        double checksum_{};
+    };
+
+    using results_t = std::vector<BenchmarkResult>;
+
+    /* lible::ints */
+
+    /// Two-, three- and four-center ERI kernels.
+    void eriKernels(const BenchmarkSettings &settings, results_t &results);
+
+    /// First and second derivative ERI kernels.
+    void eriDerivKernels(const BenchmarkSettings &settings, results_t &results);
+
+    /// Two-electron spin-orbit coupling kernels.
+    void eriSOCKernels(const BenchmarkSettings &settings, results_t &results);
+
+    /// One-electron integral kernels.
+    void oneElectronKernels(const BenchmarkSettings &settings, results_t &results);
+
+    /// Boys function.
+    void boysFunction(const BenchmarkSettings &settings, results_t &results);
+
+    /// Hermite expansion coefficients of shell pairs.
+    void ecoeffs(const BenchmarkSettings &settings, results_t &results);
+
+    /// Cartesian to spherical transformation.
+    void sphericalTransforms(const BenchmarkSettings &settings, results_t &results);
+
+    /// Returns the results as JSON, together with some info about the run.
+    std::string resultsJSON(const BenchmarkSettings &settings, const results_t &results);
+}
@@ -0,0 +1,681 @@
+#include <benchmarks.hpp>
+
+#include <lible/ints/boys_function.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/utils.hpp>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <tuple>
+#include <utility>
+
+#include <omp.h>
+
+namespace lbench = lible::benchmarks;
+namespace lints = lible::ints;
+
+namespace lible::benchmarks
+{
+    /// Accumulates the timed results so that the calls cannot be optimized away.
+    static double sink = 0;
+
+    /// Returns true if the benchmark is selected by the filter.
+    bool selected(const BenchmarkSettings &settings, const std::string &name);
+
+    /// Constructs a structure of four atoms that carry one shell of every angular momentum up to
+    /// `l_max`, all with `cdepth` primitives.
+    lints::Structure syntheticStructure(int l_max, int cdepth);
+
+    /// Timing of a run.
+    struct Timing
+    {
+        /// Number of repetitions.
+        size_t n_reps_{};
+        /// Wall time (s) of all the repetitions.
+        double time_{};
+        /// Sum of the task results from a single serial evaluation.
+        double checksum_{};
+    };
+
+    /// Evaluates `task(itask)` once for all tasks in order to get the checksum. Then runs all
+    /// the tasks, OMP parallelized, and repeats until the minimal time has passed.
+    Timing timeTasks(size_t n_tasks, double min_time, const std::function<double(size_t)> &task);
+
+    /// Appends the result of a run.
+    void addResult(const std::string &name, const std::vector<int> &ls, int cdepth,
+                   size_t n_tasks, size_t n_prim_tuples, double flops_task, const Timing &timing,
+                   results_t &results);
+
+    /// Model FLOP count of the Hermite Coulomb integrals R_{tuv} up to total angular momentum
+    /// `l`, including all the intermediate orders of the recurrence.
+    double flopsRInts(int l);
+
+    /// Model FLOP count of an ERI shell tuple in the McMurchie-Davidson/SHARK scheme. The bra
+    /// and ket are given by their angular momenta, one or two of them. Every primitive tuple
+    /// costs the R-integrals up to L + `l_shift` and the contraction of the ket Hermite index,
+    /// every bra primitive (pair) the contraction of the bra Hermite index, both repeated for
+    /// `n_comps` components.
+    double flopsERI(const std::vector<int> &ls_bra, const std::vector<int> &ls_ket, int cdepth,
+                    int l_shift = 0, int n_comps = 1);
+
+    /// Model FLOP count of the Hermite expansion coefficients of a primitive pair in all three
+    /// directions.
+    double flopsECoeffs(int la, int lb);
+
+    /// Model FLOP count of transforming a Cartesian shell pair block to the spherical basis.
+    double flopsSphericalTrafo(int la, int lb);
+
+    /// Model FLOP count of an overlap-type shell pair with `n_comps` components, where the ket
+    /// angular momentum is raised by `lb_shift` in the Hermite expansion.
+    double flopsOverlap(int la, int lb, int cdepth, int lb_shift = 0, int n_comps = 1);
+
+    /// Model FLOP count of a Coulomb potential shell pair over `n_charges` charges.
+    double flopsPotential(int la, int lb, int cdepth, size_t n_charges, int n_comps = 1);
+}
+
+bool lbench::selected(const BenchmarkSettings &settings, const std::string &name)
+{
+    return settings.filter_.empty() || name.find(settings.filter_) != std::string::npos;
+}
+
+lints::Structure lbench::syntheticStructure(const int l_max, const int cdepth)
+{
+    std::vector<int> atomic_nrs{6, 6, 6, 6};
+    std::vector<std::array<double, 3>> coords{
+        {0.0, 0.0, 0.0}, {1.4, 0.0, 0.0}, {0.1, 1.3, 0.2}, {0.3, 0.2, 1.5}
+    };
+
+    lints::basis_shells_t basis_shells;
+    for (int l = 0; l <= l_max; l++)
+    {
+        lints::BasisShell basis_shell;
+        basis_shell.l_ = l;
+        for (int i = 0; i < cdepth; i++)
+        {
+            basis_shell.exps_.push_back(0.15 * std::pow(3.2, i));
+            basis_shell.coeffs_.push_back(1.0 / cdepth);
+        }
+
+        basis_shells.push_back(basis_shell);
+    }
+
+    lints::basis_atoms_t basis_atoms;
+    for (int atomic_nr : atomic_nrs)
+        basis_atoms.push_back({atomic_nr, basis_shells});
+
+    return lints::Structure(basis_atoms, atomic_nrs, coords);
+}
+
+lbench::Timing lbench::timeTasks(const size_t n_tasks, const double min_time,
+                                 const std::function<double(size_t)> &task)
+{
+    // The checksum doesn't depend on the number of repetitions or threads, so the runs can be
+    // compared.
+    double checksum = 0;
+    for (size_t itask = 0; itask < n_tasks; itask++)
+        checksum += task(itask);
+
+    size_t n_reps = 0;
+    double time = 0;
+
+    auto start{std::chrono::steady_clock::now()};
+    do
+    {
+        double sum = 0;
+#pragma omp parallel for schedule(dynamic) reduction(+ : sum)
+        for (size_t itask = 0; itask < n_tasks; itask++)
+            sum += task(itask);
+
+        sink += sum;
+        n_reps++;
+
+        std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start};
+        time = duration.count();
+    } while (time < min_time);
+
+    return {n_reps, time, checksum};
+}
+
+void lbench::addResult(const std::string &name, const std::vector<int> &ls, const int cdepth,
+                       const size_t n_tasks, const size_t n_prim_tuples, const double flops_task,
+                       const Timing &timing, results_t &results)
+{
+    auto [n_reps, time, checksum] = timing;
+
+    BenchmarkResult result{name, ls, cdepth, n_reps * n_tasks, n_reps * n_tasks,
+                           n_reps * n_prim_tuples, double(n_reps * n_tasks) * flops_task, time,
+                           checksum};
+
+    std::string ls_str;
+    for (int l : ls)
+        ls_str += std::to_string(l);
+
+    std::cout << std::format("{:<24} {:>6} {:>3} ; {:10.3e} tuples/s ; {:10.3e} prims/s ; "
+                             "{:7.3f} GFLOP/s\n", name, ls_str, cdepth,
+                             double(result.n_shell_tuples_) / time,
+                             double(result.n_prim_tuples_) / time, result.flops_ / time * 1e-9);
+
+    results.push_back(result);
+}
+
+double lbench::flopsRInts(const int l)
+{
+    // Three terms for every R^{n}_{tuv} with t + u + v + n <= l.
+    return 3.0 * lints::numHermitesSum(l);
+}
+
+double lbench::flopsERI(const std::vector<int> &ls_bra, const std::vector<int> &ls_ket,
+                        const int cdepth, const int l_shift, const int n_comps)
+{
+    int l_bra = 0, l_ket = 0;
+    double n_sph_bra = 1, n_sph_ket = 1;
+    for (int l : ls_bra)
+    {
+        l_bra += l;
+        n_sph_bra *= lints::numSphericals(l);
+    }
+    for (int l : ls_ket)
+    {
+        l_ket += l;
+        n_sph_ket *= lints::numSphericals(l);
+    }
+
+    double n_herm_bra = lints::numHermites(l_bra);
+    double n_herm_ket = lints::numHermites(l_ket);
+    double n_prims_bra = std::pow(cdepth, ls_bra.size());
+    double n_prims_ket = std::pow(cdepth, ls_ket.size());
+
+    double flops_prim = flopsRInts(l_bra + l_ket + l_shift) +
+                        2 * n_herm_bra * n_herm_ket * n_sph_ket * n_comps;
+    double flops_bra = 2 * n_herm_bra * n_sph_bra * n_sph_ket * n_comps;
+
+    return n_prims_bra * n_prims_ket * flops_prim + n_prims_bra * flops_bra;
+}
+
+double lbench::flopsECoeffs(const int la, const int lb)
+{
+    // Four terms in the recurrence for every E^{ij}_t.
+    return 3.0 * 4 * (la + 1) * (lb + 1) * (la + lb + 1);
+}
+
+double lbench::flopsSphericalTrafo(const int la, const int lb)
+{
+    double n_cart_a = lints::numCartesians(la);
+    double n_cart_b = lints::numCartesians(lb);
+    double n_sph_a = lints::numSphericals(la);
+    double n_sph_b = lints::numSphericals(lb);
+
+    return 2 * n_cart_a * n_cart_b * n_sph_b + 2 * n_cart_a * n_sph_a * n_sph_b;
+}
+
+double lbench::flopsOverlap(const int la, const int lb, const int cdepth, const int lb_shift,
+                            const int n_comps)
+{
+    double n_cart_ab = lints::numCartesians(la) * lints::numCartesians(lb);
+    double flops_prim = flopsECoeffs(la, lb + lb_shift) + 3 * n_cart_ab * n_comps;
+
+    return cdepth * cdepth * flops_prim + n_comps * flopsSphericalTrafo(la, lb);
+}
+
+double lbench::flopsPotential(const int la, const int lb, const int cdepth,
+                              const size_t n_charges, const int n_comps)
+{
+    int lab = la + lb;
+    double n_herm = lints::numHermites(lab);
+    double n_sph_ab = lints::numSphericals(la) * lints::numSphericals(lb);
+
+    double flops_prim = flopsECoeffs(la, lb) + double(n_charges) * (flopsRInts(lab) + 2 * n_herm) +
+                        2 * n_herm * n_sph_ab * n_comps;
+
+    return cdepth * cdepth * flops_prim;
+}
+
+void lbench::eriKernels(const BenchmarkSettings &settings, results_t &results)
+{
+    using lints::ERIBackend;
+
+    std::vector<std::pair<std::string, ERIBackend>> backends{{"shark", ERIBackend::shark},
+                                                             {"rys", ERIBackend::rys}};
+
+    for (int cdepth : settings.cdepths_)
+    {
+        lints::Structure structure = syntheticStructure(settings.l_max_, cdepth);
+        std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+
+        std::vector<lints::ShellData> sh_data;
+        for (int l = 0; l <= settings.l_max_; l++)
+            sh_data.emplace_back(l, structure.getShellsLView(l));
+
+        for (const auto &[backend_name, backend] : backends)
+        {
+            // Only the SHARK scheme follows the FLOP model.
+            bool count_flops = backend != ERIBackend::rys;
+
+            std::string name = "eri4_" + backend_name;
+            if (selected(settings, name))
+                for (size_t iab = 0; iab < sp_data.size(); iab++)
+                    for (size_t icd = 0; icd <= iab; icd++)
+                    {
+                        const auto &sp_ab = sp_data[iab];
+                        const auto &sp_cd = sp_data[icd];
+                        auto [la, lb] = sp_ab.getLPair();
+                        auto [lc, ld] = sp_cd.getLPair();
+
+                        lints::ERI4Kernel kernel(sp_ab, sp_cd, backend);
+
+                        size_t n_tasks = sp_ab.n_pairs_ * sp_cd.n_pairs_;
+                        size_t n_prims = sp_ab.n_ppairs_ * sp_cd.n_ppairs_;
+                        double flops = count_flops ? flopsERI({la, lb}, {lc, ld}, cdepth) : 0;
+
+                        auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                        {
+                            lible::vec4d batch = kernel(itask / sp_cd.n_pairs_,
+                                                        itask % sp_cd.n_pairs_, sp_ab, sp_cd);
+                            return batch(0, 0, 0, 0);
+                        });
+
+                        addResult(name, {la, lb, lc, ld}, cdepth, n_tasks, n_prims, flops, timing,
+                                  results);
+                    }
+
+            name = "eri3_" + backend_name;
+            if (selected(settings, name))
+                for (const auto &sp_ab : sp_data)
+                    for (const auto &sh_c : sh_data)
+                    {
+                        auto [la, lb] = sp_ab.getLPair();
+                        int lc = sh_c.l_;
+
+                        lints::ERI3Kernel kernel(sp_ab, sh_c, backend);
+
+                        size_t n_tasks = sp_ab.n_pairs_ * sh_c.n_shells_;
+                        size_t n_prims = sp_ab.n_ppairs_ * sh_c.n_primitives_;
+                        double flops = count_flops ? flopsERI({la, lb}, {lc}, cdepth) : 0;
+
+                        auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                        {
+                            lible::vec3d batch = kernel(itask / sh_c.n_shells_,
+                                                        itask % sh_c.n_shells_, sp_ab, sh_c);
+                            return batch(0, 0, 0);
+                        });
+
+                        addResult(name, {la, lb, lc}, cdepth, n_tasks, n_prims, flops, timing,
+                                  results);
+                    }
+
+            name = "eri2_" + backend_name;
+            if (selected(settings, name))
+                for (size_t ia = 0; ia < sh_data.size(); ia++)
+                    for (size_t ib = 0; ib <= ia; ib++)
+                    {
+                        const auto &sh_a = sh_data[ia];
+                        const auto &sh_b = sh_data[ib];
+
+                        lints::ERI2Kernel kernel(sh_a, sh_b, backend);
+
+                        size_t n_tasks = sh_a.n_shells_ * sh_b.n_shells_;
+                        size_t n_prims = sh_a.n_primitives_ * sh_b.n_primitives_;
+                        double flops = count_flops ? flopsERI({sh_a.l_}, {sh_b.l_}, cdepth) : 0;
+
+                        auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                        {
+                            lible::vec2d batch = kernel(itask / sh_b.n_shells_,
+                                                        itask % sh_b.n_shells_, sh_a, sh_b);
+                            return batch(0, 0);
+                        });
+
+                        addResult(name, {sh_a.l_, sh_b.l_}, cdepth, n_tasks, n_prims, flops,
+                                  timing, results);
+                    }
+        }
+    }
+}
+
+void lbench::eriDerivKernels(const BenchmarkSettings &settings, results_t &results)
+{
+    for (int cdepth : settings.cdepths_)
+    {
+        lints::Structure structure = syntheticStructure(settings.l_max_, cdepth);
+        std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+
+        std::vector<lints::ShellData> sh_data;
+        for (int l = 0; l <= settings.l_max_; l++)
+            sh_data.emplace_back(l, structure.getShellsLView(l));
+
+        if (selected(settings, "eri4d1"))
+            for (size_t iab = 0; iab < sp_data.size(); iab++)
+                for (size_t icd = 0; icd <= iab; icd++)
+                {
+                    const auto &sp_ab = sp_data[iab];
+                    const auto &sp_cd = sp_data[icd];
+                    auto [la, lb] = sp_ab.getLPair();
+                    auto [lc, ld] = sp_cd.getLPair();
+
+                    lints::ERI4D1Kernel kernel(sp_ab, sp_cd);
+
+                    size_t n_tasks = sp_ab.n_pairs_ * sp_cd.n_pairs_;
+                    size_t n_prims = sp_ab.n_ppairs_ * sp_cd.n_ppairs_;
+                    double flops = flopsERI({la, lb}, {lc, ld}, cdepth, 1, 12);
+
+                    auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                    {
+                        auto batch = kernel(itask / sp_cd.n_pairs_, itask % sp_cd.n_pairs_, sp_ab,
+                                            sp_cd);
+                        return batch[0](0, 0, 0, 0);
+                    });
+
+                    addResult("eri4d1", {la, lb, lc, ld}, cdepth, n_tasks, n_prims, flops, timing,
+                              results);
+                }
+
+        if (selected(settings, "eri3d1"))
+            for (const auto &sp_ab : sp_data)
+                for (const auto &sh_c : sh_data)
+                {
+                    auto [la, lb] = sp_ab.getLPair();
+                    int lc = sh_c.l_;
+
+                    lints::ERI3D1Kernel kernel(sp_ab, sh_c);
+
+                    size_t n_tasks = sp_ab.n_pairs_ * sh_c.n_shells_;
+                    size_t n_prims = sp_ab.n_ppairs_ * sh_c.n_primitives_;
+                    double flops = flopsERI({la, lb}, {lc}, cdepth, 1, 9);
+
+                    auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                    {
+                        auto batch = kernel(itask / sh_c.n_shells_, itask % sh_c.n_shells_, sp_ab,
+                                            sh_c);
+                        return batch[0](0, 0, 0);
+                    });
+
+                    addResult("eri3d1", {la, lb, lc}, cdepth, n_tasks, n_prims, flops, timing,
+                              results);
+                }
+
+        for (size_t ia = 0; ia < sh_data.size(); ia++)
+            for (size_t ib = 0; ib <= ia; ib++)
+            {
+                const auto &sh_a = sh_data[ia];
+                const auto &sh_b = sh_data[ib];
+
+                size_t n_tasks = sh_a.n_shells_ * sh_b.n_shells_;
+                size_t n_prims = sh_a.n_primitives_ * sh_b.n_primitives_;
+
+                if (selected(settings, "eri2d1"))
+                {
+                    lints::ERI2D1Kernel kernel(sh_a, sh_b);
+
+                    double flops = flopsERI({sh_a.l_}, {sh_b.l_}, cdepth, 1, 6);
+                    auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                    {
+                        auto batch = kernel(itask / sh_b.n_shells_, itask % sh_b.n_shells_, sh_a,
+                                            sh_b);
+                        return batch[0](0, 0);
+                    });
+
+                    addResult("eri2d1", {sh_a.l_, sh_b.l_}, cdepth, n_tasks, n_prims, flops,
+                              timing, results);
+                }
+
+                if (selected(settings, "eri2d2"))
+                {
+                    lints::ERI2D2Kernel kernel(sh_a, sh_b);
+
+                    double flops = flopsERI({sh_a.l_}, {sh_b.l_}, cdepth, 2, 36);
+                    auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                    {
+                        auto batch = kernel(itask / sh_b.n_shells_, itask % sh_b.n_shells_, sh_a,
+                                            sh_b);
+                        return batch[0][0](0, 0);
+                    });
+
+                    addResult("eri2d2", {sh_a.l_, sh_b.l_}, cdepth, n_tasks, n_prims, flops,
+                              timing, results);
+                }
+            }
+    }
+}
+
+void lbench::eriSOCKernels(const BenchmarkSettings &settings, results_t &results)
+{
+    for (int cdepth : settings.cdepths_)
+    {
+        lints::Structure structure = syntheticStructure(settings.l_max_, cdepth);
+        std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+
+        std::vector<lints::ShellData> sh_data;
+        for (int l = 0; l <= settings.l_max_; l++)
+            sh_data.emplace_back(l, structure.getShellsLView(l));
+
+        if (selected(settings, "eri4soc"))
+            for (const auto &sp_ab : sp_data)
+                for (const auto &sp_cd : sp_data)
+                {
+                    auto [la, lb] = sp_ab.getLPair();
+                    auto [lc, ld] = sp_cd.getLPair();
+
+                    lints::ERI4SOCKernel kernel(sp_ab, sp_cd);
+
+                    size_t n_tasks = sp_ab.n_pairs_ * sp_cd.n_pairs_;
+                    size_t n_prims = sp_ab.n_ppairs_ * sp_cd.n_ppairs_;
+                    double flops = flopsERI({la, lb}, {lc, ld}, cdepth, 1, 3);
+
+                    auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                    {
+                        auto batch = kernel(itask / sp_cd.n_pairs_, itask % sp_cd.n_pairs_, sp_ab,
+                                            sp_cd);
+                        return batch[0](0, 0, 0, 0);
+                    });
+
+                    addResult("eri4soc", {la, lb, lc, ld}, cdepth, n_tasks, n_prims, flops,
+                              timing, results);
+                }
+
+        if (selected(settings, "eri3soc"))
+            for (const auto &sp_ab : sp_data)
+                for (const auto &sh_c : sh_data)
+                {
+                    auto [la, lb] = sp_ab.getLPair();
+                    int lc = sh_c.l_;
+
+                    lints::ERI3SOCKernel kernel(sp_ab, sh_c);
+
+                    size_t n_tasks = sp_ab.n_pairs_ * sh_c.n_shells_;
+                    size_t n_prims = sp_ab.n_ppairs_ * sh_c.n_primitives_;
+                    double flops = flopsERI({la, lb}, {lc}, cdepth, 1, 3);
+
+                    auto timing = timeTasks(n_tasks, settings.min_time_, [&](size_t itask)
+                    {
+                        auto batch = kernel(itask / sh_c.n_shells_, itask % sh_c.n_shells_, sp_ab,
+                                            sh_c);
+                        return batch[0](0, 0, 0);
+                    });
+
+                    addResult("eri3soc", {la, lb, lc}, cdepth, n_tasks, n_prims, flops, timing,
+                              results);
+                }
+    }
+}
+
+void lbench::oneElectronKernels(const BenchmarkSettings &settings, results_t &results)
+{
+    for (int cdepth : settings.cdepths_)
+    {
+        lints::Structure structure = syntheticStructure(settings.l_max_, cdepth);
+        std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+        std::vector<std::array<double, 4>> charges = structure.getZs();
+        std::array<double, 3> origin{0.1, 0.2, 0.3};
+
+        for (const auto &sp : sp_data)
+        {
+            auto [la, lb] = sp.getLPair();
+            size_t n_tasks = sp.n_pairs_;
+            size_t n_prims = sp.n_ppairs_;
+
+            lints::BoysGrid boys_grid(la + lb);
+
+            std::vector<std::tuple<std::string, double, std::function<double(size_t)>>> kernels{
+                {"overlap", flopsOverlap(la, lb, cdepth), [&](size_t ipair)
+                {
+                    return lints::overlapKernel(ipair, sp)(0, 0);
+                }},
+                {"overlap_d1", flopsOverlap(la, lb, cdepth, 1, 6), [&](size_t ipair)
+                {
+                    return lints::overlapD1Kernel(ipair, sp)[0](0, 0);
+                }},
+                {"kinetic", flopsOverlap(la, lb, cdepth, 2, 3), [&](size_t ipair)
+                {
+                    return lints::kineticEnergyKernel(ipair, sp)(0, 0);
+                }},
+                {"kinetic_d1", flopsOverlap(la, lb, cdepth, 3, 18), [&](size_t ipair)
+                {
+                    return lints::kineticEnergyD1Kernel(ipair, sp)[0](0, 0);
+                }},
+                {"nuclear", flopsPotential(la, lb, cdepth, charges.size()), [&](size_t ipair)
+                {
+                    return lints::externalChargesKernel(ipair, charges, boys_grid, sp)(0, 0);
+                }},
+                {"dipole", flopsOverlap(la, lb, cdepth, 1, 3), [&](size_t ipair)
+                {
+                    return lints::dipoleMomentKernel(ipair, origin, sp)[0](0, 0);
+                }},
+                {"momentum", flopsOverlap(la, lb, cdepth, 1, 3), [&](size_t ipair)
+                {
+                    return lints::momentumKernel(ipair, sp)[0](0, 0);
+                }},
+            };
+
+            for (const auto &[name, flops, kernel] : kernels)
+            {
+                if (!selected(settings, name))
+                    continue;
+
+                auto timing = timeTasks(n_tasks, settings.min_time_, kernel);
+                addResult(name, {la, lb}, cdepth, n_tasks, n_prims, flops, timing, results);
+            }
+        }
+    }
+}
+
+void lbench::boysFunction(const BenchmarkSettings &settings, results_t &results)
+{
+    if (!selected(settings, "boys"))
+        return;
+
+    // Sampled over the grid range and the asymptotic region.
+    const size_t n_points = 4096;
+    const double x_max = 40;
+
+    int n_max = 4 * settings.l_max_ + 2;
+    for (int n = 0; n <= n_max; n += 2)
+    {
+        lints::BoysGrid boys_grid(n);
+
+        auto timing = timeTasks(n_points, settings.min_time_, [&](size_t ipoint)
+        {
+            double x = x_max * double(ipoint) / n_points;
+            return lints::calcBoysF(n, x, boys_grid)[n];
+        });
+
+        // Taylor expansion over the grid and the downward recursion.
+        double flops = 2 * 7 + 3 * n;
+        addResult("boys", {n}, 0, n_points, n_points, flops, timing, results);
+    }
+}
+
+void lbench::ecoeffs(const BenchmarkSettings &settings, results_t &results)
+{
+    if (!selected(settings, "ecoeffs"))
+        return;
+
+    for (int cdepth : settings.cdepths_)
+    {
+        lints::Structure structure = syntheticStructure(settings.l_max_, cdepth);
+        std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+
+        for (const auto &sp : sp_data)
+        {
+            auto [la, lb] = sp.getLPair();
+
+            // The spherical coefficients are formed from the Cartesian ones per primitive pair.
+            double n_herm = lints::numHermites(la + lb);
+            double flops_ppair = flopsECoeffs(la, lb) +
+                                 2 * n_herm * flopsSphericalTrafo(la, lb) / 2;
+            double flops = flops_ppair * double(sp.n_ppairs_);
+
+            // One task is the whole L class.
+            auto timing = timeTasks(1, settings.min_time_, [&](size_t)
+            {
+                return lints::ecoeffsSHARK(sp)[0];
+            });
+
+            addResult("ecoeffs", {la, lb}, cdepth, 1, sp.n_ppairs_, flops, timing, results);
+        }
+    }
+}
+
+void lbench::sphericalTransforms(const BenchmarkSettings &settings, results_t &results)
+{
+    if (!selected(settings, "trafo"))
+        return;
+
+    const size_t n_blocks = 1024;
+    for (int la = 0; la <= settings.l_max_ + 2; la++)
+        for (int lb = 0; lb <= la; lb++)
+        {
+            lible::vec2d ints_cart(lible::Fill(1.0), lints::numCartesians(la),
+                                   lints::numCartesians(lb));
+
+            auto timing = timeTasks(n_blocks, settings.min_time_, [&](size_t)
+            {
+                return lints::trafo2Spherical(la, lb, ints_cart)(0, 0);
+            });
+
+            addResult("trafo", {la, lb}, 0, n_blocks, n_blocks, flopsSphericalTrafo(la, lb),
+                      timing, results);
+        }
+}
+
+std::string lbench::resultsJSON(const BenchmarkSettings &settings, const results_t &results)
+{
+    std::string cdepths;
+    for (size_t i = 0; i < settings.cdepths_.size(); i++)
+        cdepths += (i > 0 ? ", " : "") + std::to_string(settings.cdepths_[i]);
+
+    std::string json = "{\n";
+    json += std::format("  \"n_threads\": {},\n", omp_get_max_threads());
+    json += std::format("  \"l_max\": {},\n", settings.l_max_);
+    json += std::format("  \"cdepths\": [{}],\n", cdepths);
+    json += std::format("  \"min_time\": {},\n", settings.min_time_);
+    json += "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &result = results[i];
+
+        std::string ls;
+        for (size_t j = 0; j < result.ls_.size(); j++)
+            ls += (j > 0 ? ", " : "") + std::to_string(result.ls_[j]);
+
+        std::string gflops = result.flops_ > 0
+                                 ? std::format("{:.6e}", result.flops_ / result.time_ * 1e-9)
+                                 : "null";
+
+        json += std::format("    {{\"name\": \"{}\", \"ls\": [{}], \"cdepth\": {}, "
+                            "\"n_calls\": {}, \"n_shell_tuples\": {}, \"n_prim_tuples\": {}, "
+                            "\"time\": {:.6e}, \"flops\": {:.6e}, \"gflops\": {}, "
+                            "\"shell_tuples_per_s\": {:.6e}, \"prim_tuples_per_s\": {:.6e}, "
+                            "\"checksum\": {:.15e}}}{}\n",
+                            result.name_, ls, result.cdepth_, result.n_calls_,
+                            result.n_shell_tuples_, result.n_prim_tuples_, result.time_,
+                            result.flops_, gflops, result.n_shell_tuples_ / result.time_,
+                            result.n_prim_tuples_ / result.time_, result.checksum_,
+                            i + 1 < results.size() ? "," : "");
+    }
+    json += "  ]\n}\n";
+
+    return json;
+}
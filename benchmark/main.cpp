@@ -0,0 +1,95 @@
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <benchmarks.hpp>
+
+namespace lbench = lible::benchmarks;
+
+namespace
+{
+    void printUsage(const char *program)
+    {
+        std::cerr << std::format("Usage: {} [--json file] [--filter name] [--lmax l] "
+                                 "[--cdepths k1,k2,...] [--min-time seconds]\n",
+                                 program);
+    }
+
+    /// Parses the command line arguments into the settings and the JSON file name.
+    void parseArguments(int argc, char **argv, lbench::BenchmarkSettings &settings,
+                        std::string &json_file)
+    {
+        for (int iarg = 1; iarg < argc; iarg++)
+        {
+            std::string arg = argv[iarg];
+            if (iarg + 1 == argc)
+                throw std::runtime_error(std::format("Missing value for the argument: {}", arg));
+
+            std::string value = argv[++iarg];
+            if (arg == "--json")
+                json_file = value;
+            else if (arg == "--filter")
+                settings.filter_ = value;
+            else if (arg == "--lmax")
+                settings.l_max_ = std::stoi(value);
+            else if (arg == "--min-time")
+                settings.min_time_ = std::stod(value);
+            else if (arg == "--cdepths")
+            {
+                settings.cdepths_.clear();
+                size_t pos = 0;
+                while (pos != std::string::npos)
+                {
+                    size_t next = value.find(',', pos);
+                    settings.cdepths_.push_back(std::stoi(value.substr(pos, next - pos)));
+                    pos = next == std::string::npos ? next : next + 1;
+                }
+            }
+            else
+                throw std::runtime_error(std::format("Unknown argument: {}", arg));
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    lbench::BenchmarkSettings settings;
+    std::string json_file;
+
+    try
+    {
+        parseArguments(argc, argv, settings, json_file);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << std::format("Invalid arguments: {}\n", e.what());
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    lbench::results_t results;
+    lbench::eriKernels(settings, results);
+    lbench::eriDerivKernels(settings, results);
+    lbench::eriSOCKernels(settings, results);
+    lbench::oneElectronKernels(settings, results);
+    lbench::boysFunction(settings, results);
+    lbench::ecoeffs(settings, results);
+    lbench::sphericalTransforms(settings, results);
+
+    if (!json_file.empty())
+    {
+        std::ofstream file(json_file);
+        if (!file)
+        {
+            std::cerr << std::format("Could not open the file: {}\n", json_file);
+            return 1;
+        }
+
+        file << lbench::resultsJSON(settings, results);
+    }
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <lible/ints/basis_bundle.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+
+namespace lints = lible::ints;
+
+#ifdef _LIBLE_EMBEDDED_BASIS_
+/// Bounds of the bundle embedded by the build, see basis_bundle.S.in.
+extern "C" const unsigned char lible_basis_bundle_begin[];
+extern "C" const unsigned char lible_basis_bundle_end[];
+#endif
+
+namespace lible::ints
+{
+    /// Returns the record of the basis set, or nullptr if there is none.
+    const bundle::BasisSetRecord *findBasisSet(std::span<const bundle::BasisSetRecord> basis_sets,
+                                               std::string_view names,
+                                               std::string_view basis_set, bool aux);
+
+    /// Returns a view of `n` objects of type T at `ptr` and advances `ptr` past them.
+    template<typename T>
+    std::span<const T> takeSpan(const std::byte *&ptr, const std::uint64_t n)
+    {
+        std::span<const T> view(reinterpret_cast<const T *>(ptr), n);
+        ptr += n * sizeof(T);
+
+        return view;
+    }
+}
+
+const lints::bundle::BasisSetRecord *
+lints::findBasisSet(std::span<const bundle::BasisSetRecord> basis_sets, std::string_view names,
+                    std::string_view basis_set, const bool aux)
+{
+    auto key = [&](const bundle::BasisSetRecord &record)
+    {
+        return std::make_tuple(record.aux_, names.substr(record.name_ofs_, record.name_size_));
+    };
+
+    auto target = std::make_tuple(std::uint32_t(aux), basis_set);
+    auto it = std::lower_bound(basis_sets.begin(), basis_sets.end(), target,
+                               [&](const bundle::BasisSetRecord &record, const auto &value)
+                               {
+                                   return key(record) < value;
+                               });
+
+    if (it == basis_sets.end() || key(*it) != target)
+        return nullptr;
+
+    return &(*it);
+}
+
+std::vector<std::byte> lints::writeBasisBundle(const std::vector<BundledBasisSet> &basis_sets)
+{
+    std::vector<const BundledBasisSet *> sorted;
+    for (const BundledBasisSet &basis_set : basis_sets)
+        sorted.push_back(&basis_set);
+
+    std::ranges::sort(sorted, [](const BundledBasisSet *a, const BundledBasisSet *b)
+    {
+        return std::tie(a->aux_, a->name_) < std::tie(b->aux_, b->name_);
+    });
+
+    std::vector<bundle::BasisSetRecord> basis_set_records;
+    std::vector<bundle::ElementRecord> element_records;
+    std::vector<bundle::ShellRecord> shell_records;
+    std::vector<double> exps, coeffs;
+    std::string names;
+    for (const BundledBasisSet *basis_set : sorted)
+    {
+        std::vector<const BasisAtom *> basis_atoms;
+        for (const BasisAtom &basis_atom : basis_set->basis_atoms_)
+            basis_atoms.push_back(&basis_atom);
+
+        std::ranges::sort(basis_atoms, [](const BasisAtom *a, const BasisAtom *b)
+        {
+            return a->atomic_nr_ < b->atomic_nr_;
+        });
+
+        basis_set_records.push_back({std::uint32_t(names.size()),
+                                     std::uint32_t(basis_set->name_.size()),
+                                     std::uint32_t(basis_set->aux_),
+                                     std::uint32_t(basis_atoms.size()),
+                                     element_records.size()});
+        names += basis_set->name_;
+
+        for (const BasisAtom *basis_atom : basis_atoms)
+        {
+            element_records.push_back({basis_atom->atomic_nr_,
+                                       std::uint32_t(basis_atom->basis_shells_.size()),
+                                       shell_records.size()});
+
+            for (const BasisShell &basis_shell : basis_atom->basis_shells_)
+            {
+                if (basis_shell.exps_.size() != basis_shell.coeffs_.size())
+                    throw std::runtime_error("writeBasisBundle(): mismatch between the number of "
+                                             "exponents and coefficients");
+
+                shell_records.push_back({basis_shell.l_, std::uint32_t(basis_shell.exps_.size()),
+                                         exps.size()});
+                exps.insert(exps.end(), basis_shell.exps_.begin(), basis_shell.exps_.end());
+                coeffs.insert(coeffs.end(), basis_shell.coeffs_.begin(),
+                              basis_shell.coeffs_.end());
+            }
+        }
+    }
+
+    bundle::Header header{};
+    std::memcpy(header.magic_, bundle::magic, sizeof(bundle::magic));
+    header.n_basis_sets_ = basis_set_records.size();
+    header.n_elements_ = element_records.size();
+    header.n_shells_ = shell_records.size();
+    header.n_prims_ = exps.size();
+    header.n_chars_ = names.size();
+
+    std::vector<std::byte> blob;
+    auto append = [&](const void *data, size_t size)
+    {
+        if (size == 0)
+            return;
+
+        size_t pos = blob.size();
+        blob.resize(pos + size);
+        std::memcpy(&blob[pos], data, size);
+    };
+
+    append(&header, sizeof(header));
+    append(basis_set_records.data(), basis_set_records.size() * sizeof(bundle::BasisSetRecord));
+    append(element_records.data(), element_records.size() * sizeof(bundle::ElementRecord));
+    append(shell_records.data(), shell_records.size() * sizeof(bundle::ShellRecord));
+    append(exps.data(), exps.size() * sizeof(double));
+    append(coeffs.data(), coeffs.size() * sizeof(double));
+    append(names.data(), names.size());
+
+    return blob;
+}
+
+lints::BasisBundle::BasisBundle(std::span<const std::byte> blob)
+{
+    if (blob.size() < sizeof(bundle::Header))
+        throw std::runtime_error("BasisBundle(): the bundle is too small");
+
+    if (reinterpret_cast<std::uintptr_t>(blob.data()) % alignof(bundle::Header) != 0)
+        throw std::runtime_error("BasisBundle(): the bundle is not aligned");
+
+    const auto *header = reinterpret_cast<const bundle::Header *>(blob.data());
+    if (std::memcmp(header->magic_, bundle::magic, sizeof(bundle::magic)) != 0)
+        throw std::runtime_error("BasisBundle(): invalid bundle format");
+
+    size_t expected_size = sizeof(bundle::Header) +
+                           header->n_basis_sets_ * sizeof(bundle::BasisSetRecord) +
+                           header->n_elements_ * sizeof(bundle::ElementRecord) +
+                           header->n_shells_ * sizeof(bundle::ShellRecord) +
+                           2 * header->n_prims_ * sizeof(double) + header->n_chars_;
+    if (blob.size() < expected_size)
+        throw std::runtime_error("BasisBundle(): the bundle is truncated");
+
+    const std::byte *ptr = blob.data() + sizeof(bundle::Header);
+    basis_sets_ = takeSpan<bundle::BasisSetRecord>(ptr, header->n_basis_sets_);
+    elements_ = takeSpan<bundle::ElementRecord>(ptr, header->n_elements_);
+    shells_ = takeSpan<bundle::ShellRecord>(ptr, header->n_shells_);
+    exps_ = takeSpan<double>(ptr, header->n_prims_);
+    coeffs_ = takeSpan<double>(ptr, header->n_prims_);
+    names_ = std::string_view(reinterpret_cast<const char *>(ptr), header->n_chars_);
+}
+
+const lints::BasisBundle &lints::BasisBundle::embedded()
+{
+#ifdef _LIBLE_EMBEDDED_BASIS_
+    static const BasisBundle embedded_bundle(
+        std::span<const std::byte>(reinterpret_cast<const std::byte *>(lible_basis_bundle_begin),
+                                   lible_basis_bundle_end - lible_basis_bundle_begin));
+#else
+    static const BasisBundle embedded_bundle;
+#endif
+
+    return embedded_bundle;
+}
+
+bool lints::BasisBundle::empty() const
+{
+    return basis_sets_.empty();
+}
+
+std::vector<std::string_view> lints::BasisBundle::basisSets(const bool aux) const
+{
+    std::vector<std::string_view> basis_sets;
+    for (const bundle::BasisSetRecord &basis_set : basis_sets_)
+        if (basis_set.aux_ == std::uint32_t(aux))
+            basis_sets.push_back(name(basis_set));
+
+    return basis_sets;
+}
+
+bool lints::BasisBundle::contains(std::string_view basis_set, const bool aux) const
+{
+    return findBasisSet(basis_sets_, names_, basis_set, aux) != nullptr;
+}
+
+std::span<const lints::bundle::ElementRecord>
+lints::BasisBundle::elements(std::string_view basis_set, const bool aux) const
+{
+    const bundle::BasisSetRecord *record = findBasisSet(basis_sets_, names_, basis_set, aux);
+    if (record == nullptr)
+        return {};
+
+    return elements_.subspan(record->element_ofs_, record->n_elements_);
+}
+
+std::span<const lints::bundle::ShellRecord>
+lints::BasisBundle::shells(std::string_view basis_set, const bool aux, const int atomic_nr) const
+{
+    std::span<const bundle::ElementRecord> elements = this->elements(basis_set, aux);
+
+    auto it = std::ranges::lower_bound(elements, atomic_nr, {}, &bundle::ElementRecord::atomic_nr_);
+    if (it == elements.end() || it->atomic_nr_ != atomic_nr)
+        return {};
+
+    return shells_.subspan(it->shell_ofs_, it->n_shells_);
+}
+
+std::span<const double> lints::BasisBundle::exps(const bundle::ShellRecord &shell) const
+{
+    return exps_.subspan(shell.prim_ofs_, shell.n_prims_);
+}
+
+std::span<const double> lints::BasisBundle::coeffs(const bundle::ShellRecord &shell) const
+{
+    return coeffs_.subspan(shell.prim_ofs_, shell.n_prims_);
+}
+
+std::string_view lints::BasisBundle::name(const bundle::BasisSetRecord &basis_set) const
+{
+    return names_.substr(basis_set.name_ofs_, basis_set.name_size_);
+}
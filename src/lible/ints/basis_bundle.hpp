@@ -0,0 +1,151 @@
+#pragma once
+
+#include <lible/ints/shell.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lible::ints
+{
+    /// Layout of the binary basis set bundle. The bundle starts with the header, followed by the
+    /// basis set, element and shell tables, the contiguous exponent and coefficient arrays and
+    /// the basis set names. The basis sets are sorted by (aux, name) and the elements of each
+    /// basis set by the atomic number, so every lookup is a binary search. The bundle is written
+    /// and read on the same platform, so the fields are in native byte order.
+    namespace bundle
+    {
+        /// Identifies the format of the bundle.
+        constexpr char magic[8] = {'L', 'I', 'B', 'L', 'E', 'B', 'S', '1'};
+
+        /// Header of the bundle.
+        struct Header
+        {
+            /// Equal to `magic`.
+            char magic_[8];
+            /// Number of basis sets.
+            std::uint64_t n_basis_sets_;
+            /// Total number of elements over all basis sets.
+            std::uint64_t n_elements_;
+            /// Total number of shells over all elements.
+            std::uint64_t n_shells_;
+            /// Total number of primitives over all shells.
+            std::uint64_t n_prims_;
+            /// Total number of characters in the basis set names.
+            std::uint64_t n_chars_;
+        };
+
+        /// Entry of the basis set table.
+        struct BasisSetRecord
+        {
+            /// Offset of the lower case name in the names.
+            std::uint32_t name_ofs_;
+            /// Number of characters in the name.
+            std::uint32_t name_size_;
+            /// 1 for an auxiliary basis set, 0 for a main basis set.
+            std::uint32_t aux_;
+            /// Number of elements in the basis set.
+            std::uint32_t n_elements_;
+            /// Offset of the first element in the element table.
+            std::uint64_t element_ofs_;
+        };
+
+        /// Entry of the element table.
+        struct ElementRecord
+        {
+            /// Atomic number.
+            std::int32_t atomic_nr_;
+            /// Number of shells for the element.
+            std::uint32_t n_shells_;
+            /// Offset of the first shell in the shell table.
+            std::uint64_t shell_ofs_;
+        };
+
+        /// Entry of the shell table.
+        struct ShellRecord
+        {
+            /// Angular momentum.
+            std::int32_t l_;
+            /// Number of primitives in the shell.
+            std::uint32_t n_prims_;
+            /// Offset of the first primitive in the exponent and coefficient arrays.
+            std::uint64_t prim_ofs_;
+        };
+    }
+
+    /// Structure containing the basis set of all elements in a basis set library file, used for
+    /// writing the bundle.
+    struct BundledBasisSet
+    {
+        /// Lower case name of the basis set.
+        std::string name_;
+        /// Whether the basis set is auxiliary.
+        bool aux_{};
+        /// Basis sets of the elements.
+        basis_atoms_t basis_atoms_;
+    };
+
+    /// Serializes the basis sets into a bundle.
+    std::vector<std::byte> writeBasisBundle(const std::vector<BundledBasisSet> &basis_sets);
+
+    /// Class for reading a binary basis set bundle without copying it. The bundle has to outlive
+    /// the class.
+    class BasisBundle
+    {
+    public:
+        /// Creates an empty bundle.
+        BasisBundle() = default;
+
+        /// Creates a view of the given bundle. Throws if the bundle is malformed.
+        explicit BasisBundle(std::span<const std::byte> blob);
+
+        /// Returns the bundle embedded in the library at build time, or an empty bundle if the
+        /// library was built without it.
+        static const BasisBundle &embedded();
+
+        /// Returns true if the bundle contains no basis sets.
+        bool empty() const;
+
+        /// Returns the lower case names of the main or auxiliary basis sets in the bundle.
+        std::vector<std::string_view> basisSets(bool aux) const;
+
+        /// Returns true if the bundle contains the basis set given by its lower case name.
+        bool contains(std::string_view basis_set, bool aux) const;
+
+        /// Returns the elements of the basis set, or an empty span if there is no such basis
+        /// set.
+        std::span<const bundle::ElementRecord> elements(std::string_view basis_set,
+                                                        bool aux) const;
+
+        /// Returns the shells of the element in the basis set, or an empty span if there is no
+        /// such basis set or element.
+        std::span<const bundle::ShellRecord> shells(std::string_view basis_set, bool aux,
+                                                    int atomic_nr) const;
+
+        /// Returns the exponents of the shell.
+        std::span<const double> exps(const bundle::ShellRecord &shell) const;
+
+        /// Returns the contraction coefficients of the shell.
+        std::span<const double> coeffs(const bundle::ShellRecord &shell) const;
+
+    private:
+        /// Table of the basis sets.
+        std::span<const bundle::BasisSetRecord> basis_sets_;
+        /// Table of the elements.
+        std::span<const bundle::ElementRecord> elements_;
+        /// Table of the shells.
+        std::span<const bundle::ShellRecord> shells_;
+        /// Exponents of all primitives.
+        std::span<const double> exps_;
+        /// Contraction coefficients of all primitives.
+        std::span<const double> coeffs_;
+        /// Names of all basis sets.
+        std::string_view names_;
+
+        /// Returns the name of the basis set.
+        std::string_view name(const bundle::BasisSetRecord &basis_set) const;
+    };
+}
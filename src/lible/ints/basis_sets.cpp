@@ -1,26 +1,58 @@
 #include <lible/ints/basis_sets.hpp>
+#include <lible/ints/basis_bundle.hpp>
 #include <lible/ints/defs.hpp>
 #include <lible/ints/ints.hpp>
 
 #include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <charconv>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <ranges>
-#include <sstream>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 
 namespace fs = std::filesystem;
 namespace lints = lible::ints;
 
 namespace lible::ints
 {
-    /// Backend function for reading and returning a basis set from the given path.
-    BasisAtom basisForAtomImpl(int atomic_nr, const std::string &basis_set,
-                               const std::string &basis_path);
+    /// Returns the basis set of the element from the given file. Every file is read and indexed
+    /// once and every element parsed once, later calls are served from the cache. Thread-safe.
+    BasisAtom cachedBasisAtom(int atomic_nr, const std::string &basis_set,
+                              const std::string &basis_path);
+
+    /// Returns the path of the basis set file in the given directory, or an empty string if
+    /// there is none. The directory is scanned once per basis set. Thread-safe.
+    std::string cachedBasisPath(const std::string &basis_prefix, const std::string &basis_set);
+
+    /// Returns true if the basis set is taken from the bundle embedded in the library. This is
+    /// the case if the bundle contains the basis set and the basis set path has not been
+    /// overridden through `BasisPaths`.
+    bool useEmbeddedBasis(const std::string &basis_set, bool aux);
+
+    /// Returns the basis set of the element from the embedded bundle.
+    BasisAtom embeddedBasisAtom(int atomic_nr, const std::string &basis_set, bool aux);
 }
 
+/// Mutex guarding the basis set caches.
+static std::mutex basis_cache_mutex;
+
+/// Cache of the basis set file paths as "directory/basis set" -> path.
+static std::unordered_map<std::string, std::string> basis_path_cache;
+
+/// Cache of the indexed basis set files as path -> file.
+static std::unordered_map<std::string, lints::BasisFile> basis_file_cache;
+
+/// Cache of the parsed basis sets as (path, atomic number) -> basis.
+static std::map<std::pair<std::string, int>, lints::BasisAtom> basis_atom_cache;
+
 /// Mapping between auxiliary basis set names and their families.
 const static std::unordered_map<std::string, lints::AuxBasisFamily>
 aux_basis_families{
@@ -211,94 +243,265 @@ basis_families{
     {"sto-6g", lints::BasisFamily::sto}
 };
 
-lints::BasisAtom lints::basisForAtomImpl(const int atomic_nr, const std::string &basis_set,
-                                         const std::string &basis_path)
+lints::BasisFile lints::readBasisFile(const std::string &basis_path)
 {
-    std::ifstream basis_file(basis_path, std::ios::in);
+    std::ifstream basis_file(basis_path, std::ios::in | std::ios::binary);
+    if (!basis_file)
+        throw std::runtime_error(std::format("readBasisFile(): could not open {}", basis_path));
 
-    std::vector<std::string> lines;
-    {
-        bool basis_found{false}, read_lines{false};
-        std::string line;
-        while (std::getline(basis_file, line))
-        {
-            if (line == std::format("end={}", atomic_nr))
-                break;
+    BasisFile indexed_file;
+    indexed_file.contents_.assign(std::istreambuf_iterator<char>(basis_file),
+                                  std::istreambuf_iterator<char>());
 
-            if (read_lines == true)
-                lines.push_back(line);
+    const std::string &contents = indexed_file.contents_;
 
-            if (line == std::format("element={}", atomic_nr))
-            {
-                read_lines = true;
-                basis_found = true;
-            }
-        }
+    int atomic_nr = -1;
+    size_t pos_begin = 0;
+    for (size_t pos = 0; pos < contents.size();)
+    {
+        size_t pos_eol = contents.find('\n', pos);
+        if (pos_eol == std::string::npos)
+            pos_eol = contents.size();
 
-        if (basis_found == false)
+        std::string_view line(contents.data() + pos, pos_eol - pos);
+        if (line.starts_with("element="))
         {
-            std::string msg = std::format("Basis set {} not found for element {}!",
-                                          basis_set, atomic_symbols.at(atomic_nr));
-            throw std::runtime_error(msg);
+            std::from_chars(line.data() + 8, line.data() + line.size(), atomic_nr);
+            pos_begin = pos_eol + 1;
         }
+        else if (line.starts_with("end=") && atomic_nr >= 0)
+        {
+            indexed_file.offsets_[atomic_nr] = {pos_begin, pos};
+            atomic_nr = -1;
+        }
+
+        pos = pos_eol + 1;
+    }
+
+    return indexed_file;
+}
+
+lints::BasisAtom lints::parseBasisAtom(const int atomic_nr, const std::string &basis_set,
+                                       const BasisFile &basis_file)
+{
+    auto it = basis_file.offsets_.find(atomic_nr);
+    if (it == basis_file.offsets_.end())
+    {
+        std::string msg = std::format("Basis set {} not found for element {}!",
+                                      basis_set, atomic_symbols.at(atomic_nr));
+        throw std::runtime_error(msg);
     }
 
-    int l, counter = 0;
+    auto [pos_begin, pos_end] = it->second;
+    const char *data = basis_file.contents_.data();
+
+    auto parseError = [&]()
+    {
+        return std::runtime_error(std::format("parseBasisAtom(): invalid line in basis set {} "
+                                              "for element {}", basis_set,
+                                              atomic_symbols.at(atomic_nr)));
+    };
+
     BasisShell basis_shell;
     basis_shells_t basis_shells;
-    for (const std::string &line : lines)
+    for (size_t pos = pos_begin; pos < pos_end;)
     {
-        if (line.find("l=") != std::string::npos)
+        size_t pos_eol = basis_file.contents_.find('\n', pos);
+        if (pos_eol == std::string::npos || pos_eol > pos_end)
+            pos_eol = pos_end;
+
+        const char *first = data + pos;
+        const char *last = data + pos_eol;
+        pos = pos_eol + 1;
+
+        std::string_view line(first, last - first);
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos)
+            continue;
+
+        if (line.starts_with("l="))
         {
-            if (counter != 0)
+            if (!basis_shell.exps_.empty())
                 basis_shells.push_back(basis_shell);
 
-            l = line[2] - '0';
-            basis_shell.l_ = l;
             basis_shell.exps_.clear();
             basis_shell.coeffs_.clear();
-            counter = 0;
+            if (std::from_chars(first + 2, last, basis_shell.l_).ec != std::errc())
+                throw parseError();
+
+            continue;
         }
-        else
+
+        // Exponent and contraction coefficient separated by whitespace.
+        std::array<double, 2> vals{};
+        for (double &val : vals)
         {
-            double exp, coeff;
-            std::stringstream line_ss;
-            line_ss << line;
-
-            line_ss >> exp;
-            line_ss >> coeff;
-            basis_shell.exps_.push_back(exp);
-            basis_shell.coeffs_.push_back(coeff);
-            counter++;
+            while (first < last && std::isspace(static_cast<unsigned char>(*first)))
+                first++;
+
+            auto [ptr, ec] = std::from_chars(first, last, val);
+            if (ec != std::errc())
+                throw parseError();
+
+            first = ptr;
         }
+
+        basis_shell.exps_.push_back(vals[0]);
+        basis_shell.coeffs_.push_back(vals[1]);
     }
     basis_shells.push_back(basis_shell);
 
     return {atomic_nr, basis_shells};
 }
 
+lints::BasisAtom lints::cachedBasisAtom(const int atomic_nr, const std::string &basis_set,
+                                        const std::string &basis_path)
+{
+    std::lock_guard<std::mutex> lock(basis_cache_mutex);
+
+    auto it_atom = basis_atom_cache.find({basis_path, atomic_nr});
+    if (it_atom != basis_atom_cache.end())
+        return it_atom->second;
+
+    auto it_file = basis_file_cache.find(basis_path);
+    if (it_file == basis_file_cache.end())
+        it_file = basis_file_cache.emplace(basis_path, readBasisFile(basis_path)).first;
+
+    BasisAtom basis_atom = parseBasisAtom(atomic_nr, basis_set, it_file->second);
+    basis_atom_cache.emplace(std::make_pair(basis_path, atomic_nr), basis_atom);
+
+    return basis_atom;
+}
+
+std::string lints::cachedBasisPath(const std::string &basis_prefix, const std::string &basis_set)
+{
+    std::string bs = basis_set;
+    std::ranges::transform(bs, bs.begin(), [](unsigned char c)
+    {
+        return std::tolower(c);
+    });
+
+    std::string key = basis_prefix + "/" + bs;
+    {
+        std::lock_guard<std::mutex> lock(basis_cache_mutex);
+        auto it = basis_path_cache.find(key);
+        if (it != basis_path_cache.end())
+            return it->second;
+    }
+
+    for (const auto &entry : fs::directory_iterator(basis_prefix))
+    {
+        std::string basis_path = entry.path();
+        std::string basis_name = entry.path().filename();
+        basis_name = basis_name.substr(0, basis_name.find('.'));
+        if (basis_name == bs)
+        {
+            std::lock_guard<std::mutex> lock(basis_cache_mutex);
+            basis_path_cache[key] = basis_path;
+
+            return basis_path;
+        }
+    }
+
+    return {};
+}
+
+void lints::clearBasisSetCache()
+{
+    std::lock_guard<std::mutex> lock(basis_cache_mutex);
+
+    basis_path_cache.clear();
+    basis_file_cache.clear();
+    basis_atom_cache.clear();
+}
+
+bool lints::useEmbeddedBasis(const std::string &basis_set, const bool aux)
+{
+    const BasisBundle &bundle = BasisBundle::embedded();
+    if (bundle.empty())
+        return false;
+
+    if (aux && BasisPaths::getAuxBasisSetsPath() != path_to_aux_basis_sets)
+        return false;
+
+    if (!aux && BasisPaths::getMainBasisSetsPath() != path_to_basis_sets)
+        return false;
+
+    std::string bs = basis_set;
+    std::ranges::transform(bs, bs.begin(), [](unsigned char c)
+    {
+        return std::tolower(c);
+    });
+
+    return bundle.contains(bs, aux);
+}
+
+lints::BasisAtom lints::embeddedBasisAtom(const int atomic_nr, const std::string &basis_set,
+                                          const bool aux)
+{
+    std::string bs = basis_set;
+    std::ranges::transform(bs, bs.begin(), [](unsigned char c)
+    {
+        return std::tolower(c);
+    });
+
+    const BasisBundle &bundle = BasisBundle::embedded();
+    auto shells = bundle.shells(bs, aux, atomic_nr);
+    if (shells.empty())
+    {
+        std::string msg = std::format("Basis set {} not found for element {}!",
+                                      basis_set, atomic_symbols.at(atomic_nr));
+        throw std::runtime_error(msg);
+    }
+
+    basis_shells_t basis_shells(shells.size());
+    for (size_t ishell = 0; ishell < shells.size(); ishell++)
+    {
+        auto exps = bundle.exps(shells[ishell]);
+        auto coeffs = bundle.coeffs(shells[ishell]);
+
+        basis_shells[ishell].l_ = shells[ishell].l_;
+        basis_shells[ishell].exps_.assign(exps.begin(), exps.end());
+        basis_shells[ishell].coeffs_.assign(coeffs.begin(), coeffs.end());
+    }
+
+    return {atomic_nr, basis_shells};
+}
+
 lints::BasisAtom lints::basisForAtom(const int atomic_nr, const std::string &basis_set)
 {
+    if (useEmbeddedBasis(basis_set, false))
+        return embeddedBasisAtom(atomic_nr, basis_set, false);
+
     std::string basis_path = basisPath(basis_set);
-    return basisForAtomImpl(atomic_nr, basis_set, basis_path);
+    return cachedBasisAtom(atomic_nr, basis_set, basis_path);
 }
 
 lints::BasisAtom lints::basisForAtomAux(const int atomic_nr, const std::string &basis_set)
 {
+    if (useEmbeddedBasis(basis_set, true))
+        return embeddedBasisAtom(atomic_nr, basis_set, true);
+
     std::string aux_basis_path = auxBasisPath(basis_set);
-    return basisForAtomImpl(atomic_nr, basis_set, aux_basis_path);
+    return cachedBasisAtom(atomic_nr, basis_set, aux_basis_path);
 }
 
 lints::basis_atoms_t lints::basisForAtoms(const std::vector<int> &atomic_nrs,
                                           const std::string &basis_set)
 {
     basis_atoms_t basis_atoms;
-    for (const int atomic_nr : atomic_nrs)
+    basis_atoms.reserve(atomic_nrs.size());
+    if (useEmbeddedBasis(basis_set, false))
     {
-        BasisAtom basis_atom = basisForAtom(atomic_nr, basis_set);
-        basis_atoms.push_back(basis_atom);
+        for (const int atomic_nr : atomic_nrs)
+            basis_atoms.push_back(embeddedBasisAtom(atomic_nr, basis_set, false));
+
+        return basis_atoms;
     }
 
+    std::string basis_path = basisPath(basis_set);
+    for (const int atomic_nr : atomic_nrs)
+        basis_atoms.push_back(cachedBasisAtom(atomic_nr, basis_set, basis_path));
+
     return basis_atoms;
 }
 
@@ -306,34 +509,30 @@ lints::basis_atoms_t lints::basisForAtomsAux(const std::vector<int> &atomic_nrs,
                                              const std::string &aux_basis_set)
 {
     basis_atoms_t aux_basis_atoms;
-    for (const int atomic_nr : atomic_nrs)
+    aux_basis_atoms.reserve(atomic_nrs.size());
+    if (useEmbeddedBasis(aux_basis_set, true))
     {
-        BasisAtom basis_atom = basisForAtomAux(atomic_nr, aux_basis_set);
-        aux_basis_atoms.push_back(basis_atom);
+        for (const int atomic_nr : atomic_nrs)
+            aux_basis_atoms.push_back(embeddedBasisAtom(atomic_nr, aux_basis_set, true));
+
+        return aux_basis_atoms;
     }
 
+    std::string aux_basis_path = auxBasisPath(aux_basis_set);
+    for (const int atomic_nr : atomic_nrs)
+        aux_basis_atoms.push_back(cachedBasisAtom(atomic_nr, aux_basis_set, aux_basis_path));
+
     return aux_basis_atoms;
 }
 
 std::string lints::auxBasisPath(const std::string &aux_basis_set)
 {
-    std::string bs = aux_basis_set;
-    std::ranges::transform(bs, bs.begin(), [](unsigned char c)
-    {
-        return std::tolower(c);
-    });
-
     std::string basis_family_str = auxBasisFamilyString(aux_basis_set);
     std::string basis_prefix = BasisPaths::getAuxBasisSetsPath() + "/" + basis_family_str;
 
-    for (const auto &entry : fs::directory_iterator(basis_prefix))
-    {
-        std::string basis_path = entry.path();
-        std::string basis_name = entry.path().filename();
-        basis_name = basis_name.substr(0, basis_name.find('.'));
-        if (basis_name == bs)
-            return basis_path;
-    }
+    std::string basis_path = cachedBasisPath(basis_prefix, aux_basis_set);
+    if (!basis_path.empty())
+        return basis_path;
 
     std::string message = std::format("auxBasisPath(): the requested basis set {} could not be "
                                       "found", aux_basis_set);
@@ -342,23 +541,12 @@ std::string lints::auxBasisPath(const std::string &aux_basis_set)
 
 std::string lints::basisPath(const std::string &basis_set)
 {
-    std::string bs = basis_set;
-    std::ranges::transform(bs, bs.begin(), [](unsigned char c)
-    {
-        return std::tolower(c);
-    });
-
     std::string basis_family_str = basisFamilyString(basis_set);
     std::string basis_prefix = BasisPaths::getMainBasisSetsPath() + "/" + basis_family_str;
 
-    for (const auto &entry : fs::directory_iterator(basis_prefix))
-    {
-        std::string basis_path = entry.path();
-        std::string basis_name = entry.path().filename();
-        basis_name = basis_name.substr(0, basis_name.find('.'));
-        if (basis_name == bs)
-            return basis_path;
-    }
+    std::string basis_path = cachedBasisPath(basis_prefix, basis_set);
+    if (!basis_path.empty())
+        return basis_path;
 
     std::string message = std::format("The requested basis set {} could not be found!", basis_set);
     throw std::runtime_error(message);
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <lible/ints/shell.hpp>
+
+#include <map>
 #include <string>
+#include <utility>
 
 namespace lible::ints
 {
@@ -40,4 +44,21 @@ namespace lible::ints
 
     /// Returns the family of the auxiliary basis set.
     AuxBasisFamily auxBasisFamily(const std::string &aux_basis_set);
+
+    /// Structure containing the contents of a basis set file and, for every element, the
+    /// offsets of its lines between "element=" and "end=".
+    struct BasisFile
+    {
+        /// Contents of the file.
+        std::string contents_;
+        /// Offsets as atomic number -> [begin, end) in the contents.
+        std::map<int, std::pair<size_t, size_t>> offsets_;
+    };
+
+    /// Reads the basis set file and indexes its elements.
+    BasisFile readBasisFile(const std::string &basis_path);
+
+    /// Parses the basis set of the element from the indexed file.
+    BasisAtom parseBasisAtom(int atomic_nr, const std::string &basis_set,
+                             const BasisFile &basis_file);
 }
@@ -78,12 +78,16 @@ std::vector<double> lints::calcBoysF(const int n, const double x, const BoysGrid
     std::vector<double> fnx(n + 1, 0);
     if (x == 0)
     {
+        LIBLE_INSTRUMENT(instrumentation::current().n_boys_zero_++;)
+
         fnx[0] = 1;
         for (int k = 1; k <= n; k++)
             fnx[k] = 1.0 / (2 * k + 1);
     }
     else if (x > large_x)
     {
+        LIBLE_INSTRUMENT(instrumentation::current().n_boys_asymptotic_++;)
+
         // Adapted from HUMMR
         fnx[0] = 0.5 * std::sqrt(M_PI / x);
         for (int k = 1; k <= n; k++)
@@ -91,6 +95,8 @@ std::vector<double> lints::calcBoysF(const int n, const double x, const BoysGrid
     }
     else
     {
+        LIBLE_INSTRUMENT(instrumentation::current().n_boys_grid_++;)
+
         int ival = x / interval_size;
 
         double origin_x = ival * interval_size;
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <lible/ints/instrumentation.hpp>
+
 #include <array>
 #include <cmath>
 #include <vector>
@@ -69,6 +71,8 @@ namespace lible::ints
         {
             if (x == 0)
             {
+                LIBLE_INSTRUMENT(instrumentation::current().n_boys_zero_++;)
+
                 // (9.8.6) from the bible.
                 fnx[0] = 1;
                 for (int k = 1; k <= L; k++)
@@ -76,6 +80,8 @@ namespace lible::ints
             }
             else if (x > 30.0)
             {
+                LIBLE_INSTRUMENT(instrumentation::current().n_boys_asymptotic_++;)
+
                 // Adapted from HUMMR, should be (9.8.9) in the book.
                 fnx[0] = 0.5 * std::sqrt(M_PI / x);
                 for (int k = 1; k <= L; k++)
@@ -83,6 +89,8 @@ namespace lible::ints
             }
             else
             {
+                LIBLE_INSTRUMENT(instrumentation::current().n_boys_grid_++;)
+
                 // (9.8.12) from HJO.
                 int ival = x / interval_size_;
 
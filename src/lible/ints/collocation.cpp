@@ -0,0 +1,512 @@
+#include <lible/ints/cart_exps.hpp>
+#include <lible/ints/defs.hpp>
+#include <lible/ints/ecoeffs.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/spherical_trafo.hpp>
+#include <lible/ints/utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Number of points in a block handled by one task.
+    constexpr size_t n_points_block = 64;
+
+    /// Number of collocation components: value, three gradient components and Laplacian.
+    constexpr int n_components = 5;
+
+    /// Coordinates of a block of points relative to a shell center and the contracted radial
+    /// part of the shell at the points. Padded with zeros up to `n_points_block` so that all the
+    /// loops over the points have a fixed trip count.
+    struct RadialBlock
+    {
+        std::array<double, n_points_block> x_, y_, z_, r2_;
+        /// sum_k d_k exp(-a_k r^2), where d_k includes the primitive norm.
+        std::array<double, n_points_block> rad_;
+        /// Same as above with -2 a_k multiplied in.
+        std::array<double, n_points_block> rad_d1_;
+        /// Same as above with 4 a_k^2 multiplied in.
+        std::array<double, n_points_block> rad_d2_;
+    };
+
+    /// Returns the distance from the shell center beyond which the atomic orbitals, and their
+    /// derivatives up to `deriv_order`, are below `screening_thrs` in absolute value.
+    double shellExtent(const Shell &shell, int deriv_order, double screening_thrs);
+
+    /// Calculates the relative coordinates and the radial parts of the shell at the points in
+    /// [ipoint_begin, ipoint_end).
+    void radialBlock(const Shell &shell, const std::vector<std::array<double, 3>> &points,
+                     size_t ipoint_begin, size_t ipoint_end, bool calc_d1, bool calc_d2,
+                     RadialBlock &rblock);
+
+    /// Calculates the Cartesian Gaussians of the shell on a block of points as (component,
+    /// mu_, point), with the components ordered as in `n_components`. Explicitly rolled out for
+    /// each l.
+    template <int l, bool calc_gradient, bool calc_laplacian>
+    void cartesianBlock(const RadialBlock &rblock, double *cart);
+
+    /// Same as above for arbitrary l.
+    void cartesianBlock(int l, bool calc_gradient, bool calc_laplacian, const RadialBlock &rblock,
+                        double *cart);
+
+    /// Transforms one component of the Cartesian Gaussians, (mu_, point), to the normalized
+    /// spherical atomic orbitals, (mu, point), with the compile-time CSR table. Explicitly rolled
+    /// out for each l.
+    template <int l>
+    void sphericalBlock(const double *norms, const double *cart, double *sph);
+
+    /// Same as above for arbitrary l, with the CSR table from sphTrafoCSR().
+    void sphericalBlock(int l, const double *norms, const double *cart, double *sph);
+
+    /// Transforms the Cartesian Gaussians to normalized spherical atomic orbitals and copies them
+    /// to the (point, ao) matrices of the collocation.
+    void sphericalBlocks(const Shell &shell, const double *cart, size_t ipoint_begin,
+                         size_t ipoint_end, double *sph, AOCollocation &collocation);
+
+    using cartesian_block_fun_t = void (*)(const RadialBlock &rblock, double *cart);
+
+    using spherical_block_fun_t = void (*)(const double *norms, const double *cart, double *sph);
+
+    template <bool calc_gradient, bool calc_laplacian, size_t... ls>
+    constexpr std::array<cartesian_block_fun_t, sizeof...(ls)>
+    cartesianBlockFuns(std::index_sequence<ls...>)
+    {
+        return {&cartesianBlock<ls, calc_gradient, calc_laplacian>...};
+    }
+
+    /// Rolled-out Cartesian functions for l = 0,...,_max_l_rollout_, indexed as
+    /// [calc_gradient + 2 * calc_laplacian][l].
+    constexpr std::array<std::array<cartesian_block_fun_t, _max_l_rollout_ + 1>, 4>
+        cartesian_block_funs{
+            cartesianBlockFuns<false, false>(std::make_index_sequence<_max_l_rollout_ + 1>()),
+            cartesianBlockFuns<true, false>(std::make_index_sequence<_max_l_rollout_ + 1>()),
+            cartesianBlockFuns<false, true>(std::make_index_sequence<_max_l_rollout_ + 1>()),
+            cartesianBlockFuns<true, true>(std::make_index_sequence<_max_l_rollout_ + 1>())
+        };
+
+    template <size_t... ls>
+    constexpr std::array<spherical_block_fun_t, sizeof...(ls)>
+    sphericalBlockFuns(std::index_sequence<ls...>)
+    {
+        return {&sphericalBlock<ls>...};
+    }
+
+    /// Rolled-out spherical transformations for l = 0,...,_max_l_rollout_.
+    constexpr auto spherical_block_funs =
+        sphericalBlockFuns(std::make_index_sequence<_max_l_rollout_ + 1>());
+}
+
+double lints::shellExtent(const Shell &shell, const int deriv_order,
+                          const double screening_thrs)
+{
+    if (screening_thrs <= 0)
+        return std::numeric_limits<double>::infinity();
+
+    int l = shell.l_;
+
+    // |sum_mu_ c_{mu mu_} x^i y^j z^k| <= sum_mu_ |c_{mu mu_}| r^l
+    SphTrafoCSRView trafo = sphTrafoCSR(l);
+
+    double fac = 0;
+    for (int mu = 0; mu < trafo.n_sph_; mu++)
+    {
+        double bound_angular = 0;
+        for (int k = trafo.row_ptrs_[mu]; k < trafo.row_ptrs_[mu + 1]; k++)
+            bound_angular += std::fabs(trafo.vals_[k]);
+
+        fac = std::max(fac, shell.norms_[mu] * bound_angular);
+    }
+
+    // The Laplacian is a sum of three second derivatives.
+    if (deriv_order == 2)
+        fac *= 3;
+
+    // Each derivative multiplies the primitive by at most (l + 2 + 2ar) for r >= 1. The radius
+    // where the bound, c r^l (l + 2 + 2ar)^n exp(-ar^2), drops below the threshold is found by
+    // fixed-point iteration starting from beyond the maximum. The iterates increase
+    // monotonically, and if the bound is below the threshold already at the start, the start
+    // is returned.
+    double extent = 0;
+    for (size_t iprim = 0; iprim < shell.exps_.size(); iprim++)
+    {
+        double a = shell.exps_[iprim];
+        double c = fac * std::fabs(shell.coeffs_[iprim] * shell.norms_prim_[iprim]);
+
+        double r = std::max(1.0, std::sqrt((l + deriv_order) / (2 * a)));
+        for (int iter = 0; iter < 100; iter++)
+        {
+            double arg = std::log(c / screening_thrs) + l * std::log(r) +
+                         deriv_order * std::log(l + 2 + 2 * a * r);
+
+            double r_new = std::sqrt(std::max(arg, 0.0) / a);
+            if (r_new <= r * (1 + 1e-10))
+                break;
+
+            r = r_new;
+        }
+
+        extent = std::max(extent, r);
+    }
+
+    return extent;
+}
+
+void lints::radialBlock(const Shell &shell, const std::vector<std::array<double, 3>> &points,
+                        const size_t ipoint_begin, const size_t ipoint_end, const bool calc_d1,
+                        const bool calc_d2, RadialBlock &rblock)
+{
+    const auto &[xa, ya, za] = shell.xyz_coords_;
+
+    size_t n_points = ipoint_end - ipoint_begin;
+    for (size_t ip = 0; ip < n_points; ip++)
+    {
+        const auto &[x, y, z] = points[ipoint_begin + ip];
+        rblock.x_[ip] = x - xa;
+        rblock.y_[ip] = y - ya;
+        rblock.z_[ip] = z - za;
+    }
+    for (size_t ip = n_points; ip < n_points_block; ip++)
+    {
+        rblock.x_[ip] = 0;
+        rblock.y_[ip] = 0;
+        rblock.z_[ip] = 0;
+    }
+
+    for (size_t ip = 0; ip < n_points_block; ip++)
+        rblock.r2_[ip] = rblock.x_[ip] * rblock.x_[ip] + rblock.y_[ip] * rblock.y_[ip] +
+                         rblock.z_[ip] * rblock.z_[ip];
+
+    rblock.rad_.fill(0);
+    if (calc_d1)
+        rblock.rad_d1_.fill(0);
+    if (calc_d2)
+        rblock.rad_d2_.fill(0);
+
+    for (size_t iprim = 0; iprim < shell.exps_.size(); iprim++)
+    {
+        double a = shell.exps_[iprim];
+        double d = shell.coeffs_[iprim] * shell.norms_prim_[iprim];
+
+        for (size_t ip = 0; ip < n_points_block; ip++)
+        {
+            double val = d * std::exp(-a * rblock.r2_[ip]);
+
+            rblock.rad_[ip] += val;
+            if (calc_d1)
+                rblock.rad_d1_[ip] += -2 * a * val;
+            if (calc_d2)
+                rblock.rad_d2_[ip] += 4 * a * a * val;
+        }
+    }
+}
+
+template <int l, bool calc_gradient, bool calc_laplacian>
+void lints::cartesianBlock(const RadialBlock &rblock, double *cart)
+{
+    constexpr int n_cart = numCartesians(l);
+    constexpr size_t n_comp = n_cart * n_points_block;
+    constexpr auto cart_exps = cartExpsC<l>();
+
+    // Powers x^n, y^n and z^n, n = 0,...,l.
+    std::array<std::array<double, n_points_block>, l + 1> xp, yp, zp;
+    xp[0].fill(1);
+    yp[0].fill(1);
+    zp[0].fill(1);
+    for (int n = 1; n <= l; n++)
+        for (size_t ip = 0; ip < n_points_block; ip++)
+        {
+            xp[n][ip] = xp[n - 1][ip] * rblock.x_[ip];
+            yp[n][ip] = yp[n - 1][ip] * rblock.y_[ip];
+            zp[n][ip] = zp[n - 1][ip] * rblock.z_[ip];
+        }
+
+    const double *rad = &rblock.rad_[0];
+    const double *rad_d1 = &rblock.rad_d1_[0];
+    const double *rad_d2 = &rblock.rad_d2_[0];
+    for (int mu_ = 0; mu_ < n_cart; mu_++)
+    {
+        const auto [i, j, k] = cart_exps[mu_];
+        const double *xi = &xp[i][0];
+        const double *yj = &yp[j][0];
+        const double *zk = &zp[k][0];
+
+        double *val = &cart[mu_ * n_points_block];
+        for (size_t ip = 0; ip < n_points_block; ip++)
+            val[ip] = xi[ip] * yj[ip] * zk[ip] * rad[ip];
+
+        if constexpr (calc_gradient)
+        {
+            // d/dx x^i f(r^2) = i x^(i - 1) f + x^(i + 1) f'
+            double *grad_x = &cart[1 * n_comp + mu_ * n_points_block];
+            double *grad_y = &cart[2 * n_comp + mu_ * n_points_block];
+            double *grad_z = &cart[3 * n_comp + mu_ * n_points_block];
+            for (size_t ip = 0; ip < n_points_block; ip++)
+            {
+                double poly_d1 = xi[ip] * yj[ip] * zk[ip] * rad_d1[ip];
+                grad_x[ip] = rblock.x_[ip] * poly_d1;
+                grad_y[ip] = rblock.y_[ip] * poly_d1;
+                grad_z[ip] = rblock.z_[ip] * poly_d1;
+            }
+
+            if (i > 0)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    grad_x[ip] += i * xp[i - 1][ip] * yj[ip] * zk[ip] * rad[ip];
+            if (j > 0)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    grad_y[ip] += j * xi[ip] * yp[j - 1][ip] * zk[ip] * rad[ip];
+            if (k > 0)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    grad_z[ip] += k * xi[ip] * yj[ip] * zp[k - 1][ip] * rad[ip];
+        }
+
+        if constexpr (calc_laplacian)
+        {
+            // nabla^2 x^i y^j z^k f(r^2) = sum_x i(i - 1) x^(i - 2) y^j z^k f
+            //                              + ((2l + 3) f' + r^2 f'') x^i y^j z^k
+            double *lapl = &cart[4 * n_comp + mu_ * n_points_block];
+            for (size_t ip = 0; ip < n_points_block; ip++)
+                lapl[ip] = xi[ip] * yj[ip] * zk[ip] *
+                           ((2 * l + 3) * rad_d1[ip] + rblock.r2_[ip] * rad_d2[ip]);
+
+            if (i > 1)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    lapl[ip] += i * (i - 1) * xp[i - 2][ip] * yj[ip] * zk[ip] * rad[ip];
+            if (j > 1)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    lapl[ip] += j * (j - 1) * xi[ip] * yp[j - 2][ip] * zk[ip] * rad[ip];
+            if (k > 1)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    lapl[ip] += k * (k - 1) * xi[ip] * yj[ip] * zp[k - 2][ip] * rad[ip];
+        }
+    }
+}
+
+void lints::cartesianBlock(const int l, const bool calc_gradient, const bool calc_laplacian,
+                           const RadialBlock &rblock, double *cart)
+{
+    int n_cart = numCartesians(l);
+    size_t n_comp = n_cart * n_points_block;
+
+    std::vector<std::array<double, n_points_block>> xp(l + 1), yp(l + 1), zp(l + 1);
+    xp[0].fill(1);
+    yp[0].fill(1);
+    zp[0].fill(1);
+    for (int n = 1; n <= l; n++)
+        for (size_t ip = 0; ip < n_points_block; ip++)
+        {
+            xp[n][ip] = xp[n - 1][ip] * rblock.x_[ip];
+            yp[n][ip] = yp[n - 1][ip] * rblock.y_[ip];
+            zp[n][ip] = zp[n - 1][ip] * rblock.z_[ip];
+        }
+
+    const double *rad = &rblock.rad_[0];
+    const double *rad_d1 = &rblock.rad_d1_[0];
+    const double *rad_d2 = &rblock.rad_d2_[0];
+    for (const auto &[i, j, k, mu_] : cart_exps[l])
+    {
+        const double *xi = &xp[i][0];
+        const double *yj = &yp[j][0];
+        const double *zk = &zp[k][0];
+
+        double *val = &cart[mu_ * n_points_block];
+        for (size_t ip = 0; ip < n_points_block; ip++)
+            val[ip] = xi[ip] * yj[ip] * zk[ip] * rad[ip];
+
+        if (calc_gradient)
+        {
+            double *grad_x = &cart[1 * n_comp + mu_ * n_points_block];
+            double *grad_y = &cart[2 * n_comp + mu_ * n_points_block];
+            double *grad_z = &cart[3 * n_comp + mu_ * n_points_block];
+            for (size_t ip = 0; ip < n_points_block; ip++)
+            {
+                double poly_d1 = xi[ip] * yj[ip] * zk[ip] * rad_d1[ip];
+                grad_x[ip] = rblock.x_[ip] * poly_d1;
+                grad_y[ip] = rblock.y_[ip] * poly_d1;
+                grad_z[ip] = rblock.z_[ip] * poly_d1;
+            }
+
+            if (i > 0)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    grad_x[ip] += i * xp[i - 1][ip] * yj[ip] * zk[ip] * rad[ip];
+            if (j > 0)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    grad_y[ip] += j * xi[ip] * yp[j - 1][ip] * zk[ip] * rad[ip];
+            if (k > 0)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    grad_z[ip] += k * xi[ip] * yj[ip] * zp[k - 1][ip] * rad[ip];
+        }
+
+        if (calc_laplacian)
+        {
+            double *lapl = &cart[4 * n_comp + mu_ * n_points_block];
+            for (size_t ip = 0; ip < n_points_block; ip++)
+                lapl[ip] = xi[ip] * yj[ip] * zk[ip] *
+                           ((2 * l + 3) * rad_d1[ip] + rblock.r2_[ip] * rad_d2[ip]);
+
+            if (i > 1)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    lapl[ip] += i * (i - 1) * xp[i - 2][ip] * yj[ip] * zk[ip] * rad[ip];
+            if (j > 1)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    lapl[ip] += j * (j - 1) * xi[ip] * yp[j - 2][ip] * zk[ip] * rad[ip];
+            if (k > 1)
+                for (size_t ip = 0; ip < n_points_block; ip++)
+                    lapl[ip] += k * (k - 1) * xi[ip] * yj[ip] * zp[k - 2][ip] * rad[ip];
+        }
+    }
+}
+
+template <int l>
+void lints::sphericalBlock(const double *norms, const double *cart, double *sph)
+{
+    constexpr int n_sph = numSphericals(l);
+    constexpr auto trafo = sphTrafoC<l>();
+
+    for (int mu = 0; mu < n_sph; mu++)
+    {
+        double *sph_mu = &sph[mu * n_points_block];
+        std::fill(sph_mu, sph_mu + n_points_block, 0);
+
+        for (int k = trafo.row_ptrs[mu]; k < trafo.row_ptrs[mu + 1]; k++)
+        {
+            double fac = norms[mu] * trafo.vals[k];
+
+            const double *cart_mu_ = &cart[trafo.cart_idxs[k] * n_points_block];
+            for (size_t ip = 0; ip < n_points_block; ip++)
+                sph_mu[ip] += fac * cart_mu_[ip];
+        }
+    }
+}
+
+void lints::sphericalBlock(const int l, const double *norms, const double *cart, double *sph)
+{
+    SphTrafoCSRView trafo = sphTrafoCSR(l);
+
+    for (int mu = 0; mu < trafo.n_sph_; mu++)
+    {
+        double *sph_mu = &sph[mu * n_points_block];
+        std::fill(sph_mu, sph_mu + n_points_block, 0);
+
+        for (int k = trafo.row_ptrs_[mu]; k < trafo.row_ptrs_[mu + 1]; k++)
+        {
+            double fac = norms[mu] * trafo.vals_[k];
+
+            const double *cart_mu_ = &cart[trafo.cart_idxs_[k] * n_points_block];
+            for (size_t ip = 0; ip < n_points_block; ip++)
+                sph_mu[ip] += fac * cart_mu_[ip];
+        }
+    }
+}
+
+void lints::sphericalBlocks(const Shell &shell, const double *cart, const size_t ipoint_begin,
+                            const size_t ipoint_end, double *sph, AOCollocation &collocation)
+{
+    std::array<vec2d *, n_components> targets{
+        &collocation.values_, &collocation.gradients_[0], &collocation.gradients_[1],
+        &collocation.gradients_[2], &collocation.laplacians_
+    };
+
+    int l = shell.l_;
+    size_t n_cart = shell.dim_cart_;
+    size_t n_sph = shell.dim_sph_;
+    size_t n_points = ipoint_end - ipoint_begin;
+    for (int icomp = 0; icomp < n_components; icomp++)
+    {
+        vec2d &target = *targets[icomp];
+        if (target.size() == 0)
+            continue;
+
+        const double *cart_comp = &cart[icomp * n_cart * n_points_block];
+
+        if (l <= _max_l_rollout_)
+            spherical_block_funs[l](shell.norms_.data(), cart_comp, sph);
+        else
+            sphericalBlock(l, shell.norms_.data(), cart_comp, sph);
+
+        for (size_t ip = 0; ip < n_points; ip++)
+            for (size_t mu = 0; mu < n_sph; mu++)
+                target(ipoint_begin + ip, shell.ofs_sph_ + mu) = sph[mu * n_points_block + ip];
+    }
+}
+
+lints::AOCollocation
+lints::aoCollocation(const std::vector<std::array<double, 3>> &points,
+                     const Structure &structure, const bool calc_gradient,
+                     const bool calc_laplacian, const double screening_thrs)
+{
+    size_t dim_ao = structure.getDimAO();
+    size_t n_points = points.size();
+    int l_max = structure.getMaxL();
+    std::span<const Shell> shells = structure.getShellsView();
+
+    int deriv_order = calc_laplacian ? 2 : (calc_gradient ? 1 : 0);
+
+    std::vector<double> extents(shells.size());
+    for (size_t ishell = 0; ishell < shells.size(); ishell++)
+        extents[ishell] = shellExtent(shells[ishell], deriv_order, screening_thrs);
+
+    AOCollocation collocation;
+    collocation.values_ = vec2d(Fill(0), n_points, dim_ao);
+    if (calc_gradient)
+        for (int icart = 0; icart < 3; icart++)
+            collocation.gradients_[icart] = vec2d(Fill(0), n_points, dim_ao);
+    if (calc_laplacian)
+        collocation.laplacians_ = vec2d(Fill(0), n_points, dim_ao);
+
+    int idx_funs = calc_gradient + 2 * calc_laplacian;
+
+    size_t n_blocks = (n_points + n_points_block - 1) / n_points_block;
+#pragma omp parallel
+    {
+        RadialBlock rblock;
+        std::vector<double> cart(n_components * numCartesians(l_max) * n_points_block);
+        std::vector<double> sph(numSphericals(l_max) * n_points_block);
+
+#pragma omp for schedule(dynamic)
+        for (size_t iblock = 0; iblock < n_blocks; iblock++)
+        {
+            size_t ipoint_begin = iblock * n_points_block;
+            size_t ipoint_end = std::min(ipoint_begin + n_points_block, n_points);
+
+            // Bounding sphere of the block
+            std::array<double, 3> center{0, 0, 0};
+            for (size_t ipoint = ipoint_begin; ipoint < ipoint_end; ipoint++)
+                for (int icart = 0; icart < 3; icart++)
+                    center[icart] += points[ipoint][icart] / (ipoint_end - ipoint_begin);
+
+            double radius = 0;
+            for (size_t ipoint = ipoint_begin; ipoint < ipoint_end; ipoint++)
+                radius = std::max(radius, std::hypot(points[ipoint][0] - center[0],
+                                                     points[ipoint][1] - center[1],
+                                                     points[ipoint][2] - center[2]));
+
+            for (size_t ishell = 0; ishell < shells.size(); ishell++)
+            {
+                const Shell &shell = shells[ishell];
+
+                const auto &[xa, ya, za] = shell.xyz_coords_;
+                double dist = std::hypot(xa - center[0], ya - center[1], za - center[2]);
+                if (dist - radius > extents[ishell])
+                    continue;
+
+                radialBlock(shell, points, ipoint_begin, ipoint_end, deriv_order > 0,
+                            calc_laplacian, rblock);
+
+                if (shell.l_ <= _max_l_rollout_)
+                    cartesian_block_funs[idx_funs][shell.l_](rblock, cart.data());
+                else
+                    cartesianBlock(shell.l_, calc_gradient, calc_laplacian, rblock, cart.data());
+
+                sphericalBlocks(shell, cart.data(), ipoint_begin, ipoint_end, sph.data(),
+                                collocation);
+            }
+        }
+    }
+
+    return collocation;
+}
@@ -17,6 +17,9 @@ namespace lible::ints
     /// Maximum angular momentum for which explicitly rolled-out code may be used.
     constexpr int _max_l_rollout_ = 6;
 
+    /// Maximum number of roots in the Rys quadrature, covering quartets up to L = 30.
+    constexpr int _max_rys_roots_ = 16;
+
     /// Mapping between angular momentum value and label.
     const std::map<int, std::string> angmom_to_label{
         {0, "s"},
@@ -0,0 +1,150 @@
+#include <lible/ints/distributed.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+
+#ifdef _LIBLE_USE_MPI_
+#include <mpl/mpl.hpp>
+#endif
+
+namespace lints = lible::ints;
+
+int lints::processRank()
+{
+#ifdef _LIBLE_USE_MPI_
+    return mpl::environment::comm_world().rank();
+#else
+    return 0;
+#endif
+}
+
+int lints::numProcesses()
+{
+#ifdef _LIBLE_USE_MPI_
+    return mpl::environment::comm_world().size();
+#else
+    return 1;
+#endif
+}
+
+void lints::allReduceSum(double *data, const size_t size)
+{
+#ifdef _LIBLE_USE_MPI_
+    const mpl::communicator &comm = mpl::environment::comm_world();
+    if (comm.size() == 1)
+        return;
+
+    // MPI counts are ints, so large arrays go in chunks.
+    const size_t max_chunk = std::numeric_limits<int>::max() / 2;
+    for (size_t ofs = 0; ofs < size; ofs += max_chunk)
+    {
+        mpl::contiguous_layout<double> layout(std::min(max_chunk, size - ofs));
+        comm.allreduce(mpl::plus<double>(), data + ofs, layout);
+    }
+#endif
+}
+
+lints::TaskDistributor::TaskDistributor(const std::vector<double> &costs)
+{
+    rank_ = processRank();
+    n_procs_ = numProcesses();
+
+    // Longest task first onto the least loaded process.
+    std::vector<size_t> order(costs.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t i, size_t j) { return costs[i] > costs[j]; });
+
+    using load_t = std::pair<double, int>;
+    std::priority_queue<load_t, std::vector<load_t>, std::greater<load_t>> loads;
+    for (int rank = 0; rank < n_procs_; rank++)
+        loads.push({0.0, rank});
+
+    partitions_.resize(n_procs_);
+    for (size_t itask : order)
+    {
+        auto [load, rank] = loads.top();
+        loads.pop();
+
+        partitions_[rank].push_back(itask);
+        loads.push({load + costs[itask], rank});
+    }
+
+    // Consecutive tasks tend to share the kernels and data.
+    for (auto &partition : partitions_)
+        std::sort(partition.begin(), partition.end());
+
+#ifdef _LIBLE_USE_MPI_
+    MPI_Comm comm = mpl::environment::comm_world().native_handle();
+    MPI_Win_allocate(sizeof(long), sizeof(long), MPI_INFO_NULL, comm, &counter_, &window_);
+    *counter_ = 0;
+    MPI_Barrier(comm);
+    MPI_Win_lock_all(0, window_);
+#endif
+}
+
+lints::TaskDistributor::~TaskDistributor()
+{
+#ifdef _LIBLE_USE_MPI_
+    MPI_Win_unlock_all(window_);
+    MPI_Win_free(&window_);
+#endif
+}
+
+bool lints::TaskDistributor::next(size_t &itask)
+{
+    int victim = victim_.load(std::memory_order_relaxed);
+    while (victim < n_procs_)
+    {
+        int rank = (rank_ + victim) % n_procs_;
+
+        size_t ipos = fetchAndIncrement(rank);
+        if (ipos < partitions_[rank].size())
+        {
+            itask = partitions_[rank][ipos];
+            if (victim > 0)
+                n_stolen_.fetch_add(1, std::memory_order_relaxed);
+
+            return true;
+        }
+
+        // Only one of the threads that found the partition empty moves on to the next one.
+        int expected = victim;
+        if (victim_.compare_exchange_strong(expected, victim + 1, std::memory_order_relaxed))
+            victim++;
+        else
+            victim = expected;
+    }
+
+    return false;
+}
+
+const std::vector<size_t> &lints::TaskDistributor::partition(const int rank) const
+{
+    return partitions_.at(rank);
+}
+
+size_t lints::TaskDistributor::numStolen() const
+{
+    return n_stolen_.load(std::memory_order_relaxed);
+}
+
+size_t lints::TaskDistributor::fetchAndIncrement([[maybe_unused]] const int rank)
+{
+#ifdef _LIBLE_USE_MPI_
+    long one = 1, ipos = 0;
+#pragma omp critical(lible_task_distributor)
+    {
+        MPI_Fetch_and_op(&one, &ipos, MPI_LONG, rank, 0, MPI_SUM, window_);
+        MPI_Win_flush(rank, window_);
+    }
+
+    return size_t(ipos);
+#else
+    return counter_.fetch_add(1, std::memory_order_relaxed);
+#endif
+}
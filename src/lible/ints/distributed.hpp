@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+#ifdef _LIBLE_USE_MPI_
+#include <mpi.h>
+#endif
+
+namespace lible::ints
+{
+    /// Returns the rank of the process in MPI_COMM_WORLD, or 0 without MPI.
+    int processRank();
+
+    /// Returns the number of processes in MPI_COMM_WORLD, or 1 without MPI.
+    int numProcesses();
+
+    /// Sums the array element-wise over all processes, leaving the result on every process. Does
+    /// nothing without MPI. The distributed drivers, e.g., eri2(), eri3(), eri4GradientJK() and
+    /// the RI gradients, allocate their full output on every process, fill in the contributions
+    /// of their own tasks and sum them with this, so their output is replicated and not
+    /// partitioned over the processes.
+    void allReduceSum(double *data, size_t size);
+
+    /// Class for distributing a list of independent tasks over the MPI processes and the OMP
+    /// threads within them. The tasks are first partitioned statically by their estimated costs
+    /// so that every process gets roughly the same amount of work. Every partition is a queue
+    /// with a shared counter, kept in an MPI window, from which the owning process takes its
+    /// tasks and which the other processes steal from once they have run out of their own. The
+    /// ctor and dtor are collective over MPI_COMM_WORLD. Without MPI, there is one partition
+    /// shared by the threads.
+    class TaskDistributor
+    {
+    public:
+        /// Partitions the tasks given by their estimated costs. Every process must give the same
+        /// costs.
+        explicit TaskDistributor(const std::vector<double> &costs);
+
+        ~TaskDistributor();
+
+        TaskDistributor(const TaskDistributor &) = delete;
+        TaskDistributor &operator=(const TaskDistributor &) = delete;
+
+        /// Fetches the index of the next task, first from the own partition and then from the
+        /// partitions of the other processes. Returns false when there are no tasks left.
+        /// Thread-safe.
+        bool next(size_t &itask);
+
+        /// Returns the tasks assigned to the given process by the static partitioning, in
+        /// ascending order.
+        const std::vector<size_t> &partition(int rank) const;
+
+        /// Returns the number of tasks taken from the other processes.
+        size_t numStolen() const;
+
+    private:
+        /// Rank of this process.
+        int rank_{};
+        /// Number of processes.
+        int n_procs_{1};
+        /// Offset of the rank whose partition is currently worked on, 0 for the own one.
+        std::atomic<int> victim_{};
+        /// Number of tasks taken from the other processes.
+        std::atomic<size_t> n_stolen_{};
+        /// Tasks assigned to each process.
+        std::vector<std::vector<size_t>> partitions_;
+
+#ifdef _LIBLE_USE_MPI_
+        /// Window exposing the counter of the own partition.
+        MPI_Win window_{};
+        /// Counter of the own partition, allocated by MPI.
+        long *counter_{};
+#else
+        /// Counter of the partition.
+        std::atomic<size_t> counter_{};
+#endif
+
+        /// Returns the position of the next task in the partition of the given rank and
+        /// increments the counter. Without MPI, this is an atomic fetch-add. With MPI, only the
+        /// fetch-and-op on the window is serialized over the threads.
+        size_t fetchAndIncrement(int rank);
+    };
+}
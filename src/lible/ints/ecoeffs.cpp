@@ -1,13 +1,98 @@
-// #include <lible/ints/ecoeffs.hpp>
+#include <lible/ints/ecoeffs.hpp>
 #include <lible/ints/cart_exps.hpp>
 #include <lible/ints/ints.hpp>
 #include <lible/ints/utils.hpp>
 
+#include <algorithm>
 #include <array>
 #include <tuple>
+#include <utility>
 
 namespace lints = lible::ints;
 
+namespace lible::ints
+{
+    /// Type alias for the compile-time generators of a primitive.
+    using ecoeffs_prim_fun_t = void (*)(double a, const double *norms, double fac, bool transpose,
+                                        double *ecoeffs_out);
+
+    /// Type alias for the compile-time generators of a primitive pair.
+    using ecoeffs_ppair_fun_t = void (*)(double a, double b, const double *xyz_a,
+                                         const double *xyz_b, const double *norms_a,
+                                         const double *norms_b, double fac, bool transpose,
+                                         double *ecoeffs_out);
+
+    /// Type alias for the compile-time derivative generators of a primitive pair.
+    using ecoeffs_d1_ppair_fun_t = void (*)(double a, double b, const double *xyz_a,
+                                            const double *xyz_b, const double *norms_a,
+                                            const double *norms_b, double fac, bool transpose,
+                                            double *ecoeffs_out_100, double *ecoeffs_out_010,
+                                            double *ecoeffs_out_001);
+
+    constexpr int n_ls_ecoeffs = max_l_ecoeffs + 1;
+
+    /// Type alias for the compile-time generators of a primitive pair in the Cartesian basis.
+    using ecoeffs_ppair_cart_fun_t = void (*)(double a, double b, const double *xyz_a,
+                                              const double *xyz_b,
+                                              std::array<vec3d, 3> &ecoeffs);
+
+    /// Copies the compile-time expansion coefficients of a primitive pair to `ecoeffs`, which
+    /// have the same (i, j, t) layout.
+    template <int la, int lb>
+    void ecoeffsPrimitivePairCart(const double a, const double b, const double *xyz_a,
+                                  const double *xyz_b, std::array<vec3d, 3> &ecoeffs)
+    {
+        auto ecoeffs_c = ecoeffsPrimitivePair<la, lb>(a, b, xyz_a, xyz_b);
+        for (int icart = 0; icart < 3; icart++)
+            std::copy(ecoeffs_c[icart].begin(), ecoeffs_c[icart].end(),
+                      ecoeffs[icart].memptr());
+    }
+
+    template <size_t... ls>
+    constexpr std::array<ecoeffs_prim_fun_t, sizeof...(ls)>
+    ecoeffsPrimFuns(std::index_sequence<ls...>)
+    {
+        return {&ecoeffsPrimitiveSHARK<ls>...};
+    }
+
+    template <size_t... lab_idxs>
+    constexpr std::array<ecoeffs_ppair_fun_t, sizeof...(lab_idxs)>
+    ecoeffsPPairFuns(std::index_sequence<lab_idxs...>)
+    {
+        return {&ecoeffsPrimitivePairSHARK<lab_idxs / n_ls_ecoeffs, lab_idxs % n_ls_ecoeffs>...};
+    }
+
+    template <size_t... lab_idxs>
+    constexpr std::array<ecoeffs_d1_ppair_fun_t, sizeof...(lab_idxs)>
+    ecoeffsD1PPairFuns(std::index_sequence<lab_idxs...>)
+    {
+        return {&ecoeffsPrimitivePairD1SHARK<lab_idxs / n_ls_ecoeffs,
+                                             lab_idxs % n_ls_ecoeffs>...};
+    }
+
+    template <size_t... lab_idxs>
+    constexpr std::array<ecoeffs_ppair_cart_fun_t, sizeof...(lab_idxs)>
+    ecoeffsPPairCartFuns(std::index_sequence<lab_idxs...>)
+    {
+        return {&ecoeffsPrimitivePairCart<lab_idxs / n_ls_ecoeffs, lab_idxs % n_ls_ecoeffs>...};
+    }
+
+    /// Compile-time generators for l <= max_l_ecoeffs.
+    constexpr auto ecoeffs_prim_funs = ecoeffsPrimFuns(std::make_index_sequence<n_ls_ecoeffs>());
+
+    /// Compile-time generators for la, lb <= max_l_ecoeffs, stored as (la, lb).
+    constexpr auto ecoeffs_ppair_funs =
+            ecoeffsPPairFuns(std::make_index_sequence<n_ls_ecoeffs * n_ls_ecoeffs>());
+
+    /// Compile-time Cartesian generators for la, lb <= max_l_ecoeffs, stored as (la, lb).
+    constexpr auto ecoeffs_ppair_cart_funs =
+            ecoeffsPPairCartFuns(std::make_index_sequence<n_ls_ecoeffs * n_ls_ecoeffs>());
+
+    /// Compile-time derivative generators for la, lb <= max_l_ecoeffs, stored as (la, lb).
+    constexpr auto ecoeffs_d1_ppair_funs =
+            ecoeffsD1PPairFuns(std::make_index_sequence<n_ls_ecoeffs * n_ls_ecoeffs>());
+}
+
 lible::vec2d lints::ecoeffsRecurrence1(const double one_o_2a, const int l)
 {
     vec2d ecoeffs(Fill(0), l + 1, l + 1);
@@ -184,6 +269,23 @@ std::array<lible::vec3d, 3> lints::ecoeffsPrimitivePair(const double a, const do
     return {ecoeffs_x, ecoeffs_y, ecoeffs_z};
 }
 
+void lints::ecoeffsPrimitivePair(const double a, const double b, const int la, const int lb,
+                                 const double *xyz_a, const double *xyz_b,
+                                 std::array<vec3d, 3> &ecoeffs)
+{
+    if (la > max_l_ecoeffs || lb > max_l_ecoeffs)
+    {
+        ecoeffs = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        return;
+    }
+
+    for (vec3d &ecoeffs_xyz : ecoeffs)
+        if (ecoeffs_xyz.dim<0>() != size_t(la + 1) || ecoeffs_xyz.dim<1>() != size_t(lb + 1))
+            ecoeffs_xyz = vec3d(la + 1, lb + 1, la + lb + 1);
+
+    ecoeffs_ppair_cart_funs[la * n_ls_ecoeffs + lb](a, b, xyz_a, xyz_b, ecoeffs);
+}
+
 std::array<lible::vec3d, 3> lints::ecoeffsPrimitivePair_n1(const double a, const double b,
                                                            const int la, const int lb,
                                                            const double *xyz_a, const double *xyz_b,
@@ -202,7 +304,7 @@ std::array<lible::vec3d, 3> lints::ecoeffsPrimitivePair_n2(const double a, const
                                                            const std::array<vec3d, 3> &ecoeffs0,
                                                            const std::array<vec3d, 3> &ecoeffs1)
 {
-    vec3d ecoeffs2_x = ecoeffsRecurrence2_n2(a, b, la, lb, xyz_a[0], xyz_b[0], ecoeffs0[0], ecoeffs1[1]);
+    vec3d ecoeffs2_x = ecoeffsRecurrence2_n2(a, b, la, lb, xyz_a[0], xyz_b[0], ecoeffs0[0], ecoeffs1[0]);
     vec3d ecoeffs2_y = ecoeffsRecurrence2_n2(a, b, la, lb, xyz_a[1], xyz_b[1], ecoeffs0[1], ecoeffs1[1]);
     vec3d ecoeffs2_z = ecoeffsRecurrence2_n2(a, b, la, lb, xyz_a[2], xyz_b[2], ecoeffs0[2], ecoeffs1[2]);
 
@@ -229,14 +331,15 @@ std::vector<std::vector<double>> lints::ecoeffsShell(const int l, const std::vec
     const auto &cart_exps_a = cart_exps[l];
 
     std::vector<std::vector<double>> ecoeffs_out(cdepth * cdepth, std::vector<double>(dim * dim, 0));
+    std::array<vec3d, 3> ecoeffs;
     for (size_t ia = 0, iab = 0; ia < cdepth; ia++)
         for (size_t ib = 0; ib < cdepth; ib++, iab++)
         {
             double a = exps[ia];
             double b = exps[ib];
 
-            auto [ecoeffs_x, ecoeffs_y, ecoeffs_z] =
-                    ecoeffsPrimitivePair(a, b, l, l, &xyz_a[0], &xyz_a[0]);
+            ecoeffsPrimitivePair(a, b, l, l, &xyz_a[0], &xyz_a[0], ecoeffs);
+            const auto &[ecoeffs_x, ecoeffs_y, ecoeffs_z] = ecoeffs;
 
             for (const auto &[i, j, k, mu] : cart_exps_a)
                 for (const auto &[i_, j_, k_, nu] : cart_exps_a)
@@ -263,7 +366,9 @@ std::vector<double> lints::ecoeffsSHARK(const ShellData &sh_data, const bool tra
 
     const auto &ijk = cartExps(l);
     vec3i tuv_poss = getHermiteGaussianPositions(l);
-    std::vector<std::tuple<int, int, double>> sph_trafo = sphericalTrafo(l);
+    SphTrafoCSRView sph_trafo = sphTrafoCSR(l);
+
+    ecoeffs_prim_fun_t ecoeffs_fun = l <= max_l_ecoeffs ? ecoeffs_prim_funs[l] : nullptr;
 
     std::vector<double> ecoeffs(n_ecoeffs, 0);
 #pragma omp parallel for
@@ -282,29 +387,38 @@ std::vector<double> lints::ecoeffsSHARK(const ShellData &sh_data, const bool tra
             double a = sh_data.exps_[cofs + ia];
             double d = sh_data.coeffs_[cofs + ia];
 
-            auto [Ex, Ey, Ez] = ecoeffsPrimitive(a, l);
-
             size_t ofs = offset_ecoeffs + ia * n_sph * n_hermite;
-            for (const auto &[mu, mu_, val] : sph_trafo)
+            if (ecoeffs_fun != nullptr)
             {
-                auto [i, j, k] = ijk[mu_];
-                for (int t = 0; t <= i; t++)
-                    for (int u = 0; u <= j; u++)
-                        for (int v = 0; v <= k; v++)
-                        {
-                            double ecoeff = norms[mu] * d * Ex(i, t) * Ey(j, u) * Ez(k, v) * val;
+                ecoeffs_fun(a, norms, d, transpose, &ecoeffs[ofs]);
+                continue;
+            }
 
-                            int tuv = tuv_poss(t, u, v);
+            auto [Ex, Ey, Ez] = ecoeffsPrimitive(a, l);
 
-                            size_t idx;
-                            if (transpose)
-                                idx = ofs + tuv * n_sph + mu;
-                            else
-                                idx = ofs + mu * n_hermite + tuv;
+            for (int mu = 0; mu < n_sph; mu++)
+                for (int inz = sph_trafo.row_ptrs_[mu]; inz < sph_trafo.row_ptrs_[mu + 1]; inz++)
+                {
+                    double val = sph_trafo.vals_[inz];
+                    auto [i, j, k] = ijk[sph_trafo.cart_idxs_[inz]];
+                    for (int t = 0; t <= i; t++)
+                        for (int u = 0; u <= j; u++)
+                            for (int v = 0; v <= k; v++)
+                            {
+                                double ecoeff = norms[mu] * d * Ex(i, t) * Ey(j, u) * Ez(k, v) *
+                                                val;
 
-                            ecoeffs[idx] += ecoeff;
-                        }
-            }
+                                int tuv = tuv_poss(t, u, v);
+
+                                size_t idx;
+                                if (transpose)
+                                    idx = ofs + tuv * n_sph + mu;
+                                else
+                                    idx = ofs + mu * n_hermite + tuv;
+
+                                ecoeffs[idx] += ecoeff;
+                            }
+                }
         }
     }
 
@@ -326,12 +440,16 @@ std::vector<double> lints::ecoeffsSHARK(const ShellPairData &sp_data, const bool
     int n_hermite = numHermites(lab);
     int n_ecoeffs = n_sph_ab * n_hermite;
 
-    std::vector<std::tuple<int, int, double>> sph_trafo_a = sphericalTrafo(la);
-    std::vector<std::tuple<int, int, double>> sph_trafo_b = sphericalTrafo(lb);
+    SphTrafoCSRView sph_trafo_a = sphTrafoCSR(la);
+    SphTrafoCSRView sph_trafo_b = sphTrafoCSR(lb);
     const auto &cart_exps_a = cartExps(la);
     const auto &cart_exps_b = cartExps(lb);
     vec3i tuv_poss = getHermiteGaussianPositions(lab);
 
+    ecoeffs_ppair_fun_t ecoeffs_fun = nullptr;
+    if (la <= max_l_ecoeffs && lb <= max_l_ecoeffs)
+        ecoeffs_fun = ecoeffs_ppair_funs[la * n_ls_ecoeffs + lb];
+
     std::vector<double> ecoeffs(n_ecoeffs * sp_data.n_ppairs_, 0);
 #pragma omp parallel for
     for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -354,48 +472,58 @@ std::vector<double> lints::ecoeffsSHARK(const ShellPairData &sp_data, const bool
         {
             double a = exps[iab * 2];
             double b = exps[iab * 2 + 1];
+            double da = coeffs[iab * 2];
+            double db = coeffs[iab * 2 + 1];
+            double dadb = da * db;
+
+            size_t ofs = offset_ecoeffs + iab * n_ecoeffs;
+            if (ecoeffs_fun != nullptr)
+            {
+                ecoeffs_fun(a, b, xyz_a, xyz_b, norms_a, norms_b, dadb, transpose, &ecoeffs[ofs]);
+                continue;
+            }
 
             auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
 
             // first trafo
             vec3d ecoeffs_ppair_sc(Fill(0), n_sph_a, n_cart_b, n_hermite);
-            for (auto &[mu, mu_, val] : sph_trafo_a)
-                for (size_t nu_ = 0; nu_ < cart_exps_b.size(); nu_++)
-                {
-                    auto [i, j, k] = cart_exps_a[mu_];
-                    auto [i_, j_, k_] = cart_exps_b[nu_];
-                    for (int t = 0; t <= i + i_; t++)
-                        for (int u = 0; u <= j + j_; u++)
-                            for (int v = 0; v <= k + k_; v++)
-                            {
-                                int tuv = tuv_poss(t, u, v);
-
-                                ecoeffs_ppair_sc(mu, nu_, tuv) +=
-                                        val * Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
-                            }
-                }
+            for (int mu = 0; mu < n_sph_a; mu++)
+                for (int ka = sph_trafo_a.row_ptrs_[mu]; ka < sph_trafo_a.row_ptrs_[mu + 1]; ka++)
+                    for (size_t nu_ = 0; nu_ < cart_exps_b.size(); nu_++)
+                    {
+                        double val = sph_trafo_a.vals_[ka];
+                        auto [i, j, k] = cart_exps_a[sph_trafo_a.cart_idxs_[ka]];
+                        auto [i_, j_, k_] = cart_exps_b[nu_];
+                        for (int t = 0; t <= i + i_; t++)
+                            for (int u = 0; u <= j + j_; u++)
+                                for (int v = 0; v <= k + k_; v++)
+                                {
+                                    int tuv = tuv_poss(t, u, v);
+
+                                    ecoeffs_ppair_sc(mu, nu_, tuv) +=
+                                            val * Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
+                                }
+                    }
 
             // second trafo
-            double da = coeffs[iab * 2];
-            double db = coeffs[iab * 2 + 1];
-            double dadb = da * db;
-
-            size_t ofs = offset_ecoeffs + iab * n_ecoeffs;
-            for (auto &[nu, nu_, val] : sph_trafo_b)
-                for (int mu = 0; mu < n_sph_a; mu++)
-                    for (int tuv = 0; tuv < n_hermite; tuv++)
-                    {
-                        int munu = mu * n_sph_b + nu;
+            for (int nu = 0; nu < n_sph_b; nu++)
+                for (int kb = sph_trafo_b.row_ptrs_[nu]; kb < sph_trafo_b.row_ptrs_[nu + 1]; kb++)
+                    for (int mu = 0; mu < n_sph_a; mu++)
+                        for (int tuv = 0; tuv < n_hermite; tuv++)
+                        {
+                            int nu_ = sph_trafo_b.cart_idxs_[kb];
+                            double val = sph_trafo_b.vals_[kb];
+                            int munu = mu * n_sph_b + nu;
 
-                        size_t idx;
-                        if (transpose)
-                            idx = ofs + tuv * n_sph_ab + munu;
-                        else
-                            idx = ofs + munu * n_hermite + tuv;
+                            size_t idx;
+                            if (transpose)
+                                idx = ofs + tuv * n_sph_ab + munu;
+                            else
+                                idx = ofs + munu * n_hermite + tuv;
 
-                        ecoeffs[idx] += norms_a[mu] * norms_b[nu] * dadb * val *
-                                ecoeffs_ppair_sc(mu, nu_, tuv);
-                    }
+                            ecoeffs[idx] += norms_a[mu] * norms_b[nu] * dadb * val *
+                                    ecoeffs_ppair_sc(mu, nu_, tuv);
+                        }
         }
     }
 
@@ -419,11 +547,15 @@ std::vector<double> lints::ecoeffsD1SHARK(const ShellPairData &sp_data, const bo
     size_t n_ecoeffs_prims = 3 * n_ecoeffs * sp_data.n_ppairs_;
 
     vec3i tuv_poss = getHermiteGaussianPositions(lab);
-    std::vector<std::tuple<int, int, double>> sph_trafo_a = sphericalTrafo(la);
-    std::vector<std::tuple<int, int, double>> sph_trafo_b = sphericalTrafo(lb);
+    SphTrafoCSRView sph_trafo_a = sphTrafoCSR(la);
+    SphTrafoCSRView sph_trafo_b = sphTrafoCSR(lb);
     const auto &cart_exps_a = cartExps(la);
     const auto &cart_exps_b = cartExps(lb);
 
+    ecoeffs_d1_ppair_fun_t ecoeffs_fun = nullptr;
+    if (la <= max_l_ecoeffs && lb <= max_l_ecoeffs)
+        ecoeffs_fun = ecoeffs_d1_ppair_funs[la * n_ls_ecoeffs + lb];
+
     std::vector<double> ecoeffs_100_010_001(n_ecoeffs_prims, 0);
 #pragma omp parallel for
     for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -446,6 +578,20 @@ std::vector<double> lints::ecoeffsD1SHARK(const ShellPairData &sp_data, const bo
         {
             double a = exps[iab * 2];
             double b = exps[iab * 2 + 1];
+            double da = coeffs[iab * 2];
+            double db = coeffs[iab * 2 + 1];
+            double dadb = da * db;
+
+            size_t ofs_100 = offset_ecoeffs + (3 * iab + 0) * n_ecoeffs;
+            size_t ofs_010 = offset_ecoeffs + (3 * iab + 1) * n_ecoeffs;
+            size_t ofs_001 = offset_ecoeffs + (3 * iab + 2) * n_ecoeffs;
+            if (ecoeffs_fun != nullptr)
+            {
+                ecoeffs_fun(a, b, xyz_a, xyz_b, norms_a, norms_b, dadb, transpose,
+                            &ecoeffs_100_010_001[ofs_100], &ecoeffs_100_010_001[ofs_010],
+                            &ecoeffs_100_010_001[ofs_001]);
+                continue;
+            }
 
             auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
 
@@ -456,60 +602,61 @@ std::vector<double> lints::ecoeffsD1SHARK(const ShellPairData &sp_data, const bo
             vec3d ecoeffs100_ppair_sc(Fill(0), n_sph_a, n_cart_b, n_hermite_ab);
             vec3d ecoeffs010_ppair_sc(Fill(0), n_sph_a, n_cart_b, n_hermite_ab);
             vec3d ecoeffs001_ppair_sc(Fill(0), n_sph_a, n_cart_b, n_hermite_ab);
-            for (auto &[mu, mu_, val] : sph_trafo_a)
-                for (size_t nu_ = 0; nu_ < cart_exps_b.size(); nu_++)
-                {
-                    auto [i, j, k] = cart_exps_a[mu_];
-                    auto [i_, j_, k_] = cart_exps_b[nu_];
-                    for (int t = 0; t <= i + i_; t++)
-                        for (int u = 0; u <= j + j_; u++)
-                            for (int v = 0; v <= k + k_; v++)
-                            {
-                                int tuv = tuv_poss(t, u, v);
-
-                                ecoeffs100_ppair_sc(mu, nu_, tuv) +=
-                                        val * E1x(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
-                                ecoeffs010_ppair_sc(mu, nu_, tuv) +=
-                                        val * Ex(i, i_, t) * E1y(j, j_, u) * Ez(k, k_, v);
-                                ecoeffs001_ppair_sc(mu, nu_, tuv) +=
-                                        val * Ex(i, i_, t) * Ey(j, j_, u) * E1z(k, k_, v);
-                            }
-                }
-
-            // second trafo
-            double da = coeffs[iab * 2];
-            double db = coeffs[iab * 2 + 1];
-            double dadb = da * db;
-
-            size_t ofs_100 = offset_ecoeffs + (3 * iab + 0) * n_ecoeffs;
-            size_t ofs_010 = offset_ecoeffs + (3 * iab + 1) * n_ecoeffs;
-            size_t ofs_001 = offset_ecoeffs + (3 * iab + 2) * n_ecoeffs;
-            for (auto &[nu, nu_, val] : sph_trafo_b)
-                for (int mu = 0; mu < n_sph_a; mu++)
-                    for (int tuv = 0; tuv < n_hermite_ab; tuv++)
+            for (int mu = 0; mu < n_sph_a; mu++)
+                for (int ka = sph_trafo_a.row_ptrs_[mu]; ka < sph_trafo_a.row_ptrs_[mu + 1]; ka++)
+                    for (size_t nu_ = 0; nu_ < cart_exps_b.size(); nu_++)
                     {
-                        int munu = mu * n_sph_b + nu;
+                        double val = sph_trafo_a.vals_[ka];
+                        auto [i, j, k] = cart_exps_a[sph_trafo_a.cart_idxs_[ka]];
+                        auto [i_, j_, k_] = cart_exps_b[nu_];
+                        for (int t = 0; t <= i + i_; t++)
+                            for (int u = 0; u <= j + j_; u++)
+                                for (int v = 0; v <= k + k_; v++)
+                                {
+                                    int tuv = tuv_poss(t, u, v);
+
+                                    ecoeffs100_ppair_sc(mu, nu_, tuv) +=
+                                            val * E1x(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
+                                    ecoeffs010_ppair_sc(mu, nu_, tuv) +=
+                                            val * Ex(i, i_, t) * E1y(j, j_, u) * Ez(k, k_, v);
+                                    ecoeffs001_ppair_sc(mu, nu_, tuv) +=
+                                            val * Ex(i, i_, t) * Ey(j, j_, u) * E1z(k, k_, v);
+                                }
+                    }
 
-                        size_t idx_100, idx_010, idx_001;
-                        if (transpose)
-                        {
-                            idx_100 = ofs_100 + tuv * n_sph_ab + munu;
-                            idx_010 = ofs_010 + tuv * n_sph_ab + munu;
-                            idx_001 = ofs_001 + tuv * n_sph_ab + munu;
-                        }
-                        else
+            // second trafo
+            for (int nu = 0; nu < n_sph_b; nu++)
+                for (int kb = sph_trafo_b.row_ptrs_[nu]; kb < sph_trafo_b.row_ptrs_[nu + 1]; kb++)
+                    for (int mu = 0; mu < n_sph_a; mu++)
+                        for (int tuv = 0; tuv < n_hermite_ab; tuv++)
                         {
-                            idx_100 = ofs_100 + munu * n_hermite_ab + tuv;
-                            idx_010 = ofs_010 + munu * n_hermite_ab + tuv;
-                            idx_001 = ofs_001 + munu * n_hermite_ab + tuv;
-                        }
+                            int nu_ = sph_trafo_b.cart_idxs_[kb];
+                            double val = sph_trafo_b.vals_[kb];
+                            int munu = mu * n_sph_b + nu;
+
+                            size_t idx_100, idx_010, idx_001;
+                            if (transpose)
+                            {
+                                idx_100 = ofs_100 + tuv * n_sph_ab + munu;
+                                idx_010 = ofs_010 + tuv * n_sph_ab + munu;
+                                idx_001 = ofs_001 + tuv * n_sph_ab + munu;
+                            }
+                            else
+                            {
+                                idx_100 = ofs_100 + munu * n_hermite_ab + tuv;
+                                idx_010 = ofs_010 + munu * n_hermite_ab + tuv;
+                                idx_001 = ofs_001 + munu * n_hermite_ab + tuv;
+                            }
 
-                        double NaNb = norms_a[mu] * norms_b[nu];
+                            double NaNb = norms_a[mu] * norms_b[nu];
 
-                        ecoeffs_100_010_001[idx_100] += NaNb * dadb * val * ecoeffs100_ppair_sc(mu, nu_, tuv);
-                        ecoeffs_100_010_001[idx_010] += NaNb * dadb * val * ecoeffs010_ppair_sc(mu, nu_, tuv);
-                        ecoeffs_100_010_001[idx_001] += NaNb * dadb * val * ecoeffs001_ppair_sc(mu, nu_, tuv);
-                    }
+                            ecoeffs_100_010_001[idx_100] +=
+                                    NaNb * dadb * val * ecoeffs100_ppair_sc(mu, nu_, tuv);
+                            ecoeffs_100_010_001[idx_010] +=
+                                    NaNb * dadb * val * ecoeffs010_ppair_sc(mu, nu_, tuv);
+                            ecoeffs_100_010_001[idx_001] +=
+                                    NaNb * dadb * val * ecoeffs001_ppair_sc(mu, nu_, tuv);
+                        }
         }
     }
 
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <lible/ints/spherical_trafo.hpp>
+#include <lible/ints/utils.hpp>
+
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+namespace lible::ints
+{
+    // Hermite expansion coefficients for specific L. The coefficients are kept in fixed-size
+    // arrays and the loop bounds are known at compile time, so that the recurrences are unrolled
+    // and nothing is allocated per primitive pair.
+
+    /// Highest angular momentum for which the ecoeffsSHARK-functions use the compile-time
+    /// generators. Beyond it the arbitrary L versions are used.
+    constexpr int max_l_ecoeffs = 6;
+
+    /// Type alias for the Cartesian to spherical transformation, as given by sphericalTrafo().
+    using sph_trafo_t = std::vector<std::tuple<int, int, double>>;
+
+    /// Type alias for the expansion coefficients E^{ij}_t of one Cartesian direction, stored as
+    /// (i, j, t) in row-major order.
+    template <int la, int lb>
+    using ecoeffs_1d_t = std::array<double, (la + 1) * (lb + 1) * (la + lb + 1)>;
+
+    /// Returns the position of E^{ij}_t in ecoeffs_1d_t.
+    template <int la, int lb>
+    constexpr int idxECoeff(const int i, const int j, const int t)
+    {
+        return (i * (lb + 1) + j) * (la + lb + 1) + t;
+    }
+
+    /// Returns the Cartesian exponents {(i, j, k)} in the same order as `cart_exps`. Compile time
+    /// only.
+    template <int l>
+    consteval std::array<std::array<int, 3>, numCartesians(l)> cartExpsC()
+    {
+        std::array<std::array<int, 3>, numCartesians(l)> cart_exps{};
+        for (int i = l, mu = 0; i >= 0; i--)
+            for (int j = l - i; j >= 0; j--, mu++)
+                cart_exps[mu] = {i, j, l - i - j};
+
+        return cart_exps;
+    }
+
+    /// Returns the positions of the Hermite Gaussians, (t, u, v) -> tuv, as a flattened
+    /// (l + 1)^3 array. Same as getHermiteGaussianPositions(). Compile time only.
+    template <int l>
+    consteval std::array<int, (l + 1) * (l + 1) * (l + 1)> hermitePositionsC()
+    {
+        std::array<int, (l + 1) * (l + 1) * (l + 1)> tuv_poss{};
+        tuv_poss.fill(-1);
+        for (int n = 0, tuv = 0; n <= l; n++)
+            for (int t = n; t >= 0; t--)
+                for (int u = n - t; u >= 0; u--, tuv++)
+                {
+                    int v = n - t - u;
+                    tuv_poss[(t * (l + 1) + u) * (l + 1) + v] = tuv;
+                }
+
+        return tuv_poss;
+    }
+
+    /// Calculates the expansion coefficients E^{i}_t of a single Gaussian, stored as (i, t). Same
+    /// as ecoeffsRecurrence1().
+    template <int l>
+    void ecoeffsRecurrence1(const double one_o_2a, std::array<double, (l + 1) * (l + 1)> &ecoeffs)
+    {
+        constexpr int dim = l + 1;
+
+        ecoeffs.fill(0);
+        ecoeffs[0] = 1;
+        for (int i = 1; i <= l; i++)
+        {
+            if (i % 2 == 0)
+                ecoeffs[i * dim] = ecoeffs[(i - 1) * dim + 1];
+
+            for (int t = 1; t < i; t++)
+                if ((t + i) % 2 == 0)
+                    ecoeffs[i * dim + t] = one_o_2a * ecoeffs[(i - 1) * dim + t - 1] +
+                                           (t + 1) * ecoeffs[(i - 1) * dim + t + 1];
+
+            ecoeffs[i * dim + i] = one_o_2a * ecoeffs[(i - 1) * dim + i - 1];
+        }
+    }
+
+    /// Calculates the expansion coefficients E^{ij}_t of a Gaussian pair in one direction. Same
+    /// as ecoeffsRecurrence2().
+    template <int la, int lb>
+    void ecoeffsRecurrence2(const double one_o_2p, const double PA, const double PB,
+                            const double Kab, ecoeffs_1d_t<la, lb> &E)
+    {
+        constexpr auto idx = idxECoeff<la, lb>;
+
+        E.fill(0);
+        E[idx(0, 0, 0)] = Kab;
+        for (int i = 1; i <= la; i++)
+        {
+            E[idx(i, 0, 0)] = PA * E[idx(i - 1, 0, 0)] + E[idx(i - 1, 0, 1)];
+
+            for (int t = 1; t < i; t++)
+                E[idx(i, 0, t)] = one_o_2p * E[idx(i - 1, 0, t - 1)] + PA * E[idx(i - 1, 0, t)] +
+                                  (t + 1) * E[idx(i - 1, 0, t + 1)];
+
+            E[idx(i, 0, i)] = one_o_2p * E[idx(i - 1, 0, i - 1)] + PA * E[idx(i - 1, 0, i)];
+        }
+
+        for (int j = 1; j <= lb; j++)
+            for (int i = 0; i <= la; i++)
+            {
+                E[idx(i, j, 0)] = PB * E[idx(i, j - 1, 0)] + E[idx(i, j - 1, 1)];
+
+                for (int t = 1; t < i + j; t++)
+                    E[idx(i, j, t)] = one_o_2p * E[idx(i, j - 1, t - 1)] +
+                                      PB * E[idx(i, j - 1, t)] + (t + 1) * E[idx(i, j - 1, t + 1)];
+
+                E[idx(i, j, i + j)] = one_o_2p * E[idx(i, j - 1, i + j - 1)] +
+                                      PB * E[idx(i, j - 1, i + j)];
+            }
+    }
+
+    /// Calculates the derivatives of the expansion coefficients E^{ij}_t of a Gaussian pair with
+    /// respect to the coordinate of A in one direction. Same as ecoeffsRecurrence2_n1().
+    template <int la, int lb>
+    void ecoeffsRecurrence2_n1(const double a, const double b, const double A, const double B,
+                               const ecoeffs_1d_t<la, lb> &E0, ecoeffs_1d_t<la, lb> &E1)
+    {
+        constexpr auto idx = idxECoeff<la, lb>;
+
+        const double p = a + b;
+        const double one_o_2p = 1.0 / (2 * p);
+        const double a_o_p = a / p;
+        const double b_o_p = b / p;
+        const double R = A - B;
+
+        E1.fill(0);
+        E1[idx(0, 0, 0)] = -2 * (a * b) * R * E0[idx(0, 0, 0)] / p;
+        for (int i = 1; i <= la; i++)
+        {
+            E1[idx(i, 0, 0)] = -b_o_p * (R * E1[idx(i - 1, 0, 0)] + E0[idx(i - 1, 0, 0)]) +
+                               E1[idx(i - 1, 0, 1)];
+
+            for (int t = 1; t < i; t++)
+                E1[idx(i, 0, t)] = one_o_2p * E1[idx(i - 1, 0, t - 1)] -
+                                   b_o_p * (R * E1[idx(i - 1, 0, t)] + E0[idx(i - 1, 0, t)]) +
+                                   (t + 1) * E1[idx(i - 1, 0, t + 1)];
+
+            E1[idx(i, 0, i)] = one_o_2p * E1[idx(i - 1, 0, i - 1)] -
+                               b_o_p * (R * E1[idx(i - 1, 0, i)] + E0[idx(i - 1, 0, i)]);
+        }
+
+        for (int j = 1; j <= lb; j++)
+            for (int i = 0; i <= la; i++)
+            {
+                E1[idx(i, j, 0)] = a_o_p * (R * E1[idx(i, j - 1, 0)] + E0[idx(i, j - 1, 0)]) +
+                                   E1[idx(i, j - 1, 1)];
+
+                for (int t = 1; t < i + j; t++)
+                    E1[idx(i, j, t)] = one_o_2p * E1[idx(i, j - 1, t - 1)] +
+                                       a_o_p * (R * E1[idx(i, j - 1, t)] + E0[idx(i, j - 1, t)]) +
+                                       (t + 1) * E1[idx(i, j - 1, t + 1)];
+
+                E1[idx(i, j, i + j)] = one_o_2p * E1[idx(i, j - 1, i + j - 1)] +
+                                       a_o_p * (R * E1[idx(i, j - 1, i + j)] +
+                                                E0[idx(i, j - 1, i + j)]);
+            }
+    }
+
+    /// Calculates the expansion coefficients of a primitive pair in all three directions. Same as
+    /// ecoeffsPrimitivePair().
+    template <int la, int lb>
+    std::array<ecoeffs_1d_t<la, lb>, 3> ecoeffsPrimitivePair(const double a, const double b,
+                                                             const double *xyz_a,
+                                                             const double *xyz_b)
+    {
+        const double p = a + b;
+        const double mu = a * b / p;
+        const double one_o_2p = 1.0 / (2 * p);
+
+        std::array<ecoeffs_1d_t<la, lb>, 3> ecoeffs;
+        for (int i = 0; i < 3; i++)
+        {
+            double xyz_p = (a * xyz_a[i] + b * xyz_b[i]) / p;
+            double Kab = std::exp(-mu * std::pow(xyz_a[i] - xyz_b[i], 2));
+
+            ecoeffsRecurrence2<la, lb>(one_o_2p, xyz_p - xyz_a[i], xyz_p - xyz_b[i], Kab,
+                                       ecoeffs[i]);
+        }
+
+        return ecoeffs;
+    }
+
+    /// Transforms the expansion coefficients E^{ij}_t E^{kl}_u E^{mn}_v of a primitive pair to the
+    /// spherical basis and adds them, scaled by `fac` and the norms, to `ecoeffs_out` in the SHARK
+    /// order {mu nu, tuv}, or {tuv, mu nu} if transposed. The transformations are read from the
+    /// compile-time tables. The floating point operations are done in the same order as in
+    /// ecoeffsSHARK(), so that the results are identical.
+    template <int la, int lb>
+    void ecoeffsSphericalSHARK(const ecoeffs_1d_t<la, lb> &Ex, const ecoeffs_1d_t<la, lb> &Ey,
+                               const ecoeffs_1d_t<la, lb> &Ez, const double *norms_a,
+                               const double *norms_b, const double fac, const bool transpose,
+                               double *ecoeffs_out)
+    {
+        constexpr int lab = la + lb;
+        constexpr int n_cart_b = numCartesians(lb);
+        constexpr int n_sph_a = numSphericals(la);
+        constexpr int n_sph_b = numSphericals(lb);
+        constexpr int n_sph_ab = n_sph_a * n_sph_b;
+        constexpr int n_hermite = numHermites(lab);
+        constexpr auto cart_exps_a = cartExpsC<la>();
+        constexpr auto cart_exps_b = cartExpsC<lb>();
+        constexpr auto tuv_poss = hermitePositionsC<lab>();
+        constexpr auto idx = idxECoeff<la, lb>;
+        constexpr auto sph_trafo_a = sphTrafoC<la>();
+        constexpr auto sph_trafo_b = sphTrafoC<lb>();
+
+        // First trafo
+        std::array<double, n_sph_a * n_cart_b * n_hermite> ecoeffs_sc{};
+        for (int mu = 0; mu < n_sph_a; mu++)
+            for (int imu = sph_trafo_a.row_ptrs[mu]; imu < sph_trafo_a.row_ptrs[mu + 1]; imu++)
+            {
+                double val = sph_trafo_a.vals[imu];
+                auto [i, j, k] = cart_exps_a[sph_trafo_a.cart_idxs[imu]];
+                for (int nu_ = 0; nu_ < n_cart_b; nu_++)
+                {
+                    auto [i_, j_, k_] = cart_exps_b[nu_];
+
+                    double *ecoeffs_sc_munu = &ecoeffs_sc[(mu * n_cart_b + nu_) * n_hermite];
+                    for (int t = 0; t <= i + i_; t++)
+                        for (int u = 0; u <= j + j_; u++)
+                        {
+                            double val_tu = val * Ex[idx(i, i_, t)] * Ey[idx(j, j_, u)];
+                            for (int v = 0; v <= k + k_; v++)
+                            {
+                                int tuv = tuv_poss[(t * (lab + 1) + u) * (lab + 1) + v];
+                                ecoeffs_sc_munu[tuv] += val_tu * Ez[idx(k, k_, v)];
+                            }
+                        }
+                }
+            }
+
+        // Second trafo
+        for (int nu = 0; nu < n_sph_b; nu++)
+            for (int inu = sph_trafo_b.row_ptrs[nu]; inu < sph_trafo_b.row_ptrs[nu + 1]; inu++)
+            {
+                int nu_ = sph_trafo_b.cart_idxs[inu];
+                double val = sph_trafo_b.vals[inu];
+                for (int mu = 0; mu < n_sph_a; mu++)
+                {
+                    int munu = mu * n_sph_b + nu;
+                    double fac_munu = norms_a[mu] * norms_b[nu] * fac * val;
+
+                    const double *ecoeffs_sc_munu =
+                            &ecoeffs_sc[(mu * n_cart_b + nu_) * n_hermite];
+                    if (transpose)
+                        for (int tuv = 0; tuv < n_hermite; tuv++)
+                            ecoeffs_out[tuv * n_sph_ab + munu] += fac_munu * ecoeffs_sc_munu[tuv];
+                    else
+                        for (int tuv = 0; tuv < n_hermite; tuv++)
+                            ecoeffs_out[munu * n_hermite + tuv] += fac_munu * ecoeffs_sc_munu[tuv];
+                }
+            }
+    }
+
+    /// Adds the SHARK-ordered spherical expansion coefficients of a primitive pair, scaled by
+    /// `fac` and the norms, to `ecoeffs_out`.
+    template <int la, int lb>
+    void ecoeffsPrimitivePairSHARK(const double a, const double b, const double *xyz_a,
+                                   const double *xyz_b, const double *norms_a,
+                                   const double *norms_b, const double fac, const bool transpose,
+                                   double *ecoeffs_out)
+    {
+        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair<la, lb>(a, b, xyz_a, xyz_b);
+
+        ecoeffsSphericalSHARK<la, lb>(Ex, Ey, Ez, norms_a, norms_b, fac, transpose, ecoeffs_out);
+    }
+
+    /// Adds the SHARK-ordered spherical expansion coefficients of the derivatives with respect
+    /// to the x-, y- and z-coordinates of A of a primitive pair, scaled by `fac` and the norms,
+    /// to `ecoeffs_out_100`, `ecoeffs_out_010` and `ecoeffs_out_001`.
+    template <int la, int lb>
+    void ecoeffsPrimitivePairD1SHARK(const double a, const double b, const double *xyz_a,
+                                     const double *xyz_b, const double *norms_a,
+                                     const double *norms_b, const double fac,
+                                     const bool transpose, double *ecoeffs_out_100,
+                                     double *ecoeffs_out_010, double *ecoeffs_out_001)
+    {
+        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair<la, lb>(a, b, xyz_a, xyz_b);
+
+        ecoeffs_1d_t<la, lb> E1x, E1y, E1z;
+        ecoeffsRecurrence2_n1<la, lb>(a, b, xyz_a[0], xyz_b[0], Ex, E1x);
+        ecoeffsRecurrence2_n1<la, lb>(a, b, xyz_a[1], xyz_b[1], Ey, E1y);
+        ecoeffsRecurrence2_n1<la, lb>(a, b, xyz_a[2], xyz_b[2], Ez, E1z);
+
+        ecoeffsSphericalSHARK<la, lb>(E1x, Ey, Ez, norms_a, norms_b, fac, transpose,
+                                      ecoeffs_out_100);
+        ecoeffsSphericalSHARK<la, lb>(Ex, E1y, Ez, norms_a, norms_b, fac, transpose,
+                                      ecoeffs_out_010);
+        ecoeffsSphericalSHARK<la, lb>(Ex, Ey, E1z, norms_a, norms_b, fac, transpose,
+                                      ecoeffs_out_001);
+    }
+
+    /// Adds the SHARK-ordered spherical expansion coefficients of a primitive, scaled by `fac`
+    /// and the norms, to `ecoeffs_out` in the order {mu, tuv}, or {tuv, mu} if transposed.
+    template <int l>
+    void ecoeffsPrimitiveSHARK(const double a, const double *norms, const double fac,
+                               const bool transpose, double *ecoeffs_out)
+    {
+        constexpr int n_sph = numSphericals(l);
+        constexpr int n_hermite = numHermites(l);
+        constexpr auto cart_exps = cartExpsC<l>();
+        constexpr auto tuv_poss = hermitePositionsC<l>();
+        constexpr auto sph_trafo = sphTrafoC<l>();
+
+        // The coefficients are the same in all directions.
+        std::array<double, (l + 1) * (l + 1)> E;
+        ecoeffsRecurrence1<l>(1.0 / (2 * a), E);
+
+        for (int mu = 0; mu < n_sph; mu++)
+            for (int imu = sph_trafo.row_ptrs[mu]; imu < sph_trafo.row_ptrs[mu + 1]; imu++)
+            {
+                double val = sph_trafo.vals[imu];
+                auto [i, j, k] = cart_exps[sph_trafo.cart_idxs[imu]];
+                for (int t = 0; t <= i; t++)
+                    for (int u = 0; u <= j; u++)
+                    {
+                        double fac_tu = norms[mu] * fac * E[i * (l + 1) + t] * E[j * (l + 1) + u];
+                        for (int v = 0; v <= k; v++)
+                        {
+                            int tuv = tuv_poss[(t * (l + 1) + u) * (l + 1) + v];
+
+                            double ecoeff = fac_tu * E[k * (l + 1) + v] * val;
+                            if (transpose)
+                                ecoeffs_out[tuv * n_sph + mu] += ecoeff;
+                            else
+                                ecoeffs_out[mu * n_hermite + tuv] += ecoeff;
+                        }
+                    }
+            }
+    }
+}
@@ -0,0 +1,247 @@
+#include <lible/ints/instrumentation.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <format>
+#include <mutex>
+#include <optional>
+
+#include <omp.h>
+
+namespace lints = lible::ints;
+
+namespace lible::ints::instrumentation
+{
+    /// Counters of the calling thread that are not yet merged.
+    struct ThreadState
+    {
+        /// Counters of the L classes worked on by the thread, indexed by the class ids. A deque
+        /// keeps the counters in place when new classes are added.
+        std::deque<std::optional<Counters>> counters_;
+        /// Counters of the currently set L class, nullptr if none.
+        Counters *current_{};
+        /// Counters for the kernels called outside an instrumented driver.
+        Counters discarded_;
+    };
+
+    thread_local ThreadState thread_state;
+
+    /// Guards the global counters and the class ids.
+    std::mutex counters_mutex;
+
+    /// Keys of the registered L classes, indexed by the class ids.
+    std::vector<class_key_t> class_keys;
+
+    /// Ids of the registered L classes.
+    std::map<class_key_t, class_id_t> class_ids;
+
+    /// Merged counters of all drivers and L classes.
+    std::map<class_key_t, Counters> merged_counters;
+
+    /// Busy times of the drivers per OMP thread.
+    std::map<std::string, std::vector<double>> busy_times;
+
+    /// Wall times of the parallel regions of the drivers.
+    std::map<std::string, double> wall_times;
+
+    /// Returns the counters as a JSON object.
+    std::string countersJSON(const Counters &counters);
+}
+
+lints::instrumentation::Counters &
+lints::instrumentation::Counters::operator+=(const Counters &other)
+{
+    n_shell_tuples_ += other.n_shell_tuples_;
+    n_screened_ += other.n_screened_;
+    n_prim_tuples_ += other.n_prim_tuples_;
+    n_boys_zero_ += other.n_boys_zero_;
+    n_boys_grid_ += other.n_boys_grid_;
+    n_boys_asymptotic_ += other.n_boys_asymptotic_;
+    time_rints_ += other.time_rints_;
+    time_shark_ += other.time_shark_;
+    time_scatter_ += other.time_scatter_;
+    time_busy_ += other.time_busy_;
+
+    return *this;
+}
+
+lints::instrumentation::class_id_t
+lints::instrumentation::classId(const std::string &driver, const std::vector<int> &ls)
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+
+    auto [it, inserted] = class_ids.try_emplace({driver, ls}, class_keys.size());
+    if (inserted)
+        class_keys.push_back(it->first);
+
+    return it->second;
+}
+
+lints::instrumentation::Counters &lints::instrumentation::setClass(const class_id_t class_id)
+{
+    if (thread_state.counters_.size() <= class_id)
+        thread_state.counters_.resize(class_id + 1);
+
+    std::optional<Counters> &counters = thread_state.counters_[class_id];
+    if (!counters)
+        counters.emplace();
+
+    thread_state.current_ = &*counters;
+
+    return *thread_state.current_;
+}
+
+lints::instrumentation::Counters &lints::instrumentation::current()
+{
+    if (thread_state.current_ == nullptr)
+        return thread_state.discarded_;
+
+    return *thread_state.current_;
+}
+
+void lints::instrumentation::unsetClass()
+{
+    thread_state.current_ = nullptr;
+}
+
+void lints::instrumentation::addWallTime(const std::string &driver, const double time)
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+    wall_times[driver] += time;
+}
+
+void lints::instrumentation::mergeThreads()
+{
+#pragma omp parallel
+    {
+        size_t ithread = omp_get_thread_num();
+
+        std::lock_guard<std::mutex> lock(counters_mutex);
+        for (size_t class_id = 0; class_id < thread_state.counters_.size(); class_id++)
+        {
+            const std::optional<Counters> &counters = thread_state.counters_[class_id];
+            if (!counters)
+                continue;
+
+            const class_key_t &key = class_keys[class_id];
+            merged_counters[key] += *counters;
+
+            std::vector<double> &busy = busy_times[key.first];
+            if (busy.size() <= ithread)
+                busy.resize(ithread + 1, 0);
+            busy[ithread] += counters->time_busy_;
+        }
+
+        thread_state.counters_.clear();
+        thread_state.current_ = nullptr;
+        thread_state.discarded_ = Counters();
+    }
+}
+
+std::map<lints::instrumentation::class_key_t, lints::instrumentation::Counters>
+lints::instrumentation::counters()
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+
+    return merged_counters;
+}
+
+lints::instrumentation::Counters lints::instrumentation::counters(const std::string &driver)
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+
+    Counters sum;
+    for (const auto &[key, counters] : merged_counters)
+        if (key.first == driver)
+            sum += counters;
+
+    return sum;
+}
+
+std::vector<lints::instrumentation::ThreadTimes>
+lints::instrumentation::threadTimes(const std::string &driver)
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+
+    if (!wall_times.contains(driver))
+        return {};
+
+    double wall_time = wall_times.at(driver);
+    std::vector<double> busy = busy_times[driver];
+    busy.resize(std::max(busy.size(), size_t(omp_get_max_threads())), 0);
+
+    std::vector<ThreadTimes> thread_times;
+    for (double busy_time : busy)
+        thread_times.push_back({busy_time, std::max(wall_time - busy_time, 0.0)});
+
+    return thread_times;
+}
+
+void lints::instrumentation::reset()
+{
+    std::lock_guard<std::mutex> lock(counters_mutex);
+
+    merged_counters.clear();
+    busy_times.clear();
+    wall_times.clear();
+}
+
+std::string lints::instrumentation::countersJSON(const Counters &counters)
+{
+    return std::format("\"n_shell_tuples\": {}, \"n_screened\": {}, \"n_prim_tuples\": {}, "
+                       "\"n_boys_zero\": {}, \"n_boys_grid\": {}, \"n_boys_asymptotic\": {}, "
+                       "\"time_rints\": {:.6e}, \"time_shark\": {:.6e}, \"time_scatter\": {:.6e}, "
+                       "\"time_busy\": {:.6e}",
+                       counters.n_shell_tuples_, counters.n_screened_, counters.n_prim_tuples_,
+                       counters.n_boys_zero_, counters.n_boys_grid_, counters.n_boys_asymptotic_,
+                       counters.time_rints_, counters.time_shark_, counters.time_scatter_,
+                       counters.time_busy_);
+}
+
+std::string lints::instrumentation::countersJSON()
+{
+    std::map<class_key_t, Counters> all_counters = counters();
+
+    std::vector<std::string> drivers;
+    for (const auto &[key, counters] : all_counters)
+        if (drivers.empty() || drivers.back() != key.first)
+            drivers.push_back(key.first);
+
+    std::string json = "{\n";
+    for (size_t idriver = 0; idriver < drivers.size(); idriver++)
+    {
+        const std::string &driver = drivers[idriver];
+
+        json += std::format("  \"{}\": {{\n", driver);
+        json += std::format("    \"total\": {{{}}},\n", countersJSON(counters(driver)));
+
+        std::vector<ThreadTimes> thread_times = threadTimes(driver);
+        json += "    \"threads\": [";
+        for (size_t ithread = 0; ithread < thread_times.size(); ithread++)
+            json += std::format("{}{{\"busy\": {:.6e}, \"idle\": {:.6e}}}",
+                                ithread > 0 ? ", " : "", thread_times[ithread].busy_,
+                                thread_times[ithread].idle_);
+        json += "],\n";
+
+        json += "    \"classes\": [\n";
+        bool first = true;
+        for (const auto &[key, counters] : all_counters)
+        {
+            if (key.first != driver)
+                continue;
+
+            std::string ls;
+            for (size_t i = 0; i < key.second.size(); i++)
+                ls += (i > 0 ? ", " : "") + std::to_string(key.second[i]);
+
+            json += std::format("{}      {{\"ls\": [{}], {}}}", first ? "" : ",\n", ls,
+                                countersJSON(counters));
+            first = false;
+        }
+        json += "\n    ]\n";
+        json += std::format("  }}{}\n", idriver + 1 < drivers.size() ? "," : "");
+    }
+    json += "}\n";
+
+    return json;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/// Expands to its arguments only when the library is built with LIBLE_INSTRUMENT, so that the
+/// instrumentation has no cost otherwise.
+#ifdef _LIBLE_INSTRUMENT_
+#define LIBLE_INSTRUMENT(...) __VA_ARGS__
+#else
+#define LIBLE_INSTRUMENT(...)
+#endif
+
+namespace lible::ints
+{
+    /// Instrumentation of the integral drivers. The counters are accumulated per driver and L
+    /// class in thread-local storage and merged into the global counters at the end of every
+    /// driver. The kernels count into the L class set by the driver on the calling thread, the
+    /// counts from kernels called outside an instrumented driver are discarded. Without
+    /// LIBLE_INSTRUMENT nothing is recorded and all queries return empty results.
+    namespace instrumentation
+    {
+        /// Returns true if the library was built with the instrumentation.
+        constexpr bool enabled()
+        {
+#ifdef _LIBLE_INSTRUMENT_
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /// Counters of one L class.
+        struct Counters
+        {
+            /// Number of evaluated shell tuples (quartets for ERI4, triples for ERI3).
+            size_t n_shell_tuples_{};
+            /// Number of shell tuples skipped by screening or symmetry.
+            size_t n_screened_{};
+            /// Number of evaluated primitive tuples.
+            size_t n_prim_tuples_{};
+            /// Number of Boys function calls at x = 0.
+            size_t n_boys_zero_{};
+            /// Number of Boys function calls using the interpolation grid.
+            size_t n_boys_grid_{};
+            /// Number of Boys function calls using the asymptotic expansion.
+            size_t n_boys_asymptotic_{};
+            /// Time (s) in the Hermite Coulomb integrals, including the Boys function.
+            double time_rints_{};
+            /// Time (s) in the SHARK contractions with the Hermite expansion coefficients.
+            double time_shark_{};
+            /// Time (s) spent copying the shell batches into the output.
+            double time_scatter_{};
+            /// Time (s) spent on the tasks of the class, summed over the threads.
+            double time_busy_{};
+
+            Counters &operator+=(const Counters &other);
+        };
+
+        /// Busy and idle time of a thread in a driver.
+        struct ThreadTimes
+        {
+            /// Time (s) spent on the tasks.
+            double busy_{};
+            /// Time (s) spent in the parallel regions without tasks, i.e., waiting.
+            double idle_{};
+        };
+
+        /// Key of the counters: name of the driver and the angular momenta of the L class.
+        using class_key_t = std::pair<std::string, std::vector<int>>;
+
+        using time_point_t = std::chrono::steady_clock::time_point;
+
+        /// Returns the current time point.
+        inline time_point_t now()
+        {
+            return std::chrono::steady_clock::now();
+        }
+
+        /// Returns the time (s) passed since the given time point.
+        inline double since(const time_point_t start)
+        {
+            return std::chrono::duration<double>(now() - start).count();
+        }
+
+        /// Index of an L class, see classId().
+        using class_id_t = size_t;
+
+        /// Returns the index of the L class of the driver, registering it if new. Looks up the
+        /// class under a lock, so the drivers call it once per class outside the task loops.
+        class_id_t classId(const std::string &driver, const std::vector<int> &ls);
+
+        /// Sets the L class, given by classId(), the calling thread counts into and returns its
+        /// counters. Cheap enough to be called per task.
+        Counters &setClass(class_id_t class_id);
+
+        /// Returns the counters of the L class set on the calling thread. If none is set, returns
+        /// thread-local counters that are never merged.
+        Counters &current();
+
+        /// Unsets the L class on the calling thread.
+        void unsetClass();
+
+        /// Adds the wall time (s) of a parallel region of the driver. Used for the idle times of
+        /// the threads. Called by one thread.
+        void addWallTime(const std::string &driver, double time);
+
+        /// Merges the counters of all OMP threads into the global counters and clears them. Has
+        /// to be called outside of parallel regions.
+        void mergeThreads();
+
+        /// Returns the counters of all drivers and L classes.
+        std::map<class_key_t, Counters> counters();
+
+        /// Returns the counters of the driver summed over the L classes.
+        Counters counters(const std::string &driver);
+
+        /// Returns the busy and idle times of the driver per OMP thread.
+        std::vector<ThreadTimes> threadTimes(const std::string &driver);
+
+        /// Clears all the counters.
+        void reset();
+
+        /// Returns all the counters and thread times as JSON.
+        std::string countersJSON();
+    }
+}
@@ -5,7 +5,9 @@
 #include <lible/ints/shell_pair_data.hpp>
 #include <lible/ints/utils.hpp>
 #include <lible/ints/structure.hpp>
+#include <lible/ints/symmetry.hpp>
 #include <lible/ints/twoel/eri_kernels.hpp>
+#include <lible/ints/twoel/kernel_selector.hpp>
 
 #include <array>
 #include <set>
@@ -29,27 +31,80 @@ namespace lible::ints
     /// Calculates the overlap integrals. OMP parallelized.
     vec2d overlap(const Structure &structure);
 
+    /// Calculates the overlap integrals for the symmetry-unique shell pairs and reconstructs the
+    /// rest with the point group operations. OMP parallelized.
+    vec2d overlap(const Structure &structure, const PointGroup &point_group);
+
     /// Calculates a batch of overlap integrals.
     vec2d overlapKernel(size_t ipair, const ShellPairData &sp_data);
 
     /// Calculates a batch of overlap integral derivatives.
     std::array<vec2d, 6> overlapD1Kernel(size_t ipair, const ShellPairData &sp_data);
 
+    /// Calculates a batch of overlap integral second derivatives as [ideriv][jderiv], with the
+    /// derivatives ordered as {Ax, Ay, Az, Bx, By, Bz}.
+    arr2d<vec2d, 6, 6> overlapD2Kernel(size_t ipair, const ShellPairData &sp_data);
+
     /// Calculates the kinetic energy integrals. OMP parallelized.
     vec2d kineticEnergy(const Structure &structure);
 
+    /// Calculates the kinetic energy integrals for the symmetry-unique shell pairs and
+    /// reconstructs the rest with the point group operations. OMP parallelized.
+    vec2d kineticEnergy(const Structure &structure, const PointGroup &point_group);
+
     /// Calculates a batch of kinetic energy integrals.
     vec2d kineticEnergyKernel(size_t ipair, const ShellPairData &sp_data);
 
     /// Calculates a batch of kinetic energy integral derivatives.
     std::array<vec2d, 6> kineticEnergyD1Kernel(size_t ipair, const ShellPairData &sp_data);
 
+    /// Calculates a batch of kinetic energy integral second derivatives as [ideriv][jderiv],
+    /// with the derivatives ordered as {Ax, Ay, Az, Bx, By, Bz}.
+    arr2d<vec2d, 6, 6> kineticEnergyD2Kernel(size_t ipair, const ShellPairData &sp_data);
+
     /// Calculates nuclear attraction integrals. OMP parallelized.
     vec2d nuclearAttraction(const Structure &structure);
 
+    /// Calculates nuclear attraction integrals for the symmetry-unique shell pairs and
+    /// reconstructs the rest with the point group operations. OMP parallelized.
+    vec2d nuclearAttraction(const Structure &structure, const PointGroup &point_group);
+
     /// Calculates attenuated nuclear attraction integrals. OMP parallelized.
     vec2d nuclearAttractionErf(const Structure &structure, const std::vector<double> &omegas);
 
+    /// Integrals of the core Hamiltonian, and optionally the dipole moment integrals.
+    struct CoreHamiltonian
+    {
+        /// Overlap integrals.
+        vec2d overlap_;
+        /// Kinetic energy integrals.
+        vec2d kinetic_energy_;
+        /// Nuclear attraction integrals.
+        vec2d nuclear_attraction_;
+        /// Dipole moment integrals in the three Cartesian directions. Empty if not requested.
+        std::array<vec2d, 3> dipole_moment_;
+    };
+
+    /// Calculates the overlap, kinetic energy and nuclear attraction integrals in one pass over
+    /// the shell pairs. The integrals share the Hermite expansion coefficients and the spherical
+    /// transformation. OMP parallelized.
+    CoreHamiltonian coreHamiltonian(const Structure &structure);
+
+    /// Calculates the overlap, kinetic energy and nuclear attraction integrals, and the dipole
+    /// moment integrals with respect to the given origin, in one pass over the shell pairs. OMP
+    /// parallelized.
+    CoreHamiltonian coreHamiltonian(const std::array<double, 3> &origin,
+                                    const Structure &structure);
+
+    /// Calculates a batch of core Hamiltonian integrals for the given nuclear charges
+    /// {x, y, z, q}. The dipole moment integrals are calculated only if `calc_dipole` is true.
+    /// The Boys function must be initialized with l = la + lb.
+    CoreHamiltonian coreHamiltonianKernel(size_t ipair,
+                                          const std::vector<std::array<double, 4>> &charges,
+                                          const BoysGrid &boys_grid, const ShellPairData &sp_data,
+                                          bool calc_dipole = false,
+                                          const std::array<double, 3> &origin = {});
+
     /// Calculates one-electron Coulomb integrals with given point charges {x, y, z, q}.
     /// OMP parallelized.
     vec2d externalCharges(const std::vector<std::array<double, 4>> &point_charges,
@@ -126,6 +181,20 @@ namespace lible::ints
     std::array<vec2d, 3> dipoleMomentKernel(size_t ipair, const std::array<double, 3> &origin,
                                             const ShellPairData &sp_data);
 
+    /// Calculates the Cartesian multipole moment integrals, <a|(x - x_O)^e_x (y - y_O)^e_y
+    /// (z - z_O)^e_z|b>, of all orders e_x + e_y + e_z <= `order` with respect to the given
+    /// origin O. The integrals are ordered by the order and then like the Cartesian Gaussians,
+    /// {(0, 0, 0), (1, 0, 0), (0, 1, 0), (0, 0, 1), (2, 0, 0), (1, 1, 0), ...}, see `cart_exps`.
+    /// OMP parallelized.
+    std::vector<vec2d> multipoleMoment(int order, const std::array<double, 3> &origin,
+                                       const Structure &structure);
+
+    /// Calculates a batch of Cartesian multipole moment integrals of all orders up to `order`,
+    /// ordered as in `multipoleMoment`.
+    std::vector<vec2d> multipoleMomentKernel(size_t ipair, int order,
+                                             const std::array<double, 3> &origin,
+                                             const ShellPairData &sp_data);
+
     /// Calculates the one-electron spin-orbit coupling integrals in three Cartesian directions.
     /// OMP parallelized.
     std::array<vec2d, 3> spinOrbitCoupling1El(const Structure &structure);
@@ -136,6 +205,25 @@ namespace lible::ints
     spinOrbitCoupling1ElKernel(size_t ipair, const std::vector<std::array<double, 4>> &charges,
                                const BoysGrid &boys_grid, const ShellPairData &sp_data);
 
+    /// Calculates the two-electron part of the spin-orbit mean-field (SOMF) operator in three
+    /// Cartesian directions for the symmetric total density D of a closed-shell reference,
+    ///   G_mu,nu = sum_{ka ta} D_{ka ta} [(mu nu|ka ta) - 3/2 (mu ka|ta nu) - 3/2 (ta nu|mu ka)],
+    /// where (ab|cd) are the SOC integrals from `ERI4SOCKernel`. These carry the opposite sign to
+    /// the nuclear term, so the SOMF operator is `spinOrbitCoupling1El()` + G. The integral
+    /// batches are contracted on the fly and only the output-sized matrices are stored. OMP
+    /// parallelized.
+    std::array<vec2d, 3> spinOrbitMeanField(const Structure &structure, const vec2d &density);
+
+    /// Calculates the two-electron part of the SOMF operator, as in `spinOrbitMeanField()`,
+    /// with the RI approximation (ab|cd) = sum_PQ (ab|P)_SOC (P|Q)^-1 (Q|cd). The three-index
+    /// integrals are contracted with DGEMM one shell pair at a time. The exchange term is
+    /// accumulated over blocks of the fitted auxiliary functions, sized such that their
+    /// three-index intermediates fit into `max_memory_mb`, and the SOC integrals from
+    /// `ERI3SOCKernel` are recalculated for every block. The Coulomb term only needs vectors of
+    /// the auxiliary dimension. OMP parallelized.
+    std::array<vec2d, 3> spinOrbitMeanFieldRI(const Structure &structure, const vec2d &density,
+                                              double max_memory_mb = 1024);
+
     /// Calculates the linear momentum integrals in three Cartesian directions. OMP parallelized.
     std::array<vec2d, 3> momentum(const Structure &structure);
 
@@ -165,19 +253,246 @@ namespace lible::ints
     /// Calculates the diagonal of the ERI2 over the auxiliary basis set. OMP parallelized.
     std::vector<double> eri2Diagonal(const Structure &structure);
 
-    /// Calculates the ERI2 over the auxiliary basis set. OMP parallelized.
+    /// Calculates the ERI2 over the auxiliary basis set. OMP parallelized. With LIBLE_USE_MPI,
+    /// the shell pairs are distributed over the processes and the full matrix is returned on
+    /// every process.
     vec2d eri2(const Structure &structure);
 
+    /// Calculates the ERI2 from the auxiliary shell data of shellDataAux() and the kernels of
+    /// eri2Kernels(). These can be kept across Structure::updateCoordinates() calls when they
+    /// are refreshed with updateShellDataAux() and updateERI2Kernels(). OMP parallelized and
+    /// distributed over MPI as above.
+    vec2d eri2(const Structure &structure, const std::vector<ShellData> &sh_data_aux,
+               const std::vector<ERI2Kernel> &eri2_kernels);
+
+    /// Constructs the ERI2 kernels of the (a|b) classes of the auxiliary shell data, ordered as
+    /// {(0|0), (1|0), (1|1), (2|0), ...} for the classes a >= b.
+    std::vector<ERI2Kernel> eri2Kernels(const std::vector<ShellData> &sh_data_aux);
+
+    /// Refreshes the kernels from eri2Kernels() after updateShellDataAux().
+    void updateERI2Kernels(const std::vector<ShellData> &sh_data_aux,
+                           std::vector<ERI2Kernel> &eri2_kernels);
+
     /// Calculates the ERI4 diagonal, (ab|ab). OMP parallelized.
     vec2d eri4Diagonal(const Structure &structure);
 
+    /// Calculates the ERI4 diagonal from the shell pair data of shellPairData(true, structure).
+    /// OMP parallelized.
+    vec2d eri4Diagonal(const Structure &structure, const std::vector<ShellPairData> &sp_data);
+
     /// Calculates the ERI3 tensor, (ab|P) where a and b are main basis AOs, P is an auxiliary
-    /// basis AO. OMP parallelized. OMP parallelized.
+    /// basis AO. OMP parallelized. With LIBLE_USE_MPI, the shell triples are distributed over
+    /// the processes, but the output is replicated: every process allocates the full tensor and
+    /// receives the complete result from allReduceSum(), so the memory per process is not
+    /// reduced.
     vec3d eri3(const Structure &structure);
 
+    /// Calculates the ERI3 tensor for the symmetry-unique shell triples and reconstructs the rest
+    /// with the point group operations. OMP parallelized.
+    vec3d eri3(const Structure &structure, const PointGroup &point_group);
+
+    /// Calculates the ERI3 tensor from the shell pair data of shellPairData(true, structure),
+    /// the auxiliary shell data of shellDataAux() and the kernels of eri3Kernels(). These can
+    /// be kept across Structure::updateCoordinates() calls when they are refreshed with
+    /// updateShellPairData(), updateShellDataAux() and updateERI3Kernels(). OMP parallelized and
+    /// distributed over MPI as above, with the replicated output.
+    vec3d eri3(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+               const std::vector<ShellData> &sh_data_aux,
+               const std::vector<ERI3Kernel> &eri3_kernels);
+
+    /// Constructs the ERI3 kernels of the (ab|c) classes, ordered as ab * n_c + c. The kernels
+    /// of a shell pair class share its E-coefficients.
+    std::vector<ERI3Kernel> eri3Kernels(const std::vector<ShellPairData> &sp_data,
+                                        const std::vector<ShellData> &sh_data_aux);
+
+    /// Refreshes the kernels from eri3Kernels() after updateShellPairData() and
+    /// updateShellDataAux().
+    void updateERI3Kernels(const std::vector<ShellPairData> &sp_data,
+                           const std::vector<ShellData> &sh_data_aux,
+                           std::vector<ERI3Kernel> &eri3_kernels);
+
     /// Calculates the ERI4 tensor. OMP parallelized.
     vec4d eri4(const Structure &structure);
 
+    /// Calculates the ERI4 tensor using the kernel variants chosen by the given selector. OMP
+    /// parallelized.
+    vec4d eri4(const Structure &structure, const KernelSelector &kernel_selector);
+
+    /// Calculates the ERI4 tensor for the symmetry-unique shell quartets and reconstructs the
+    /// rest with the point group operations. For D2h, this reduces the work up to 8 times. OMP
+    /// parallelized.
+    vec4d eri4(const Structure &structure, const PointGroup &point_group);
+
+    /// Calculates the ERI4 tensor from the shell pair data of shellPairData(true, structure)
+    /// and the kernels of eri4Kernels(). These can be kept across Structure::updateCoordinates()
+    /// calls when they are refreshed with updateShellPairData() and updateERI4Kernels(). OMP
+    /// parallelized.
+    vec4d eri4(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+               const std::vector<ERI4Kernel> &eri4_kernels);
+
+    /// Constructs the ERI4 kernels of the (ab|cd) classes, ordered as {(0|0), (1|0), (1|1),
+    /// (2|0), ...} for the shell pair classes ab >= cd, with the variants chosen by the given
+    /// selector. The kernels with the same bra or ket class share its E-coefficients.
+    std::vector<ERI4Kernel> eri4Kernels(const std::vector<ShellPairData> &sp_data,
+                                        const KernelSelector &kernel_selector = KernelSelector());
+
+    /// Refreshes the kernels from eri4Kernels() after updateShellPairData().
+    void updateERI4Kernels(const std::vector<ShellPairData> &sp_data,
+                           std::vector<ERI4Kernel> &eri4_kernels);
+
+    /// Transforms the ERI4 to the MO basis, (pq|rs) = sum C_mu,p C_nu,q C_ka,r C_ta,s
+    /// (mu nu|ka ta), for the MO coefficients C given as (dim_ao, n_mo), e.g., the active
+    /// orbitals. The transformation is integral-direct: the shell quartets are calculated once
+    /// for ab >= cd and added with DGEMM to the quarter-transformed (mu nu|ka r) of both shell
+    /// pairs, which are then transformed to (mu nu|rs), and the second half is done by the rs
+    /// columns. The MOs r are processed in batches and the bra shell pairs in blocks such that
+    /// the intermediates, the buffers of the threads and the E-coefficients fit into
+    /// `max_memory_mb`. The integrals are recalculated for every batch, and the quartets between
+    /// different blocks for each of the blocks. If more than one batch is needed and
+    /// `scratch_dir` is given, the (mu nu|rs) are instead calculated once for all the MOs and
+    /// staged on disk, and the second half is done by the batches of the rs columns read from
+    /// there. Returned in the packed form, see idxPackedERI4MO(). OMP parallelized.
+    std::vector<double> eri4MO(const Structure &structure, const vec2d &mo_coeffs,
+                               double max_memory_mb = 1024, const std::string &scratch_dir = "");
+
+    /// Returns the position of (pq|rs) in the packed integrals from eri4MO(). The pairs are
+    /// packed as pq = p (p + 1) / 2 + q for p >= q, and the integrals as pq (pq + 1) / 2 + rs for
+    /// pq >= rs.
+    constexpr size_t idxPackedERI4MO(const size_t p, const size_t q, const size_t r,
+                                     const size_t s)
+    {
+        size_t pq = p >= q ? p * (p + 1) / 2 + q : q * (q + 1) / 2 + p;
+        size_t rs = r >= s ? r * (r + 1) / 2 + s : s * (s + 1) / 2 + r;
+
+        return pq >= rs ? pq * (pq + 1) / 2 + rs : rs * (rs + 1) / 2 + pq;
+    }
+
+    /// Unpacks the integrals from eri4MO() to the full (n_mo, n_mo, n_mo, n_mo) tensor, e.g.,
+    /// for the GUGA-CI.
+    vec4d unpackERI4MO(size_t n_mo, const std::vector<double> &eri4_mo);
+
+    /// Calculates the ERI4 contributions to the nuclear gradient, returned as {J, K}, each as
+    /// (atom, xyz) in a.u. The energies are defined as E_J = 1/2 sum D^J_ab D^J_cd (ab|cd) and
+    /// E_K = 1/2 sum D^K_ac D^K_bd (ab|cd), where the densities are symmetric. For example, for
+    /// RHF the exchange gradient is -1/2 of the K part with the total density. The derivative
+    /// integrals are contracted on the fly and shell quartets are screened by the
+    /// density-weighted Schwarz bound. Ghost atoms, if any, follow the atoms. OMP parallelized.
+    std::pair<vec2d, vec2d> eri4GradientJK(const Structure &structure, const vec2d &density_j,
+                                           const vec2d &density_k, double screening_thrs = 1e-12);
+
+    /// Calculates the ERI4 contributions to the nuclear gradient, as above, from the shell pair
+    /// data of shellPairData(true, structure), which can be kept across
+    /// Structure::updateCoordinates() calls when it is refreshed with updateShellPairData().
+    std::pair<vec2d, vec2d> eri4GradientJK(const Structure &structure,
+                                           const std::vector<ShellPairData> &sp_data,
+                                           const vec2d &density_j, const vec2d &density_k,
+                                           double screening_thrs = 1e-12);
+
+    /// Calculates the RI-J contribution to the nuclear gradient as (atom, xyz) in a.u. The
+    /// energy is E_J = sum_P c_P sum_ab D_ab (ab|P) - 1/2 sum_PQ c_P (P|Q) c_Q, where c are the
+    /// fitting coefficients for the symmetric density D. The (ab|P) and (P|Q) derivative
+    /// batches are contracted on the fly. OMP parallelized.
+    vec2d riGradientJ(const Structure &structure, const vec2d &density,
+                      const std::vector<double> &coeffs_fit);
+
+    /// Calculates the RI-J contribution to the nuclear gradient, as above, from the shell pair
+    /// data of shellPairData(true, structure) and the auxiliary shell data of shellDataAux(),
+    /// which can be kept across Structure::updateCoordinates() calls when they are refreshed
+    /// with updateShellPairData() and updateShellDataAux().
+    vec2d riGradientJ(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+                      const std::vector<ShellData> &sh_data_aux, const vec2d &density,
+                      const std::vector<double> &coeffs_fit);
+
+    /// Calculates the RI-K contribution to the nuclear gradient as (atom, xyz) in a.u. The
+    /// energy is E_K = 1/2 sum D_ac D_bd (ab|cd) with the RI approximation to (ab|cd), and the
+    /// fitting coefficients are given as C_{ab,P} = sum_Q (ab|Q) (Q|P)^-1. For example, for RHF
+    /// the exchange gradient is -1/2 of this with the total density. The density-contracted
+    /// three-index intermediate is formed from C for blocks of the auxiliary functions as they are
+    /// contracted, so besides C only two blocks of dim_ao^2 x 64 are stored. OMP parallelized.
+    vec2d riGradientK(const Structure &structure, const vec2d &density, const vec3d &coeffs_fit);
+
+    /// Calculates the RI-K contribution to the nuclear gradient, as above, from the cached
+    /// shell pair and auxiliary shell data, as in riGradientJ().
+    vec2d riGradientK(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+                      const std::vector<ShellData> &sh_data_aux, const vec2d &density,
+                      const vec3d &coeffs_fit);
+
+    /// Calculates sum_ab W_ab d/dR S_ab as (atom, xyz) in a.u., where W is the symmetric
+    /// energy-weighted density. The derivative batches are contracted on the fly. OMP
+    /// parallelized.
+    vec2d overlapGradient(const Structure &structure, const vec2d &density_energy_weighted);
+
+    /// Calculates sum_ab D_ab d/dR T_ab as (atom, xyz) in a.u. for the symmetric density D. OMP
+    /// parallelized.
+    vec2d kineticEnergyGradient(const Structure &structure, const vec2d &density);
+
+    /// Calculates sum_ab W_ab d^2/dR dR' S_ab as (3 * atom + xyz, 3 * atom' + xyz') in a.u.,
+    /// where W is the symmetric energy-weighted density. The second derivative batches are
+    /// contracted on the fly. OMP parallelized.
+    vec2d overlapHessian(const Structure &structure, const vec2d &density_energy_weighted);
+
+    /// Calculates sum_ab D_ab d^2/dR dR' T_ab as (3 * atom + xyz, 3 * atom' + xyz') in a.u. for
+    /// the symmetric density D. OMP parallelized.
+    vec2d kineticEnergyHessian(const Structure &structure, const vec2d &density);
+
+    /// Calculates sum_PQ W_PQ d^2/dR dR' (P|Q) as (3 * atom + xyz, 3 * atom' + xyz') in a.u.
+    /// for the symmetric weight W over the auxiliary basis set, e.g., W = c c^T for the RI-J
+    /// fitting coefficients c. The batches of `ERI2D2Kernel` are contracted on the fly. OMP
+    /// parallelized.
+    vec2d eri2Hessian(const Structure &structure, const vec2d &weight);
+
+    /// Calculates sum_ab D_ab d/dR V_ab as (atom, xyz) in a.u. for the symmetric density D,
+    /// including both the orbital and the operator (Hellmann-Feynman) parts. OMP parallelized.
+    vec2d nuclearAttractionGradient(const Structure &structure, const vec2d &density);
+
+    /// Calculates the derivatives of sum_ab D_ab V^C_ab, with V^C from `externalCharges()`, for
+    /// the symmetric density D. Returns {atoms, charges}, where the derivatives with respect to
+    /// the atomic centers are given as (atom, xyz) and those with respect to the point charge
+    /// positions as (charge, xyz). The operator part is contracted with the density in the
+    /// Hermite basis, so no per-charge integral matrices are formed. OMP parallelized.
+    std::pair<vec2d, vec2d>
+    externalChargesGradient(const std::vector<std::array<double, 4>> &point_charges,
+                            const Structure &structure, const vec2d &density);
+
+    /// Electrostatic potential and electric field of the electron density at a set of points.
+    struct ElectrostaticPotential
+    {
+        /// Potential at the points, sum_ab D_ab (a|-1/r_1C|b).
+        std::vector<double> potential_;
+        /// Electric field, -dV/dC, at the points as {x, y, z}. Empty if not requested.
+        std::vector<std::array<double, 3>> field_;
+    };
+
+    /// Calculates the electrostatic potential, and optionally the electric field, of the
+    /// electrons for the symmetric density D at the given points {x, y, z} in a.u. The nuclear
+    /// contribution is not included. The density is transformed to Hermite Gaussian charge
+    /// distributions once, and the primitive pairs with coefficients below `screening_thrs`
+    /// are skipped. The points are processed in blocks that are OMP parallelized.
+    ElectrostaticPotential electrostaticPotential(const std::vector<std::array<double, 3>> &points,
+                                                  const Structure &structure,
+                                                  const vec2d &density, bool calc_field = false,
+                                                  double screening_thrs = 1e-12);
+
+    /// Values, and optionally derivatives, of the atomic orbitals at a set of points.
+    struct AOCollocation
+    {
+        /// Values of the atomic orbitals as (point, ao).
+        vec2d values_;
+        /// Gradients {d/dx, d/dy, d/dz} of the atomic orbitals as (point, ao). Empty if not
+        /// requested.
+        std::array<vec2d, 3> gradients_;
+        /// Laplacians of the atomic orbitals as (point, ao). Empty if not requested.
+        vec2d laplacians_;
+    };
+
+    /// Calculates the values of the atomic orbitals, and optionally their gradients and
+    /// Laplacians, at the given points {x, y, z} in a.u. The points are processed in blocks that
+    /// are OMP parallelized. In each block, the shells whose radial extent for `screening_thrs`
+    /// does not reach the bounding sphere of the block are skipped and left as zeros.
+    AOCollocation aoCollocation(const std::vector<std::array<double, 3>> &points,
+                                const Structure &structure, bool calc_gradient = false,
+                                bool calc_laplacian = false, double screening_thrs = 1e-12);
+
     /// Returns the main basis set for an atom.
     BasisAtom basisForAtom(int atomic_nr, const std::string &basis_set);
 
@@ -191,6 +506,10 @@ namespace lible::ints
     basis_atoms_t basisForAtomsAux(const std::vector<int> &atomic_nrs,
                                    const std::string &aux_basis_set);
 
+    /// Clears the cached basis sets. The basis set files are read and parsed once and the results
+    /// are kept for later calls, so this is needed only if the files have changed on disk.
+    void clearBasisSetCache();
+
     /// Returns the Cartesian to spherical transformation for given angular momentum. Returned as
     /// a list, {mu, mu_, val}, where mu and mu_ are spherical and Cartesian indices, respectively,
     /// and val is the value of the transformation coefficient.
@@ -199,6 +518,12 @@ namespace lible::ints
     /// Transforms the input Cartesian basis integrals to the spherical basis.
     vec2d trafo2Spherical(int la, int lb, const vec2d &ints_cart);
 
+    /// Transforms `n_blocks` consecutive blocks of Cartesian basis integrals, (n_cart_a, n_cart_b)
+    /// each, to the spherical basis, (n_sph_a, n_sph_b) each, in `ints_sph`. Uses the
+    /// compile-time transformation tables and allocates nothing.
+    void trafo2SphericalBatch(int la, int lb, size_t n_blocks, const double *ints_cart,
+                              double *ints_sph);
+
     // TODO: docstri
     using xyz_coords_t = std::vector<std::array<double, 3>>;
 
@@ -231,6 +556,15 @@ namespace lible::ints
     /// Returns data for (la, lb) pairs. If symmetry is used, returns data for (la >= lb).
     std::vector<ShellPairData> shellPairData(bool use_symm, const Structure &structure);
 
+    /// Refreshes the auxiliary shell data from shellDataAux() after
+    /// Structure::updateCoordinates().
+    void updateShellDataAux(const Structure &structure, std::vector<ShellData> &sh_data);
+
+    /// Refreshes the shell pair data from shellPairData(use_symm, structure) after
+    /// Structure::updateCoordinates(). Only the coordinates are overwritten unless the screening
+    /// outcome of the primitive pairs changes.
+    void updateShellPairData(const Structure &structure, std::vector<ShellPairData> &sp_data);
+
     ///  Constructs the shell pair data from the given shells.
     std::vector<ShellPairData> shellPairData(const std::vector<Shell> &shells_a,
                                              const std::vector<Shell> &shells_b);
@@ -265,6 +599,12 @@ namespace lible::ints
     std::array<vec3d, 3> ecoeffsPrimitivePair(double a, double b, int la, int lb,
                                               const double *xyz_a, const double *xyz_b);
 
+    /// Calculates the Hermite expansion coefficients for a single primitive Gaussian function
+    /// product, as above, into `ecoeffs`, which are reallocated only when la or lb change. For
+    /// la, lb <= max_l_ecoeffs the compile-time generators are used.
+    void ecoeffsPrimitivePair(double a, double b, int la, int lb, const double *xyz_a,
+                              const double *xyz_b, std::array<vec3d, 3> &ecoeffs);
+
     /// Calculates the first derivative of the Hermite expansion coefficients for a single
     /// primitive Gaussian function product in three Cartesian directions.
     std::array<vec3d, 3> ecoeffsPrimitivePair_n1(double a, double b, int la, int lb,
@@ -326,8 +666,13 @@ namespace lible::ints
     /// Returns the available auxiliary basis sets.
     std::set<std::string> availableBasisSetsAux();
 
-    /// Function for doing an ERI4 benchmark.
-    void eri4Benchmark(const Structure &structure);
+    /// Function for doing an ERI4 benchmark. The timings are printed per L class for the given
+    /// backend, which allows choosing the faster one for each class.
+    void eri4Benchmark(const Structure &structure, ERIBackend backend = ERIBackend::shark);
+
+    /// Times every available ERI4 kernel variant per (la, lb, lc, ld) class and primitive depth
+    /// bucket, writes the fastest ones to `tuning_file` and returns the corresponding selector.
+    KernelSelector eri4Autotune(const Structure &structure, const std::string &tuning_file);
 
     ///
     class BasisPaths
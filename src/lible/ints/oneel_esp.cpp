@@ -0,0 +1,329 @@
+#include <lible/ints/boys_function.hpp>
+#include <lible/ints/defs.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/rints.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Hermite Gaussian charge distributions, sum_{mu nu} D_{mu nu} E^{mu nu}_{tuv}, of the
+    /// primitive pairs with L = la + lb.
+    struct HermiteDensities
+    {
+        size_t n_ppairs_{};
+        /// Exponents p = a + b of the primitive pairs.
+        std::vector<double> exps_;
+        /// Centers of the primitive pairs as {x, y, z}.
+        std::vector<double> coords_;
+        /// Hermite coefficients as (ppair, tuv), with 2pi / p multiplied in.
+        std::vector<double> coeffs_;
+    };
+
+    /// Number of points in a block handled by one task.
+    constexpr size_t n_points_block = 64;
+
+    /// Transforms the density to Hermite Gaussian charge distributions for L = 0,...,2 l_max.
+    /// Skips the primitive pairs with all coefficients below `screening_thrs`.
+    std::vector<HermiteDensities> hermiteDensities(const Structure &structure,
+                                                   const vec2d &density, double screening_thrs);
+
+    /// Adds the potential, and optionally the field, of the Hermite densities with L = lab to
+    /// the points in [ipoint_begin, ipoint_end). Explicitly rolled out for each L.
+    template <int lab, bool calc_field>
+    void espBlock(const HermiteDensities &hdens, const std::vector<std::array<double, 3>> &points,
+                  size_t ipoint_begin, size_t ipoint_end, double *potential,
+                  std::array<double, 3> *field);
+
+    /// Same as above for arbitrary L. The Boys function must be initialized with l = lab + 1
+    /// if the field is calculated, and l = lab otherwise.
+    void espBlock(int lab, bool calc_field, const HermiteDensities &hdens,
+                  const BoysGrid &boys_grid, const std::vector<std::array<double, 3>> &points,
+                  size_t ipoint_begin, size_t ipoint_end, double *potential,
+                  std::array<double, 3> *field);
+
+    using esp_block_fun_t = void (*)(const HermiteDensities &hdens,
+                                     const std::vector<std::array<double, 3>> &points,
+                                     size_t ipoint_begin, size_t ipoint_end, double *potential,
+                                     std::array<double, 3> *field);
+
+    template <bool calc_field, size_t... labs>
+    constexpr std::array<esp_block_fun_t, sizeof...(labs)>
+    espBlockFuns(std::index_sequence<labs...>)
+    {
+        return {&espBlock<labs, calc_field>...};
+    }
+
+    /// Rolled-out ESP functions for L = 0,...,_max_l_rollout_.
+    constexpr auto esp_block_funs = espBlockFuns<false>(
+            std::make_index_sequence<_max_l_rollout_ + 1>());
+
+    /// Rolled-out ESP and field functions for L = 0,...,_max_l_rollout_.
+    constexpr auto esp_field_block_funs = espBlockFuns<true>(
+            std::make_index_sequence<_max_l_rollout_ + 1>());
+}
+
+std::vector<lints::HermiteDensities>
+lints::hermiteDensities(const Structure &structure, const vec2d &density,
+                        const double screening_thrs)
+{
+    int l_max = structure.getMaxL();
+
+    std::vector<HermiteDensities> hdenss(2 * l_max + 1);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+            int lab = la + lb;
+            int n_sph_a = numSphericals(la);
+            int n_sph_b = numSphericals(lb);
+            int n_sph_ab = n_sph_a * n_sph_b;
+            int n_hermites = numHermites(lab);
+
+            std::vector<double> ecoeffs = ecoeffsSHARK(sp_data, false);
+
+            HermiteDensities &hdens = hdenss[lab];
+            std::vector<double> density_block(n_sph_ab);
+            std::vector<double> coeffs(n_hermites);
+            for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+            {
+                size_t ofs_a = sp_data.offsets_sph_[2 * ipair + 0];
+                size_t ofs_b = sp_data.offsets_sph_[2 * ipair + 1];
+
+                // The off-diagonal shell pairs appear once in the symmetric list.
+                double deg = (sp_data.shell_idxs_[2 * ipair + 0] ==
+                              sp_data.shell_idxs_[2 * ipair + 1]) ? 1.0 : 2.0;
+
+                for (int mu = 0; mu < n_sph_a; mu++)
+                    for (int nu = 0; nu < n_sph_b; nu++)
+                        density_block[mu * n_sph_b + nu] = deg * density(ofs_a + mu, ofs_b + nu);
+
+                size_t ofs_prim = sp_data.offsets_primitives_[ipair];
+                const double *exps = &sp_data.exps_[ofs_prim];
+                const double *xyz_a = &sp_data.coords_[6 * ipair + 0];
+                const double *xyz_b = &sp_data.coords_[6 * ipair + 3];
+
+                for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
+                {
+                    double a = exps[iab * 2];
+                    double b = exps[iab * 2 + 1];
+                    double p = a + b;
+                    double fac = 2 * (M_PI / p);
+
+                    size_t ofs_ecoeffs = sp_data.offsets_ecoeffs_[ipair] +
+                                         iab * n_sph_ab * n_hermites;
+
+                    std::fill(coeffs.begin(), coeffs.end(), 0);
+                    for (int munu = 0; munu < n_sph_ab; munu++)
+                    {
+                        double dens = fac * density_block[munu];
+                        const double *ecoeffs_munu = &ecoeffs[ofs_ecoeffs + munu * n_hermites];
+                        for (int tuv = 0; tuv < n_hermites; tuv++)
+                            coeffs[tuv] += dens * ecoeffs_munu[tuv];
+                    }
+
+                    double coeff_max = 0;
+                    for (double coeff : coeffs)
+                        coeff_max = std::max(coeff_max, std::fabs(coeff));
+
+                    if (coeff_max < screening_thrs)
+                        continue;
+
+                    hdens.n_ppairs_++;
+                    hdens.exps_.push_back(p);
+                    for (int icart = 0; icart < 3; icart++)
+                        hdens.coords_.push_back((a * xyz_a[icart] + b * xyz_b[icart]) / p);
+                    hdens.coeffs_.insert(hdens.coeffs_.end(), coeffs.begin(), coeffs.end());
+                }
+            }
+        }
+
+    return hdenss;
+}
+
+template <int lab, bool calc_field>
+void lints::espBlock(const HermiteDensities &hdens,
+                     const std::vector<std::array<double, 3>> &points, const size_t ipoint_begin,
+                     const size_t ipoint_end, double *potential, std::array<double, 3> *field)
+{
+    constexpr int l = calc_field ? lab + 1 : lab;
+    constexpr int n_hermites = numHermitesC(lab);
+    constexpr int n_rints = numHermitesC(l) + l;
+
+    // Positions of R_{tuv}, R_{t+1,u,v}, R_{t,u+1,v} and R_{t,u,v+1} in the R-integrals.
+    constexpr auto idxs_rints = []()
+    {
+        constexpr auto hermite_idxs = generateHermiteIdxs<lab>();
+
+        std::array<std::array<int, 4>, n_hermites> idxs{};
+        for (int tuv = 0; tuv < n_hermites; tuv++)
+        {
+            auto [t, u, v] = hermite_idxs[tuv];
+            idxs[tuv] = {indexRRollout(l, t, u, v), indexRRollout(l, t + 1, u, v),
+                         indexRRollout(l, t, u + 1, v), indexRRollout(l, t, u, v + 1)};
+        }
+
+        return idxs;
+    }();
+
+    BoysF2<l> boys_f;
+    std::array<double, l + 1> fnx;
+    std::array<double, n_rints> rints;
+    for (size_t ippair = 0; ippair < hdens.n_ppairs_; ippair++)
+    {
+        double p = hdens.exps_[ippair];
+        const double *xyz_p = &hdens.coords_[3 * ippair];
+        const double *coeffs = &hdens.coeffs_[ippair * n_hermites];
+
+        for (size_t ipoint = ipoint_begin; ipoint < ipoint_end; ipoint++)
+        {
+            std::array<double, 3> xyz_pc{xyz_p[0] - points[ipoint][0],
+                                         xyz_p[1] - points[ipoint][1],
+                                         xyz_p[2] - points[ipoint][2]};
+
+            double x = p * (xyz_pc[0] * xyz_pc[0] + xyz_pc[1] * xyz_pc[1] +
+                            xyz_pc[2] * xyz_pc[2]);
+
+            boys_f.calcFnx(x, &fnx[0]);
+            calcRInts<l>(p, &fnx[0], &xyz_pc[0], &rints[0]);
+
+            // -1 = charge of electron
+            double pot = 0;
+            for (int tuv = 0; tuv < n_hermites; tuv++)
+                pot += coeffs[tuv] * rints[idxs_rints[tuv][0]];
+            potential[ipoint] -= pot;
+
+            if constexpr (calc_field)
+            {
+                double field_x = 0, field_y = 0, field_z = 0;
+                for (int tuv = 0; tuv < n_hermites; tuv++)
+                {
+                    field_x += coeffs[tuv] * rints[idxs_rints[tuv][1]];
+                    field_y += coeffs[tuv] * rints[idxs_rints[tuv][2]];
+                    field_z += coeffs[tuv] * rints[idxs_rints[tuv][3]];
+                }
+
+                field[ipoint][0] -= field_x;
+                field[ipoint][1] -= field_y;
+                field[ipoint][2] -= field_z;
+            }
+        }
+    }
+}
+
+void lints::espBlock(const int lab, const bool calc_field, const HermiteDensities &hdens,
+                     const BoysGrid &boys_grid, const std::vector<std::array<double, 3>> &points,
+                     const size_t ipoint_begin, const size_t ipoint_end, double *potential,
+                     std::array<double, 3> *field)
+{
+    int l = calc_field ? lab + 1 : lab;
+    int n_hermites = numHermites(lab);
+    std::vector<std::array<int, 3>> hermite_idxs = getHermiteGaussianIdxs(lab);
+
+    for (size_t ippair = 0; ippair < hdens.n_ppairs_; ippair++)
+    {
+        double p = hdens.exps_[ippair];
+        const double *xyz_p = &hdens.coords_[3 * ippair];
+        const double *coeffs = &hdens.coeffs_[ippair * n_hermites];
+
+        for (size_t ipoint = ipoint_begin; ipoint < ipoint_end; ipoint++)
+        {
+            std::array<double, 3> xyz_pc{xyz_p[0] - points[ipoint][0],
+                                         xyz_p[1] - points[ipoint][1],
+                                         xyz_p[2] - points[ipoint][2]};
+
+            double x = p * (xyz_pc[0] * xyz_pc[0] + xyz_pc[1] * xyz_pc[1] +
+                            xyz_pc[2] * xyz_pc[2]);
+
+            std::vector<double> fnx = calcBoysF(l, x, boys_grid);
+
+            vec3d rints = calcRInts3D(l, p, &xyz_pc[0], &fnx[0]);
+
+            // -1 = charge of electron
+            double pot = 0, field_x = 0, field_y = 0, field_z = 0;
+            for (int tuv = 0; tuv < n_hermites; tuv++)
+            {
+                auto [t, u, v] = hermite_idxs[tuv];
+                pot += coeffs[tuv] * rints(t, u, v);
+
+                if (calc_field)
+                {
+                    field_x += coeffs[tuv] * rints(t + 1, u, v);
+                    field_y += coeffs[tuv] * rints(t, u + 1, v);
+                    field_z += coeffs[tuv] * rints(t, u, v + 1);
+                }
+            }
+            potential[ipoint] -= pot;
+
+            if (calc_field)
+            {
+                field[ipoint][0] -= field_x;
+                field[ipoint][1] -= field_y;
+                field[ipoint][2] -= field_z;
+            }
+        }
+    }
+}
+
+lints::ElectrostaticPotential
+lints::electrostaticPotential(const std::vector<std::array<double, 3>> &points,
+                              const Structure &structure, const vec2d &density,
+                              const bool calc_field, const double screening_thrs)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("electrostaticPotential(): the density has wrong dimensions");
+
+    std::vector<HermiteDensities> hdenss = hermiteDensities(structure, density, screening_thrs);
+
+    int lab_max = hdenss.size() - 1;
+    std::vector<BoysGrid> boys_grids(lab_max + 1);
+    for (int lab = _max_l_rollout_ + 1; lab <= lab_max; lab++)
+        boys_grids[lab] = BoysGrid(calc_field ? lab + 1 : lab);
+
+    size_t n_points = points.size();
+
+    ElectrostaticPotential esp;
+    esp.potential_.assign(n_points, 0);
+    if (calc_field)
+        esp.field_.assign(n_points, {0, 0, 0});
+
+    double *potential = esp.potential_.data();
+    std::array<double, 3> *field = esp.field_.data();
+
+    size_t n_blocks = (n_points + n_points_block - 1) / n_points_block;
+#pragma omp parallel for schedule(dynamic)
+    for (size_t iblock = 0; iblock < n_blocks; iblock++)
+    {
+        size_t ipoint_begin = iblock * n_points_block;
+        size_t ipoint_end = std::min(ipoint_begin + n_points_block, n_points);
+
+        for (int lab = 0; lab <= lab_max; lab++)
+        {
+            const HermiteDensities &hdens = hdenss[lab];
+            if (hdens.n_ppairs_ == 0)
+                continue;
+
+            if (lab <= _max_l_rollout_)
+            {
+                if (calc_field)
+                    esp_field_block_funs[lab](hdens, points, ipoint_begin, ipoint_end, potential,
+                                              field);
+                else
+                    esp_block_funs[lab](hdens, points, ipoint_begin, ipoint_end, potential,
+                                        field);
+            }
+            else
+                espBlock(lab, calc_field, hdens, boys_grids[lab], points, ipoint_begin,
+                         ipoint_end, potential, field);
+        }
+    }
+
+    return esp;
+}
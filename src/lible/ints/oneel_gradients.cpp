@@ -0,0 +1,556 @@
+#include <lible/ints/boys_function.hpp>
+#include <lible/ints/cart_exps.hpp>
+#include <lible/ints/defs.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/rints.hpp>
+#include <lible/ints/spherical_trafo.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Returns the density block of the shell pair, multiplied by its degeneracy in the
+    /// symmetric list of shell pairs.
+    vec2d densityBlock(size_t ipair, const ShellPairData &sp_data, const vec2d &density);
+
+    /// Contracts a batch of d/dA and d/dB one-electron integral derivatives with the density
+    /// block and adds the result to the gradient.
+    void contractD1Batch(size_t ipair, const ShellPairData &sp_data,
+                         const std::array<vec2d, 6> &ints_batch, const vec2d &density_block,
+                         vec2d &gradient);
+
+    /// Contracts a batch of second derivatives, [ideriv][jderiv] with {Ax, Ay, Az, Bx, By, Bz},
+    /// with the density block and adds the result to the Hessian.
+    void contractD2Batch(size_t ipair, const ShellPairData &sp_data,
+                         const arr2d<vec2d, 6, 6> &ints_batch, const vec2d &density_block,
+                         vec2d &hessian);
+
+    /// Calculates the operator part of the one-electron Coulomb integral derivatives for the
+    /// given charges, {x, y, z, q}, contracted with the density block, and adds the result to
+    /// `gradient_charges` as (charge, xyz). The density is transformed to the Hermite basis
+    /// once per primitive pair so that every charge costs only one dot product. The Boys
+    /// function must be initialized with l = la + lb + 1. The buffers of the Cartesian density,
+    /// (n_cart_a, n_cart_b), and the Hermite density, numHermites(la + lb), are given by the
+    /// caller, so that they can be reused for all the shell pairs of a thread.
+    void externalChargesOperatorD1Contracted(size_t ipair,
+                                             const std::vector<std::array<double, 4>> &charges,
+                                             const vec2d &density_block,
+                                             const BoysGrid &boys_grid,
+                                             const ShellPairData &sp_data, vec2d &density_cart,
+                                             std::vector<double> &density_hermite,
+                                             vec2d &gradient_charges);
+
+    /// Adds the contributions of a primitive pair, with the exponent p, the center P and the
+    /// Hermite density in the order of getHermiteGaussianIdxs(lab), to the derivatives with
+    /// respect to the charges. Explicitly rolled out for each L.
+    template <int lab>
+    void chargesD1Primitive(double p, const std::array<double, 3> &xyz_p,
+                            const double *density_hermite,
+                            const std::vector<std::array<double, 4>> &charges,
+                            vec2d &gradient_charges);
+
+    /// Same as above for arbitrary L. The Boys function must be initialized with l = lab + 1.
+    void chargesD1Primitive(int lab, double p, const std::array<double, 3> &xyz_p,
+                            const double *density_hermite,
+                            const std::vector<std::array<double, 4>> &charges,
+                            const BoysGrid &boys_grid, vec2d &gradient_charges);
+
+    using charges_d1_primitive_fun_t = void (*)(double p, const std::array<double, 3> &xyz_p,
+                                                const double *density_hermite,
+                                                const std::vector<std::array<double, 4>> &charges,
+                                                vec2d &gradient_charges);
+
+    template <size_t... labs>
+    constexpr std::array<charges_d1_primitive_fun_t, sizeof...(labs)>
+    chargesD1PrimitiveFuns(std::index_sequence<labs...>)
+    {
+        return {&chargesD1Primitive<labs>...};
+    }
+
+    /// Rolled-out charge derivative functions for L = 0,...,_max_l_rollout_.
+    constexpr auto charges_d1_primitive_funs = chargesD1PrimitiveFuns(
+            std::make_index_sequence<_max_l_rollout_ + 1>());
+}
+
+lible::vec2d lints::densityBlock(const size_t ipair, const ShellPairData &sp_data,
+                                 const vec2d &density)
+{
+    int n_sph_a = numSphericals(sp_data.la_);
+    int n_sph_b = numSphericals(sp_data.lb_);
+    size_t ofs_a = sp_data.offsets_sph_[2 * ipair + 0];
+    size_t ofs_b = sp_data.offsets_sph_[2 * ipair + 1];
+
+    double deg = (sp_data.shell_idxs_[2 * ipair + 0] == sp_data.shell_idxs_[2 * ipair + 1]) ?
+                     1.0 : 2.0;
+
+    vec2d density_block(Fill(0), n_sph_a, n_sph_b);
+    for (int mu = 0; mu < n_sph_a; mu++)
+        for (int nu = 0; nu < n_sph_b; nu++)
+            density_block(mu, nu) = deg * density(ofs_a + mu, ofs_b + nu);
+
+    return density_block;
+}
+
+void lints::contractD1Batch(const size_t ipair, const ShellPairData &sp_data,
+                            const std::array<vec2d, 6> &ints_batch, const vec2d &density_block,
+                            vec2d &gradient)
+{
+    size_t atom_a = sp_data.atomic_idxs_[2 * ipair + 0];
+    size_t atom_b = sp_data.atomic_idxs_[2 * ipair + 1];
+
+    for (int icart = 0; icart < 3; icart++)
+    {
+        double grad_a = 0, grad_b = 0;
+        for (size_t i = 0; i < density_block.size(); i++)
+        {
+            grad_a += density_block[i] * ints_batch[icart][i];
+            grad_b += density_block[i] * ints_batch[3 + icart][i];
+        }
+
+        gradient(atom_a, icart) += grad_a;
+        gradient(atom_b, icart) += grad_b;
+    }
+}
+
+void lints::contractD2Batch(const size_t ipair, const ShellPairData &sp_data,
+                            const arr2d<vec2d, 6, 6> &ints_batch, const vec2d &density_block,
+                            vec2d &hessian)
+{
+    std::array<size_t, 2> atoms{sp_data.atomic_idxs_[2 * ipair + 0],
+                                sp_data.atomic_idxs_[2 * ipair + 1]};
+
+    for (int ideriv = 0; ideriv < 6; ideriv++)
+        for (int jderiv = 0; jderiv < 6; jderiv++)
+        {
+            double contr = 0;
+            for (size_t i = 0; i < density_block.size(); i++)
+                contr += density_block[i] * ints_batch[ideriv][jderiv][i];
+
+            hessian(3 * atoms[ideriv / 3] + ideriv % 3, 3 * atoms[jderiv / 3] + jderiv % 3) +=
+                contr;
+        }
+}
+
+template <int lab>
+void lints::chargesD1Primitive(const double p, const std::array<double, 3> &xyz_p,
+                               const double *density_hermite,
+                               const std::vector<std::array<double, 4>> &charges,
+                               vec2d &gradient_charges)
+{
+    constexpr int l = lab + 1;
+    constexpr int n_hermites = numHermitesC(lab);
+    constexpr int n_rints = numHermitesC(l) + l;
+
+    // Positions of R_{t+1,u,v}, R_{t,u+1,v} and R_{t,u,v+1} in the R-integrals.
+    constexpr auto idxs_rints = []()
+    {
+        constexpr auto hermite_idxs = generateHermiteIdxs<lab>();
+
+        std::array<std::array<int, 3>, n_hermites> idxs{};
+        for (int tuv = 0; tuv < n_hermites; tuv++)
+        {
+            auto [t, u, v] = hermite_idxs[tuv];
+            idxs[tuv] = {indexRRollout(l, t + 1, u, v), indexRRollout(l, t, u + 1, v),
+                         indexRRollout(l, t, u, v + 1)};
+        }
+
+        return idxs;
+    }();
+
+    BoysF2<l> boys_f;
+    std::array<double, l + 1> fnx;
+    std::array<double, n_rints> rints;
+    for (size_t icharge = 0; icharge < charges.size(); icharge++)
+    {
+        auto [xc, yc, zc, charge] = charges[icharge];
+
+        std::array<double, 3> xyz_pc{xyz_p[0] - xc, xyz_p[1] - yc, xyz_p[2] - zc};
+
+        double x = p * (xyz_pc[0] * xyz_pc[0] + xyz_pc[1] * xyz_pc[1] + xyz_pc[2] * xyz_pc[2]);
+
+        boys_f.calcFnx(x, &fnx[0]);
+        calcRInts<l>(p, &fnx[0], &xyz_pc[0], &rints[0]);
+
+        double grad_x = 0, grad_y = 0, grad_z = 0;
+        for (int tuv = 0; tuv < n_hermites; tuv++)
+        {
+            grad_x += density_hermite[tuv] * rints[idxs_rints[tuv][0]];
+            grad_y += density_hermite[tuv] * rints[idxs_rints[tuv][1]];
+            grad_z += density_hermite[tuv] * rints[idxs_rints[tuv][2]];
+        }
+
+        gradient_charges(icharge, 0) += charge * grad_x;
+        gradient_charges(icharge, 1) += charge * grad_y;
+        gradient_charges(icharge, 2) += charge * grad_z;
+    }
+}
+
+void lints::chargesD1Primitive(const int lab, const double p, const std::array<double, 3> &xyz_p,
+                               const double *density_hermite,
+                               const std::vector<std::array<double, 4>> &charges,
+                               const BoysGrid &boys_grid, vec2d &gradient_charges)
+{
+    std::vector<std::array<int, 3>> hermite_idxs = getHermiteGaussianIdxs(lab);
+
+    for (size_t icharge = 0; icharge < charges.size(); icharge++)
+    {
+        auto [xc, yc, zc, charge] = charges[icharge];
+
+        std::array<double, 3> xyz_pc{xyz_p[0] - xc, xyz_p[1] - yc, xyz_p[2] - zc};
+
+        double x = p * (xyz_pc[0] * xyz_pc[0] + xyz_pc[1] * xyz_pc[1] + xyz_pc[2] * xyz_pc[2]);
+
+        std::vector<double> fnx = calcBoysF(lab + 1, x, boys_grid);
+
+        vec3d rints = calcRInts3D(lab + 1, p, &xyz_pc[0], &fnx[0]);
+
+        double grad_x = 0, grad_y = 0, grad_z = 0;
+        for (size_t tuv = 0; tuv < hermite_idxs.size(); tuv++)
+        {
+            auto [t, u, v] = hermite_idxs[tuv];
+            grad_x += density_hermite[tuv] * rints(t + 1, u, v);
+            grad_y += density_hermite[tuv] * rints(t, u + 1, v);
+            grad_z += density_hermite[tuv] * rints(t, u, v + 1);
+        }
+
+        gradient_charges(icharge, 0) += charge * grad_x;
+        gradient_charges(icharge, 1) += charge * grad_y;
+        gradient_charges(icharge, 2) += charge * grad_z;
+    }
+}
+
+void lints::externalChargesOperatorD1Contracted(const size_t ipair,
+                                                const std::vector<std::array<double, 4>> &charges,
+                                                const vec2d &density_block,
+                                                const BoysGrid &boys_grid,
+                                                const ShellPairData &sp_data,
+                                                vec2d &density_cart,
+                                                std::vector<double> &density_hermite,
+                                                vec2d &gradient_charges)
+{
+    if (boys_grid.getN() - 1 != sp_data.la_ + sp_data.lb_)
+        throw std::runtime_error("externalChargesOperatorD1Contracted(): wrong n-value given to "
+                                 "`BoysGrid`");
+
+    auto [la, lb] = sp_data.getLPair();
+    int lab = la + lb;
+
+    size_t ofs_prim = sp_data.offsets_primitives_[ipair];
+    const double *exps = &sp_data.exps_[ofs_prim];
+    const double *coeffs = &sp_data.coeffs_[ofs_prim];
+    const double *xyz_a = &sp_data.coords_[6 * ipair + 0];
+    const double *xyz_b = &sp_data.coords_[6 * ipair + 3];
+
+    const auto &cart_exps_a = cart_exps[la];
+    const auto &cart_exps_b = cart_exps[lb];
+
+    // Transforms the normalized spherical density block to the Cartesian basis.
+    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
+    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
+
+    SphTrafoCSRView trafo_a = sphTrafoCSR(la);
+    SphTrafoCSRView trafo_b = sphTrafoCSR(lb);
+
+    density_cart.set(0);
+    for (int mu = 0; mu < trafo_a.n_sph_; mu++)
+        for (int ka = trafo_a.row_ptrs_[mu]; ka < trafo_a.row_ptrs_[mu + 1]; ka++)
+            for (int nu = 0; nu < trafo_b.n_sph_; nu++)
+                for (int kb = trafo_b.row_ptrs_[nu]; kb < trafo_b.row_ptrs_[nu + 1]; kb++)
+                {
+                    int mu_ = trafo_a.cart_idxs_[ka];
+                    int nu_ = trafo_b.cart_idxs_[kb];
+                    double val_a = trafo_a.vals_[ka];
+                    double val_b = trafo_b.vals_[kb];
+                    double norm_a = sp_data.norms_[ofs_norm_a + mu];
+                    double norm_b = sp_data.norms_[ofs_norm_b + nu];
+                    density_cart(mu_, nu_) +=
+                            val_a * val_b * norm_a * norm_b * density_block(mu, nu);
+                }
+
+    std::array<vec3d, 3> ecoeffs;
+
+    for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
+    {
+        double a = exps[iab * 2];
+        double b = exps[iab * 2 + 1];
+        double da = coeffs[iab * 2];
+        double db = coeffs[iab * 2 + 1];
+
+        double p = a + b;
+        double fac = 2 * (M_PI / p) * da * db;
+
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
+
+        // Density in the Hermite Gaussian basis, sum_{mu nu} D_{mu nu} E^{mu nu}_{tuv}, in the
+        // order of getHermiteGaussianIdxs(lab).
+        std::fill(density_hermite.begin(), density_hermite.end(), 0);
+        for (const auto &[i, j, k, mu] : cart_exps_a)
+            for (const auto &[i_, j_, k_, nu] : cart_exps_b)
+            {
+                double dens = fac * density_cart(mu, nu);
+                for (int t = 0; t <= i + i_; t++)
+                    for (int u = 0; u <= j + j_; u++)
+                        for (int v = 0; v <= k + k_; v++)
+                        {
+                            int tuv = numHermites(t + u + v - 1) + indexCart(t, u, v);
+                            density_hermite[tuv] += dens * Ex(i, i_, t) * Ey(j, j_, u) *
+                                                    Ez(k, k_, v);
+                        }
+            }
+
+        std::array<double, 3> xyz_p{
+            (a * xyz_a[0] + b * xyz_b[0]) / p,
+            (a * xyz_a[1] + b * xyz_b[1]) / p,
+            (a * xyz_a[2] + b * xyz_b[2]) / p
+        };
+
+        if (lab <= _max_l_rollout_)
+            charges_d1_primitive_funs[lab](p, xyz_p, &density_hermite[0], charges,
+                                           gradient_charges);
+        else
+            chargesD1Primitive(lab, p, xyz_p, &density_hermite[0], charges, boys_grid,
+                               gradient_charges);
+    }
+}
+
+lible::vec2d lints::overlapGradient(const Structure &structure,
+                                    const vec2d &density_energy_weighted)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density_energy_weighted.dim<0>() != dim_ao || density_energy_weighted.dim<1>() != dim_ao)
+        throw std::runtime_error("overlapGradient(): dimensions of the density matrix don't "
+                                 "match the number of AOs");
+
+    int l_max = structure.getMaxL();
+    size_t n_centers = structure.getNCenters();
+
+    vec2d gradient(Fill(0), n_centers, 3);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel
+            {
+                vec2d gradient_omp(Fill(0), n_centers, 3);
+
+#pragma omp for
+                for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+                {
+                    std::array<vec2d, 6> ints_batch = overlapD1Kernel(ipair, sp_data);
+
+                    vec2d density_block = densityBlock(ipair, sp_data, density_energy_weighted);
+
+                    contractD1Batch(ipair, sp_data, ints_batch, density_block, gradient_omp);
+                }
+
+#pragma omp critical
+                {
+                    gradient += gradient_omp;
+                }
+            }
+        }
+
+    return gradient;
+}
+
+lible::vec2d lints::kineticEnergyGradient(const Structure &structure, const vec2d &density)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("kineticEnergyGradient(): dimensions of the density matrix "
+                                 "don't match the number of AOs");
+
+    int l_max = structure.getMaxL();
+    size_t n_centers = structure.getNCenters();
+
+    vec2d gradient(Fill(0), n_centers, 3);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel
+            {
+                vec2d gradient_omp(Fill(0), n_centers, 3);
+
+#pragma omp for
+                for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+                {
+                    std::array<vec2d, 6> ints_batch = kineticEnergyD1Kernel(ipair, sp_data);
+
+                    vec2d density_block = densityBlock(ipair, sp_data, density);
+
+                    contractD1Batch(ipair, sp_data, ints_batch, density_block, gradient_omp);
+                }
+
+#pragma omp critical
+                {
+                    gradient += gradient_omp;
+                }
+            }
+        }
+
+    return gradient;
+}
+
+std::pair<lible::vec2d, lible::vec2d>
+lints::externalChargesGradient(const std::vector<std::array<double, 4>> &point_charges,
+                               const Structure &structure, const vec2d &density)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("externalChargesGradient(): dimensions of the density matrix "
+                                 "don't match the number of AOs");
+
+    int l_max = structure.getMaxL();
+    size_t n_centers = structure.getNCenters();
+    size_t n_charges = point_charges.size();
+
+    vec2d gradient(Fill(0), n_centers, 3);
+    vec2d gradient_charges(Fill(0), n_charges, 3);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+            int lab = la + lb;
+            BoysGrid boys_grid(lab + 1);
+
+#pragma omp parallel
+            {
+                vec2d gradient_omp(Fill(0), n_centers, 3);
+                vec2d gradient_charges_omp(Fill(0), n_charges, 3);
+                vec2d density_cart(Fill(0), numCartesians(la), numCartesians(lb));
+                std::vector<double> density_hermite(numHermites(lab));
+
+#pragma omp for schedule(dynamic)
+                for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+                {
+                    vec2d density_block = densityBlock(ipair, sp_data, density);
+
+                    std::array<vec2d, 6> ints_batch = externalChargesD1Kernel(ipair, point_charges,
+                                                                              boys_grid, sp_data);
+
+                    contractD1Batch(ipair, sp_data, ints_batch, density_block, gradient_omp);
+
+                    externalChargesOperatorD1Contracted(ipair, point_charges, density_block,
+                                                        boys_grid, sp_data, density_cart,
+                                                        density_hermite, gradient_charges_omp);
+                }
+
+#pragma omp critical
+                {
+                    gradient += gradient_omp;
+                    gradient_charges += gradient_charges_omp;
+                }
+            }
+        }
+
+    return {gradient, gradient_charges};
+}
+
+lible::vec2d lints::overlapHessian(const Structure &structure,
+                                   const vec2d &density_energy_weighted)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density_energy_weighted.dim<0>() != dim_ao || density_energy_weighted.dim<1>() != dim_ao)
+        throw std::runtime_error("overlapHessian(): dimensions of the density matrix don't "
+                                 "match the number of AOs");
+
+    int l_max = structure.getMaxL();
+    size_t n_coords = 3 * structure.getNCenters();
+
+    vec2d hessian(Fill(0), n_coords, n_coords);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel
+            {
+                vec2d hessian_omp(Fill(0), n_coords, n_coords);
+
+#pragma omp for
+                for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+                {
+                    arr2d<vec2d, 6, 6> ints_batch = overlapD2Kernel(ipair, sp_data);
+
+                    vec2d density_block = densityBlock(ipair, sp_data, density_energy_weighted);
+
+                    contractD2Batch(ipair, sp_data, ints_batch, density_block, hessian_omp);
+                }
+
+#pragma omp critical
+                {
+                    hessian += hessian_omp;
+                }
+            }
+        }
+
+    return hessian;
+}
+
+lible::vec2d lints::kineticEnergyHessian(const Structure &structure, const vec2d &density)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("kineticEnergyHessian(): dimensions of the density matrix "
+                                 "don't match the number of AOs");
+
+    int l_max = structure.getMaxL();
+    size_t n_coords = 3 * structure.getNCenters();
+
+    vec2d hessian(Fill(0), n_coords, n_coords);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel
+            {
+                vec2d hessian_omp(Fill(0), n_coords, n_coords);
+
+#pragma omp for
+                for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+                {
+                    arr2d<vec2d, 6, 6> ints_batch = kineticEnergyD2Kernel(ipair, sp_data);
+
+                    vec2d density_block = densityBlock(ipair, sp_data, density);
+
+                    contractD2Batch(ipair, sp_data, ints_batch, density_block, hessian_omp);
+                }
+
+#pragma omp critical
+                {
+                    hessian += hessian_omp;
+                }
+            }
+        }
+
+    return hessian;
+}
+
+lible::vec2d lints::nuclearAttractionGradient(const Structure &structure, const vec2d &density)
+{
+    std::vector<std::array<double, 4>> charges = structure.getZs();
+
+    auto [gradient, gradient_charges] = externalChargesGradient(charges, structure, density);
+
+    // The operator part goes to the atoms carrying the nuclear charges.
+    for (size_t iatom = 0; iatom < charges.size(); iatom++)
+        for (int icart = 0; icart < 3; icart++)
+            gradient(iatom, icart) += gradient_charges(iatom, icart);
+
+    return gradient;
+}
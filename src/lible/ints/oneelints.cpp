@@ -2,6 +2,10 @@
 #include <lible/ints/ints.hpp>
 #include <lible/ints/rints.hpp>
 #include <lible/ints/spherical_trafo.hpp>
+#include <lible/ints/symmetry.hpp>
+
+#include <algorithm>
+#include <format>
 
 namespace lints = lible::ints;
 
@@ -11,6 +15,75 @@ namespace lible::ints
     double kineticEKernelKernel(double b, double b2, double fac, const vec3d &ecoeffs_x,
                                 const vec3d &ecoeffs_y, const vec3d &ecoeffs_z,
                                 const std::array<int, 3> &ijk, const std::array<int, 3> &i_j_k_);
+
+    /// Copies the integrals of a symmetry-unique shell pair to all of its images under the given
+    /// point group operations, (g(a)|g(b)) = s_a s_b (a|b).
+    void transferInts1ElSymm(size_t ipair, const ShellPairData &sp_data, const vec2d &ints_ipair,
+                             const SymmetryOps &ops, const ShellSymmetryMap &shell_map,
+                             vec2d &ints);
+
+    /// Transforms the `n_blocks` consecutive Cartesian blocks of the shell pair, (n_cart_a,
+    /// n_cart_b) each, to the normalized spherical basis with one trafo2SphericalBatch() call.
+    std::vector<vec2d> trafo2SphericalNorm(size_t ipair, const ShellPairData &sp_data,
+                                           size_t n_blocks, const double *ints_cart);
+
+    /// Completes a batch of second derivatives from the Cartesian d^2/dA_i dA_j blocks,
+    /// (3, 3, n_cart_a, n_cart_b), using d/dB = -d/dA for the two-center integrals. Only the
+    /// blocks with i <= j are read. Transforms the batch to the normalized spherical basis.
+    arr2d<vec2d, 6, 6> completeD2Batch(size_t ipair, const ShellPairData &sp_data,
+                                       const vec4d &ints_cart_aa);
+
+    /// Driver for 'coreHamiltonian'. Calculates the dipole moment integrals only if
+    /// `calc_dipole` is true.
+    CoreHamiltonian calcCoreHamiltonian(const Structure &structure, bool calc_dipole,
+                                        const std::array<double, 3> &origin);
+}
+
+void lints::transferInts1ElSymm(const size_t ipair, const ShellPairData &sp_data,
+                                const vec2d &ints_ipair, const SymmetryOps &ops,
+                                const ShellSymmetryMap &shell_map, vec2d &ints)
+{
+    size_t ofs_a = sp_data.offsets_sph_[2 * ipair + 0];
+    size_t ofs_b = sp_data.offsets_sph_[2 * ipair + 1];
+    for (size_t iop : ops)
+    {
+        const auto &aos = shell_map.aos_[iop];
+        const auto &signs = shell_map.signs_[iop];
+        for (size_t mu = 0; mu < ints_ipair.dim<0>(); mu++)
+            for (size_t nu = 0; nu < ints_ipair.dim<1>(); nu++)
+            {
+                size_t mu_ = aos[ofs_a + mu];
+                size_t nu_ = aos[ofs_b + nu];
+                double integral = signs[ofs_a + mu] * signs[ofs_b + nu] * ints_ipair(mu, nu);
+
+                ints(mu_, nu_) = integral;
+                ints(nu_, mu_) = integral;
+            }
+    }
+}
+
+std::vector<lible::vec2d> lints::trafo2SphericalNorm(const size_t ipair,
+                                                     const ShellPairData &sp_data,
+                                                     const size_t n_blocks,
+                                                     const double *ints_cart)
+{
+    auto [la, lb] = sp_data.getLPair();
+    int n_sph_a = numSphericals(la);
+    int n_sph_b = numSphericals(lb);
+
+    std::vector<double> ints_sph(n_blocks * n_sph_a * n_sph_b);
+    trafo2SphericalBatch(la, lb, n_blocks, ints_cart, ints_sph.data());
+
+    const double *norms_a = &sp_data.norms_[sp_data.offsets_norms_[2 * ipair + 0]];
+    const double *norms_b = &sp_data.norms_[sp_data.offsets_norms_[2 * ipair + 1]];
+
+    std::vector<vec2d> blocks(n_blocks, vec2d(n_sph_a, n_sph_b));
+    for (size_t iblock = 0, idx = 0; iblock < n_blocks; iblock++)
+        for (int mu = 0; mu < n_sph_a; mu++)
+            for (int nu = 0; nu < n_sph_b; nu++, idx++)
+                blocks[iblock](mu, nu) = ints_sph[idx] * (norms_a[mu] * norms_b[nu]);
+
+    return blocks;
 }
 
 double lints::kineticEKernelKernel(const double b, const double b2, const double fac,
@@ -67,6 +140,7 @@ lible::vec2d lints::overlapKernel(const size_t ipair, const ShellPairData &sp_da
     const auto &cart_exps_b = cart_exps[lb];
 
     vec2d ints_cart(Fill(0), numCartesians(la), numCartesians(lb));
+    std::array<vec3d, 3> ecoeffs;
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
         double a = exps[iab * 2];
@@ -78,7 +152,8 @@ lible::vec2d lints::overlapKernel(const size_t ipair, const ShellPairData &sp_da
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         for (const auto &[i, j, k, mu] : cart_exps_a)
             for (const auto &[i_, j_, k_, nu] : cart_exps_b)
@@ -113,9 +188,9 @@ std::array<lible::vec2d, 6> lints::overlapD1Kernel(const size_t ipair, const She
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 6> ints_cart;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 6, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -128,39 +203,29 @@ std::array<lible::vec2d, 6> lints::overlapD1Kernel(const size_t ipair, const She
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
-        auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b, {Ex, Ey, Ez});
+        auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
 
         for (const auto &[i, j, k, mu] : cart_exps_a)
             for (const auto &[i_, j_, k_, nu] : cart_exps_b)
             {
                 // d/dA
-                ints_cart[0](mu, nu) += fac * E1x(i, i_, 0) * Ey(j, j_, 0) * Ez(k, k_, 0);
-                ints_cart[1](mu, nu) += fac * Ex(i, i_, 0) * E1y(j, j_, 0) * Ez(k, k_, 0);
-                ints_cart[2](mu, nu) += fac * Ex(i, i_, 0) * Ey(j, j_, 0) * E1z(k, k_, 0);
+                ints_cart(0, mu, nu) += fac * E1x(i, i_, 0) * Ey(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(1, mu, nu) += fac * Ex(i, i_, 0) * E1y(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(2, mu, nu) += fac * Ex(i, i_, 0) * Ey(j, j_, 0) * E1z(k, k_, 0);
 
                 // d/dB
-                ints_cart[3](mu, nu) -= fac * E1x(i, i_, 0) * Ey(j, j_, 0) * Ez(k, k_, 0);
-                ints_cart[4](mu, nu) -= fac * Ex(i, i_, 0) * E1y(j, j_, 0) * Ez(k, k_, 0);
-                ints_cart[5](mu, nu) -= fac * Ex(i, i_, 0) * Ey(j, j_, 0) * E1z(k, k_, 0);
+                ints_cart(3, mu, nu) -= fac * E1x(i, i_, 0) * Ey(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(4, mu, nu) -= fac * Ex(i, i_, 0) * E1y(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(5, mu, nu) -= fac * Ex(i, i_, 0) * Ey(j, j_, 0) * E1z(k, k_, 0);
             }
     }
 
     std::array<vec2d, 6> ints_sph;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_sph[ideriv] = trafo2Spherical(la, lb, ints_cart[ideriv]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        for (size_t mu = 0; mu < ints_sph[ideriv].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[ideriv].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[ideriv](mu, nu) *= norm_a * norm_b;
-            }
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 6, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -175,7 +240,8 @@ lible::vec2d lints::overlap(const Structure &structure)
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
 #pragma omp parallel for
             for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -196,6 +262,40 @@ lible::vec2d lints::overlap(const Structure &structure)
     return ints;
 }
 
+lible::vec2d lints::overlap(const Structure &structure, const PointGroup &point_group)
+{
+    if (point_group.order() == 1)
+        return overlap(structure);
+
+    ShellSymmetryMap shell_map = shellSymmetryMap(point_group, structure.getShellsView());
+
+    int l_max = structure.getMaxL();
+    size_t dim_ao = structure.getDimAO();
+
+    vec2d ints(Fill(0), dim_ao, dim_ao);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel for
+            for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+            {
+                SymmetryOps ops = uniquePairOps(sp_data.shell_idxs_[2 * ipair + 0],
+                                                sp_data.shell_idxs_[2 * ipair + 1], shell_map);
+                if (ops.empty())
+                    continue;
+
+                vec2d ints_ipair = overlapKernel(ipair, sp_data);
+
+                transferInts1ElSymm(ipair, sp_data, ints_ipair, ops, shell_map, ints);
+            }
+        }
+
+    return ints;
+}
+
 lible::vec2d lints::kineticEnergyKernel(const size_t ipair, const ShellPairData &sp_data)
 {
     // Formula taken from https://gqcg-res.github.io/knowdes/the-mcmurchie-davidson-integral-scheme.html.
@@ -212,6 +312,7 @@ lible::vec2d lints::kineticEnergyKernel(const size_t ipair, const ShellPairData
     const auto &cart_exps_b = cart_exps[lb];
 
     vec2d ints_cart(Fill(0), numCartesians(la), numCartesians(lb));
+    std::array<vec3d, 3> ecoeffs;
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
         double a = exps[iab * 2];
@@ -224,7 +325,8 @@ lible::vec2d lints::kineticEnergyKernel(const size_t ipair, const ShellPairData
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb + 2, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb + 2, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         for (const auto &[i, j, k, mu] : cart_exps_a)
             for (const auto &[i_, j_, k_, nu] : cart_exps_b)
@@ -287,9 +389,9 @@ std::array<lible::vec2d, 6> lints::kineticEnergyD1Kernel(const size_t ipair, con
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 6> ints_cart;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 6, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -303,10 +405,11 @@ std::array<lible::vec2d, 6> lints::kineticEnergyD1Kernel(const size_t ipair, con
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb + 2, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb + 2, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb + 2, xyz_a, xyz_b,
-                                                       {Ex, Ey, Ez});
+                                                       ecoeffs);
 
         for (const auto &[i, j, k, mu] : cart_exps_a)
             for (const auto &[i_, j_, k_, nu] : cart_exps_b)
@@ -316,35 +419,170 @@ std::array<lible::vec2d, 6> lints::kineticEnergyD1Kernel(const size_t ipair, con
                 double kin_z = kineticEKernelKernel(b, b2, fac, Ex, Ey, E1z, {i, j, k}, {i_, j_, k_});
 
                 // d/dA
-                ints_cart[0](mu, nu) += kin_x;
-                ints_cart[1](mu, nu) += kin_y;
-                ints_cart[2](mu, nu) += kin_z;
+                ints_cart(0, mu, nu) += kin_x;
+                ints_cart(1, mu, nu) += kin_y;
+                ints_cart(2, mu, nu) += kin_z;
 
                 // d/dB
-                ints_cart[3](mu, nu) -= kin_x;
-                ints_cart[4](mu, nu) -= kin_y;
-                ints_cart[5](mu, nu) -= kin_z;
+                ints_cart(3, mu, nu) -= kin_x;
+                ints_cart(4, mu, nu) -= kin_y;
+                ints_cart(5, mu, nu) -= kin_z;
             }
     }
 
     std::array<vec2d, 6> ints_sph;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_sph[ideriv] = trafo2Spherical(la, lb, ints_cart[ideriv]);
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 6, ints_cart.memptr()),
+                      ints_sph.begin());
 
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        for (size_t mu = 0; mu < ints_sph[ideriv].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[ideriv].dim<1>(); nu++)
+    return ints_sph;
+}
+
+lible::arr2d<lible::vec2d, 6, 6>
+lints::completeD2Batch(const size_t ipair, const ShellPairData &sp_data,
+                       const vec4d &ints_cart_aa)
+{
+    arr2d<vec2d, 6, 6> ints_sph;
+    for (int ideriv = 0; ideriv < 3; ideriv++)
+    {
+        // The blocks with jderiv >= ideriv are consecutive.
+        std::vector<vec2d> ints_aa = trafo2SphericalNorm(ipair, sp_data, 3 - ideriv,
+                                                         &ints_cart_aa(ideriv, ideriv, 0, 0));
+        for (int jderiv = ideriv; jderiv < 3; jderiv++)
+        {
+            const vec2d &ints_ij = ints_aa[jderiv - ideriv];
+
+            // AA, AB, BA and BB, and the same for the swapped derivatives.
+            for (auto [i, j] : {std::pair{ideriv, jderiv}, std::pair{jderiv, ideriv}})
             {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[ideriv](mu, nu) *= norm_a * norm_b;
+                ints_sph[i][j] = ints_ij;
+                ints_sph[i][3 + j] = -1 * ints_ij;
+                ints_sph[3 + i][j] = -1 * ints_ij;
+                ints_sph[3 + i][3 + j] = ints_ij;
+
+                if (ideriv == jderiv)
+                    break;
             }
+        }
+    }
 
     return ints_sph;
 }
 
+lible::arr2d<lible::vec2d, 6, 6> lints::overlapD2Kernel(const size_t ipair,
+                                                       const ShellPairData &sp_data)
+{
+    size_t ofs_prim = sp_data.offsets_primitives_[ipair];
+    const double *exps = &sp_data.exps_[ofs_prim];
+    const double *coeffs = &sp_data.coeffs_[ofs_prim];
+    const double *xyz_a = &sp_data.coords_[6 * ipair + 0];
+    const double *xyz_b = &sp_data.coords_[6 * ipair + 3];
+
+    auto [la, lb] = sp_data.getLPair();
+    const auto &cart_exps_a = cart_exps[la];
+    const auto &cart_exps_b = cart_exps[lb];
+
+    vec4d ints_cart(Fill(0), 3, 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
+
+    for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
+    {
+        double a = exps[iab * 2];
+        double b = exps[iab * 2 + 1];
+        double da = coeffs[iab * 2];
+        double db = coeffs[iab * 2 + 1];
+
+        double p = a + b;
+        double dadb = da * db;
+        double fac = dadb * std::pow(M_PI / p, 1.5);
+
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
+
+        auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+
+        auto [E2x, E2y, E2z] = ecoeffsPrimitivePair_n2(a, b, la, lb, xyz_a, xyz_b, ecoeffs,
+                                                       {E1x, E1y, E1z});
+
+        for (const auto &[i, j, k, mu] : cart_exps_a)
+            for (const auto &[i_, j_, k_, nu] : cart_exps_b)
+            {
+                ints_cart(0, 0, mu, nu) += fac * E2x(i, i_, 0) * Ey(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(0, 1, mu, nu) += fac * E1x(i, i_, 0) * E1y(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(0, 2, mu, nu) += fac * E1x(i, i_, 0) * Ey(j, j_, 0) * E1z(k, k_, 0);
+                ints_cart(1, 1, mu, nu) += fac * Ex(i, i_, 0) * E2y(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(1, 2, mu, nu) += fac * Ex(i, i_, 0) * E1y(j, j_, 0) * E1z(k, k_, 0);
+                ints_cart(2, 2, mu, nu) += fac * Ex(i, i_, 0) * Ey(j, j_, 0) * E2z(k, k_, 0);
+            }
+    }
+
+    return completeD2Batch(ipair, sp_data, ints_cart);
+}
+
+lible::arr2d<lible::vec2d, 6, 6> lints::kineticEnergyD2Kernel(const size_t ipair,
+                                                             const ShellPairData &sp_data)
+{
+    size_t ofs_prim = sp_data.offsets_primitives_[ipair];
+    const double *exps = &sp_data.exps_[ofs_prim];
+    const double *coeffs = &sp_data.coeffs_[ofs_prim];
+    const double *xyz_a = &sp_data.coords_[6 * ipair + 0];
+    const double *xyz_b = &sp_data.coords_[6 * ipair + 3];
+
+    auto [la, lb] = sp_data.getLPair();
+    const auto &cart_exps_a = cart_exps[la];
+    const auto &cart_exps_b = cart_exps[lb];
+
+    vec4d ints_cart(Fill(0), 3, 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
+
+    for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
+    {
+        double a = exps[iab * 2];
+        double b = exps[iab * 2 + 1];
+        double b2 = b * b;
+        double da = coeffs[iab * 2];
+        double db = coeffs[iab * 2 + 1];
+
+        double p = a + b;
+        double dadb = da * db;
+        double fac = dadb * std::pow(M_PI / p, 1.5);
+
+        ecoeffsPrimitivePair(a, b, la, lb + 2, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
+
+        auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb + 2, xyz_a, xyz_b,
+                                                       ecoeffs);
+
+        auto [E2x, E2y, E2z] = ecoeffsPrimitivePair_n2(a, b, la, lb + 2, xyz_a, xyz_b,
+                                                       ecoeffs, {E1x, E1y, E1z});
+
+        // The kinetic energy integral is linear in the expansion coefficients of each
+        // direction, so the derivatives follow from replacing them by their derivatives.
+        for (const auto &[i, j, k, mu] : cart_exps_a)
+            for (const auto &[i_, j_, k_, nu] : cart_exps_b)
+            {
+                std::array<int, 3> ijk{i, j, k};
+                std::array<int, 3> i_j_k_{i_, j_, k_};
+
+                ints_cart(0, 0, mu, nu) += kineticEKernelKernel(b, b2, fac, E2x, Ey, Ez, ijk,
+                                                                i_j_k_);
+                ints_cart(0, 1, mu, nu) += kineticEKernelKernel(b, b2, fac, E1x, E1y, Ez, ijk,
+                                                                i_j_k_);
+                ints_cart(0, 2, mu, nu) += kineticEKernelKernel(b, b2, fac, E1x, Ey, E1z, ijk,
+                                                                i_j_k_);
+                ints_cart(1, 1, mu, nu) += kineticEKernelKernel(b, b2, fac, Ex, E2y, Ez, ijk,
+                                                                i_j_k_);
+                ints_cart(1, 2, mu, nu) += kineticEKernelKernel(b, b2, fac, Ex, E1y, E1z, ijk,
+                                                                i_j_k_);
+                ints_cart(2, 2, mu, nu) += kineticEKernelKernel(b, b2, fac, Ex, Ey, E2z, ijk,
+                                                                i_j_k_);
+            }
+    }
+
+    return completeD2Batch(ipair, sp_data, ints_cart);
+}
+
 lible::vec2d lints::kineticEnergy(const Structure &structure)
 {
     int l_max = structure.getMaxL();
@@ -354,7 +592,8 @@ lible::vec2d lints::kineticEnergy(const Structure &structure)
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
 #pragma omp parallel for
             for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -375,6 +614,40 @@ lible::vec2d lints::kineticEnergy(const Structure &structure)
     return ints;
 }
 
+lible::vec2d lints::kineticEnergy(const Structure &structure, const PointGroup &point_group)
+{
+    if (point_group.order() == 1)
+        return kineticEnergy(structure);
+
+    ShellSymmetryMap shell_map = shellSymmetryMap(point_group, structure.getShellsView());
+
+    int l_max = structure.getMaxL();
+    size_t dim_ao = structure.getDimAO();
+
+    vec2d ints(Fill(0), dim_ao, dim_ao);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel for
+            for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+            {
+                SymmetryOps ops = uniquePairOps(sp_data.shell_idxs_[2 * ipair + 0],
+                                                sp_data.shell_idxs_[2 * ipair + 1], shell_map);
+                if (ops.empty())
+                    continue;
+
+                vec2d ints_ipair = kineticEnergyKernel(ipair, sp_data);
+
+                transferInts1ElSymm(ipair, sp_data, ints_ipair, ops, shell_map, ints);
+            }
+        }
+
+    return ints;
+}
+
 std::array<lible::vec2d, 3>
 lints::dipoleMomentKernel(const size_t ipair, const std::array<double, 3> &origin,
                           const ShellPairData &sp_data)
@@ -390,9 +663,9 @@ lints::dipoleMomentKernel(const size_t ipair, const std::array<double, 3> &origi
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 3> ints_cart;
-    for (int icart = 0; icart < 3; icart++)
-        ints_cart[icart] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -405,7 +678,8 @@ lints::dipoleMomentKernel(const size_t ipair, const std::array<double, 3> &origi
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -448,26 +722,15 @@ lints::dipoleMomentKernel(const size_t ipair, const std::array<double, 3> &origi
                          (xyz_po[2] * Ez(k, k_, 0));
                 }
 
-                ints_cart[0](mu, nu) += dx;
-                ints_cart[1](mu, nu) += dy;
-                ints_cart[2](mu, nu) += dz;
+                ints_cart(0, mu, nu) += dx;
+                ints_cart(1, mu, nu) += dy;
+                ints_cart(2, mu, nu) += dz;
             }
     }
 
     std::array<vec2d, 3> ints_sph;
-    for (int icart = 0; icart < 3; icart++)
-        ints_sph[icart] = trafo2Spherical(la, lb, ints_cart[icart]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int icart = 0; icart < 3; icart++)
-        for (size_t mu = 0; mu < ints_sph[icart].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icart].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[icart](mu, nu) *= norm_a * norm_b;
-            }
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 3, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -483,7 +746,8 @@ std::array<lible::vec2d, 3> lints::dipoleMoment(const std::array<double, 3> &ori
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
 #pragma omp parallel for
             for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -505,6 +769,140 @@ std::array<lible::vec2d, 3> lints::dipoleMoment(const std::array<double, 3> &ori
     return ints;
 }
 
+std::vector<lible::vec2d>
+lints::multipoleMomentKernel(const size_t ipair, const int order,
+                             const std::array<double, 3> &origin, const ShellPairData &sp_data)
+{
+    size_t ofs_prim = sp_data.offsets_primitives_[ipair];
+    const double *exps = &sp_data.exps_[ofs_prim];
+    const double *coeffs = &sp_data.coeffs_[ofs_prim];
+    const double *xyz_a = &sp_data.coords_[6 * ipair + 0];
+    const double *xyz_b = &sp_data.coords_[6 * ipair + 3];
+
+    auto [la, lb] = sp_data.getLPair();
+    const auto &cart_exps_a = cart_exps[la];
+    const auto &cart_exps_b = cart_exps[lb];
+
+    size_t n_moments = numCartesiansSum(order);
+    vec3d ints_cart(Fill(0), n_moments, numCartesians(la), numCartesians(lb));
+
+    vec2d hmoments(order + 1, order + 1);
+    std::array<vec3d, 3> moments_1d;
+    for (int icart = 0; icart < 3; icart++)
+        moments_1d[icart] = vec3d(order + 1, la + 1, lb + 1);
+
+    std::array<vec3d, 3> ecoeffs;
+
+    for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
+    {
+        double a = exps[iab * 2];
+        double b = exps[iab * 2 + 1];
+        double da = coeffs[iab * 2];
+        double db = coeffs[iab * 2 + 1];
+
+        double p = a + b;
+        double one_o_2p = 1.0 / (2 * p);
+        double dadb = da * db;
+
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+
+        // One-dimensional moments, S^e_{ii'} = sum_t E^{ii'}_t M^e_t, where the Hermite moments
+        // follow M^{e+1}_t = t M^e_{t-1} + X_PO M^e_t + 1 / (2p) M^e_{t+1}, M^0_t = delta_t0
+        // (pi / p)^{1/2}.
+        for (int icart = 0; icart < 3; icart++)
+        {
+            double xyz_p = (a * xyz_a[icart] + b * xyz_b[icart]) / p;
+            double xyz_po = xyz_p - origin[icart];
+
+            hmoments.set(0);
+            hmoments(0, 0) = std::sqrt(M_PI / p);
+            for (int e = 0; e < order; e++)
+                for (int t = 0; t <= e + 1; t++)
+                {
+                    double hmoment = 0;
+                    if (t > 0)
+                        hmoment += t * hmoments(e, t - 1);
+                    if (t <= e)
+                        hmoment += xyz_po * hmoments(e, t);
+                    if (t + 1 <= e)
+                        hmoment += one_o_2p * hmoments(e, t + 1);
+
+                    hmoments(e + 1, t) = hmoment;
+                }
+
+            const vec3d &E = ecoeffs[icart];
+            vec3d &moments = moments_1d[icart];
+            for (int e = 0; e <= order; e++)
+                for (int i = 0; i <= la; i++)
+                    for (int j = 0; j <= lb; j++)
+                    {
+                        double moment = 0;
+                        for (int t = 0; t <= std::min(i + j, e); t++)
+                            moment += E(i, j, t) * hmoments(e, t);
+
+                        moments(e, i, j) = moment;
+                    }
+        }
+
+        const auto &[Mx, My, Mz] = moments_1d;
+        for (int n = 0, imoment = 0; n <= order; n++)
+            for (const auto &[ex, ey, ez, _] : cart_exps[n])
+            {
+                for (const auto &[i, j, k, mu] : cart_exps_a)
+                    for (const auto &[i_, j_, k_, nu] : cart_exps_b)
+                        ints_cart(imoment, mu, nu) += dadb * Mx(ex, i, i_) * My(ey, j, j_) *
+                                                      Mz(ez, k, k_);
+                imoment++;
+            }
+    }
+
+    return trafo2SphericalNorm(ipair, sp_data, n_moments, ints_cart.memptr());
+}
+
+std::vector<lible::vec2d> lints::multipoleMoment(const int order,
+                                                 const std::array<double, 3> &origin,
+                                                 const Structure &structure)
+{
+    if (order < 0)
+        throw std::runtime_error("multipoleMoment(): order must be non-negative");
+
+    if (order >= int(cart_exps.size()))
+        throw std::runtime_error(std::format("multipoleMoment(): orders above {} are not "
+                                             "supported", cart_exps.size() - 1));
+
+    int l_max = structure.getMaxL();
+    size_t dim_ao = structure.getDimAO();
+
+    size_t n_moments = numCartesiansSum(order);
+    std::vector<vec2d> ints(n_moments, vec2d(Fill(0), dim_ao, dim_ao));
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+#pragma omp parallel for
+            for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+            {
+                std::vector<vec2d> ints_ipair = multipoleMomentKernel(ipair, order, origin,
+                                                                      sp_data);
+
+                size_t ofs_a = sp_data.offsets_sph_[2 * ipair + 0];
+                size_t ofs_b = sp_data.offsets_sph_[2 * ipair + 1];
+                for (size_t imoment = 0; imoment < n_moments; imoment++)
+                    for (size_t mu = 0; mu < ints_ipair[imoment].dim<0>(); mu++)
+                        for (size_t nu = 0; nu < ints_ipair[imoment].dim<1>(); nu++)
+                        {
+                            double integral = ints_ipair[imoment](mu, nu);
+                            ints[imoment](ofs_a + mu, ofs_b + nu) = integral;
+                            ints[imoment](ofs_b + nu, ofs_a + mu) = integral;
+                        }
+            }
+        }
+
+    return ints;
+}
+
 lible::vec2d
 lints::externalChargesKernel(const size_t ipair, const std::vector<std::array<double, 4>> &charges,
                              const BoysGrid &boys_grid, const ShellPairData &sp_data)
@@ -521,6 +919,7 @@ lints::externalChargesKernel(const size_t ipair, const std::vector<std::array<do
     const auto &cart_exps_b = cart_exps[lb];
 
     vec2d ints_cart(Fill(0), numCartesians(la), numCartesians(lb));
+    std::array<vec3d, 3> ecoeffs;
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
         double a = exps[iab * 2];
@@ -532,7 +931,8 @@ lints::externalChargesKernel(const size_t ipair, const std::vector<std::array<do
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -607,6 +1007,7 @@ lible::vec2d lints::externalChargesErfKernel(const size_t ipair,
     const auto &cart_exps_b = cart_exps[lb];
 
     vec2d ints_cart(Fill(0), numCartesians(la), numCartesians(lb));
+    std::array<vec3d, 3> ecoeffs;
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
         double a = exps[iab * 2];
@@ -618,7 +1019,8 @@ lible::vec2d lints::externalChargesErfKernel(const size_t ipair,
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -698,9 +1100,9 @@ lints::externalChargesD1Kernel(const size_t ipair, const std::vector<std::array<
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 6> ints_cart;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 6, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -713,10 +1115,11 @@ lints::externalChargesD1Kernel(const size_t ipair, const std::vector<std::array<
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b,
-                                                       {Ex, Ey, Ez});
+                                                       ecoeffs);
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -758,31 +1161,21 @@ lints::externalChargesD1Kernel(const size_t ipair, const std::vector<std::array<
                             double drz = fac * Ex(i, i_, t) * Ey(j, j_, u) * E1z(k, k_, v) * rints_sum(t, u, v);
 
                             // d/dA
-                            ints_cart[0](mu, nu) += -1 * ((a / p) * dpx + drx); // -1 = charge of electron
-                            ints_cart[1](mu, nu) += -1 * ((a / p) * dpy + dry);
-                            ints_cart[2](mu, nu) += -1 * ((a / p) * dpz + drz);
+                            // -1 = charge of electron
+                            ints_cart(0, mu, nu) += -1 * ((a / p) * dpx + drx);
+                            ints_cart(1, mu, nu) += -1 * ((a / p) * dpy + dry);
+                            ints_cart(2, mu, nu) += -1 * ((a / p) * dpz + drz);
 
                             // d/dB
-                            ints_cart[3](mu, nu) += -1 * ((b / p) * dpx - drx);
-                            ints_cart[4](mu, nu) += -1 * ((b / p) * dpy - dry);
-                            ints_cart[5](mu, nu) += -1 * ((b / p) * dpz - drz);
+                            ints_cart(3, mu, nu) += -1 * ((b / p) * dpx - drx);
+                            ints_cart(4, mu, nu) += -1 * ((b / p) * dpy - dry);
+                            ints_cart(5, mu, nu) += -1 * ((b / p) * dpz - drz);
                         }
     }
 
     std::array<vec2d, 6> ints_sph;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_sph[ideriv] = trafo2Spherical(la, lb, ints_cart[ideriv]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        for (size_t mu = 0; mu < ints_sph[ideriv].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[ideriv].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[ideriv](mu, nu) *= norm_a * norm_b;
-            }
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 6, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -807,10 +1200,9 @@ lints::externalChargesOperatorD1Kernel(const size_t ipair, const std::vector<std
     const auto &cart_exps_b = cart_exps[lb];
 
     size_t n_charges = charges.size();
-    std::vector<std::array<vec2d, 3>> ints_cart(n_charges);
-    for (size_t icharge = 0; icharge < n_charges; icharge++)
-        for (int icoord = 0; icoord < 3; icoord++)
-            ints_cart[icharge][icoord] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec4d ints_cart(Fill(0), n_charges, 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -823,10 +1215,11 @@ lints::externalChargesOperatorD1Kernel(const size_t ipair, const std::vector<std
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b,
-                                                       {Ex, Ey, Ez});
+                                                       ecoeffs);
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -855,34 +1248,23 @@ lints::externalChargesOperatorD1Kernel(const size_t ipair, const std::vector<std
                             for (int v = 0; v <= k + k_; v++)
                             {
                                 double Exyz = Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
-                                ints_cart[icharge][0](mu, nu) += charge * fac * Exyz * rints(t + 1, u, v);
-                                ints_cart[icharge][1](mu, nu) += charge * fac * Exyz * rints(t, u + 1, v);
-                                ints_cart[icharge][2](mu, nu) += charge * fac * Exyz * rints(t, u, v + 1);
+                                ints_cart(icharge, 0, mu, nu) +=
+                                        charge * fac * Exyz * rints(t + 1, u, v);
+                                ints_cart(icharge, 1, mu, nu) +=
+                                        charge * fac * Exyz * rints(t, u + 1, v);
+                                ints_cart(icharge, 2, mu, nu) +=
+                                        charge * fac * Exyz * rints(t, u, v + 1);
                             }
         }
     }
 
-    std::vector<std::array<vec2d, 3>> ints_sph(n_charges);
-    for (size_t icharge = 0; icharge < n_charges; icharge++)
-    {
-        ints_sph[icharge][0] = trafo2Spherical(la, lb, ints_cart[icharge][0]);
-        ints_sph[icharge][1] = trafo2Spherical(la, lb, ints_cart[icharge][1]);
-        ints_sph[icharge][2] = trafo2Spherical(la, lb, ints_cart[icharge][2]);
-    }
+    std::vector<vec2d> ints_sph_blocks = trafo2SphericalNorm(ipair, sp_data, 3 * n_charges,
+                                                             ints_cart.memptr());
 
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
+    std::vector<std::array<vec2d, 3>> ints_sph(n_charges);
     for (size_t icharge = 0; icharge < n_charges; icharge++)
-        for (size_t mu = 0; mu < ints_sph[icharge][0].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icharge][0].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-
-                ints_sph[icharge][0](mu, nu) *= norm_a * norm_b;
-                ints_sph[icharge][1](mu, nu) *= norm_a * norm_b;
-                ints_sph[icharge][2](mu, nu) *= norm_a * norm_b;
-            }
+        for (int icoord = 0; icoord < 3; icoord++)
+            ints_sph[icharge][icoord] = std::move(ints_sph_blocks[3 * icharge + icoord]);
 
     return ints_sph;
 }
@@ -906,7 +1288,8 @@ lints::potentialAtExternalChargesKernel(const size_t ipair,
 
     const size_t n_ext_points = charges.size();
 
-    std::vector<vec2d> ints_cart(n_ext_points, vec2d(Fill(0), numCartesians(la), numCartesians(lb)));
+    vec3d ints_cart(Fill(0), n_ext_points, numCartesians(la), numCartesians(lb));
+    std::array<vec3d, 3> ecoeffs;
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
         double a = exps[iab * 2];
@@ -918,7 +1301,8 @@ lints::potentialAtExternalChargesKernel(const size_t ipair,
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -952,31 +1336,14 @@ lints::potentialAtExternalChargesKernel(const size_t ipair,
                     for (int t = 0; t <= i + i_; t++)
                         for (int u = 0; u <= j + j_; u++)
                             for (int v = 0; v <= k + k_; v++)
-                                ints_cart[icharge](mu, nu) += (-1) * fac * // -1 = charge of electron
+                                // -1 = charge of electron
+                                ints_cart(icharge, mu, nu) += (-1) * fac *
                                         Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v) *
                                         rints_sum[icharge](t, u, v);
         }
     }
 
-    std::vector<vec2d> ints_sph(n_ext_points, vec2d(Fill(0), numSphericals(la), numSphericals(lb)));
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-
-    for (size_t icharge = 0; icharge < charges.size(); icharge++)
-    {
-        ints_sph[icharge] = trafo2Spherical(la, lb, ints_cart[icharge]);
-
-        for (size_t mu = 0; mu < ints_sph[icharge].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icharge].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[icharge](mu, nu) *= norm_a * norm_b;
-            }
-    }
-
-    return ints_sph;
+    return trafo2SphericalNorm(ipair, sp_data, n_ext_points, ints_cart.memptr());
 }
 
 std::vector<lible::vec2d>
@@ -1003,7 +1370,9 @@ lints::potentialAtExternalChargesErfKernel(const size_t ipair,
 
     size_t n_ext_points = charges.size();
 
-    std::vector<vec2d> ints_cart(n_ext_points, vec2d(Fill(0), numCartesians(la), numCartesians(lb)));
+    vec3d ints_cart(Fill(0), n_ext_points, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -1016,7 +1385,8 @@ lints::potentialAtExternalChargesErfKernel(const size_t ipair,
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -1057,31 +1427,14 @@ lints::potentialAtExternalChargesErfKernel(const size_t ipair,
                     for (int t = 0; t <= i + i_; t++)
                         for (int u = 0; u <= j + j_; u++)
                             for (int v = 0; v <= k + k_; v++)
-                                ints_cart[icharge](mu, nu) += (-1) * fac * // -1 = charge of electron
+                                // -1 = charge of electron
+                                ints_cart(icharge, mu, nu) += (-1) * fac *
                                         Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v) *
                                         rints_sum[icharge](t, u, v);
         }
     }
 
-    std::vector<vec2d> ints_sph(n_ext_points, vec2d(Fill(0), numSphericals(la), numSphericals(lb)));
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-
-    for (size_t icharge = 0; icharge < charges.size(); icharge++)
-    {
-        ints_sph[icharge] = trafo2Spherical(la, lb, ints_cart[icharge]);
-
-        for (size_t mu = 0; mu < ints_sph[icharge].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icharge].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[icharge](mu, nu) *= norm_a * norm_b;
-            }
-    }
-
-    return ints_sph;
+    return trafo2SphericalNorm(ipair, sp_data, n_ext_points, ints_cart.memptr());
 }
 
 lible::vec2d lints::externalCharges(const std::vector<std::array<double, 4>> &point_charges,
@@ -1094,7 +1447,8 @@ lible::vec2d lints::externalCharges(const std::vector<std::array<double, 4>> &po
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
             BoysGrid boys_grid(la + lb);
 
@@ -1133,7 +1487,8 @@ lible::vec2d lints::externalChargesErf(const std::vector<std::array<double, 4>>
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
             int lab = la + lb;
             BoysGrid boys_grid(lab);
@@ -1175,7 +1530,8 @@ std::array<lible::vec2d, 3> lints::spinOrbitCoupling1El(const Structure &structu
     for (int la = 0; la <= l_max; la++)
         for (int lb = 0; lb <= l_max; lb++)
         {
-            ShellPairData sp_data(false, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(false, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
             int lab = la + lb;
             BoysGrid boys_grid(lab + 1);
@@ -1223,9 +1579,9 @@ lints::spinOrbitCoupling1ElKernel(const size_t ipair,
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 3> ints_cart;
-    for (int ideriv = 0; ideriv < 3; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -1234,10 +1590,11 @@ lints::spinOrbitCoupling1ElKernel(const size_t ipair,
         double da = coeffs[iab * 2];
         double db = coeffs[iab * 2 + 1];
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b,
-                                                       {Ex, Ey, Ez});
+                                                       ecoeffs);
 
         // R integrals
         double p = a + b;
@@ -1290,26 +1647,15 @@ lints::spinOrbitCoupling1ElKernel(const size_t ipair,
                             double pr_yx = r010 * e100;
 
                             // -1 = charge of electron
-                            ints_cart[0](mu, nu) += -1.0 * fac * (pr_zy - pr_yz);
-                            ints_cart[1](mu, nu) += -1.0 * fac * (pr_xz - pr_zx);
-                            ints_cart[2](mu, nu) += -1.0 * fac * (pr_yx - pr_xy);
+                            ints_cart(0, mu, nu) += -1.0 * fac * (pr_zy - pr_yz);
+                            ints_cart(1, mu, nu) += -1.0 * fac * (pr_xz - pr_zx);
+                            ints_cart(2, mu, nu) += -1.0 * fac * (pr_yx - pr_xy);
                         }
     }
 
     std::array<vec2d, 3> ints_sph;
-    for (int icoord = 0; icoord < 3; icoord++)
-        ints_sph[icoord] = trafo2Spherical(la, lb, ints_cart[icoord]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int icoord = 0; icoord < 3; icoord++)
-        for (size_t mu = 0; mu < ints_sph[icoord].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icoord].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[icoord](mu, nu) *= norm_a * norm_b;
-            }
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 3, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -1330,10 +1676,9 @@ lints::pVpKernel(const size_t ipair, const std::vector<std::array<double, 4>> &c
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    arr2d<vec2d, 3, 3> ints_cart;
-    for (int id = 0; id < 3; id++)
-        for (int jd = 0; jd < 3; jd++)
-            ints_cart[id][jd] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec4d ints_cart(Fill(0), 3, 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -1342,13 +1687,14 @@ lints::pVpKernel(const size_t ipair, const std::vector<std::array<double, 4>> &c
         double da = coeffs[iab * 2];
         double db = coeffs[iab * 2 + 1];
 
-        const auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         const auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b,
-                                                             {Ex, Ey, Ez});
+                                                             ecoeffs);
 
         const auto [E2x, E2y, E2z] = ecoeffsPrimitivePair_n2(a, b, la, lb, xyz_a, xyz_b,
-                                                             {Ex, Ey, Ez}, {E1x, E1y, E1z});
+                                                             ecoeffs, {E1x, E1y, E1z});
 
         // R integrals
         const double p = a + b;
@@ -1393,21 +1739,22 @@ lints::pVpKernel(const size_t ipair, const std::vector<std::array<double, 4>> &c
                             arr2d<double, 3, 3> rr{};
 
                             // PP
+                            double e000 = Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
                             double r200 = rints_sum(t + 2, u, v);
                             double r110 = rints_sum(t + 1, u + 1, v);
                             double r101 = rints_sum(t + 1, u, v + 1);
                             double r020 = rints_sum(t, u + 2, v);
                             double r011 = rints_sum(t, u + 1, v + 1);
                             double r002 = rints_sum(t, u, v + 2);
-                            pp[0][0] = r200;
-                            pp[0][1] = r110;
-                            pp[0][2] = r101;
-                            pp[1][0] = r110;
-                            pp[1][1] = r020;
-                            pp[1][2] = r011;
-                            pp[2][0] = r101;
-                            pp[2][1] = r011;
-                            pp[2][2] = r002;
+                            pp[0][0] = r200 * e000;
+                            pp[0][1] = r110 * e000;
+                            pp[0][2] = r101 * e000;
+                            pp[1][0] = r110 * e000;
+                            pp[1][1] = r020 * e000;
+                            pp[1][2] = r011 * e000;
+                            pp[2][0] = r101 * e000;
+                            pp[2][1] = r011 * e000;
+                            pp[2][2] = r002 * e000;
 
                             // PR
                             double r100 = rints_sum(t + 1, u, v);
@@ -1427,26 +1774,27 @@ lints::pVpKernel(const size_t ipair, const std::vector<std::array<double, 4>> &c
                             pr[2][2] = r001 * e001;
 
                             // RR
+                            double r000 = rints_sum(t, u, v);
                             double e200 = E2x(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
                             double e110 = E1x(i, i_, t) * E1y(j, j_, u) * Ez(k, k_, v);
                             double e101 = E1x(i, i_, t) * Ey(j, j_, u) * E1z(k, k_, v);
                             double e020 = Ex(i, i_, t) * E2y(j, j_, u) * Ez(k, k_, v);
                             double e011 = Ex(i, i_, t) * E1y(j, j_, u) * E1z(k, k_, v);
                             double e002 = Ex(i, i_, t) * Ey(j, j_, u) * E2z(k, k_, v);
-                            rr[0][0] = e200;
-                            rr[0][1] = e110;
-                            rr[0][2] = e101;
-                            rr[1][0] = e110;
-                            rr[1][1] = e020;
-                            rr[1][2] = e011;
-                            rr[2][0] = e101;
-                            rr[2][1] = e011;
-                            rr[2][2] = e002;
+                            rr[0][0] = r000 * e200;
+                            rr[0][1] = r000 * e110;
+                            rr[0][2] = r000 * e101;
+                            rr[1][0] = r000 * e110;
+                            rr[1][1] = r000 * e020;
+                            rr[1][2] = r000 * e011;
+                            rr[2][0] = r000 * e101;
+                            rr[2][1] = r000 * e011;
+                            rr[2][2] = r000 * e002;
 
                             for (int id = 0; id < 3; id++)
                                 for (int jd = 0; jd < 3; jd++)
                                 {
-                                    ints_cart[id][jd](mu, nu) += (-1.0) * // -1 charge of electron
+                                    ints_cart(id, jd, mu, nu) += (-1.0) * // -1 charge of electron
                                             fac * ((ab / p2) * pp[id][jd] -
                                                    (a / p) * pr[id][jd] +
                                                    (b / p) * pr[jd][id] - rr[id][jd]);
@@ -1454,22 +1802,13 @@ lints::pVpKernel(const size_t ipair, const std::vector<std::array<double, 4>> &c
                         }
     }
 
-    arr2d<vec2d, 3, 3> ints_sph;
-    for (int id = 0; id < 3; id++)
-        for (int jd = 0; jd < 3; jd++)
-            ints_sph[id][jd] = trafo2Spherical(la, lb, ints_cart[id][jd]);
+    std::vector<vec2d> ints_sph_blocks = trafo2SphericalNorm(ipair, sp_data, 9,
+                                                             ints_cart.memptr());
 
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
+    arr2d<vec2d, 3, 3> ints_sph;
     for (int id = 0; id < 3; id++)
         for (int jd = 0; jd < 3; jd++)
-            for (size_t mu = 0; mu < ints_sph[id][jd].dim<0>(); mu++)
-                for (size_t nu = 0; nu < ints_sph[id][jd].dim<1>(); nu++)
-                {
-                    double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                    double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                    ints_sph[id][jd](mu, nu) *= norm_a * norm_b;
-                }
+            ints_sph[id][jd] = std::move(ints_sph_blocks[3 * id + jd]);
 
     return ints_sph;
 }
@@ -1484,7 +1823,8 @@ std::array<lible::vec2d, 3> lints::momentum(const Structure &structure)
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
 #pragma omp parallel for
             for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -1523,9 +1863,9 @@ std::array<lible::vec2d, 3> lints::momentumKernel(const size_t ipair, const Shel
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 3> ints_cart;
-    for (int ideriv = 0; ideriv < 3; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -1538,7 +1878,8 @@ std::array<lible::vec2d, 3> lints::momentumKernel(const size_t ipair, const Shel
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb + 1, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb + 1, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         for (const auto &[i, j, k, mu] : cart_exps_a)
             for (const auto &[i_, j_, k_, nu] : cart_exps_b)
@@ -1555,23 +1896,15 @@ std::array<lible::vec2d, 3> lints::momentumKernel(const size_t ipair, const Shel
                 if (k_ > 0)
                     D1z += k_ * Ez(k, k_ - 1, 0);
 
-                ints_cart[0](mu, nu) -= fac * D1x * Ey(j, j_, 0) * Ez(k, k_, 0);
-                ints_cart[1](mu, nu) -= fac * Ex(i, i_, 0) * D1y * Ez(k, k_, 0);
-                ints_cart[2](mu, nu) -= fac * Ex(i, i_, 0) * Ey(j, j_, 0) * D1z;
+                ints_cart(0, mu, nu) -= fac * D1x * Ey(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(1, mu, nu) -= fac * Ex(i, i_, 0) * D1y * Ez(k, k_, 0);
+                ints_cart(2, mu, nu) -= fac * Ex(i, i_, 0) * Ey(j, j_, 0) * D1z;
             }
     }
 
     std::array<vec2d, 3> ints_sph;
-    for (int ideriv = 0; ideriv < 3; ideriv++)
-        ints_sph[ideriv] = trafo2Spherical(la, lb, ints_cart[ideriv]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int ideriv = 0; ideriv < 3; ideriv++)
-        for (size_t mu = 0; mu < ints_sph[ideriv].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[ideriv].dim<1>(); nu++)
-                ints_sph[ideriv](mu, nu) *=
-                        sp_data.norms_[ofs_norm_a + mu] * sp_data.norms_[ofs_norm_b + nu];
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 3, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -1587,7 +1920,8 @@ std::array<lible::vec2d, 3> lints::angularMomentum(const std::array<double, 3> &
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
 #pragma omp parallel for
             for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
@@ -1629,9 +1963,9 @@ lints::angularMomentumKernel(const size_t ipair, const std::array<double, 3> &or
     const auto &cart_exps_a = cart_exps[la];
     const auto &cart_exps_b = cart_exps[lb];
 
-    std::array<vec2d, 3> ints_cart;
-    for (int ideriv = 0; ideriv < 3; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), numCartesians(la), numCartesians(lb));
+    vec3d ints_cart(Fill(0), 3, numCartesians(la), numCartesians(lb));
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -1644,7 +1978,8 @@ lints::angularMomentumKernel(const size_t ipair, const std::array<double, 3> &or
         double dadb = da * db;
         double fac = dadb * std::pow(M_PI / p, 1.5);
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb + 1, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb + 1, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         std::array<double, 3> xyz_po{
             (a * xyz_a[0] + b * xyz_b[0]) / p - origin[0],
@@ -1679,23 +2014,15 @@ lints::angularMomentumKernel(const size_t ipair, const std::array<double, 3> &or
                 if (k + k_ > 0)
                     S1z += Ez(k, k_, 1);
 
-                ints_cart[0](mu, nu) -= fac * Ex(i, i_, 0) * (S1y * D1z - S1z * D1y);
-                ints_cart[1](mu, nu) -= fac * Ey(j, j_, 0) * (S1z * D1x - S1x * D1z);
-                ints_cart[2](mu, nu) -= fac * Ez(k, k_, 0) * (S1x * D1y - S1y * D1x);
+                ints_cart(0, mu, nu) -= fac * Ex(i, i_, 0) * (S1y * D1z - S1z * D1y);
+                ints_cart(1, mu, nu) -= fac * Ey(j, j_, 0) * (S1z * D1x - S1x * D1z);
+                ints_cart(2, mu, nu) -= fac * Ez(k, k_, 0) * (S1x * D1y - S1y * D1x);
             }
     }
 
     std::array<vec2d, 3> ints_sph;
-    for (int icart = 0; icart < 3; icart++)
-        ints_sph[icart] = trafo2Spherical(la, lb, ints_cart[icart]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int icart = 0; icart < 3; icart++)
-        for (size_t mu = 0; mu < ints_sph[icart].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icart].dim<1>(); nu++)
-                ints_sph[icart](mu, nu) *=
-                        sp_data.norms_[ofs_norm_a + mu] * sp_data.norms_[ofs_norm_b + nu];
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 3, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -1719,7 +2046,8 @@ lible::vec2d lints::nuclearAttraction(const Structure &structure)
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
             int lab = la + lb;
             BoysGrid boys_grid(lab);
@@ -1743,6 +2071,46 @@ lible::vec2d lints::nuclearAttraction(const Structure &structure)
     return ints;
 }
 
+lible::vec2d lints::nuclearAttraction(const Structure &structure, const PointGroup &point_group)
+{
+    if (point_group.order() == 1)
+        return nuclearAttraction(structure);
+
+    ShellSymmetryMap shell_map = shellSymmetryMap(point_group, structure.getShellsView());
+
+    int l_max = structure.getMaxL();
+    size_t dim_ao = structure.getDimAO();
+
+    // The nuclear charges are symmetric under the point group operations by construction.
+    std::vector<std::array<double, 4>> charges = structure.getZs();
+
+    vec2d ints(Fill(0), dim_ao, dim_ao);
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+            int lab = la + lb;
+            BoysGrid boys_grid(lab);
+
+#pragma omp parallel for
+            for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+            {
+                SymmetryOps ops = uniquePairOps(sp_data.shell_idxs_[2 * ipair + 0],
+                                                sp_data.shell_idxs_[2 * ipair + 1], shell_map);
+                if (ops.empty())
+                    continue;
+
+                vec2d ints_ipair = externalChargesKernel(ipair, charges, boys_grid, sp_data);
+
+                transferInts1ElSymm(ipair, sp_data, ints_ipair, ops, shell_map, ints);
+            }
+        }
+
+    return ints;
+}
+
 lible::vec2d lints::nuclearAttractionErf(const Structure &structure, const std::vector<double> &omegas)
 {
     if (omegas.size() != structure.getNAtoms())
@@ -1765,7 +2133,8 @@ lible::vec2d lints::nuclearAttractionErf(const Structure &structure, const std::
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
             int lab = la + lb;
             BoysGrid boys_grid(lab);
@@ -1790,6 +2159,246 @@ lible::vec2d lints::nuclearAttractionErf(const Structure &structure, const std::
 }
 
 
+lints::CoreHamiltonian
+lints::coreHamiltonianKernel(const size_t ipair, const std::vector<std::array<double, 4>> &charges,
+                             const BoysGrid &boys_grid, const ShellPairData &sp_data,
+                             const bool calc_dipole, const std::array<double, 3> &origin)
+{
+    size_t ofs_prim = sp_data.offsets_primitives_[ipair];
+    const double *exps = &sp_data.exps_[ofs_prim];
+    const double *coeffs = &sp_data.coeffs_[ofs_prim];
+    const double *xyz_a = &sp_data.coords_[6 * ipair + 0];
+    const double *xyz_b = &sp_data.coords_[6 * ipair + 3];
+
+    auto [la, lb] = sp_data.getLPair();
+    int lab = la + lb;
+    int n_cart_a = numCartesians(la);
+    int n_cart_b = numCartesians(lb);
+    const auto &cart_exps_a = cart_exps[la];
+    const auto &cart_exps_b = cart_exps[lb];
+
+    // Order: overlap, kinetic energy, nuclear attraction, dipole moment x, y, z.
+    int n_ints = calc_dipole ? 6 : 3;
+    vec3d ints_cart(Fill(0), n_ints, n_cart_a, n_cart_b);
+
+    std::array<vec3d, 3> ecoeffs;
+
+    for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
+    {
+        double a = exps[iab * 2];
+        double b = exps[iab * 2 + 1];
+        double b2 = b * b;
+        double da = coeffs[iab * 2];
+        double db = coeffs[iab * 2 + 1];
+
+        double p = a + b;
+        double dadb = da * db;
+        double fac = dadb * std::pow(M_PI / p, 1.5);
+        double fac_nuc = 2 * (M_PI / p) * dadb;
+
+        // The coefficients up to lb + 2 are needed for the kinetic energy, the lower ones are
+        // the same as for the rest of the integrals.
+        ecoeffsPrimitivePair(a, b, la, lb + 2, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
+
+        std::array<double, 3> xyz_p{
+            (a * xyz_a[0] + b * xyz_b[0]) / p,
+            (a * xyz_a[1] + b * xyz_b[1]) / p,
+            (a * xyz_a[2] + b * xyz_b[2]) / p
+        };
+
+        vec3d rints_sum(Fill(0), lab + 1);
+        for (auto [xc, yc, zc, charge] : charges)
+        {
+            std::array<double, 3> xyz_pc{xyz_p[0] - xc, xyz_p[1] - yc, xyz_p[2] - zc};
+
+            double xx{xyz_pc[0]}, xy{xyz_pc[1]}, xz{xyz_pc[2]};
+            double xyz_pc_dot = xx * xx + xy * xy + xz * xz;
+            double x = p * xyz_pc_dot;
+
+            std::vector<double> fnx = calcBoysF(lab, x, boys_grid);
+
+            vec3d rints = calcRInts3D(lab, p, &xyz_pc[0], &fnx[0]);
+
+            for (int t = 0; t <= lab; t++)
+                for (int u = 0; u <= lab; u++)
+                    for (int v = 0; v <= lab; v++)
+                        rints_sum(t, u, v) += charge * rints(t, u, v);
+        }
+
+        std::array<double, 3> xyz_po{
+            xyz_p[0] - origin[0],
+            xyz_p[1] - origin[1],
+            xyz_p[2] - origin[2]
+        };
+
+        for (const auto &[i, j, k, mu] : cart_exps_a)
+            for (const auto &[i_, j_, k_, nu] : cart_exps_b)
+            {
+                ints_cart(0, mu, nu) += fac * Ex(i, i_, 0) * Ey(j, j_, 0) * Ez(k, k_, 0);
+
+                double Tx, Ty, Tz;
+                if (i_ < 2)
+                    Tx = -2 * b2 * Ex(i, i_ + 2, 0) +
+                         b * (2 * i_ + 1) * Ex(i, i_, 0);
+                else
+                    Tx = -2 * b2 * Ex(i, i_ + 2, 0) +
+                         b * (2 * i_ + 1) * Ex(i, i_, 0) -
+                         0.5 * i_ * (i_ - 1) * Ex(i, i_ - 2, 0);
+
+                if (j_ < 2)
+                    Ty = -2 * b2 * Ey(j, j_ + 2, 0) +
+                         b * (2 * j_ + 1) * Ey(j, j_, 0);
+                else
+                    Ty = -2 * b2 * Ey(j, j_ + 2, 0) +
+                         b * (2 * j_ + 1) * Ey(j, j_, 0) -
+                         0.5 * j_ * (j_ - 1) * Ey(j, j_ - 2, 0);
+
+                if (k_ < 2)
+                    Tz = -2 * b2 * Ez(k, k_ + 2, 0) +
+                         b * (2 * k_ + 1) * Ez(k, k_, 0);
+                else
+                    Tz = -2 * b2 * Ez(k, k_ + 2, 0) +
+                         b * (2 * k_ + 1) * Ez(k, k_, 0) -
+                         0.5 * k_ * (k_ - 1) * Ez(k, k_ - 2, 0);
+
+                ints_cart(1, mu, nu) += fac * Tx * Ey(j, j_, 0) * Ez(k, k_, 0);
+                ints_cart(1, mu, nu) += fac * Ex(i, i_, 0) * Ty * Ez(k, k_, 0);
+                ints_cart(1, mu, nu) += fac * Ex(i, i_, 0) * Ey(j, j_, 0) * Tz;
+
+                for (int t = 0; t <= i + i_; t++)
+                    for (int u = 0; u <= j + j_; u++)
+                        for (int v = 0; v <= k + k_; v++)
+                            ints_cart(2, mu, nu) += (-1) * fac_nuc * // -1 = charge of electron
+                                    Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v) *
+                                    rints_sum(t, u, v);
+
+                if (!calc_dipole)
+                    continue;
+
+                double dx, dy, dz;
+                if (lab > 0)
+                {
+                    dx = fac * (Ex(i, i_, 1) + xyz_po[0] * Ex(i, i_, 0)) *
+                         Ey(j, j_, 0) * Ez(k, k_, 0);
+
+                    dy = fac * (Ex(i, i_, 0)) *
+                         (Ey(j, j_, 1) + xyz_po[1] * Ey(j, j_, 0)) *
+                         Ez(k, k_, 0);
+
+                    dz = fac * (Ex(i, i_, 0)) * Ey(j, j_, 0) *
+                         (Ez(k, k_, 1) + xyz_po[2] * Ez(k, k_, 0));
+                }
+                else
+                {
+                    dx = fac * (xyz_po[0] * Ex(i, i_, 0)) *
+                         Ey(j, j_, 0) * Ez(k, k_, 0);
+
+                    dy = fac * (Ex(i, i_, 0)) *
+                         (xyz_po[1] * Ey(j, j_, 0)) *
+                         Ez(k, k_, 0);
+
+                    dz = fac * (Ex(i, i_, 0)) * Ey(j, j_, 0) *
+                         (xyz_po[2] * Ez(k, k_, 0));
+                }
+
+                ints_cart(3, mu, nu) += dx;
+                ints_cart(4, mu, nu) += dy;
+                ints_cart(5, mu, nu) += dz;
+            }
+    }
+
+    // One spherical transformation for all the integrals
+    std::vector<vec2d> ints_sph = trafo2SphericalNorm(ipair, sp_data, n_ints,
+                                                      ints_cart.memptr());
+
+    CoreHamiltonian core_hamiltonian{std::move(ints_sph[0]), std::move(ints_sph[1]),
+                                     std::move(ints_sph[2])};
+    if (calc_dipole)
+        core_hamiltonian.dipole_moment_ = {std::move(ints_sph[3]), std::move(ints_sph[4]),
+                                           std::move(ints_sph[5])};
+
+    return core_hamiltonian;
+}
+
+lints::CoreHamiltonian lints::calcCoreHamiltonian(const Structure &structure,
+                                                  const bool calc_dipole,
+                                                  const std::array<double, 3> &origin)
+{
+    int l_max = structure.getMaxL();
+    size_t dim_ao = structure.getDimAO();
+
+    std::vector<std::array<double, 4>> charges(structure.getNAtoms());
+    for (size_t iatom = 0; iatom < structure.getNAtoms(); iatom++)
+    {
+        std::array<double, 3> coords = structure.getCoordsAtom(iatom);
+
+        double Z = structure.getZ(iatom);
+        charges[iatom] = {coords[0], coords[1], coords[2], Z};
+    }
+
+    vec2d filler(Fill(0), dim_ao, dim_ao);
+    CoreHamiltonian core_hamiltonian{filler, filler, filler};
+    if (calc_dipole)
+        core_hamiltonian.dipole_moment_ = {filler, filler, filler};
+
+    std::vector<vec2d *> ints{&core_hamiltonian.overlap_, &core_hamiltonian.kinetic_energy_,
+                              &core_hamiltonian.nuclear_attraction_};
+    if (calc_dipole)
+        for (vec2d &ints_dipole : core_hamiltonian.dipole_moment_)
+            ints.push_back(&ints_dipole);
+
+    for (int la = l_max; la >= 0; la--)
+        for (int lb = la; lb >= 0; lb--)
+        {
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
+
+            int lab = la + lb;
+            BoysGrid boys_grid(lab);
+
+#pragma omp parallel for
+            for (size_t ipair = 0; ipair < sp_data.n_pairs_; ipair++)
+            {
+                CoreHamiltonian ints_ipair = coreHamiltonianKernel(ipair, charges, boys_grid,
+                                                                   sp_data, calc_dipole, origin);
+
+                std::vector<const vec2d *> ints_ipair_ptrs{&ints_ipair.overlap_,
+                                                           &ints_ipair.kinetic_energy_,
+                                                           &ints_ipair.nuclear_attraction_};
+                if (calc_dipole)
+                    for (const vec2d &ints_dipole : ints_ipair.dipole_moment_)
+                        ints_ipair_ptrs.push_back(&ints_dipole);
+
+                size_t ofs_a = sp_data.offsets_sph_[2 * ipair + 0];
+                size_t ofs_b = sp_data.offsets_sph_[2 * ipair + 1];
+                for (size_t iint = 0; iint < ints.size(); iint++)
+                {
+                    const vec2d &ints_iint = *ints_ipair_ptrs[iint];
+                    for (size_t mu = 0; mu < ints_iint.dim<0>(); mu++)
+                        for (size_t nu = 0; nu < ints_iint.dim<1>(); nu++)
+                        {
+                            (*ints[iint])(ofs_a + mu, ofs_b + nu) = ints_iint(mu, nu);
+                            (*ints[iint])(ofs_b + nu, ofs_a + mu) = ints_iint(mu, nu);
+                        }
+                }
+            }
+        }
+
+    return core_hamiltonian;
+}
+
+lints::CoreHamiltonian lints::coreHamiltonian(const Structure &structure)
+{
+    return calcCoreHamiltonian(structure, false, {});
+}
+
+lints::CoreHamiltonian lints::coreHamiltonian(const std::array<double, 3> &origin,
+                                              const Structure &structure)
+{
+    return calcCoreHamiltonian(structure, true, origin);
+}
+
 lible::arr2d<lible::vec2d, 3, 3> lints::pVpIntegrals(const Structure &structure)
 {
     int l_max = structure.getMaxL();
@@ -1813,7 +2422,8 @@ lible::arr2d<lible::vec2d, 3, 3> lints::pVpIntegrals(const Structure &structure)
     for (int la = l_max; la >= 0; la--)
         for (int lb = la; lb >= 0; lb--)
         {
-            ShellPairData sp_data(true, la, lb, structure.getShellsL(la), structure.getShellsL(lb));
+            ShellPairData sp_data(true, la, lb, structure.getShellsLView(la),
+                                  structure.getShellsLView(lb));
 
             int lab = la + lb;
             BoysGrid boys_grid(lab + 2);
@@ -1832,7 +2442,7 @@ lible::arr2d<lible::vec2d, 3, 3> lints::pVpIntegrals(const Structure &structure)
                             for (size_t nu = 0; nu < ints_ipair[i][j].dim<1>(); nu++)
                             {
                                 ints[i][j](ofs_a + mu, ofs_b + nu) = ints_ipair[i][j](mu, nu);
-                                ints[i][j](ofs_b + nu, ofs_a + mu) = ints_ipair[i][j](mu, nu);
+                                ints[j][i](ofs_b + nu, ofs_a + mu) = ints_ipair[i][j](mu, nu);
                             }
             }
         }
@@ -1866,9 +2476,9 @@ lints::externalChargesErfD1Kernel(const size_t ipair,
     int n_cart_a = numCartesians(la);
     int n_cart_b = numCartesians(lb);
 
-    std::array<vec2d, 6> ints_cart;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_cart[ideriv] = vec2d(Fill(0), n_cart_a, n_cart_b);
+    vec3d ints_cart(Fill(0), 6, n_cart_a, n_cart_b);
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -1881,9 +2491,10 @@ lints::externalChargesErfD1Kernel(const size_t ipair,
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
-        auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b, {Ex, Ey, Ez});
+        auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -1931,31 +2542,21 @@ lints::externalChargesErfD1Kernel(const size_t ipair,
                             double drz = fac * Ex(i, i_, t) * Ey(j, j_, u) * E1z(k, k_, v) * rints_sum(t, u, v);
 
                             // d/dA
-                            ints_cart[0](mu, nu) += -1 * ((a / p) * dpx + drx); // -1 = charge of electron
-                            ints_cart[1](mu, nu) += -1 * ((a / p) * dpy + dry);
-                            ints_cart[2](mu, nu) += -1 * ((a / p) * dpz + drz);
+                            // -1 = charge of electron
+                            ints_cart(0, mu, nu) += -1 * ((a / p) * dpx + drx);
+                            ints_cart(1, mu, nu) += -1 * ((a / p) * dpy + dry);
+                            ints_cart(2, mu, nu) += -1 * ((a / p) * dpz + drz);
 
                             // d/dB
-                            ints_cart[3](mu, nu) += -1 * ((b / p) * dpx - drx);
-                            ints_cart[4](mu, nu) += -1 * ((b / p) * dpy - dry);
-                            ints_cart[5](mu, nu) += -1 * ((b / p) * dpz - drz);
+                            ints_cart(3, mu, nu) += -1 * ((b / p) * dpx - drx);
+                            ints_cart(4, mu, nu) += -1 * ((b / p) * dpy - dry);
+                            ints_cart(5, mu, nu) += -1 * ((b / p) * dpz - drz);
                         }
     }
 
     std::array<vec2d, 6> ints_sph;
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        ints_sph[ideriv] = trafo2Spherical(la, lb, ints_cart[ideriv]);
-
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
-    for (int ideriv = 0; ideriv < 6; ideriv++)
-        for (size_t mu = 0; mu < ints_sph[ideriv].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[ideriv].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-                ints_sph[ideriv](mu, nu) *= norm_a * norm_b;
-            }
+    std::ranges::move(trafo2SphericalNorm(ipair, sp_data, 6, ints_cart.memptr()),
+                      ints_sph.begin());
 
     return ints_sph;
 }
@@ -1988,10 +2589,9 @@ lints::externalChargesOperatorErfD1Kernel(const size_t ipair,
     int n_cart_b = numCartesians(lb);
 
     size_t n_charges = charges.size();
-    std::vector<std::array<vec2d, 3>> ints_cart(n_charges);
-    for (size_t icharge = 0; icharge < n_charges; icharge++)
-        for (int icoord = 0; icoord < 3; icoord++)
-            ints_cart[icharge][icoord] = vec2d(Fill(0), n_cart_a, n_cart_b);
+    vec4d ints_cart(Fill(0), n_charges, 3, n_cart_a, n_cart_b);
+
+    std::array<vec3d, 3> ecoeffs;
 
     for (size_t iab = 0; iab < sp_data.nrs_ppairs_[ipair]; iab++)
     {
@@ -2004,10 +2604,11 @@ lints::externalChargesOperatorErfD1Kernel(const size_t ipair,
         double dadb = da * db;
         double fac = 2 * (M_PI / p) * dadb;
 
-        auto [Ex, Ey, Ez] = ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b);
+        ecoeffsPrimitivePair(a, b, la, lb, xyz_a, xyz_b, ecoeffs);
+        const auto &[Ex, Ey, Ez] = ecoeffs;
 
         auto [E1x, E1y, E1z] = ecoeffsPrimitivePair_n1(a, b, la, lb, xyz_a, xyz_b,
-                                                       {Ex, Ey, Ez});
+                                                       ecoeffs);
 
         std::array<double, 3> xyz_p{
             (a * xyz_a[0] + b * xyz_b[0]) / p,
@@ -2040,37 +2641,23 @@ lints::externalChargesOperatorErfD1Kernel(const size_t ipair,
                             {
                                 double Exyz = Ex(i, i_, t) * Ey(j, j_, u) * Ez(k, k_, v);
 
-                                ints_cart[icharge][0](mu, nu) +=
+                                ints_cart(icharge, 0, mu, nu) +=
                                         erf_factor * charge * fac * Exyz * rints(t + 1, u, v);
-                                ints_cart[icharge][1](mu, nu) +=
+                                ints_cart(icharge, 1, mu, nu) +=
                                         erf_factor * charge * fac * Exyz * rints(t, u + 1, v);
-                                ints_cart[icharge][2](mu, nu) +=
+                                ints_cart(icharge, 2, mu, nu) +=
                                         erf_factor * charge * fac * Exyz * rints(t, u, v + 1);
                             }
         }
     }
 
-    std::vector<std::array<vec2d, 3>> ints_sph(n_charges);
-    for (size_t icharge = 0; icharge < n_charges; icharge++)
-    {
-        ints_sph[icharge][0] = trafo2Spherical(la, lb, ints_cart[icharge][0]);
-        ints_sph[icharge][1] = trafo2Spherical(la, lb, ints_cart[icharge][1]);
-        ints_sph[icharge][2] = trafo2Spherical(la, lb, ints_cart[icharge][2]);
-    }
+    std::vector<vec2d> ints_sph_blocks = trafo2SphericalNorm(ipair, sp_data, 3 * n_charges,
+                                                             ints_cart.memptr());
 
-    size_t ofs_norm_a = sp_data.offsets_norms_[2 * ipair + 0];
-    size_t ofs_norm_b = sp_data.offsets_norms_[2 * ipair + 1];
+    std::vector<std::array<vec2d, 3>> ints_sph(n_charges);
     for (size_t icharge = 0; icharge < n_charges; icharge++)
-        for (size_t mu = 0; mu < ints_sph[icharge][0].dim<0>(); mu++)
-            for (size_t nu = 0; nu < ints_sph[icharge][0].dim<1>(); nu++)
-            {
-                double norm_a = sp_data.norms_[ofs_norm_a + mu];
-                double norm_b = sp_data.norms_[ofs_norm_b + nu];
-
-                ints_sph[icharge][0](mu, nu) *= norm_a * norm_b;
-                ints_sph[icharge][1](mu, nu) *= norm_a * norm_b;
-                ints_sph[icharge][2](mu, nu) *= norm_a * norm_b;
-            }
+        for (int icoord = 0; icoord < 3; icoord++)
+            ints_sph[icharge][icoord] = std::move(ints_sph_blocks[3 * icharge + icoord]);
 
     return ints_sph;
 }
@@ -0,0 +1,399 @@
+#include <lible/ints/defs.hpp>
+#include <lible/ints/rys_quadrature.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+
+#include <omp.h>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Calculates the nodes and weights of the Gauss-Legendre quadrature on [-1, 1] and returns
+    /// only the positive half as {t_j}, {w_j}. Requires an even number of points.
+    void gaussLegendreHalf(int n_points, std::vector<double> &nodes, std::vector<double> &weights);
+
+    /// Diagonalizes the symmetric tridiagonal (Jacobi) matrix by the implicit QL algorithm and
+    /// returns the eigenvalues in ascending order with the squares of the first components of
+    /// the eigenvectors. Based on the tqli routine from https://numerical.recipes.
+    void diagJacobiMatrix(std::vector<double> &diag, std::vector<double> &offdiag,
+                          std::vector<double> &first_comps);
+
+    /// Calculates the Rys roots and weights from the Gauss-Legendre discretization of the
+    /// measure, given by the squared positive nodes `us` and the weights `gl_weights`.
+    void rysRootsWeightsStieltjes(int n_roots, double x, const std::vector<double> &us,
+                                  const std::vector<double> &gl_weights, double *roots,
+                                  double *weights);
+
+    /// Number of Gauss-Legendre points used for discretizing the Rys measure.
+    int rysNGaussLegendre(int n_roots);
+
+    /// Returns {u_i, w_i} of the asymptotic Rys quadrature from the positive nodes of the
+    /// 2n-point Gauss-Hermite quadrature, u_i = y_i^2 and w_i = w^H_i.
+    std::vector<double> hermiteRysTable(int n_roots);
+
+    /// Returns the piecewise Chebyshev expansions of the roots and weights on [0, large_x).
+    std::vector<double> chebyshevRysTable(int n_roots, int n_intervals, int n_cheb,
+                                          double interval_size);
+
+    /// Value of x after which the asymptotic Rys roots and weights are accurate to double
+    /// precision for the given number of roots.
+    double rysLargeX(int n_roots);
+}
+
+void lints::gaussLegendreHalf(const int n_points, std::vector<double> &nodes,
+                              std::vector<double> &weights)
+{
+    int n_half = n_points / 2;
+    nodes.resize(n_half);
+    weights.resize(n_half);
+    for (int i = 0; i < n_half; i++)
+    {
+        // Newton iteration from the Chebyshev-like initial guess
+        double t = std::cos(M_PI * (i + 0.75) / (n_points + 0.5));
+        double dp = 0;
+        for (int iter = 0; iter < 100; iter++)
+        {
+            double p0 = 1, p1 = 0;
+            for (int k = 1; k <= n_points; k++)
+            {
+                double p2 = p1;
+                p1 = p0;
+                p0 = ((2 * k - 1) * t * p1 - (k - 1) * p2) / k;
+            }
+            dp = n_points * (t * p0 - p1) / (t * t - 1);
+
+            double delta = p0 / dp;
+            t -= delta;
+            if (std::fabs(delta) < 1e-16)
+                break;
+        }
+
+        nodes[i] = t;
+        weights[i] = 2.0 / ((1 - t * t) * dp * dp);
+    }
+}
+
+void lints::diagJacobiMatrix(std::vector<double> &diag, std::vector<double> &offdiag,
+                             std::vector<double> &first_comps)
+{
+    int n = diag.size();
+
+    // Only the first row of the eigenvector matrix is needed for the quadrature weights.
+    std::vector<double> z(n, 0);
+    z[0] = 1;
+
+    std::vector<double> e(n, 0);
+    for (int i = 0; i < n - 1; i++)
+        e[i] = offdiag[i];
+
+    for (int l = 0; l < n; l++)
+    {
+        int iter = 0;
+        int m;
+        do
+        {
+            for (m = l; m < n - 1; m++)
+            {
+                double dd = std::fabs(diag[m]) + std::fabs(diag[m + 1]);
+                if (std::fabs(e[m]) <= std::numeric_limits<double>::epsilon() * dd)
+                    break;
+            }
+
+            if (m != l)
+            {
+                if (iter++ == 60)
+                    throw std::runtime_error("diagJacobiMatrix(): no convergence");
+
+                double g = (diag[l + 1] - diag[l]) / (2.0 * e[l]);
+                double r = std::hypot(g, 1.0);
+                g = diag[m] - diag[l] + e[l] / (g + std::copysign(r, g));
+
+                double s = 1, c = 1, p = 0;
+                int i;
+                for (i = m - 1; i >= l; i--)
+                {
+                    double f = s * e[i];
+                    double b = c * e[i];
+                    r = std::hypot(f, g);
+                    e[i + 1] = r;
+                    if (r == 0)
+                    {
+                        diag[i + 1] -= p;
+                        e[m] = 0;
+                        break;
+                    }
+                    s = f / r;
+                    c = g / r;
+                    g = diag[i + 1] - p;
+                    r = (diag[i] - g) * s + 2.0 * c * b;
+                    p = s * r;
+                    diag[i + 1] = g + p;
+                    g = c * r - b;
+
+                    f = z[i + 1];
+                    z[i + 1] = s * z[i] + c * f;
+                    z[i] = c * z[i] - s * f;
+                }
+
+                if (r == 0 && i >= l)
+                    continue;
+
+                diag[l] -= p;
+                e[l] = g;
+                e[m] = 0;
+            }
+        } while (m != l);
+    }
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int i, int j) { return diag[i] < diag[j]; });
+
+    std::vector<double> diag_sorted(n);
+    first_comps.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        diag_sorted[i] = diag[order[i]];
+        first_comps[i] = z[order[i]] * z[order[i]];
+    }
+    diag = diag_sorted;
+}
+
+int lints::rysNGaussLegendre(const int n_roots)
+{
+    return 2 * (96 + 8 * n_roots);
+}
+
+void lints::calcRysRootsWeightsRef(const int n_roots, const double x, double *roots,
+                                   double *weights)
+{
+    std::vector<double> nodes, gl_weights;
+    gaussLegendreHalf(rysNGaussLegendre(n_roots), nodes, gl_weights);
+
+    std::vector<double> us(nodes.size());
+    for (size_t j = 0; j < nodes.size(); j++)
+        us[j] = nodes[j] * nodes[j];
+
+    rysRootsWeightsStieltjes(n_roots, x, us, gl_weights, roots, weights);
+}
+
+void lints::rysRootsWeightsStieltjes(const int n_roots, const double x,
+                                     const std::vector<double> &us,
+                                     const std::vector<double> &gl_weights, double *roots,
+                                     double *weights)
+{
+    // Discretized measure in u = t^2 from the Gauss-Legendre quadrature over t, which is exact
+    // for the polynomial part and resolves exp(-x t^2) to double precision for x < large_x.
+    int n_half = us.size();
+    std::vector<double> ws(n_half);
+    for (int j = 0; j < n_half; j++)
+        ws[j] = gl_weights[j] * std::exp(-x * us[j]);
+
+    // Stieltjes procedure for the recurrence coefficients of the monic orthogonal polynomials
+    std::vector<double> alphas(n_roots), betas(n_roots);
+    std::vector<double> p_prev(n_half, 0), p_cur(n_half, 1), p_next(n_half);
+
+    double norm_prev = 1;
+    for (int k = 0; k < n_roots; k++)
+    {
+        double norm = 0, norm_u = 0;
+        for (int j = 0; j < n_half; j++)
+        {
+            double wp2 = ws[j] * p_cur[j] * p_cur[j];
+            norm += wp2;
+            norm_u += wp2 * us[j];
+        }
+
+        alphas[k] = norm_u / norm;
+        betas[k] = (k == 0) ? norm : norm / norm_prev;
+
+        for (int j = 0; j < n_half; j++)
+            p_next[j] = (us[j] - alphas[k]) * p_cur[j] - (k == 0 ? 0 : betas[k]) * p_prev[j];
+
+        std::swap(p_prev, p_cur);
+        std::swap(p_cur, p_next);
+        norm_prev = norm;
+    }
+
+    // Golub-Welsch
+    std::vector<double> diag = alphas;
+    std::vector<double> offdiag(std::max(n_roots - 1, 0));
+    for (int k = 0; k < n_roots - 1; k++)
+        offdiag[k] = std::sqrt(betas[k + 1]);
+
+    std::vector<double> first_comps;
+    diagJacobiMatrix(diag, offdiag, first_comps);
+
+    for (int i = 0; i < n_roots; i++)
+    {
+        roots[i] = diag[i];
+        weights[i] = betas[0] * first_comps[i];
+    }
+}
+
+double lints::rysLargeX(const int n_roots)
+{
+    return 40.0 + 8.0 * n_roots;
+}
+
+std::vector<double> lints::hermiteRysTable(const int n_roots)
+{
+    int n_points = 2 * n_roots;
+
+    std::vector<double> diag(n_points, 0);
+    std::vector<double> offdiag(n_points - 1);
+    for (int k = 0; k < n_points - 1; k++)
+        offdiag[k] = std::sqrt(0.5 * (k + 1));
+
+    std::vector<double> first_comps;
+    diagJacobiMatrix(diag, offdiag, first_comps);
+
+    // The nodes are symmetric around zero, so the positive half is at the end. Doubling the
+    // weight accounts for the negative nodes and halving for the integration over [0, inf).
+    std::vector<double> table(2 * n_roots);
+    for (int i = 0; i < n_roots; i++)
+    {
+        double y = diag[n_roots + i];
+        table[i] = y * y;
+        table[n_roots + i] = std::sqrt(M_PI) * first_comps[n_roots + i];
+    }
+
+    return table;
+}
+
+std::vector<double> lints::chebyshevRysTable(const int n_roots, const int n_intervals,
+                                             const int n_cheb, const double interval_size)
+{
+    int n_funs = 2 * n_roots;
+
+    std::vector<double> nodes, gl_weights;
+    gaussLegendreHalf(rysNGaussLegendre(n_roots), nodes, gl_weights);
+
+    std::vector<double> us(nodes.size());
+    for (size_t j = 0; j < nodes.size(); j++)
+        us[j] = nodes[j] * nodes[j];
+
+    std::vector<double> table(n_intervals * n_funs * n_cheb, 0);
+#pragma omp parallel for
+    for (int ival = 0; ival < n_intervals; ival++)
+    {
+        double half = 0.5 * interval_size;
+        double mid = ival * interval_size + half;
+
+        std::vector<double> vals(n_cheb * n_funs);
+        for (int k = 0; k < n_cheb; k++)
+        {
+            double x = mid + half * std::cos(M_PI * (k + 0.5) / n_cheb);
+            rysRootsWeightsStieltjes(n_roots, x, us, gl_weights, &vals[k * n_funs],
+                                     &vals[k * n_funs + n_roots]);
+        }
+
+        for (int ifun = 0; ifun < n_funs; ifun++)
+            for (int j = 0; j < n_cheb; j++)
+            {
+                double sum = 0;
+                for (int k = 0; k < n_cheb; k++)
+                    sum += vals[k * n_funs + ifun] * std::cos(M_PI * j * (k + 0.5) / n_cheb);
+
+                double coeff = 2.0 * sum / n_cheb;
+                if (j == 0)
+                    coeff *= 0.5;
+
+                table[(ival * n_funs + ifun) * n_cheb + j] = coeff;
+            }
+    }
+
+    return table;
+}
+
+lints::RysGrid::RysGrid(const int n_roots) : n_roots_(n_roots)
+{
+    if (n_roots < 1 || n_roots > _max_rys_roots_)
+        throw std::runtime_error("RysGrid::RysGrid(): number of roots is out of range");
+
+    if (omp_in_parallel() == true)
+        throw std::runtime_error("RysGrid::RysGrid(): cannot be called inside a parallel region");
+
+    large_x_ = rysLargeX(n_roots);
+    n_intervals_ = std::ceil(large_x_ / interval_size_);
+
+    // The tables depend only on the number of roots, so they are calculated once.
+    static std::mutex tables_mutex;
+    static std::map<int, std::vector<double>> cheb_tables;
+    static std::map<int, std::vector<double>> hermite_tables;
+
+    std::lock_guard<std::mutex> lock(tables_mutex);
+    if (cheb_tables.contains(n_roots) == false)
+    {
+        cheb_tables[n_roots] = chebyshevRysTable(n_roots, n_intervals_, n_cheb_, interval_size_);
+        hermite_tables[n_roots] = hermiteRysTable(n_roots);
+    }
+
+    cheb_table_ = &cheb_tables.at(n_roots);
+    hermite_table_ = &hermite_tables.at(n_roots);
+}
+
+void lints::RysGrid::calcRootsWeights(const double x, double *roots, double *weights) const
+{
+    if (x >= large_x_)
+    {
+        const double *table = hermite_table_->data();
+        double one_o_x = 1.0 / x;
+        double one_o_sqrtx = std::sqrt(one_o_x);
+        for (int i = 0; i < n_roots_; i++)
+        {
+            roots[i] = table[i] * one_o_x;
+            weights[i] = table[n_roots_ + i] * one_o_sqrtx;
+        }
+
+        return;
+    }
+
+    int ival = x / interval_size_;
+    double half = 0.5 * interval_size_;
+    double y = (x - (ival * interval_size_ + half)) / half;
+    double y2 = 2 * y;
+
+    int n_funs = 2 * n_roots_;
+    const double *coeffs = &(*cheb_table_)[ival * n_funs * n_cheb_];
+    for (int ifun = 0; ifun < n_funs; ifun++)
+    {
+        // Clenshaw recurrence
+        const double *c = &coeffs[ifun * n_cheb_];
+        double b1 = 0, b2 = 0;
+        for (int j = n_cheb_ - 1; j >= 1; j--)
+        {
+            double b0 = c[j] + y2 * b1 - b2;
+            b2 = b1;
+            b1 = b0;
+        }
+        double val = c[0] + y * b1 - b2;
+
+        if (ifun < n_roots_)
+            roots[ifun] = val;
+        else
+            weights[ifun - n_roots_] = val;
+    }
+}
+
+int lints::RysGrid::getNRoots() const
+{
+    return n_roots_;
+}
+
+double lints::RysGrid::getLargeX() const
+{
+    return large_x_;
+}
+
+double lints::RysGrid::getIntervalSize() const
+{
+    return interval_size_;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+
+namespace lible::ints
+{
+    /// Class for precalculating and using the Rys quadrature root and weight tables. The roots
+    /// and weights of the n-point Rys quadrature satisfy sum_i w_i u_i^k = F_k(x) for
+    /// k = 0,...,2n - 1, where F_k(x) is the Boys function. On [0, large_x) they are tabulated as
+    /// piecewise Chebyshev expansions, beyond that the Gauss-Hermite asymptotic form is used.
+    class RysGrid
+    {
+    public:
+        /// Default ctor.
+        RysGrid() = default;
+
+        /// Initializes the Rys quadrature tables for `n_roots` roots. The tables are constructed
+        /// only once per `n_roots` and shared between the instances.
+        explicit RysGrid(int n_roots);
+
+        /// Calculates the roots, u_i = t_i^2, and weights of the Rys quadrature at x. Both output
+        /// arrays must have at least `n_roots` elements.
+        void calcRootsWeights(double x, double *roots, double *weights) const;
+
+        /// Returns the number of roots.
+        int getNRoots() const;
+
+        /// Returns the value of x after which the asymptotic roots and weights are used.
+        double getLargeX() const;
+
+        /// Returns the interval size of the tables.
+        double getIntervalSize() const;
+
+    private:
+        /// Length of the table interval.
+        static constexpr double interval_size_ = 0.5;
+
+        /// Number of Chebyshev expansion terms per interval.
+        static constexpr int n_cheb_ = 16;
+
+        /// Number of roots.
+        int n_roots_{};
+
+        /// Number of table intervals.
+        int n_intervals_{};
+
+        /// Value of x after which the asymptotic Gauss-Hermite roots and weights are used.
+        double large_x_{};
+
+        /// Chebyshev expansion coefficients laid out as (interval, root/weight, term). The first
+        /// `n_roots_` functions are the roots, the rest are the weights.
+        const std::vector<double> *cheb_table_{};
+
+        /// Positive Gauss-Hermite nodes squared and the corresponding weights for 2 * `n_roots_`
+        /// nodes. Used for x >= `large_x_` as u_i = h_i / x and w_i = w^H_i / sqrt(x).
+        const std::vector<double> *hermite_table_{};
+    };
+
+    /// Calculates the Rys quadrature roots and weights at x with the given number of points by
+    /// the discretized Stieltjes procedure and the Golub-Welsch algorithm. Intended for
+    /// constructing and testing the tables, not for the integral kernels.
+    void calcRysRootsWeightsRef(int n_roots, double x, double *roots, double *weights);
+}
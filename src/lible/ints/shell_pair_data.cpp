@@ -4,7 +4,7 @@
 
 namespace lints = lible::ints;
 
-lints::ShellData::ShellData(const int l, const std::vector<Shell> &shells)
+lints::ShellData::ShellData(const int l, std::span<const Shell> shells)
     : l_(l)
 {
     if (omp_in_parallel() == true)
@@ -70,9 +70,19 @@ lints::ShellData::ShellData(const int l, const std::vector<Shell> &shells)
     }
 }
 
+void lints::ShellData::updateCoordinates(std::span<const Shell> shells)
+{
+    if (shells.size() != n_shells_)
+        throw std::runtime_error("ShellData::updateCoordinates(): number of shells doesn't match");
+
+    for (size_t ishell = 0; ishell < n_shells_; ishell++)
+        for (int icart = 0; icart < 3; icart++)
+            coords_[3 * ishell + icart] = shells[ishell].xyz_coords_[icart];
+}
+
 lints::ShellPairData::ShellPairData(const bool use_symm, const int la, const int lb,
-                                    const std::vector<Shell> &shells_a,
-                                    const std::vector<Shell> &shells_b,
+                                    std::span<const Shell> shells_a,
+                                    std::span<const Shell> shells_b,
                                     const double primitives_thrs)
     : uses_symm_(use_symm), primitives_thrs_(primitives_thrs), la_(la), lb_(lb)
 {
@@ -80,6 +90,7 @@ lints::ShellPairData::ShellPairData(const bool use_symm, const int la, const int
         throw std::runtime_error("ShellPairData(): cannot be initialized inside a parallel region");
 
     countPairs(shells_a, shells_b, n_pairs_, n_pairs_total_, n_ppairs_, n_ppairs_total_);
+    ppairs_mask_.reserve(n_ppairs_total_);
 
     // Write the shell pair data based on how many significant shell and primitive pairs are there.
     int n_sph_a = numSphericals(la_);
@@ -143,6 +154,7 @@ lints::ShellPairData::ShellPairData(const bool use_symm, const int la, const int
                     double mu = a * b / (a + b);
                     double Kab = std::exp(-mu * RAB2);
                     double screen_val = std::fabs(dadb * Kab);
+                    ppairs_mask_.push_back(screen_val >= primitives_thrs);
                     if (screen_val >= primitives_thrs)
                     {
                         exps_[ofs_primitives + iab * 2 + 0] = a;
@@ -201,8 +213,100 @@ lints::ShellPairData::ShellPairData(const bool use_symm, const int la, const int
     }
 }
 
-void lints::ShellPairData::countPairs(const std::vector<Shell> &shells_a,
-                                      const std::vector<Shell> &shells_b, size_t &n_pairs,
+bool lints::ShellPairData::updateCoordinates(std::span<const Shell> shells_a,
+                                             std::span<const Shell> shells_b)
+{
+    if (omp_in_parallel() == true)
+        throw std::runtime_error("ShellPairData::updateCoordinates(): cannot be called inside a "
+                                 "parallel region");
+
+    if (screeningMask(shells_a, shells_b) != ppairs_mask_)
+    {
+        *this = ShellPairData(uses_symm_, la_, lb_, shells_a, shells_b, primitives_thrs_);
+        return false;
+    }
+
+    // Same survivors, so the shell pairs are in the same places as before.
+    size_t ippair = 0;
+    for (size_t ishell = 0, ipair = 0; ishell < shells_a.size(); ishell++)
+    {
+        size_t bound_shell_b;
+        if (uses_symm_ == true && la_ == lb_)
+            bound_shell_b = ishell + 1;
+        else
+            bound_shell_b = shells_b.size();
+
+        for (size_t jshell = 0; jshell < bound_shell_b; jshell++)
+        {
+            size_t n_ppairs = shells_a[ishell].exps_.size() * shells_b[jshell].exps_.size();
+
+            bool survived = false;
+            for (size_t i = 0; i < n_ppairs; i++)
+                survived = survived || ppairs_mask_[ippair + i];
+            ippair += n_ppairs;
+
+            if (survived)
+            {
+                const auto &xyz_a = shells_a[ishell].xyz_coords_;
+                const auto &xyz_b = shells_b[jshell].xyz_coords_;
+                for (int icart = 0; icart < 3; icart++)
+                {
+                    coords_[6 * ipair + icart] = xyz_a[icart];
+                    coords_[6 * ipair + 3 + icart] = xyz_b[icart];
+                }
+
+                ipair++;
+            }
+        }
+    }
+
+    return true;
+}
+
+std::vector<bool> lints::ShellPairData::screeningMask(std::span<const Shell> shells_a,
+                                                      std::span<const Shell> shells_b) const
+{
+    std::vector<bool> mask;
+    mask.reserve(n_ppairs_total_);
+    for (size_t ishell = 0; ishell < shells_a.size(); ishell++)
+    {
+        size_t bound_shell_b;
+        if (uses_symm_ == true && la_ == lb_)
+            bound_shell_b = ishell + 1;
+        else
+            bound_shell_b = shells_b.size();
+
+        for (size_t jshell = 0; jshell < bound_shell_b; jshell++)
+        {
+            const auto &shell_a = shells_a[ishell];
+            const auto &shell_b = shells_b[jshell];
+
+            const auto &xyz_a = shell_a.xyz_coords_;
+            const auto &xyz_b = shell_b.xyz_coords_;
+            double RAB2 = std::pow(xyz_a[0] - xyz_b[0], 2) +
+                          std::pow(xyz_a[1] - xyz_b[1], 2) +
+                          std::pow(xyz_a[2] - xyz_b[2], 2);
+
+            for (size_t ia = 0; ia < shell_a.exps_.size(); ia++)
+                for (size_t ib = 0; ib < shell_b.exps_.size(); ib++)
+                {
+                    double a = shell_a.exps_[ia];
+                    double b = shell_b.exps_[ib];
+                    double da = shell_a.norms_prim_[ia] * shell_a.coeffs_[ia];
+                    double db = shell_b.norms_prim_[ib] * shell_b.coeffs_[ib];
+
+                    double mu = a * b / (a + b);
+                    double Kab = std::exp(-mu * RAB2);
+                    mask.push_back(std::fabs(da * db * Kab) >= primitives_thrs_);
+                }
+        }
+    }
+
+    return mask;
+}
+
+void lints::ShellPairData::countPairs(std::span<const Shell> shells_a,
+                                      std::span<const Shell> shells_b, size_t &n_pairs,
                                       size_t &n_pairs_total, size_t &n_ppairs,
                                       size_t &n_ppairs_total) const
 {
@@ -286,7 +390,7 @@ std::vector<lints::ShellData> lints::shellDataAux(const Structure &structure)
 
     std::vector<ShellData> sh_data;
     for (int l = 0; l <= l_max_aux; l++)
-        sh_data.emplace_back(l, structure.getShellsLAux(l));
+        sh_data.emplace_back(l, structure.getShellsLViewAux(l));
 
     return sh_data;
 }
@@ -302,12 +406,27 @@ lints::shellPairData(const bool use_symm, const Structure &structure)
 
     std::vector<ShellPairData> sp_data;
     for (const auto &[la, lb] : l_pairs)
-        sp_data.emplace_back(use_symm, la, lb, structure.getShellsL(la),
-                             structure.getShellsL(lb));
+        sp_data.emplace_back(use_symm, la, lb, structure.getShellsLView(la),
+                             structure.getShellsLView(lb));
 
     return sp_data;
 }
 
+void lints::updateShellDataAux(const Structure &structure, std::vector<ShellData> &sh_data)
+{
+    for (ShellData &sh_data_l : sh_data)
+        sh_data_l.updateCoordinates(structure.getShellsLViewAux(sh_data_l.l_));
+}
+
+void lints::updateShellPairData(const Structure &structure, std::vector<ShellPairData> &sp_data)
+{
+    for (ShellPairData &sp_data_ab : sp_data)
+    {
+        auto [la, lb] = sp_data_ab.getLPair();
+        sp_data_ab.updateCoordinates(structure.getShellsLView(la), structure.getShellsLView(lb));
+    }
+}
+
 std::vector<lints::ShellPairData> lints::shellPairData(const std::vector<Shell> &shells_a,
                                                        const std::vector<Shell> &shells_b)
 {
@@ -2,6 +2,8 @@
 
 #include <lible/ints/shell.hpp>
 
+#include <span>
+
 namespace lible::ints
 {
     /// Structure containing contiguous data from shells for calculating integrals.
@@ -9,7 +11,11 @@ namespace lible::ints
     {
         /// Constructor for the shell data. Expects that the angular momentum in `shells`
         /// equals `l`. Cannot be called in an OMP parallel region.
-        ShellData(int l, const std::vector<Shell> &shells);
+        ShellData(int l, std::span<const Shell> shells);
+
+        /// Refreshes the shell coordinates after the atoms have moved. Expects the same shells,
+        /// in the same order, as given to the constructor.
+        void updateCoordinates(std::span<const Shell> shells);
 
         /// Angular momentum.
         int l_{};
@@ -52,10 +58,17 @@ namespace lible::ints
         /// Constructor for the shell pair data. Expects that the angular momentum in `shells_a`
         /// equals `la` and the same for `shells_b` and `lb`. Cannot be called in an OMP parallel
         /// region.
-        ShellPairData(bool use_symm, int la, int lb, const std::vector<Shell> &shells_a,
-                      const std::vector<Shell> &shells_b,
+        ShellPairData(bool use_symm, int la, int lb, std::span<const Shell> shells_a,
+                      std::span<const Shell> shells_b,
                       double primitives_thrs = 1e-15); // TODO: add this number as a constant somewhere?
 
+        /// Refreshes the coordinate-dependent data after the atoms have moved. Expects the same
+        /// shells, in the same order, as given to the constructor. If the same primitive pairs
+        /// survive the screening, only the shell coordinates are overwritten and the layout is
+        /// kept. Otherwise, the data is constructed anew. Returns true if the layout was kept.
+        /// Cannot be called in an OMP parallel region.
+        bool updateCoordinates(std::span<const Shell> shells_a, std::span<const Shell> shells_b);
+
         /// Flag indicating whether symmetry is used or not.
         bool uses_symm_{};
 
@@ -105,6 +118,9 @@ namespace lible::ints
         /// Indices of the involved shells in the list of all shells.
         std::vector<size_t> shell_idxs_;
 
+        /// Screening outcome of all primitive pairs, true for the survivors.
+        std::vector<bool> ppairs_mask_;
+
         /// Returns the angular momentum pair.
         std::pair<int, int> getLPair() const
         {
@@ -113,8 +129,12 @@ namespace lible::ints
 
     private:
         /// Counts the numbers of total and screened shell and primitive Gaussian pairs.
-        void countPairs(const std::vector<Shell> &shells_a, const std::vector<Shell> &shells_b,
+        void countPairs(std::span<const Shell> shells_a, std::span<const Shell> shells_b,
                         size_t &n_pairs, size_t &n_pairs_total, size_t &n_ppairs,
                         size_t &n_ppairs_total) const;
+
+        /// Returns the screening outcome of all primitive pairs, true for the survivors.
+        std::vector<bool> screeningMask(std::span<const Shell> shells_a,
+                                        std::span<const Shell> shells_b) const;
     };
 }
@@ -0,0 +1,245 @@
+#include <lible/ints/single_precision.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _LIBLE_USE_MKL_
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Number of elements in a tile upcast to double precision, 256 KB.
+    constexpr size_t n_tile_elements = 32768;
+
+    /// Smallest number of rows in a tile, so that the contractions of wide matrices remain
+    /// DGEMMs.
+    constexpr size_t n_rows_tile_min = 64;
+}
+
+lints::SinglePrecisionMatrix::SinglePrecisionMatrix(const size_t n_rows, const size_t n_cols)
+    : n_rows_(n_rows), n_cols_(n_cols), values_(n_rows * n_cols, 0), scales_(n_rows, 1)
+{
+    n_rows_tile_ = std::min(std::max(n_tile_elements / std::max(n_cols, size_t(1)),
+                                     n_rows_tile_min),
+                            std::max(n_rows, size_t(1)));
+    n_cols_tile_ = std::clamp(n_tile_elements / n_rows_tile_, size_t(1),
+                              std::max(n_cols, size_t(1)));
+}
+
+lints::SinglePrecisionMatrix::SinglePrecisionMatrix(const size_t n_rows, const size_t n_cols,
+                                                    const double *matrix)
+    : SinglePrecisionMatrix(n_rows, n_cols)
+{
+#pragma omp parallel for
+    for (size_t row = 0; row < n_rows; row++)
+        setRow(row, &matrix[row * n_cols]);
+}
+
+lints::SinglePrecisionMatrix::SinglePrecisionMatrix(const vec2d &matrix)
+    : SinglePrecisionMatrix(matrix.dim<0>(), matrix.dim<1>(), matrix.memptr())
+{
+}
+
+lints::SinglePrecisionMatrix::SinglePrecisionMatrix(const vec3d &tensor)
+    : SinglePrecisionMatrix(tensor.dim<0>() * tensor.dim<1>(), tensor.dim<2>(), tensor.memptr())
+{
+}
+
+lints::SinglePrecisionMatrix::SinglePrecisionMatrix(const vec4d &tensor)
+    : SinglePrecisionMatrix(tensor.dim<0>() * tensor.dim<1>(), tensor.dim<2>() * tensor.dim<3>(),
+                            tensor.memptr())
+{
+}
+
+void lints::SinglePrecisionMatrix::setRow(const size_t row, const double *values)
+{
+    double max_abs = 0;
+    for (size_t col = 0; col < n_cols_; col++)
+        max_abs = std::max(max_abs, std::fabs(values[col]));
+
+    // max_abs = m 2^exponent with m in [0.5, 1).
+    int exponent = 0;
+    std::frexp(max_abs, &exponent);
+
+    double scale = std::ldexp(1.0, exponent);
+    double scale_inv = std::ldexp(1.0, -exponent);
+
+    scales_[row] = scale;
+    float *row_values = &values_[row * n_cols_];
+    for (size_t col = 0; col < n_cols_; col++)
+        row_values[col] = float(values[col] * scale_inv);
+}
+
+void lints::SinglePrecisionMatrix::set(const size_t row, const size_t col, const double value)
+{
+    values_[row * n_cols_ + col] = float(value / scales_[row]);
+}
+
+void lints::SinglePrecisionMatrix::upcastRows(const size_t ofs_row, const size_t n_rows,
+                                              double *tile) const
+{
+    upcastTile(ofs_row, n_rows, 0, n_cols_, tile);
+}
+
+void lints::SinglePrecisionMatrix::upcastTile(const size_t ofs_row, const size_t n_rows,
+                                              const size_t ofs_col, const size_t n_cols,
+                                              double *tile) const
+{
+    for (size_t irow = 0; irow < n_rows; irow++)
+    {
+        double scale = scales_[ofs_row + irow];
+        const float *row_values = &values_[(ofs_row + irow) * n_cols_ + ofs_col];
+        for (size_t col = 0; col < n_cols; col++)
+            tile[irow * n_cols + col] = double(row_values[col]) * scale;
+    }
+}
+
+double lints::SinglePrecisionMatrix::operator()(const size_t row, const size_t col) const
+{
+    return double(values_[row * n_cols_ + col]) * scales_[row];
+}
+
+std::vector<double> lints::SinglePrecisionMatrix::toDouble() const
+{
+    std::vector<double> matrix(n_rows_ * n_cols_);
+    upcastRows(0, n_rows_, matrix.data());
+
+    return matrix;
+}
+
+void lints::SinglePrecisionMatrix::multiply(const size_t n_cols_b, const double *b, double *c,
+                                            const double alpha, const double beta) const
+{
+    size_t n_tiles_rows = (n_rows_ + n_rows_tile_ - 1) / n_rows_tile_;
+    size_t n_tiles_cols = (n_cols_ + n_cols_tile_ - 1) / n_cols_tile_;
+
+#pragma omp parallel
+    {
+        std::vector<double> tile(n_rows_tile_ * n_cols_tile_);
+
+#pragma omp for schedule(dynamic)
+        for (size_t itile = 0; itile < n_tiles_rows; itile++)
+        {
+            size_t ofs_row = itile * n_rows_tile_;
+            size_t n_rows = std::min(n_rows_tile_, n_rows_ - ofs_row);
+
+            // The column tiles are summed into the same rows of C.
+            for (size_t jtile = 0; jtile < n_tiles_cols; jtile++)
+            {
+                size_t ofs_col = jtile * n_cols_tile_;
+                size_t n_cols = std::min(n_cols_tile_, n_cols_ - ofs_col);
+
+                upcastTile(ofs_row, n_rows, ofs_col, n_cols, tile.data());
+
+                cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, int(n_rows),
+                            int(n_cols_b), int(n_cols), alpha, tile.data(), int(n_cols),
+                            &b[ofs_col * n_cols_b], int(n_cols_b), jtile == 0 ? beta : 1.0,
+                            &c[ofs_row * n_cols_b], int(n_cols_b));
+            }
+        }
+    }
+}
+
+void lints::SinglePrecisionMatrix::multiplyTrans(const size_t n_cols_b, const double *b,
+                                                 double *c, const double alpha,
+                                                 const double beta) const
+{
+    size_t n_tiles_rows = (n_rows_ + n_rows_tile_ - 1) / n_rows_tile_;
+    size_t n_tiles_cols = (n_cols_ + n_cols_tile_ - 1) / n_cols_tile_;
+    size_t n_tiles = n_tiles_rows * n_tiles_cols;
+    size_t size_c = n_cols_ * n_cols_b;
+
+    for (size_t i = 0; i < size_c; i++)
+        c[i] = beta == 0 ? 0 : beta * c[i];
+
+    // Every thread accumulates the contributions of its tiles, which are summed at the end.
+#pragma omp parallel
+    {
+        std::vector<double> tile(n_rows_tile_ * n_cols_tile_);
+        std::vector<double> c_thread(size_c, 0);
+
+#pragma omp for schedule(dynamic)
+        for (size_t itile = 0; itile < n_tiles; itile++)
+        {
+            size_t ofs_row = (itile / n_tiles_cols) * n_rows_tile_;
+            size_t ofs_col = (itile % n_tiles_cols) * n_cols_tile_;
+            size_t n_rows = std::min(n_rows_tile_, n_rows_ - ofs_row);
+            size_t n_cols = std::min(n_cols_tile_, n_cols_ - ofs_col);
+
+            upcastTile(ofs_row, n_rows, ofs_col, n_cols, tile.data());
+
+            cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, int(n_cols), int(n_cols_b),
+                        int(n_rows), alpha, tile.data(), int(n_cols), &b[ofs_row * n_cols_b],
+                        int(n_cols_b), 1.0, &c_thread[ofs_col * n_cols_b], int(n_cols_b));
+        }
+
+#pragma omp critical
+        {
+            for (size_t i = 0; i < size_c; i++)
+                c[i] += c_thread[i];
+        }
+    }
+}
+
+lints::SinglePrecisionError lints::SinglePrecisionMatrix::errorReport(const double *reference)
+    const
+{
+    SinglePrecisionError error;
+
+    double norm_diff = 0;
+    double norm_ref = 0;
+    for (size_t row = 0; row < n_rows_; row++)
+    {
+        double max_abs_row = 0;
+        double max_diff_row = 0;
+        for (size_t col = 0; col < n_cols_; col++)
+        {
+            double ref = reference[row * n_cols_ + col];
+            double diff = std::fabs((*this)(row, col) - ref);
+
+            max_abs_row = std::max(max_abs_row, std::fabs(ref));
+            max_diff_row = std::max(max_diff_row, diff);
+            norm_diff += diff * diff;
+            norm_ref += ref * ref;
+        }
+
+        error.max_abs_ = std::max(error.max_abs_, max_diff_row);
+        if (max_abs_row > 0)
+            error.max_rel_row_ = std::max(error.max_rel_row_, max_diff_row / max_abs_row);
+    }
+
+    if (norm_ref > 0)
+        error.rel_norm_ = std::sqrt(norm_diff / norm_ref);
+
+    return error;
+}
+
+size_t lints::SinglePrecisionMatrix::getNRows() const
+{
+    return n_rows_;
+}
+
+size_t lints::SinglePrecisionMatrix::getNCols() const
+{
+    return n_cols_;
+}
+
+size_t lints::SinglePrecisionMatrix::getNRowsTile() const
+{
+    return n_rows_tile_;
+}
+
+size_t lints::SinglePrecisionMatrix::getNColsTile() const
+{
+    return n_cols_tile_;
+}
+
+size_t lints::SinglePrecisionMatrix::getMemoryBytes() const
+{
+    return values_.size() * sizeof(float) + scales_.size() * sizeof(double);
+}
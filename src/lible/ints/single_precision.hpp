@@ -0,0 +1,142 @@
+#pragma once
+
+#include <lible/types.hpp>
+#include <lible/ints/twoel/ri_metric.hpp>
+#include <lible/ints/structure.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace lible::ints
+{
+    /// Errors of a single precision matrix relative to the double precision reference.
+    struct SinglePrecisionError
+    {
+        /// Largest absolute error.
+        double max_abs_{};
+        /// Largest absolute error relative to the largest magnitude of its row. Bounded by
+        /// 2^-24 ~ 6e-8.
+        double max_rel_row_{};
+        /// Frobenius norm of the error relative to the Frobenius norm of the reference.
+        double rel_norm_{};
+    };
+
+    /// Class for a row-major matrix, (n_rows, n_cols), stored in single precision to halve the
+    /// memory and the bandwidth. The rounding error of every element is at most 2^-24 of its
+    /// magnitude within the range of single precision. The rows set by setRow() are scaled by a
+    /// power of two such that their largest magnitude is in [0.5, 1). This only guards the
+    /// range: it changes the exponents and not the rounding, except for the values that would
+    /// otherwise overflow or underflow in single precision. The contractions upcast tiles of the
+    /// matrix to double precision and use DGEMM on the tiles. Tensors are stored with their
+    /// leading indices as rows, e.g., the ERI3 as (ab, P) and the ERI4 as (ab, cd).
+    class SinglePrecisionMatrix
+    {
+    public:
+        /// Default ctor.
+        SinglePrecisionMatrix() = default;
+
+        /// Creates a zero matrix of the given dimensions.
+        SinglePrecisionMatrix(size_t n_rows, size_t n_cols);
+
+        /// Converts the row-major double precision matrix, (n_rows, n_cols).
+        SinglePrecisionMatrix(size_t n_rows, size_t n_cols, const double *matrix);
+
+        /// Converts the matrix.
+        explicit SinglePrecisionMatrix(const vec2d &matrix);
+
+        /// Converts the three-index tensor as (d0 d1, d2), e.g., the ERI3 as (ab, P).
+        explicit SinglePrecisionMatrix(const vec3d &tensor);
+
+        /// Converts the four-index tensor as (d0 d1, d2 d3), e.g., the ERI4 as (ab, cd).
+        explicit SinglePrecisionMatrix(const vec4d &tensor);
+
+        /// Converts and stores a row given in double precision. Different rows can be set from
+        /// different threads.
+        void setRow(size_t row, const double *values);
+
+        /// Converts and stores a single element with the scaling factor of its row, which is 1
+        /// unless the row was set by setRow(). Different elements can be set from different
+        /// threads.
+        void set(size_t row, size_t col, double value);
+
+        /// Upcasts the rows [ofs_row, ofs_row + n_rows) to `tile`, (n_rows, n_cols).
+        void upcastRows(size_t ofs_row, size_t n_rows, double *tile) const;
+
+        /// Upcasts the block of the rows [ofs_row, ofs_row + n_rows) and the columns
+        /// [ofs_col, ofs_col + n_cols) to `tile`, (n_rows, n_cols).
+        void upcastTile(size_t ofs_row, size_t n_rows, size_t ofs_col, size_t n_cols,
+                        double *tile) const;
+
+        /// Returns the element upcast to double precision.
+        double operator()(size_t row, size_t col) const;
+
+        /// Returns the whole matrix upcast to double precision as (n_rows, n_cols).
+        std::vector<double> toDouble() const;
+
+        /// Calculates C = alpha A B + beta C, where A is this matrix, B is (n_cols, n_cols_b) and
+        /// C is (n_rows, n_cols_b), both row-major in double precision. OMP parallelized over
+        /// the tiles.
+        void multiply(size_t n_cols_b, const double *b, double *c, double alpha = 1,
+                      double beta = 0) const;
+
+        /// Calculates C = alpha A^T B + beta C, where A is this matrix, B is (n_rows, n_cols_b)
+        /// and C is (n_cols, n_cols_b), both row-major in double precision. OMP parallelized
+        /// over the tiles.
+        void multiplyTrans(size_t n_cols_b, const double *b, double *c, double alpha = 1,
+                           double beta = 0) const;
+
+        /// Compares against the double precision reference, (n_rows, n_cols).
+        SinglePrecisionError errorReport(const double *reference) const;
+
+        /// Returns the number of rows.
+        size_t getNRows() const;
+
+        /// Returns the number of columns.
+        size_t getNCols() const;
+
+        /// Returns the number of rows upcast at once in the contractions.
+        size_t getNRowsTile() const;
+
+        /// Returns the number of columns upcast at once in the contractions.
+        size_t getNColsTile() const;
+
+        /// Returns the memory used by the values and the scaling factors in bytes.
+        size_t getMemoryBytes() const;
+
+    private:
+        /// Number of rows.
+        size_t n_rows_{};
+        /// Number of columns.
+        size_t n_cols_{};
+        /// Number of rows in a tile. A tile is about 256 KB in double precision and has at
+        /// least 64 rows, unless the matrix has fewer, so wide matrices are split into tiles
+        /// of the columns too.
+        size_t n_rows_tile_{};
+        /// Number of columns in a tile.
+        size_t n_cols_tile_{};
+        /// Scaled values in single precision.
+        std::vector<float> values_;
+        /// Power-of-two scaling factors of the rows.
+        std::vector<double> scales_;
+    };
+
+    /// Calculates the ERI3 tensor, as `eri3()`, and stores it in single precision as (ab, P).
+    /// The (ab|P) are calculated one shell pair at a time for all the auxiliary shells, so the
+    /// double precision tensor is never stored. OMP parallelized.
+    SinglePrecisionMatrix eri3SinglePrecision(const Structure &structure);
+
+    /// Calculates the ERI4 tensor, as `eri4()`, and stores it in single precision as (ab, cd).
+    /// The (ab|cd) are calculated for ab >= cd, as in `eri4()`, and stored element by element,
+    /// so the double precision tensor is never stored. OMP parallelized.
+    SinglePrecisionMatrix eri4SinglePrecision(const Structure &structure);
+
+    /// Calculates the RI B-tensor in the MO basis, as `riBTensorMO()`, and stores it in single
+    /// precision as (Q, pq). The B-tensor is converted block by block of the Q indices.
+    SinglePrecisionMatrix riBTensorMOSinglePrecision(const Structure &structure,
+                                                     const RIMetric &metric,
+                                                     const vec2d &mo_coeffs_p,
+                                                     const vec2d &mo_coeffs_q,
+                                                     double max_memory_mb = 1024,
+                                                     const std::string &scratch_dir = "");
+}
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <lible/types.hpp>
+#include <lible/ints/utils.hpp>
 
+#include <array>
+#include <cstddef>
 #include <tuple>
+#include <vector>
 
 namespace lible::ints
 {
@@ -10,5 +14,325 @@ namespace lible::ints
     /// refer to the spherical and Cartesian Gaussians, respectively.
     std::vector<std::tuple<int, int, double>> sphericalTrafo(int l);
 
+    /// Highest angular momentum for which the Cartesian to spherical transformation is
+    /// tabulated.
+    constexpr int max_l_sph_trafo = 9;
 
+    /// Cartesian to spherical transformation in the compressed sparse row format. The entries of
+    /// the spherical Gaussian mu are in [row_ptrs[mu], row_ptrs[mu + 1]) of `cart_idxs` and
+    /// `vals`, in the same order as in sphericalTrafo().
+    template <int n_sph, int n_nonzero>
+    struct SphTrafoCSR
+    {
+        std::array<int, n_sph + 1> row_ptrs;
+        std::array<int, n_nonzero> cart_idxs;
+        std::array<double, n_nonzero> vals;
+    };
+
+    /// View of a CSR table from sphTrafoC() for an angular momentum known only at run time.
+    struct SphTrafoCSRView
+    {
+        int n_sph_{};
+        const int *row_ptrs_{};
+        const int *cart_idxs_{};
+        const double *vals_{};
+    };
+
+    /// Returns a view of the compile-time CSR table for angular momentum l. Nothing is
+    /// allocated.
+    SphTrafoCSRView sphTrafoCSR(int l);
+
+    /// Returns the Cartesian to spherical transformation for angular momentum l as a CSR table.
+    /// Compile time only.
+    template <int l>
+    consteval auto sphTrafoC()
+    {
+        static_assert(l >= 0 && l <= max_l_sph_trafo, "sphTrafoC(): unsupported angular momentum");
+
+        if constexpr (l == 0)
+        {
+            return SphTrafoCSR<1, 1>{
+                {0, 1},
+                {0},
+                {1.00000000000000}};
+        }
+        else if constexpr (l == 1)
+        {
+            return SphTrafoCSR<3, 3>{
+                {0, 1, 2, 3},
+                {2, 0, 1},
+                {1.00000000000000, 1.00000000000000, 1.00000000000000}};
+        }
+        else if constexpr (l == 2)
+        {
+            return SphTrafoCSR<5, 8>{
+                {0, 3, 4, 5, 7, 8},
+                {0, 3, 5, 2, 4, 0, 3, 1},
+                {-0.50000000000000, -0.50000000000000, 1.00000000000000, 1.73205080756888,
+                 1.73205080756888, 0.86602540378444, -0.86602540378444, 1.73205080756888}};
+        }
+        else if constexpr (l == 3)
+        {
+            return SphTrafoCSR<7, 16>{
+                {0, 3, 6, 9, 11, 12, 14, 16},
+                {2, 7, 9, 0, 3, 5, 1, 6, 8, 2, 7, 4, 0, 3, 1, 6},
+                {-1.50000000000000, -1.50000000000000, 1.00000000000000, -0.61237243569579,
+                 -0.61237243569579, 2.44948974278318, -0.61237243569579, -0.61237243569579,
+                 2.44948974278318, 1.93649167310371, -1.93649167310371, 3.87298334620742,
+                 0.79056941504209, -2.37170824512628, 2.37170824512628, -0.79056941504209}};
+        }
+        else if constexpr (l == 4)
+        {
+            return SphTrafoCSR<9, 28>{
+                {0, 6, 9, 12, 16, 19, 21, 23, 26, 28},
+                {0, 3, 5, 10, 12, 14, 2, 7, 9, 4, 11, 13, 0, 5, 10, 12, 1, 6, 8, 2, 7, 4, 11, 0, 3,
+                 10, 1, 6},
+                {0.37500000000000, 0.75000000000000, -3.00000000000000, 0.37500000000000,
+                 -3.00000000000000, 1.00000000000000, -2.37170824512628, -2.37170824512628,
+                 3.16227766016838, -2.37170824512628, -2.37170824512628, 3.16227766016838,
+                 -0.55901699437495, 3.35410196624968, 0.55901699437495, -3.35410196624968,
+                 -1.11803398874989, -1.11803398874989, 6.70820393249937, 2.09165006633519,
+                 -6.27495019900557, 6.27495019900557, -2.09165006633519, 0.73950997288745,
+                 -4.43705983732471, 0.73950997288745, 2.95803989154981, -2.95803989154981}};
+        }
+        else if constexpr (l == 5)
+        {
+            return SphTrafoCSR<11, 46>{
+                {0, 6, 12, 18, 22, 25, 30, 35, 38, 40, 43, 46},
+                {2, 7, 9, 16, 18, 20, 0, 3, 5, 10, 12, 14, 1, 6, 8, 15, 17, 19, 2, 9, 16, 18, 4,
+                 11, 13, 0, 3, 5, 10, 12, 1, 6, 8, 15, 17, 2, 7, 16, 4, 11, 0, 3, 10, 1, 6, 15},
+                {1.87500000000000, 3.75000000000000, -5.00000000000000, 1.87500000000000,
+                 -5.00000000000000, 1.00000000000000, 0.48412291827593, 0.96824583655185,
+                 -5.80947501931113, 0.48412291827593, -5.80947501931113, 3.87298334620742,
+                 0.48412291827593, 0.96824583655185, -5.80947501931113, 0.48412291827593,
+                 -5.80947501931113, 3.87298334620742, -2.56173769148990, 5.12347538297980,
+                 2.56173769148990, -5.12347538297980, -5.12347538297980, -5.12347538297980,
+                 10.24695076595960, -0.52291251658380, 1.04582503316759, 4.18330013267038,
+                 1.56873754975139, -12.54990039801113, -1.56873754975139, -1.04582503316759,
+                 12.54990039801113, 0.52291251658380, -4.18330013267038, 2.21852991866236,
+                 -13.31117951197414, 2.21852991866236, 8.87411967464942, -8.87411967464942,
+                 0.70156076002011, -7.01560760020114, 3.50780380010057, 3.50780380010057,
+                 -7.01560760020114, 0.70156076002011}};
+        }
+        else if constexpr (l == 6)
+        {
+            return SphTrafoCSR<13, 70>{
+                {0, 10, 16, 22, 30, 36, 41, 46, 53, 57, 60, 63, 67, 70},
+                {0, 3, 5, 10, 12, 14, 21, 23, 25, 27, 2, 7, 9, 16, 18, 20, 4, 11, 13, 22, 24, 26,
+                 0, 3, 5, 10, 14, 21, 23, 25, 1, 6, 8, 15, 17, 19, 2, 7, 9, 16, 18, 4, 11, 13, 22,
+                 24, 0, 3, 5, 10, 12, 21, 23, 1, 8, 15, 17, 2, 7, 16, 4, 11, 22, 0, 3, 10, 21, 1,
+                 6, 15},
+                {-0.31250000000000, -0.93750000000000, 5.62500000000000, -0.93750000000000,
+                 11.25000000000000, -7.50000000000000, -0.31250000000000, 5.62500000000000,
+                 -7.50000000000000, 1.00000000000000, 2.86410980934740, 5.72821961869480,
+                 -11.45643923738960, 2.86410980934740, -11.45643923738960, 4.58257569495584,
+                 2.86410980934740, 5.72821961869480, -11.45643923738960, 2.86410980934740,
+                 -11.45643923738960, 4.58257569495584, 0.45285552331842, 0.45285552331842,
+                 -7.24568837309472, -0.45285552331842, 7.24568837309472, -0.45285552331842,
+                 7.24568837309472, -7.24568837309472, 0.90571104663684, 1.81142209327368,
+                 -14.49137674618944, 0.90571104663684, -14.49137674618944, 14.49137674618944,
+                 -2.71713313991052, 5.43426627982104, 7.24568837309472, 8.15139941973156,
+                 -21.73706511928416, -8.15139941973156, -5.43426627982104, 21.73706511928416,
+                 2.71713313991052, -7.24568837309472, -0.49607837082461, 2.48039185412305,
+                 4.96078370824611, 2.48039185412305, -29.76470224947665, -0.49607837082461,
+                 4.96078370824611, -1.98431348329844, 19.84313483298443, 1.98431348329844,
+                 -19.84313483298443, 2.32681380862329, -23.26813808623286, 11.63406904311643,
+                 11.63406904311643, -23.26813808623286, 2.32681380862329, 0.67169328938140,
+                 -10.07539934072094, 10.07539934072094, -0.67169328938140, 4.03015973628838,
+                 -13.43386578762792, 4.03015973628838}};
+        }
+        else if constexpr (l == 7)
+        {
+            return SphTrafoCSR<15, 102>{
+                {0, 10, 20, 30, 38, 44, 53, 62, 69, 73, 80, 87, 91, 94, 98, 102},
+                {2, 7, 9, 16, 18, 20, 29, 31, 33, 35, 0, 3, 5, 10, 12, 14, 21, 23, 25, 27, 1, 6, 8,
+                 15, 17, 19, 28, 30, 32, 34, 2, 7, 9, 16, 20, 29, 31, 33, 4, 11, 13, 22, 24, 26, 0,
+                 3, 5, 10, 12, 14, 21, 23, 25, 1, 6, 8, 15, 17, 19, 28, 30, 32, 2, 7, 9, 16, 18,
+                 29, 31, 4, 13, 22, 24, 0, 3, 5, 10, 12, 21, 23, 1, 6, 8, 15, 17, 28, 30, 2, 7, 16,
+                 29, 4, 11, 22, 0, 3, 10, 21, 1, 6, 15, 28},
+                {-2.18750000000000, -6.56250000000000, 13.12500000000000, -6.56250000000000,
+                 26.25000000000000, -10.50000000000000, -2.18750000000000, 13.12500000000000,
+                 -10.50000000000000, 1.00000000000000, -0.41339864235384, -1.24019592706153,
+                 9.92156741649221, -1.24019592706153, 19.84313483298443, -19.84313483298443,
+                 -0.41339864235384, 9.92156741649221, -19.84313483298443, 5.29150262212918,
+                 -0.41339864235384, -1.24019592706153, 9.92156741649221, -1.24019592706153,
+                 19.84313483298443, -19.84313483298443, -0.41339864235384, 9.92156741649221,
+                 -19.84313483298443, 5.29150262212918, 3.03784720237868, 3.03784720237868,
+                 -16.20185174601965, -3.03784720237868, 9.72111104761179, -3.03784720237868,
+                 16.20185174601965, -9.72111104761179, 6.07569440475737, 12.15138880951474,
+                 -32.40370349203930, 6.07569440475737, -32.40370349203930, 19.44222209522358,
+                 0.42961647140211, -0.42961647140211, -8.59232942804220, -2.14808235701055,
+                 17.18465885608440, 11.45643923738960, -1.28884941420633, 25.77698828412660,
+                 -34.36931771216879, 1.28884941420633, 2.14808235701055, -25.77698828412660,
+                 0.42961647140211, -17.18465885608440, 34.36931771216879, -0.42961647140211,
+                 8.59232942804220, -11.45643923738960, -2.84975327879450, 14.24876639397250,
+                 9.49917759598167, 14.24876639397250, -56.99506557588999, -2.84975327879450,
+                 9.49917759598167, -11.39901311517800, 37.99671038392666, 11.39901311517800,
+                 -37.99671038392666, -0.47495887979908, 4.27462991819175, 5.69950655758900,
+                 2.37479439899542, -56.99506557588999, -2.37479439899542, 28.49753278794499,
+                 -2.37479439899542, 2.37479439899542, 28.49753278794499, 4.27462991819175,
+                 -56.99506557588999, -0.47495887979908, 5.69950655758900, 2.42182459624970,
+                 -36.32736894374543, 36.32736894374543, -2.42182459624970, 14.53094757749817,
+                 -48.43649192499390, 14.53094757749817, 0.64725984928775, -13.59245683504274,
+                 22.65409472507123, -4.53081894501425, 4.53081894501425, -22.65409472507123,
+                 13.59245683504274, -0.64725984928775}};
+        }
+        else if constexpr (l == 8)
+        {
+            return SphTrafoCSR<17, 141>{
+                {0, 15, 25, 35, 47, 57, 66, 75, 87, 95, 102, 109, 117, 124, 128, 132, 137, 141},
+                {0, 3, 5, 10, 12, 14, 21, 23, 25, 27, 36, 38, 40, 42, 44, 2, 7, 9, 16, 18, 20, 29,
+                 31, 33, 35, 4, 11, 13, 22, 24, 26, 37, 39, 41, 43, 0, 3, 5, 12, 14, 21, 23, 27,
+                 36, 38, 40, 42, 1, 6, 8, 15, 17, 19, 28, 30, 32, 34, 2, 7, 9, 16, 18, 20, 29, 31,
+                 33, 4, 11, 13, 22, 24, 26, 37, 39, 41, 0, 3, 5, 10, 12, 14, 21, 23, 25, 36, 38,
+                 40, 1, 6, 8, 15, 19, 28, 30, 32, 2, 7, 9, 16, 18, 29, 31, 4, 11, 13, 22, 24, 37,
+                 39, 0, 3, 5, 12, 21, 23, 36, 38, 1, 6, 8, 15, 17, 28, 30, 2, 7, 16, 29, 4, 11, 22,
+                 37, 0, 3, 10, 21, 36, 1, 6, 15, 28},
+                {0.27343750000000, 1.09375000000000, -8.75000000000000, 1.64062500000000,
+                 -26.25000000000000, 26.25000000000000, 1.09375000000000, -26.25000000000000,
+                 52.50000000000000, -14.00000000000000, 0.27343750000000, -8.75000000000000,
+                 26.25000000000000, -14.00000000000000, 1.00000000000000, -3.28125000000000,
+                 -9.84375000000000, 26.25000000000000, -9.84375000000000, 52.50000000000000,
+                 -31.50000000000000, -3.28125000000000, 26.25000000000000, -31.50000000000000,
+                 6.00000000000000, -3.28125000000000, -9.84375000000000, 26.25000000000000,
+                 -9.84375000000000, 52.50000000000000, -31.50000000000000, -3.28125000000000,
+                 26.25000000000000, -31.50000000000000, 6.00000000000000, -0.39218438743785,
+                 -0.78436877487570, 11.76553162313544, 11.76553162313544, -31.37475099502783,
+                 0.78436877487570, -11.76553162313544, 12.54990039801113, 0.39218438743785,
+                 -11.76553162313544, 31.37475099502783, -12.54990039801113, -0.78436877487570,
+                 -2.35310632462709, 23.53106324627088, -2.35310632462709, 47.06212649254175,
+                 -62.74950199005566, -0.78436877487570, 23.53106324627088, -62.74950199005566,
+                 25.09980079602227, 3.18612102524371, -3.18612102524370, -21.24080683495804,
+                 -15.93060512621853, 42.48161366991607, 16.99264546796643, -9.55836307573112,
+                 63.72242050487411, -50.97793640389929, 9.55836307573112, 15.93060512621853,
+                 -63.72242050487411, 3.18612102524370, -42.48161366991607, 50.97793640389929,
+                 -3.18612102524371, 21.24080683495804, -16.99264546796643, 0.41132645565901,
+                 -1.64530582263602, -9.87183493581614, -4.11326455659006, 49.35917467908068,
+                 16.45305822636023, -1.64530582263602, 49.35917467908068, -98.71834935816138,
+                 0.41132645565901, -9.87183493581614, 16.45305822636023, 1.64530582263602,
+                 1.64530582263602, -39.48733974326455, -1.64530582263602, 65.81223290544091,
+                 -1.64530582263602, 39.48733974326455, -65.81223290544091, -2.96611725366682,
+                 26.69505528300138, 11.86446901466728, 14.83058626833410, -118.64469014667280,
+                 -14.83058626833410, 59.32234507333640, -14.83058626833410, 14.83058626833410,
+                 59.32234507333640, 26.69505528300138, -118.64469014667280, -2.96611725366682,
+                 11.86446901466728, -0.45768182862115, 6.40754560069610, 6.40754560069610,
+                 -96.11318401044156, -6.40754560069610, 96.11318401044156, 0.45768182862115,
+                 -6.40754560069610, -2.74609097172690, 6.40754560069610, 38.44527360417662,
+                 6.40754560069610, -128.15091201392207, -2.74609097172690, 38.44527360417662,
+                 2.50682661696018, -52.64335895616369, 87.73893159360614, -17.54778631872123,
+                 17.54778631872123, -87.73893159360614, 52.64335895616369, -2.50682661696018,
+                 0.62670665424004, -17.54778631872123, 43.86946579680307, -17.54778631872123,
+                 0.62670665424004, 5.01365323392035, -35.09557263744246, 35.09557263744246,
+                 -5.01365323392035}};
+        }
+        else if constexpr (l == 9)
+        {
+            return SphTrafoCSR<19, 187>{
+                {0, 15, 30, 45, 57, 67, 80, 93, 105, 113, 124, 135, 143, 150, 159, 168, 173, 177,
+                 182, 187},
+                {2, 7, 9, 16, 18, 20, 29, 31, 33, 35, 46, 48, 50, 52, 54, 0, 3, 5, 10, 12, 14, 21,
+                 23, 25, 27, 36, 38, 40, 42, 44, 1, 6, 8, 15, 17, 19, 28, 30, 32, 34, 45, 47, 49,
+                 51, 53, 2, 7, 9, 18, 20, 29, 31, 35, 46, 48, 50, 52, 4, 11, 13, 22, 24, 26, 37,
+                 39, 41, 43, 0, 5, 10, 12, 14, 21, 23, 25, 27, 36, 38, 40, 42, 1, 6, 8, 15, 17, 19,
+                 30, 32, 34, 45, 47, 49, 51, 2, 7, 9, 16, 18, 20, 29, 31, 33, 46, 48, 50, 4, 11,
+                 13, 22, 26, 37, 39, 41, 0, 3, 5, 10, 12, 14, 23, 25, 36, 38, 40, 1, 8, 15, 17, 19,
+                 28, 30, 32, 45, 47, 49, 2, 7, 9, 18, 29, 31, 46, 48, 4, 11, 13, 22, 24, 37, 39, 0,
+                 3, 5, 10, 12, 21, 23, 36, 38, 1, 6, 8, 15, 17, 28, 30, 45, 47, 2, 7, 16, 29, 46,
+                 4, 11, 22, 37, 0, 3, 10, 21, 36, 1, 6, 15, 28, 45},
+                {2.46093750000000, 9.84375000000000, -26.25000000000000, 14.76562500000000,
+                 -78.75000000000000, 47.25000000000000, 9.84375000000000, -78.75000000000000,
+                 94.50000000000000, -18.00000000000000, 2.46093750000000, -26.25000000000000,
+                 47.25000000000000, -18.00000000000000, 1.00000000000000, 0.36685490255856,
+                 1.46741961023424, -14.67419610234237, 2.20112941535136, -44.02258830702711,
+                 58.69678440936949, 1.46741961023424, -44.02258830702711, 117.39356881873897,
+                 -46.95742752749559, 0.36685490255856, -14.67419610234237, 58.69678440936949,
+                 -46.95742752749559, 6.70820393249937, 0.36685490255856, 1.46741961023424,
+                 -14.67419610234237, 2.20112941535136, -44.02258830702711, 58.69678440936949,
+                 1.46741961023424, -44.02258830702711, 117.39356881873897, -46.95742752749559,
+                 0.36685490255856, -14.67419610234237, 58.69678440936949, -46.95742752749559,
+                 6.70820393249937, -3.44140403305831, -6.88280806611662, 34.41404033058310,
+                 34.41404033058310, -55.06246452893296, 6.88280806611662, -34.41404033058310,
+                 15.73213272255227, 3.44140403305831, -34.41404033058310, 55.06246452893296,
+                 -15.73213272255227, -6.88280806611662, -20.64842419834986, 68.82808066116620,
+                 -20.64842419834986, 137.65616132233239, -110.12492905786593, -6.88280806611662,
+                 68.82808066116620, -110.12492905786593, 31.46426544510455, -0.37548796377181,
+                 13.51756669578516, 2.25292778263086, -13.51756669578516, -45.05855565261719,
+                 3.00390371017448, -67.58783347892577, 90.11711130523439, 24.03122968139584,
+                 1.12646389131543, -40.55270008735547, 135.17566695785158, -72.09368904418750,
+                 -1.12646389131543, -3.00390371017448, 40.55270008735547, -2.25292778263086,
+                 67.58783347892577, -135.17566695785158, 13.51756669578516, -90.11711130523439,
+                 72.09368904418750, 0.37548796377181, -13.51756669578516, 45.05855565261719,
+                 -24.03122968139584, 3.31621990421700, -13.26487961686800, -26.52975923373599,
+                 -33.16219904216999, 132.64879616867995, 26.52975923373599, -13.26487961686800,
+                 132.64879616867995, -159.17855540241595, 3.31621990421700, -26.52975923373599,
+                 26.52975923373599, 13.26487961686800, 13.26487961686800, -106.11903693494396,
+                 -13.26487961686800, 106.11903693494396, -13.26487961686800, 106.11903693494396,
+                 -106.11903693494396, 0.39636409043643, -3.17091272349146, -11.09819453222009,
+                 -5.54909726611005, 99.88375078998087, 22.19638906444019, 55.49097266110048,
+                 -221.96389064440191, 1.98182045218216, -55.49097266110048, 110.98194532220096,
+                 1.98182045218216, -55.49097266110048, -5.54909726611005, 55.49097266110048,
+                 110.98194532220096, -3.17091272349146, 99.88375078998087, -221.96389064440191,
+                 0.39636409043643, -11.09819453222009, 22.19638906444019, -3.07022304258990,
+                 42.98312259625865, 14.32770753208622, -214.91561298129324, -42.98312259625865,
+                 214.91561298129324, 3.07022304258990, -14.32770753208622, -18.42133825553942,
+                 42.98312259625864, 85.96624519251729, 42.98312259625864, -286.55415064172428,
+                 -18.42133825553942, 85.96624519251729, -0.44314852502787, 8.86297050055736,
+                 7.09037640044589, -6.20407935039015, -148.89790440936369, -12.40815870078031,
+                 248.16317401560616, 3.10203967519508, -49.63263480312123, -3.10203967519508,
+                 12.40815870078031, 49.63263480312123, 6.20407935039015, -248.16317401560616,
+                 -8.86297050055736, 148.89790440936369, 0.44314852502787, -7.09037640044589,
+                 2.58397773170915, -72.35137648785613, 180.87844121964034, -72.35137648785613,
+                 2.58397773170915, 20.67182185367318, -144.70275297571226, 144.70275297571226,
+                 -20.67182185367318, 0.60904939217552, -21.92577811831886, 76.74022341411600,
+                 -51.16014894274400, 5.48144452957971, 5.48144452957971, -51.16014894274400,
+                 76.74022341411600, -21.92577811831886, 0.60904939217552}};
+        }
+    }
+
+    /// Transforms a block of Cartesian integrals, (n_cart_a, n_cart_b), to the spherical basis,
+    /// (n_sph_a, n_sph_b), with the compile-time tables. Nothing is allocated. The floating point
+    /// operations are done in the same order as in trafo2Spherical(la, lb, ints_cart).
+    template <int la, int lb>
+    void trafo2Spherical(const double *ints_cart, double *ints_sph)
+    {
+        constexpr int n_cart_a = numCartesians(la);
+        constexpr int n_cart_b = numCartesians(lb);
+        constexpr int n_sph_a = numSphericals(la);
+        constexpr int n_sph_b = numSphericals(lb);
+        constexpr auto trafo_a = sphTrafoC<la>();
+        constexpr auto trafo_b = sphTrafoC<lb>();
+
+        std::array<double, n_cart_a * n_sph_b> ints_cart_sph;
+        for (int ia = 0; ia < n_cart_a; ia++)
+            for (int isph = 0; isph < n_sph_b; isph++)
+            {
+                double val = 0;
+                for (int k = trafo_b.row_ptrs[isph]; k < trafo_b.row_ptrs[isph + 1]; k++)
+                    val += trafo_b.vals[k] * ints_cart[ia * n_cart_b + trafo_b.cart_idxs[k]];
+
+                ints_cart_sph[ia * n_sph_b + isph] = val;
+            }
+
+        for (int isph = 0; isph < n_sph_a; isph++)
+            for (int ib = 0; ib < n_sph_b; ib++)
+            {
+                double val = 0;
+                for (int k = trafo_a.row_ptrs[isph]; k < trafo_a.row_ptrs[isph + 1]; k++)
+                    val += trafo_a.vals[k] * ints_cart_sph[trafo_a.cart_idxs[k] * n_sph_b + ib];
+
+                ints_sph[isph * n_sph_b + ib] = val;
+            }
+    }
+
+    /// Transforms `n_blocks` consecutive blocks of Cartesian integrals, (n_cart_a, n_cart_b)
+    /// each, to the consecutive spherical blocks, (n_sph_a, n_sph_b) each. Nothing is allocated.
+    template <int la, int lb>
+    void trafo2SphericalBatch(const size_t n_blocks, const double *ints_cart, double *ints_sph)
+    {
+        constexpr size_t n_cart_ab = numCartesians(la) * numCartesians(lb);
+        constexpr size_t n_sph_ab = numSphericals(la) * numSphericals(lb);
+
+        for (size_t iblock = 0; iblock < n_blocks; iblock++)
+            trafo2Spherical<la, lb>(&ints_cart[iblock * n_cart_ab], &ints_sph[iblock * n_sph_ab]);
+    }
 }
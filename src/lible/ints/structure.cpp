@@ -251,6 +251,64 @@ lints::Structure::Structure(const basis_atoms_t &basis_set, const basis_atoms_t
     }
 }
 
+void lints::Structure::updateCoordinates(const std::vector<std::array<double, 3>> &coords_angstrom)
+{
+    if (coords_angstrom.size() != n_atoms_)
+        throw std::runtime_error("Structure::updateCoordinates(): number of coordinates does not "
+            "match the number of atoms");
+
+    coords_ = coords_angstrom;
+    for (size_t iatom = 0; iatom < n_atoms_; iatom++)
+        for (int icart = 0; icart < 3; icart++)
+            coords_[iatom][icart] *= _ang_to_bohr_;
+
+    updateShellCoordinates();
+}
+
+void lints::Structure::updateCoordinates(
+    const std::vector<std::array<double, 3>> &coords_angstrom,
+    const std::vector<std::array<double, 3>> &coords_angstrom_ghost)
+{
+    if (coords_angstrom.size() != n_atoms_ || coords_angstrom_ghost.size() != n_atoms_ghost_)
+        throw std::runtime_error("Structure::updateCoordinates(): number of coordinates does not "
+            "match the number of atoms");
+
+    coords_ = coords_angstrom;
+    coords_ghost_ = coords_angstrom_ghost;
+
+    for (size_t iatom = 0; iatom < n_atoms_; iatom++)
+        for (int icart = 0; icart < 3; icart++)
+            coords_[iatom][icart] *= _ang_to_bohr_;
+
+    for (size_t iatom = 0; iatom < n_atoms_ghost_; iatom++)
+        for (int icart = 0; icart < 3; icart++)
+            coords_ghost_[iatom][icart] *= _ang_to_bohr_;
+
+    updateShellCoordinates();
+}
+
+void lints::Structure::updateShellCoordinates()
+{
+    auto atomCoords = [&](const size_t iatom)
+    {
+        return iatom < n_atoms_ ? coords_[iatom] : coords_ghost_[iatom - n_atoms_];
+    };
+
+    for (Shell &shell : shells_)
+        shell.xyz_coords_ = atomCoords(shell.idx_atom_);
+
+    for (Shell &shell : shells_aux_)
+        shell.xyz_coords_ = atomCoords(shell.idx_atom_);
+
+    for (auto &[l, shells] : shells_map_)
+        for (Shell &shell : shells)
+            shell.xyz_coords_ = atomCoords(shell.idx_atom_);
+
+    for (auto &[l, shells] : shells_map_aux_)
+        for (Shell &shell : shells)
+            shell.xyz_coords_ = atomCoords(shell.idx_atom_);
+}
+
 bool lints::Structure::getUseRI() const
 {
     return use_ri_;
@@ -296,6 +354,11 @@ size_t lints::Structure::getNAtoms() const
     return n_atoms_;
 }
 
+size_t lints::Structure::getNCenters() const
+{
+    return n_atoms_ + n_atoms_ghost_;
+}
+
 std::array<double, 3> lints::Structure::getCoordsAtom(const size_t iatom) const
 {
     return coords_[iatom];
@@ -345,3 +408,33 @@ std::map<int, std::vector<lints::Shell>> lints::Structure::getShellsMapAux() con
 {
     return shells_map_aux_;
 }
+
+std::span<const lints::Shell> lints::Structure::getShellsView() const
+{
+    return shells_;
+}
+
+std::span<const lints::Shell> lints::Structure::getShellsViewAux() const
+{
+    return shells_aux_;
+}
+
+std::span<const lints::Shell> lints::Structure::getShellsLView(const int l) const
+{
+    return shells_map_.at(l);
+}
+
+std::span<const lints::Shell> lints::Structure::getShellsLViewAux(const int l) const
+{
+    return shells_map_aux_.at(l);
+}
+
+const std::map<int, std::vector<lints::Shell>> &lints::Structure::getShellsMapView() const
+{
+    return shells_map_;
+}
+
+const std::map<int, std::vector<lints::Shell>> &lints::Structure::getShellsMapViewAux() const
+{
+    return shells_map_aux_;
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <span>
 #include <string>
 
 #include <lible/ints/shell.hpp>
@@ -58,6 +59,15 @@ namespace lible::ints
                   const std::vector<std::array<double, 3>> &coords_angstrom,
                   const std::vector<std::array<double, 3>> &coords_angstrom_ghost);
 
+        /// Moves the atoms to the given coordinates (in Angstrom), keeping the basis sets. All
+        /// shells are updated in place, so the shell views remain valid.
+        void updateCoordinates(const std::vector<std::array<double, 3>> &coords_angstrom);
+
+        /// Moves the atoms and the ghost atoms to the given coordinates (in Angstrom), keeping
+        /// the basis sets.
+        void updateCoordinates(const std::vector<std::array<double, 3>> &coords_angstrom,
+                               const std::vector<std::array<double, 3>> &coords_angstrom_ghost);
+
         // Some getters
 
         /// Returns the flag for using RI.
@@ -87,30 +97,56 @@ namespace lible::ints
         /// Returns the number of atoms.
         size_t getNAtoms() const;
 
+        /// Returns the number of centers, the atoms followed by the ghost atoms, that the shells
+        /// and the gradients are indexed by.
+        size_t getNCenters() const;
+
         /// Returns the xyz-coordinates (in a.u.) at atom `iatom`.
         std::array<double, 3> getCoordsAtom(size_t iatom) const;
 
         /// Returns for every atom {x, y, z, charge}.
         std::vector<std::array<double, 4>> getZs() const;
 
-        /// Returns all the main basis set shells.
+        /// Returns a copy of all the main basis set shells.
         std::vector<Shell> getShells() const;
 
-        /// Returns all the auxiliary basis set shells.
+        /// Returns a copy of all the auxiliary basis set shells.
         std::vector<Shell> getShellsAux() const;
 
-        /// Returns all the main basis shells with angular momentum `l`.
+        /// Returns a copy of all the main basis shells with angular momentum `l`.
         std::vector<Shell> getShellsL(int l) const;
 
-        /// Returns all the auxiliary basis shells with angular momentum `l`.
+        /// Returns a copy of all the auxiliary basis shells with angular momentum `l`.
         std::vector<Shell> getShellsLAux(int l) const;
 
-        /// Returns the main basis shells map, {l, {shells}}.
+        /// Returns a copy of the main basis shells map, {l, {shells}}.
         std::map<int, std::vector<Shell>> getShellsMap() const;
 
-        /// Returns the auxiliary basis shells map, {l, {shells}}.
+        /// Returns a copy of the auxiliary basis shells map, {l, {shells}}.
         std::map<int, std::vector<Shell>> getShellsMapAux() const;
 
+        // Zero-copy views of the shells, valid for the lifetime of the structure.
+
+        /// Returns a view of all the main basis set shells.
+        std::span<const Shell> getShellsView() const;
+
+        /// Returns a view of all the auxiliary basis set shells.
+        std::span<const Shell> getShellsViewAux() const;
+
+        /// Returns a view of the main basis shells with angular momentum `l`. Throws if there are
+        /// no such shells.
+        std::span<const Shell> getShellsLView(int l) const;
+
+        /// Returns a view of the auxiliary basis shells with angular momentum `l`. Throws if
+        /// there are no such shells.
+        std::span<const Shell> getShellsLViewAux(int l) const;
+
+        /// Returns a reference to the main basis shells map, {l, {shells}}.
+        const std::map<int, std::vector<Shell>> &getShellsMapView() const;
+
+        /// Returns a reference to the auxiliary basis shells map, {l, {shells}}.
+        const std::map<int, std::vector<Shell>> &getShellsMapViewAux() const;
+
     private:
         /// Flag for using the RI approximation.
         bool use_ri_{false};
@@ -162,5 +198,8 @@ namespace lible::ints
         std::map<int, std::vector<Shell>> shells_map_;
         /// Shells corresponding to the auxiliary basis set for each angular momentum.
         std::map<int, std::vector<Shell>> shells_map_aux_;
+
+        /// Sets the shell coordinates from the coordinates of their (ghost) atoms.
+        void updateShellCoordinates();
     };
 }
@@ -0,0 +1,313 @@
+#include <lible/ints/symmetry.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/spherical_trafo.hpp>
+#include <lible/ints/utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Operations of D2h as the signs of the x, y and z coordinates: E, C2(z), C2(y), C2(x), i,
+    /// sigma(xy), sigma(xz) and sigma(yz).
+    const std::array<std::array<int, 3>, 8> d2h_operations{
+        {
+            {1, 1, 1}, {-1, -1, 1}, {-1, 1, -1}, {1, -1, -1},
+            {-1, -1, -1}, {1, 1, -1}, {1, -1, 1}, {-1, 1, 1}
+        }
+    };
+
+    /// Returns the image of the point `xyz` under the operation.
+    std::array<double, 3> applyOperation(const std::array<int, 3> &operation,
+                                         const std::array<double, 3> &origin,
+                                         const std::array<double, 3> &xyz);
+
+    /// Returns the index of the shell that is the image of `shell` under the operation, or -1
+    /// if there is none.
+    long imageShell(const std::array<int, 3> &operation, const std::array<double, 3> &origin,
+                    double tol, const Shell &shell, std::span<const Shell> shells);
+
+    /// Returns the Schoenflies symbol for the given set of D2h operations.
+    std::string pointGroupName(const std::vector<std::array<int, 3>> &operations);
+
+    /// Returns the operations whose images of a shell tuple, given by `keyImage(iop)` in the
+    /// canonical order, are distinct. Returns an empty list if some image comes before the tuple
+    /// itself, given by `key`.
+    template <typename Key, typename F>
+    SymmetryOps uniqueOps(const Key &key, const size_t n_ops, F keyImage)
+    {
+        SymmetryOps ops;
+        std::array<Key, 8> keys;
+        for (size_t iop = 0; iop < n_ops; iop++)
+        {
+            Key key_image = keyImage(iop);
+            if (key_image < key)
+                return {};
+
+            if (std::find(keys.begin(), keys.begin() + ops.n_ops_, key_image) ==
+                keys.begin() + ops.n_ops_)
+            {
+                keys[ops.n_ops_] = key_image;
+                ops.ops_[ops.n_ops_++] = iop;
+            }
+        }
+
+        return ops;
+    }
+}
+
+std::array<double, 3> lints::applyOperation(const std::array<int, 3> &operation,
+                                            const std::array<double, 3> &origin,
+                                            const std::array<double, 3> &xyz)
+{
+    std::array<double, 3> xyz_image;
+    for (int icart = 0; icart < 3; icart++)
+        xyz_image[icart] = origin[icart] + operation[icart] * (xyz[icart] - origin[icart]);
+
+    return xyz_image;
+}
+
+long lints::imageShell(const std::array<int, 3> &operation, const std::array<double, 3> &origin,
+                       const double tol, const Shell &shell, std::span<const Shell> shells)
+{
+    std::array<double, 3> xyz_image = applyOperation(operation, origin, shell.xyz_coords_);
+
+    for (size_t ishell = 0; ishell < shells.size(); ishell++)
+    {
+        const Shell &shell_ = shells[ishell];
+        if (shell_.l_ != shell.l_ || shell_.exps_ != shell.exps_ || shell_.coeffs_ != shell.coeffs_)
+            continue;
+
+        if (std::fabs(shell_.xyz_coords_[0] - xyz_image[0]) < tol &&
+            std::fabs(shell_.xyz_coords_[1] - xyz_image[1]) < tol &&
+            std::fabs(shell_.xyz_coords_[2] - xyz_image[2]) < tol)
+            return long(ishell);
+    }
+
+    return -1;
+}
+
+std::string lints::pointGroupName(const std::vector<std::array<int, 3>> &operations)
+{
+    int n_c2 = 0;
+    bool has_inversion = false;
+    for (const auto &[sx, sy, sz] : operations)
+    {
+        int n_flips = (sx < 0) + (sy < 0) + (sz < 0);
+        if (n_flips == 2)
+            n_c2++;
+        if (n_flips == 3)
+            has_inversion = true;
+    }
+
+    switch (operations.size())
+    {
+        case 1:
+            return "C1";
+        case 2:
+            if (has_inversion)
+                return "Ci";
+            return n_c2 == 1 ? "C2" : "Cs";
+        case 4:
+            if (n_c2 == 3)
+                return "D2";
+            return has_inversion ? "C2h" : "C2v";
+        case 8:
+            return "D2h";
+        default:
+            throw std::runtime_error("pointGroupName(): invalid number of operations");
+    }
+}
+
+lints::PointGroup lints::pointGroup(const Structure &structure, const double tol)
+{
+    std::vector<std::array<double, 4>> charges = structure.getZs();
+
+    std::array<double, 3> origin{};
+    double total_charge = 0;
+    for (const auto &[x, y, z, charge] : charges)
+    {
+        origin[0] += charge * x;
+        origin[1] += charge * y;
+        origin[2] += charge * z;
+        total_charge += charge;
+    }
+
+    if (total_charge > 0)
+        for (int icart = 0; icart < 3; icart++)
+            origin[icart] /= total_charge;
+
+    std::span<const Shell> shells = structure.getShellsView();
+    std::span<const Shell> shells_aux = structure.getShellsViewAux();
+
+    std::vector<std::array<int, 3>> operations;
+    for (const auto &operation : d2h_operations)
+    {
+        bool is_symmetric = true;
+
+        for (const auto &[x, y, z, charge] : charges)
+        {
+            std::array<double, 3> xyz_image = applyOperation(operation, origin, {x, y, z});
+
+            bool found = false;
+            for (const auto &[x_, y_, z_, charge_] : charges)
+                if (charge_ == charge && std::fabs(x_ - xyz_image[0]) < tol &&
+                    std::fabs(y_ - xyz_image[1]) < tol && std::fabs(z_ - xyz_image[2]) < tol)
+                {
+                    found = true;
+                    break;
+                }
+
+            if (!found)
+            {
+                is_symmetric = false;
+                break;
+            }
+        }
+
+        for (size_t ishell = 0; ishell < shells.size() && is_symmetric; ishell++)
+            if (imageShell(operation, origin, tol, shells[ishell], shells) < 0)
+                is_symmetric = false;
+
+        for (size_t ishell = 0; ishell < shells_aux.size() && is_symmetric; ishell++)
+            if (imageShell(operation, origin, tol, shells_aux[ishell], shells_aux) < 0)
+                is_symmetric = false;
+
+        if (is_symmetric)
+            operations.push_back(operation);
+    }
+
+    return PointGroup{pointGroupName(operations), origin, operations};
+}
+
+std::vector<int> lints::sphericalSigns(const int l, const std::array<int, 3> &operation)
+{
+    std::vector<std::array<int, 3>> cart_exps_l = cartExps(l);
+
+    std::vector<int> signs(numSphericals(l), 0);
+    for (const auto &[mu, mu_, val] : sphericalTrafo(l))
+    {
+        auto [i, j, k] = cart_exps_l[mu_];
+
+        int sign = 1;
+        if (i % 2 == 1)
+            sign *= operation[0];
+        if (j % 2 == 1)
+            sign *= operation[1];
+        if (k % 2 == 1)
+            sign *= operation[2];
+
+        if (signs[mu] == 0)
+            signs[mu] = sign;
+        else if (signs[mu] != sign)
+            throw std::runtime_error("sphericalSigns(): spherical Gaussian is not an eigenfunction "
+                                     "of the operation");
+    }
+
+    return signs;
+}
+
+lints::ShellSymmetryMap lints::shellSymmetryMap(const PointGroup &point_group,
+                                                std::span<const Shell> shells,
+                                                const double tol)
+{
+    size_t n_ops = point_group.order();
+    size_t n_shells = shells.size();
+
+    size_t dim_ao = 0;
+    for (const Shell &shell : shells)
+        dim_ao = std::max(dim_ao, shell.ofs_sph_ + shell.dim_sph_);
+
+    ShellSymmetryMap shell_map;
+    shell_map.shells_.resize(n_ops, std::vector<size_t>(n_shells));
+    shell_map.aos_.resize(n_ops, std::vector<size_t>(dim_ao));
+    shell_map.signs_.resize(n_ops, std::vector<int>(dim_ao));
+    for (size_t iop = 0; iop < n_ops; iop++)
+    {
+        const auto &operation = point_group.operations_[iop];
+
+        for (size_t ishell = 0; ishell < n_shells; ishell++)
+        {
+            const Shell &shell = shells[ishell];
+
+            long jshell = imageShell(operation, point_group.origin_, tol, shell, shells);
+            if (jshell < 0)
+                throw std::runtime_error("shellSymmetryMap(): shell has no image under the "
+                                         "operation");
+
+            shell_map.shells_[iop][ishell] = jshell;
+
+            const Shell &shell_image = shells[jshell];
+            std::vector<int> signs = sphericalSigns(shell.l_, operation);
+            for (size_t mu = 0; mu < shell.dim_sph_; mu++)
+            {
+                shell_map.aos_[iop][shell.ofs_sph_ + mu] = shell_image.ofs_sph_ + mu;
+                shell_map.signs_[iop][shell.ofs_sph_ + mu] = signs[mu];
+            }
+        }
+    }
+
+    return shell_map;
+}
+
+lints::SymmetryOps lints::uniquePairOps(const size_t ishell_a, const size_t ishell_b,
+                                        const ShellSymmetryMap &shell_map)
+{
+    auto canonical = [](size_t a, size_t b) -> std::array<size_t, 2>
+    {
+        return {std::min(a, b), std::max(a, b)};
+    };
+
+    return uniqueOps(canonical(ishell_a, ishell_b), shell_map.shells_.size(),
+                     [&](const size_t iop)
+                     {
+                         const auto &shells = shell_map.shells_[iop];
+                         return canonical(shells[ishell_a], shells[ishell_b]);
+                     });
+}
+
+lints::SymmetryOps lints::uniqueTripleOps(const size_t ishell_a, const size_t ishell_b,
+                                          const size_t ishell_c,
+                                          const ShellSymmetryMap &shell_map,
+                                          const ShellSymmetryMap &shell_map_aux)
+{
+    auto canonical = [](size_t a, size_t b, size_t c) -> std::array<size_t, 3>
+    {
+        return {std::min(a, b), std::max(a, b), c};
+    };
+
+    return uniqueOps(canonical(ishell_a, ishell_b, ishell_c), shell_map.shells_.size(),
+                     [&](const size_t iop)
+                     {
+                         const auto &shells = shell_map.shells_[iop];
+                         const auto &shells_aux = shell_map_aux.shells_[iop];
+                         return canonical(shells[ishell_a], shells[ishell_b],
+                                          shells_aux[ishell_c]);
+                     });
+}
+
+lints::SymmetryOps lints::uniqueQuartetOps(const size_t ishell_a, const size_t ishell_b,
+                                           const size_t ishell_c, const size_t ishell_d,
+                                           const ShellSymmetryMap &shell_map)
+{
+    auto canonical = [](size_t a, size_t b, size_t c, size_t d) -> std::array<size_t, 4>
+    {
+        std::array<size_t, 2> ab{std::min(a, b), std::max(a, b)};
+        std::array<size_t, 2> cd{std::min(c, d), std::max(c, d)};
+        if (cd < ab)
+            std::swap(ab, cd);
+
+        return {ab[0], ab[1], cd[0], cd[1]};
+    };
+
+    return uniqueOps(canonical(ishell_a, ishell_b, ishell_c, ishell_d), shell_map.shells_.size(),
+                     [&](const size_t iop)
+                     {
+                         const auto &shells = shell_map.shells_[iop];
+                         return canonical(shells[ishell_a], shells[ishell_b], shells[ishell_c],
+                                          shells[ishell_d]);
+                     });
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <lible/ints/structure.hpp>
+
+#include <array>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace lible::ints
+{
+    /// Structure for representing an abelian point group, D2h or one of its subgroups, with the
+    /// symmetry elements along the Cartesian axes. Every operation is a sign change of some of
+    /// the Cartesian coordinates relative to the origin, e.g., {-1, -1, 1} for C2(z).
+    struct PointGroup
+    {
+        /// Schoenflies symbol of the point group, e.g., "C2v".
+        std::string name_;
+        /// Origin of the symmetry elements in a.u.
+        std::array<double, 3> origin_{};
+        /// Operations as the signs of the x, y and z coordinates. The first one is the identity.
+        std::vector<std::array<int, 3>> operations_;
+
+        /// Returns the number of operations.
+        size_t order() const
+        {
+            return operations_.size();
+        }
+    };
+
+    /// Structure containing the symmetry-equivalent shells and atomic orbitals under the point
+    /// group operations. Under operation g, the atomic orbital mu goes to sign * mu', where the
+    /// sign comes from the parity of the real spherical harmonic.
+    struct ShellSymmetryMap
+    {
+        /// Images of the shells as (operation, shell) -> shell.
+        std::vector<std::vector<size_t>> shells_;
+        /// Images of the atomic orbitals as (operation, mu) -> mu'.
+        std::vector<std::vector<size_t>> aos_;
+        /// Signs of the atomic orbital images as (operation, mu) -> +-1.
+        std::vector<std::vector<int>> signs_;
+    };
+
+    /// Detects the abelian point group of the structure. Only the operations of D2h with the
+    /// symmetry elements along the Cartesian axes, passing through the center of nuclear charge,
+    /// are considered. An operation is accepted if it maps every atom onto an atom with the same
+    /// atomic number and every shell onto a shell with the same basis functions, within `tol`
+    /// (a.u.). Returns C1 when no symmetry is found.
+    PointGroup pointGroup(const Structure &structure, double tol = 1e-8);
+
+    /// Constructs the symmetry-equivalence map of the given shells. Throws if some shell has no
+    /// image under an operation of the point group.
+    ShellSymmetryMap shellSymmetryMap(const PointGroup &point_group,
+                                      std::span<const Shell> shells, double tol = 1e-8);
+
+    /// Returns the signs of the spherical atomic orbitals with angular momentum `l` under the
+    /// given operation.
+    std::vector<int> sphericalSigns(int l, const std::array<int, 3> &operation);
+
+    /// Structure for the operations that give the distinct images of a shell tuple. A point
+    /// group has at most the 8 operations of D2h, so they are kept in a fixed-size array instead
+    /// of allocating for every shell tuple.
+    struct SymmetryOps
+    {
+        /// Indices of the operations, of which the first `n_ops` are used.
+        std::array<size_t, 8> ops_{};
+        /// Number of the operations.
+        size_t n_ops_{};
+
+        bool empty() const
+        {
+            return n_ops_ == 0;
+        }
+
+        const size_t *begin() const
+        {
+            return ops_.data();
+        }
+
+        const size_t *end() const
+        {
+            return ops_.data() + n_ops_;
+        }
+    };
+
+    /// Returns the operations that give the distinct images of the shell pair (a, b) if the pair
+    /// is the representative of its symmetry-equivalence class, otherwise an empty list. The
+    /// pair is assumed to be symmetric, (a, b) = (b, a).
+    SymmetryOps uniquePairOps(size_t ishell_a, size_t ishell_b, const ShellSymmetryMap &shell_map);
+
+    /// Returns the operations that give the distinct images of the shell triple (ab|c) if the
+    /// triple is the representative of its symmetry-equivalence class, otherwise an empty list.
+    /// The shells a and b are from the main basis and c from the auxiliary basis.
+    SymmetryOps uniqueTripleOps(size_t ishell_a, size_t ishell_b, size_t ishell_c,
+                                const ShellSymmetryMap &shell_map,
+                                const ShellSymmetryMap &shell_map_aux);
+
+    /// Returns the operations that give the distinct images of the shell quartet (ab|cd) if the
+    /// quartet is the representative of its symmetry-equivalence class, otherwise an empty list.
+    /// The 8-fold permutational symmetry of (ab|cd) is taken into account.
+    SymmetryOps uniqueQuartetOps(size_t ishell_a, size_t ishell_b, size_t ishell_c,
+                                 size_t ishell_d, const ShellSymmetryMap &shell_map);
+}
@@ -0,0 +1,77 @@
+// Build-time tool that converts the basis set library files into the binary bundle embedded in
+// Lible.
+//
+// Usage: lible_basis_bundler <main basis set dir> <aux basis set dir> <output file>
+
+#include <lible/ints/basis_bundle.hpp>
+#include <lible/ints/basis_sets.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace lints = lible::ints;
+
+/// Reads all basis set files under the directory.
+static std::vector<lints::BundledBasisSet> readBasisSets(const fs::path &basis_dir, const bool aux)
+{
+    std::vector<lints::BundledBasisSet> basis_sets;
+    for (const auto &entry : fs::recursive_directory_iterator(basis_dir))
+    {
+        if (!entry.is_regular_file())
+            continue;
+
+        std::string name = entry.path().filename();
+        name = name.substr(0, name.find('.'));
+        std::ranges::transform(name, name.begin(), [](unsigned char c)
+        {
+            return std::tolower(c);
+        });
+
+        lints::BasisFile basis_file = lints::readBasisFile(entry.path());
+
+        lints::BundledBasisSet basis_set{name, aux, {}};
+        for (const auto &[atomic_nr, offsets] : basis_file.offsets_)
+            basis_set.basis_atoms_.push_back(lints::parseBasisAtom(atomic_nr, name, basis_file));
+
+        basis_sets.push_back(basis_set);
+    }
+
+    return basis_sets;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <main basis set dir> <aux basis set dir> <output>\n";
+        return 1;
+    }
+
+    try
+    {
+        std::vector<lints::BundledBasisSet> basis_sets = readBasisSets(argv[1], false);
+        std::vector<lints::BundledBasisSet> aux_basis_sets = readBasisSets(argv[2], true);
+        basis_sets.insert(basis_sets.end(), aux_basis_sets.begin(), aux_basis_sets.end());
+
+        std::vector<std::byte> blob = lints::writeBasisBundle(basis_sets);
+
+        std::ofstream output(argv[3], std::ios::out | std::ios::binary);
+        output.write(reinterpret_cast<const char *>(blob.data()), std::streamsize(blob.size()));
+        if (!output)
+            throw std::runtime_error(std::string("could not write ") + argv[3]);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << argv[0] << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include <lible/ints/distributed.hpp>
 #include <lible/ints/rints.hpp>
 #include <lible/ints/ints.hpp>
 #include <lible/ints/twoel/eri_kernels.hpp>
@@ -31,46 +32,113 @@ lible::vec2d lints::eri2(const Structure &structure)
 
     std::vector<ShellData> sh_datas = shellDataAux(structure);
 
-    size_t dim_ao_aux = structure.getDimAOAux();
-    vec2d eri2(Fill(0), dim_ao_aux, dim_ao_aux);
+    return eri2(structure, sh_datas, eri2Kernels(sh_datas));
+}
+
+lible::vec2d lints::eri2(const Structure &structure, const std::vector<ShellData> &sh_datas,
+                         const std::vector<ERI2Kernel> &eri2_kernels)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("eri2(): RI approximation is not enabled");
+
+    if (eri2_kernels.size() != sh_datas.size() * (sh_datas.size() + 1) / 2)
+        throw std::runtime_error("eri2(): number of kernels doesn't match the shell data");
+
+    // The tasks, {class, ishell_a}, are the shells a of every (a|b) class, distributed over the
+    // processes and threads.
+    std::vector<std::pair<size_t, size_t>> classes;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    std::vector<double> costs;
     for (size_t ishdata_a = 0; ishdata_a < sh_datas.size(); ishdata_a++)
         for (size_t ishdata_b = 0; ishdata_b <= ishdata_a; ishdata_b++)
         {
-            ShellData &sh_data_a = sh_datas[ishdata_a];
-            ShellData &sh_data_b = sh_datas[ishdata_b];
+            const ShellData &sh_data_a = sh_datas[ishdata_a];
+            const ShellData &sh_data_b = sh_datas[ishdata_b];
+
+            size_t iclass = classes.size();
+            classes.push_back({ishdata_a, ishdata_b});
+
+            double cost_b = 0;
+            for (size_t ishell_b = 0; ishell_b < sh_data_b.n_shells_; ishell_b++)
+                cost_b += sh_data_b.cdepths_[ishell_b];
+            cost_b *= numSphericals(sh_data_a.l_) * numSphericals(sh_data_b.l_);
+
+            for (size_t ishell_a = 0; ishell_a < sh_data_a.n_shells_; ishell_a++)
+            {
+                tasks.push_back({iclass, ishell_a});
+                costs.push_back(sh_data_a.cdepths_[ishell_a] * cost_b);
+            }
+        }
+
+    size_t dim_ao_aux = structure.getDimAOAux();
+    vec2d eri2(Fill(0), dim_ao_aux, dim_ao_aux);
+
+    TaskDistributor distributor(costs);
+
+#pragma omp parallel
+    {
+        size_t itask;
+        while (distributor.next(itask))
+        {
+            auto [iclass, ishell_a] = tasks[itask];
+            auto [ishdata_a, ishdata_b] = classes[iclass];
+
+            const ShellData &sh_data_a = sh_datas[ishdata_a];
+            const ShellData &sh_data_b = sh_datas[ishdata_b];
+            const ERI2Kernel &eri2_kernel = eri2_kernels[iclass];
 
             int la = sh_data_a.l_;
             int lb = sh_data_b.l_;
             int n_sph_a = numSphericals(la);
             int n_sph_b = numSphericals(lb);
 
-            ERI2Kernel eri2_kernel(sh_data_a, sh_data_b);
-
-#pragma omp parallel for
-            for (size_t ishell_a = 0; ishell_a < sh_data_a.n_shells_; ishell_a++)
+            size_t bound_b = (la == lb) ? ishell_a + 1 : sh_data_b.n_shells_;
+            for (size_t ishell_b = 0; ishell_b < bound_b; ishell_b++)
             {
-                size_t bound_b = (la == lb) ? ishell_a + 1 : sh_data_b.n_shells_;
-                for (size_t ishell_b = 0; ishell_b < bound_b; ishell_b++)
-                {
-                    vec2d eri2_batch = eri2_kernel(ishell_a, ishell_b, sh_data_a, sh_data_b);
-
-                    size_t ofs_a = sh_data_a.offsets_sph_[ishell_a];
-                    size_t ofs_b = sh_data_b.offsets_sph_[ishell_b];
-                    for (int ia = 0; ia < n_sph_a; ia++)
-                        for (int ib = 0; ib < n_sph_b; ib++)
-                        {
-                            size_t mu = ofs_a + ia;
-                            size_t nu = ofs_b + ib;
-                            eri2(mu, nu) = eri2_batch(ia, ib);
-                            eri2(nu, mu) = eri2_batch(ia, ib);
-                        }
-                }
+                vec2d eri2_batch = eri2_kernel(ishell_a, ishell_b, sh_data_a, sh_data_b);
+
+                size_t ofs_a = sh_data_a.offsets_sph_[ishell_a];
+                size_t ofs_b = sh_data_b.offsets_sph_[ishell_b];
+                for (int ia = 0; ia < n_sph_a; ia++)
+                    for (int ib = 0; ib < n_sph_b; ib++)
+                    {
+                        size_t mu = ofs_a + ia;
+                        size_t nu = ofs_b + ib;
+                        eri2(mu, nu) = eri2_batch(ia, ib);
+                        eri2(nu, mu) = eri2_batch(ia, ib);
+                    }
             }
         }
+    }
+
+    // Every element is computed by exactly one process.
+    allReduceSum(&eri2[0], eri2.size());
 
     return eri2;
 }
 
+std::vector<lints::ERI2Kernel> lints::eri2Kernels(const std::vector<ShellData> &sh_datas)
+{
+    std::vector<ERI2Kernel> eri2_kernels;
+    for (size_t ishdata_a = 0; ishdata_a < sh_datas.size(); ishdata_a++)
+        for (size_t ishdata_b = 0; ishdata_b <= ishdata_a; ishdata_b++)
+            eri2_kernels.emplace_back(sh_datas[ishdata_a], sh_datas[ishdata_b]);
+
+    return eri2_kernels;
+}
+
+void lints::updateERI2Kernels(const std::vector<ShellData> &sh_datas,
+                              std::vector<ERI2Kernel> &eri2_kernels)
+{
+    if (eri2_kernels.size() != sh_datas.size() * (sh_datas.size() + 1) / 2)
+        throw std::runtime_error("updateERI2Kernels(): number of kernels doesn't match the shell "
+                                 "data");
+
+    for (size_t ishdata_a = 0, iclass = 0; ishdata_a < sh_datas.size(); ishdata_a++)
+        for (size_t ishdata_b = 0; ishdata_b <= ishdata_a; ishdata_b++, iclass++)
+            eri2_kernels[iclass].updateCoordinates(sh_datas[ishdata_a], sh_datas[ishdata_b]);
+}
+
 std::vector<double> lints::eri2Diagonal(const Structure &structure)
 {
     if (structure.getUseRI() == false)
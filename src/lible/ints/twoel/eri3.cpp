@@ -1,5 +1,8 @@
+#include <lible/ints/distributed.hpp>
+#include <lible/ints/instrumentation.hpp>
 #include <lible/ints/ints.hpp>
 #include <lible/ints/spherical_trafo.hpp>
+#include <lible/ints/symmetry.hpp>
 #include <lible/ints/twoel/eri_kernels.hpp>
 
 namespace lints = lible::ints;
@@ -12,6 +15,163 @@ lible::vec3d lints::eri3(const Structure &structure)
     std::vector<ShellData> sh_datas = shellDataAux(structure);
     std::vector<ShellPairData> sp_data = shellPairData(true, structure);
 
+    return eri3(structure, sp_data, sh_datas, eri3Kernels(sp_data, sh_datas));
+}
+
+lible::vec3d lints::eri3(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+                         const std::vector<ShellData> &sh_datas,
+                         const std::vector<ERI3Kernel> &eri3_kernels)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("RI approximation is not enabled!");
+
+    if (eri3_kernels.size() != sp_data.size() * sh_datas.size())
+        throw std::runtime_error("eri3(): number of kernels doesn't match the shell data");
+
+    // The tasks, {class, ipair_ab}, are the shell pairs of every (ab|c) class, distributed over
+    // the processes and threads.
+    std::vector<std::pair<size_t, size_t>> classes;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    std::vector<double> costs;
+    LIBLE_INSTRUMENT(std::vector<instrumentation::class_id_t> class_ids;)
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++)
+        {
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellData &sh_data_c = sh_datas[ishdata_c];
+
+            size_t iclass = classes.size();
+            classes.push_back({ispdata_ab, ishdata_c});
+            LIBLE_INSTRUMENT(class_ids.push_back(instrumentation::classId(
+                                 "eri3", {sp_data_ab.la_, sp_data_ab.lb_, sh_data_c.l_}));)
+
+            double cost_c = 0;
+            for (size_t ishell_c = 0; ishell_c < sh_data_c.n_shells_; ishell_c++)
+                cost_c += sh_data_c.cdepths_[ishell_c];
+            cost_c *= numSphericals(sp_data_ab.la_) * numSphericals(sp_data_ab.lb_) *
+                      numSphericals(sh_data_c.l_);
+
+            for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+            {
+                tasks.push_back({iclass, ipair_ab});
+                costs.push_back(sp_data_ab.nrs_ppairs_[ipair_ab] * cost_c);
+            }
+        }
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    vec3d eri3(Fill(0), dim_ao, dim_ao, dim_ao_aux);
+
+    TaskDistributor distributor(costs);
+
+    LIBLE_INSTRUMENT(instrumentation::time_point_t start_region = instrumentation::now();)
+
+#pragma omp parallel
+    {
+        size_t itask;
+        while (distributor.next(itask))
+        {
+            auto [iclass, ipair_ab] = tasks[itask];
+            auto [ispdata_ab, ishdata_c] = classes[iclass];
+
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellData &sh_data_c = sh_datas[ishdata_c];
+            const ERI3Kernel &eri3_kernel = eri3_kernels[iclass];
+
+            LIBLE_INSTRUMENT(instrumentation::Counters &counters =
+                                 instrumentation::setClass(class_ids[iclass]);)
+            LIBLE_INSTRUMENT(instrumentation::time_point_t start_task = instrumentation::now();)
+
+            for (size_t ishell_c = 0; ishell_c < sh_data_c.n_shells_; ishell_c++)
+            {
+                vec3d eri3_batch = eri3_kernel(ipair_ab, ishell_c, sp_data_ab, sh_data_c);
+
+                LIBLE_INSTRUMENT(counters.n_shell_tuples_++;)
+                LIBLE_INSTRUMENT(counters.n_prim_tuples_ += sp_data_ab.nrs_ppairs_[ipair_ab] *
+                                                            sh_data_c.cdepths_[ishell_c];)
+                LIBLE_INSTRUMENT(instrumentation::time_point_t start_scatter =
+                                     instrumentation::now();)
+
+                size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
+                for (size_t ia = 0; ia < eri3_batch.dim<0>(); ia++)
+                    for (size_t ib = 0; ib < eri3_batch.dim<1>(); ib++)
+                        for (size_t ic = 0; ic < eri3_batch.dim<2>(); ic++)
+                        {
+                            size_t mu = ofs_a + ia;
+                            size_t nu = ofs_b + ib;
+                            size_t ka = ofs_c + ic;
+
+                            eri3(mu, nu, ka) = eri3_batch(ia, ib, ic);
+                            eri3(nu, mu, ka) = eri3_batch(ia, ib, ic);
+                        }
+
+                LIBLE_INSTRUMENT(counters.time_scatter_ += instrumentation::since(start_scatter);)
+            }
+
+            LIBLE_INSTRUMENT(counters.time_busy_ += instrumentation::since(start_task);)
+            LIBLE_INSTRUMENT(instrumentation::unsetClass();)
+        }
+    }
+
+    LIBLE_INSTRUMENT(instrumentation::addWallTime("eri3", instrumentation::since(start_region));)
+    LIBLE_INSTRUMENT(instrumentation::mergeThreads();)
+
+    // Every element is computed by exactly one process.
+    allReduceSum(&eri3[0], eri3.size());
+
+    return eri3;
+}
+
+std::vector<lints::ERI3Kernel> lints::eri3Kernels(const std::vector<ShellPairData> &sp_data,
+                                                 const std::vector<ShellData> &sh_datas)
+{
+    std::vector<ERI3Kernel> eri3_kernels;
+    for (const ShellPairData &sp_data_ab : sp_data)
+    {
+        auto ecoeffs_bra = ecoeffsShared(sp_data_ab);
+        for (const ShellData &sh_data_c : sh_datas)
+            eri3_kernels.emplace_back(sp_data_ab, sh_data_c, ecoeffs_bra);
+    }
+
+    return eri3_kernels;
+}
+
+void lints::updateERI3Kernels(const std::vector<ShellPairData> &sp_data,
+                              const std::vector<ShellData> &sh_datas,
+                              std::vector<ERI3Kernel> &eri3_kernels)
+{
+    if (eri3_kernels.size() != sp_data.size() * sh_datas.size())
+        throw std::runtime_error("updateERI3Kernels(): number of kernels doesn't match the shell "
+                                 "data");
+
+    for (size_t ispdata_ab = 0, iclass = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+    {
+        auto ecoeffs_bra = ecoeffsShared(sp_data[ispdata_ab]);
+        for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++, iclass++)
+            eri3_kernels[iclass].updateCoordinates(sh_datas[ishdata_c], ecoeffs_bra);
+    }
+}
+
+lible::vec3d lints::eri3(const Structure &structure, const PointGroup &point_group)
+{
+    if (point_group.order() == 1)
+        return eri3(structure);
+
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("RI approximation is not enabled!");
+
+    ShellSymmetryMap shell_map = shellSymmetryMap(point_group, structure.getShellsView());
+    ShellSymmetryMap shell_map_aux = shellSymmetryMap(point_group, structure.getShellsViewAux());
+    const auto &aos = shell_map.aos_;
+    const auto &signs = shell_map.signs_;
+    const auto &aos_aux = shell_map_aux.aos_;
+    const auto &signs_aux = shell_map_aux.signs_;
+
+    std::vector<ShellData> sh_datas = shellDataAux(structure);
+    std::vector<ShellPairData> sp_data = shellPairData(true, structure);
+
     size_t dim_ao = structure.getDimAO();
     size_t dim_ao_aux = structure.getDimAOAux();
     vec3d eri3(Fill(0), dim_ao, dim_ao, dim_ao_aux);
@@ -20,29 +180,72 @@ lible::vec3d lints::eri3(const Structure &structure)
         {
             ERI3Kernel eri3_kernel(sp_data_ab, sh_data_c);
 
-#pragma omp parallel for
+            LIBLE_INSTRUMENT(instrumentation::class_id_t class_id = instrumentation::classId(
+                                 "eri3", {sp_data_ab.la_, sp_data_ab.lb_, sh_data_c.l_});)
+            LIBLE_INSTRUMENT(instrumentation::time_point_t start_class = instrumentation::now();)
+
+#pragma omp parallel for schedule(dynamic)
             for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+            {
+                LIBLE_INSTRUMENT(instrumentation::Counters &counters =
+                                     instrumentation::setClass(class_id);)
+                LIBLE_INSTRUMENT(instrumentation::time_point_t start_task = instrumentation::now();)
+
                 for (size_t ishell_c = 0; ishell_c < sh_data_c.n_shells_; ishell_c++)
                 {
+                    // Only the representative of the symmetry-equivalent triples is calculated,
+                    // the rest are obtained as (g(ab)|g(c)) = s_a s_b s_c (ab|c).
+                    SymmetryOps ops = uniqueTripleOps(sp_data_ab.shell_idxs_[2 * ipair_ab],
+                                                      sp_data_ab.shell_idxs_[2 * ipair_ab + 1],
+                                                      sh_data_c.shell_idxs_[ishell_c], shell_map,
+                                                      shell_map_aux);
+                    if (ops.empty())
+                    {
+                        LIBLE_INSTRUMENT(counters.n_screened_++;)
+                        continue;
+                    }
+
                     vec3d eri3_batch = eri3_kernel(ipair_ab, ishell_c, sp_data_ab,
                                                    sh_data_c);
 
+                    LIBLE_INSTRUMENT(counters.n_shell_tuples_++;)
+                    LIBLE_INSTRUMENT(counters.n_prim_tuples_ += sp_data_ab.nrs_ppairs_[ipair_ab] *
+                                                                sh_data_c.cdepths_[ishell_c];)
+                    LIBLE_INSTRUMENT(instrumentation::time_point_t start_scatter =
+                                         instrumentation::now();)
+
                     size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
                     size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
                     size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
-                    for (size_t ia = 0; ia < eri3_batch.dim<0>(); ia++)
-                        for (size_t ib = 0; ib < eri3_batch.dim<1>(); ib++)
-                            for (size_t ic = 0; ic < eri3_batch.dim<2>(); ic++)
-                            {
-                                size_t mu = ofs_a + ia;
-                                size_t nu = ofs_b + ib;
-                                size_t ka = ofs_c + ic;
-
-                                eri3(mu, nu, ka) = eri3_batch(ia, ib, ic);
-                                eri3(nu, mu, ka) = eri3_batch(ia, ib, ic);
-                            }
+                    for (size_t iop : ops)
+                        for (size_t ia = 0; ia < eri3_batch.dim<0>(); ia++)
+                            for (size_t ib = 0; ib < eri3_batch.dim<1>(); ib++)
+                                for (size_t ic = 0; ic < eri3_batch.dim<2>(); ic++)
+                                {
+                                    size_t mu = aos[iop][ofs_a + ia];
+                                    size_t nu = aos[iop][ofs_b + ib];
+                                    size_t ka = aos_aux[iop][ofs_c + ic];
+
+                                    int sign = signs[iop][ofs_a + ia] * signs[iop][ofs_b + ib] *
+                                               signs_aux[iop][ofs_c + ic];
+
+                                    eri3(mu, nu, ka) = sign * eri3_batch(ia, ib, ic);
+                                    eri3(nu, mu, ka) = sign * eri3_batch(ia, ib, ic);
+                                }
+
+                    LIBLE_INSTRUMENT(counters.time_scatter_ +=
+                                         instrumentation::since(start_scatter);)
                 }
+
+                LIBLE_INSTRUMENT(counters.time_busy_ += instrumentation::since(start_task);)
+                LIBLE_INSTRUMENT(instrumentation::unsetClass();)
+            }
+
+            LIBLE_INSTRUMENT(instrumentation::addWallTime("eri3",
+                                                         instrumentation::since(start_class));)
         }
 
+    LIBLE_INSTRUMENT(instrumentation::mergeThreads();)
+
     return eri3;
 }
\ No newline at end of file
@@ -1,10 +1,19 @@
 #include <lible/utils.hpp>
+#include <lible/ints/defs.hpp>
+#include <lible/ints/distributed.hpp>
+#include <lible/ints/instrumentation.hpp>
 #include <lible/ints/ints.hpp>
+#include <lible/ints/symmetry.hpp>
 #include <lible/ints/twoel/eri_kernels.hpp>
+#include <lible/ints/twoel/kernel_selector.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstring>
 #include <format>
+#include <limits>
+#include <utility>
 
 namespace lints = lible::ints;
 
@@ -13,6 +22,27 @@ namespace lible::ints
     /// Copies the integrals from the shell batch to the target container.
     void transferIntsERI4Diag(int ipair_ab, const ShellPairData &sp_data_ab,
                               const vec4d &eri4_batch, vec2d &eri4_diagonal);
+
+    /// Returns the maximum absolute values of the shell blocks of the given AO matrix.
+    vec2d shellBlockMaxima(const vec2d &matrix, std::span<const Shell> shells);
+
+    /// Timing of one pass over the shell quartets of an (ab|cd) class.
+    struct ClassTiming
+    {
+        /// Average time of a pass in seconds.
+        double time_{};
+        /// Number of the shell quartets in a pass.
+        size_t n_quartets_{};
+        /// Sum of the absolute values of the integrals from the last pass.
+        double sum_abs_{};
+    };
+
+    /// Calculates the shell quartets ab >= cd of the class with the given kernel. The pass is
+    /// repeated until `min_time` seconds have been spent or `max_repeats` passes are done, to
+    /// reduce the noise for the small classes. The kernel setup is left out of the timing.
+    ClassTiming timeERI4Class(const ERI4Kernel &eri4_kernel, bool same_class,
+                              const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd,
+                              double min_time = 0, int max_repeats = 1);
 }
 
 void lints::transferIntsERI4Diag(const int ipair_ab, const ShellPairData &sp_data_ab,
@@ -35,14 +65,51 @@ void lints::transferIntsERI4Diag(const int ipair_ab, const ShellPairData &sp_dat
         }
 }
 
+lible::vec2d lints::shellBlockMaxima(const vec2d &matrix, std::span<const Shell> shells)
+{
+    size_t n_shells = shells.size();
+
+    vec2d maxima(Fill(0), n_shells, n_shells);
+    for (size_t ishell = 0; ishell < n_shells; ishell++)
+        for (size_t jshell = 0; jshell < n_shells; jshell++)
+        {
+            const Shell &shell_a = shells[ishell];
+            const Shell &shell_b = shells[jshell];
+
+            double max_val = 0;
+            for (size_t mu = 0; mu < shell_a.dim_sph_; mu++)
+                for (size_t nu = 0; nu < shell_b.dim_sph_; nu++)
+                    max_val = std::max(max_val, std::fabs(matrix(shell_a.ofs_sph_ + mu,
+                                                                 shell_b.ofs_sph_ + nu)));
+
+            maxima(ishell, jshell) = max_val;
+        }
+
+    return maxima;
+}
+
 lible::vec4d lints::eri4(const Structure &structure)
+{
+    return eri4(structure, KernelSelector());
+}
+
+lible::vec4d lints::eri4(const Structure &structure, const KernelSelector &kernel_selector)
 {
     std::vector<ShellPairData> sp_data = shellPairData(true, structure);
 
+    return eri4(structure, sp_data, eri4Kernels(sp_data, kernel_selector));
+}
+
+lible::vec4d lints::eri4(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+                         const std::vector<ERI4Kernel> &eri4_kernels)
+{
+    if (eri4_kernels.size() != sp_data.size() * (sp_data.size() + 1) / 2)
+        throw std::runtime_error("eri4(): number of kernels doesn't match the shell pair data");
+
     size_t dim_ao = structure.getDimAO();
     vec4d eri4(Fill(0), dim_ao);
-    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
-        for (size_t isp_data_cd = 0; isp_data_cd <= ispdata_ab; isp_data_cd++)
+    for (size_t ispdata_ab = 0, iclass = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t isp_data_cd = 0; isp_data_cd <= ispdata_ab; isp_data_cd++, iclass++)
         {
             const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
             const ShellPairData &sp_data_cd = sp_data[isp_data_cd];
@@ -52,16 +119,31 @@ lible::vec4d lints::eri4(const Structure &structure)
             int n_sph_c = numSphericals(sp_data_cd.la_);
             int n_sph_d = numSphericals(sp_data_cd.lb_);
 
-            ERI4Kernel eri4_kernel(sp_data_ab, sp_data_cd);
+            const ERI4Kernel &eri4_kernel = eri4_kernels[iclass];
+
+            LIBLE_INSTRUMENT(instrumentation::class_id_t class_id = instrumentation::classId(
+                                 "eri4", {sp_data_ab.la_, sp_data_ab.lb_, sp_data_cd.la_,
+                                          sp_data_cd.lb_});)
+            LIBLE_INSTRUMENT(instrumentation::time_point_t start_class = instrumentation::now();)
 
 #pragma omp parallel for
             for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
             {
+                LIBLE_INSTRUMENT(instrumentation::Counters &counters =
+                                     instrumentation::setClass(class_id);)
+                LIBLE_INSTRUMENT(instrumentation::time_point_t start_task = instrumentation::now();)
+
                 size_t bound_cd = (ispdata_ab == isp_data_cd) ? ipair_ab + 1 : sp_data_cd.n_pairs_;
                 for (size_t ipair_cd = 0; ipair_cd < bound_cd; ipair_cd++)
                 {
                     vec4d eri4_batch = eri4_kernel(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd);
 
+                    LIBLE_INSTRUMENT(counters.n_shell_tuples_++;)
+                    LIBLE_INSTRUMENT(counters.n_prim_tuples_ += sp_data_ab.nrs_ppairs_[ipair_ab] *
+                                                                sp_data_cd.nrs_ppairs_[ipair_cd];)
+                    LIBLE_INSTRUMENT(instrumentation::time_point_t start_scatter =
+                                         instrumentation::now();)
+
                     size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
                     size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
                     size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
@@ -87,59 +169,258 @@ lible::vec4d lints::eri4(const Structure &structure)
                                     eri4(ta, ka, mu, nu) = integral;
                                     eri4(ta, ka, nu, mu) = integral;
                                 }
+
+                    LIBLE_INSTRUMENT(counters.time_scatter_ +=
+                                         instrumentation::since(start_scatter);)
                 }
+
+                LIBLE_INSTRUMENT(counters.time_busy_ += instrumentation::since(start_task);)
+                LIBLE_INSTRUMENT(instrumentation::unsetClass();)
             }
+
+            LIBLE_INSTRUMENT(instrumentation::addWallTime("eri4",
+                                                         instrumentation::since(start_class));)
         }
 
+    LIBLE_INSTRUMENT(instrumentation::mergeThreads();)
+
     return eri4;
 }
 
-void lints::eri4Benchmark(const Structure &structure)
+std::vector<lints::ERI4Kernel> lints::eri4Kernels(const std::vector<ShellPairData> &sp_data,
+                                                 const KernelSelector &kernel_selector)
 {
-    palPrint(std::format("Lible::{:<40}\n", "ERI4 benchmark..."));
+    // The E-coefficients of a class are calculated when a kernel first needs them, so the
+    // classes used only by the Rys kernels don't store them.
+    std::vector<std::shared_ptr<const std::vector<double>>> ecoeffs_bra(sp_data.size());
+    std::vector<std::shared_ptr<const std::vector<double>>> ecoeffs_ket(sp_data.size());
 
-    auto start_total{std::chrono::steady_clock::now()};
+    std::vector<ERI4Kernel> eri4_kernels;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++)
+        {
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellPairData &sp_data_cd = sp_data[ispdata_cd];
+
+            ERIBackend backend = kernel_selector.select(sp_data_ab, sp_data_cd);
+            if (backend == ERIBackend::rys)
+            {
+                eri4_kernels.emplace_back(sp_data_ab, sp_data_cd, backend);
+                continue;
+            }
+
+            if (!ecoeffs_bra[ispdata_ab])
+                ecoeffs_bra[ispdata_ab] = ecoeffsShared(sp_data_ab, false);
+            if (!ecoeffs_ket[ispdata_cd])
+                ecoeffs_ket[ispdata_cd] = ecoeffsShared(sp_data_cd, true);
+
+            eri4_kernels.emplace_back(sp_data_ab, sp_data_cd, ecoeffs_bra[ispdata_ab],
+                                      ecoeffs_ket[ispdata_cd], backend);
+        }
+
+    return eri4_kernels;
+}
+
+void lints::updateERI4Kernels(const std::vector<ShellPairData> &sp_data,
+                              std::vector<ERI4Kernel> &eri4_kernels)
+{
+    if (eri4_kernels.size() != sp_data.size() * (sp_data.size() + 1) / 2)
+        throw std::runtime_error("updateERI4Kernels(): number of kernels doesn't match the shell "
+                                 "pair data");
+
+    std::vector<std::shared_ptr<const std::vector<double>>> ecoeffs_bra(sp_data.size());
+    std::vector<std::shared_ptr<const std::vector<double>>> ecoeffs_ket(sp_data.size());
+    for (size_t ispdata_ab = 0, iclass = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++, iclass++)
+        {
+            ERI4Kernel &eri4_kernel = eri4_kernels[iclass];
+            if (eri4_kernel.backend_ == ERIBackend::rys)
+                continue;
+
+            if (!ecoeffs_bra[ispdata_ab])
+                ecoeffs_bra[ispdata_ab] = ecoeffsShared(sp_data[ispdata_ab], false);
+            if (!ecoeffs_ket[ispdata_cd])
+                ecoeffs_ket[ispdata_cd] = ecoeffsShared(sp_data[ispdata_cd], true);
+
+            eri4_kernel.updateCoordinates(ecoeffs_bra[ispdata_ab], ecoeffs_ket[ispdata_cd]);
+        }
+}
+
+lible::vec4d lints::eri4(const Structure &structure, const PointGroup &point_group)
+{
+    if (point_group.order() == 1)
+        return eri4(structure);
+
+    ShellSymmetryMap shell_map = shellSymmetryMap(point_group, structure.getShellsView());
+    const auto &aos = shell_map.aos_;
+    const auto &signs = shell_map.signs_;
 
     std::vector<ShellPairData> sp_data = shellPairData(true, structure);
 
-    double sum_eri4 = 0;
+    size_t dim_ao = structure.getDimAO();
+    vec4d eri4(Fill(0), dim_ao);
     for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
-        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++)
+        for (size_t isp_data_cd = 0; isp_data_cd <= ispdata_ab; isp_data_cd++)
         {
-            auto start{std::chrono::steady_clock::now()};
-
-            const auto &sp_data_ab = sp_data[ispdata_ab];
-            const auto &sp_data_cd = sp_data[ispdata_cd];
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellPairData &sp_data_cd = sp_data[isp_data_cd];
 
-            size_t n_pairs_ab = sp_data_ab.n_pairs_;
-            size_t n_pairs_cd = sp_data_cd.n_pairs_;
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            int n_sph_c = numSphericals(sp_data_cd.la_);
+            int n_sph_d = numSphericals(sp_data_cd.lb_);
 
             ERI4Kernel eri4_kernel(sp_data_ab, sp_data_cd);
 
-            size_t n_shells_abcd = 0;
-            for (size_t ipair_ab = 0; ipair_ab < n_pairs_ab; ipair_ab++)
+            LIBLE_INSTRUMENT(instrumentation::class_id_t class_id = instrumentation::classId(
+                                 "eri4", {sp_data_ab.la_, sp_data_ab.lb_, sp_data_cd.la_,
+                                          sp_data_cd.lb_});)
+            LIBLE_INSTRUMENT(instrumentation::time_point_t start_class = instrumentation::now();)
+
+#pragma omp parallel for schedule(dynamic)
+            for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
             {
-                size_t bound_cd = (ispdata_ab == ispdata_cd) ? ipair_ab + 1 : n_pairs_cd;
+                LIBLE_INSTRUMENT(instrumentation::Counters &counters =
+                                     instrumentation::setClass(class_id);)
+                LIBLE_INSTRUMENT(instrumentation::time_point_t start_task = instrumentation::now();)
+
+                size_t bound_cd = (ispdata_ab == isp_data_cd) ? ipair_ab + 1 : sp_data_cd.n_pairs_;
                 for (size_t ipair_cd = 0; ipair_cd < bound_cd; ipair_cd++)
                 {
+                    // Only the representative of the symmetry-equivalent quartets is calculated,
+                    // the rest are obtained as (g(ab)|g(cd)) = s_a s_b s_c s_d (ab|cd).
+                    SymmetryOps ops = uniqueQuartetOps(sp_data_ab.shell_idxs_[2 * ipair_ab],
+                                                       sp_data_ab.shell_idxs_[2 * ipair_ab + 1],
+                                                       sp_data_cd.shell_idxs_[2 * ipair_cd],
+                                                       sp_data_cd.shell_idxs_[2 * ipair_cd + 1],
+                                                       shell_map);
+                    if (ops.empty())
+                    {
+                        LIBLE_INSTRUMENT(counters.n_screened_++;)
+                        continue;
+                    }
+
                     vec4d eri4_batch = eri4_kernel(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd);
 
-                    for (double x : eri4_batch)
-                        sum_eri4 += std::fabs(x);
+                    LIBLE_INSTRUMENT(counters.n_shell_tuples_++;)
+                    LIBLE_INSTRUMENT(counters.n_prim_tuples_ += sp_data_ab.nrs_ppairs_[ipair_ab] *
+                                                                sp_data_cd.nrs_ppairs_[ipair_cd];)
+                    LIBLE_INSTRUMENT(instrumentation::time_point_t start_scatter =
+                                         instrumentation::now();)
 
-                    n_shells_abcd++;
+                    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                    size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
+                    size_t ofs_d = sp_data_cd.offsets_sph_[2 * ipair_cd + 1];
+
+                    for (size_t iop : ops)
+                        for (int ia = 0; ia < n_sph_a; ia++)
+                            for (int ib = 0; ib < n_sph_b; ib++)
+                                for (int ic = 0; ic < n_sph_c; ic++)
+                                    for (int id = 0; id < n_sph_d; id++)
+                                    {
+                                        size_t mu = aos[iop][ofs_a + ia];
+                                        size_t nu = aos[iop][ofs_b + ib];
+                                        size_t ka = aos[iop][ofs_c + ic];
+                                        size_t ta = aos[iop][ofs_d + id];
+
+                                        int sign = signs[iop][ofs_a + ia] * signs[iop][ofs_b + ib] *
+                                                   signs[iop][ofs_c + ic] * signs[iop][ofs_d + id];
+
+                                        double integral = sign * eri4_batch(ia, ib, ic, id);
+                                        eri4(mu, nu, ka, ta) = integral;
+                                        eri4(mu, nu, ta, ka) = integral;
+                                        eri4(nu, mu, ka, ta) = integral;
+                                        eri4(nu, mu, ta, ka) = integral;
+                                        eri4(ka, ta, mu, nu) = integral;
+                                        eri4(ka, ta, nu, mu) = integral;
+                                        eri4(ta, ka, mu, nu) = integral;
+                                        eri4(ta, ka, nu, mu) = integral;
+                                    }
+
+                    LIBLE_INSTRUMENT(counters.time_scatter_ +=
+                                         instrumentation::since(start_scatter);)
                 }
+
+                LIBLE_INSTRUMENT(counters.time_busy_ += instrumentation::since(start_task);)
+                LIBLE_INSTRUMENT(instrumentation::unsetClass();)
+            }
+
+            LIBLE_INSTRUMENT(instrumentation::addWallTime("eri4",
+                                                         instrumentation::since(start_class));)
+        }
+
+    LIBLE_INSTRUMENT(instrumentation::mergeThreads();)
+
+    return eri4;
+}
+
+lints::ClassTiming lints::timeERI4Class(const ERI4Kernel &eri4_kernel, const bool same_class,
+                                        const ShellPairData &sp_data_ab,
+                                        const ShellPairData &sp_data_cd, const double min_time,
+                                        const int max_repeats)
+{
+    ClassTiming timing;
+
+    auto start{std::chrono::steady_clock::now()};
+
+    int n_repeats = 0;
+    double elapsed = 0;
+    while (n_repeats == 0 || (elapsed < min_time && n_repeats < max_repeats))
+    {
+        timing.n_quartets_ = 0;
+        timing.sum_abs_ = 0;
+        for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+        {
+            size_t bound_cd = same_class ? ipair_ab + 1 : sp_data_cd.n_pairs_;
+            for (size_t ipair_cd = 0; ipair_cd < bound_cd; ipair_cd++)
+            {
+                vec4d eri4_batch = eri4_kernel(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd);
+
+                for (double x : eri4_batch)
+                    timing.sum_abs_ += std::fabs(x);
+
+                timing.n_quartets_++;
             }
+        }
+
+        n_repeats++;
+        std::chrono::duration<double> duration{std::chrono::steady_clock::now() - start};
+        elapsed = duration.count();
+    }
 
-            auto end{std::chrono::steady_clock::now()};
-            std::chrono::duration<double> duration{end - start};
+    timing.time_ = elapsed / n_repeats;
+
+    return timing;
+}
+
+void lints::eri4Benchmark(const Structure &structure, const ERIBackend backend)
+{
+    palPrint(std::format("Lible::{:<40}\n", "ERI4 benchmark..."));
+
+    auto start_total{std::chrono::steady_clock::now()};
+
+    std::vector<ShellPairData> sp_data = shellPairData(true, structure);
+
+    double sum_eri4 = 0;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++)
+        {
+            const auto &sp_data_ab = sp_data[ispdata_ab];
+            const auto &sp_data_cd = sp_data[ispdata_cd];
+
+            ERI4Kernel eri4_kernel(sp_data_ab, sp_data_cd, backend);
+
+            ClassTiming timing = timeERI4Class(eri4_kernel, ispdata_ab == ispdata_cd, sp_data_ab,
+                                               sp_data_cd);
+            sum_eri4 += timing.sum_abs_;
 
             int la = sp_data_ab.la_;
             int lb = sp_data_ab.lb_;
             int lc = sp_data_cd.la_;
             int ld = sp_data_cd.lb_;
             palPrint(std::format("   {} {} {} {} ; {:10} ; {:.2e} s\n", la, lb, lc, ld,
-                                 n_shells_abcd, duration.count()));
+                                 timing.n_quartets_, timing.time_));
         }
 
     palPrint(std::format("   sum_eri4 = {:16.12f}\n", sum_eri4));
@@ -149,10 +430,77 @@ void lints::eri4Benchmark(const Structure &structure)
     palPrint(std::format("done {:.2e} s\n", duration.count()));
 }
 
-lible::vec2d lints::eri4Diagonal(const Structure &structure)
+lints::KernelSelector lints::eri4Autotune(const Structure &structure,
+                                          const std::string &tuning_file)
 {
+    palPrint(std::format("Lible::{:<40}\n", "ERI4 autotuning..."));
+
+    auto start_total{std::chrono::steady_clock::now()};
+
+    // Each variant is repeated until this much time has been spent on it.
+    const double min_time = 1e-2;
+    const int max_repeats = 10;
+
     std::vector<ShellPairData> sp_data = shellPairData(true, structure);
 
+    KernelSelector kernel_selector;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++)
+        {
+            const auto &sp_data_ab = sp_data[ispdata_ab];
+            const auto &sp_data_cd = sp_data[ispdata_cd];
+
+            auto [la, lb] = sp_data_ab.getLPair();
+            auto [lc, ld] = sp_data_cd.getLPair();
+            int labcd = la + lb + lc + ld;
+
+            std::vector<ERIBackend> variants{ERIBackend::shark, ERIBackend::rys};
+            if (labcd <= _max_l_rollout_)
+                variants.push_back(ERIBackend::shark_generic);
+
+            ERIBackend best_variant = ERIBackend::shark;
+            double best_time = std::numeric_limits<double>::max();
+            std::string timings;
+            for (ERIBackend variant : variants)
+            {
+                // The Rys quadrature tables, e.g., are built only once per number of roots.
+                ERI4Kernel eri4_kernel(sp_data_ab, sp_data_cd, variant);
+
+                double time = timeERI4Class(eri4_kernel, ispdata_ab == ispdata_cd, sp_data_ab,
+                                            sp_data_cd, min_time, max_repeats).time_;
+                if (time < best_time)
+                {
+                    best_time = time;
+                    best_variant = variant;
+                }
+
+                timings += std::format(" ; {} {:.2e} s", eriBackendString(variant), time);
+            }
+
+            int depth_bucket = KernelSelector::depthBucket(sp_data_ab, sp_data_cd);
+            kernel_selector.set(la, lb, lc, ld, depth_bucket, best_variant);
+
+            palPrint(std::format("   {} {} {} {} ; {}{} ; -> {}\n", la, lb, lc, ld, depth_bucket,
+                                 timings, eriBackendString(best_variant)));
+        }
+
+    kernel_selector.write(tuning_file);
+
+    const auto end_total{std::chrono::steady_clock::now()};
+    std::chrono::duration<double> duration{end_total - start_total};
+    palPrint(std::format("done {:.2e} s\n", duration.count()));
+
+    return kernel_selector;
+}
+
+lible::vec2d lints::eri4Diagonal(const Structure &structure)
+{
+    return eri4Diagonal(structure, shellPairData(true, structure));
+}
+
+lible::vec2d lints::eri4Diagonal(const Structure &structure,
+                                 const std::vector<ShellPairData> &sp_data)
+{
     size_t dim_ao = structure.getDimAO();
     vec2d eri4_diagonal(Fill(0), dim_ao, dim_ao);
     for (size_t ispdata = 0; ispdata < sp_data.size(); ispdata++)
@@ -172,3 +520,182 @@ lible::vec2d lints::eri4Diagonal(const Structure &structure)
 
     return eri4_diagonal;
 }
+
+std::pair<lible::vec2d, lible::vec2d> lints::eri4GradientJK(const Structure &structure,
+                                                           const vec2d &density_j,
+                                                           const vec2d &density_k,
+                                                           const double screening_thrs)
+{
+    return eri4GradientJK(structure, shellPairData(true, structure), density_j, density_k,
+                          screening_thrs);
+}
+
+std::pair<lible::vec2d, lible::vec2d>
+lints::eri4GradientJK(const Structure &structure, const std::vector<ShellPairData> &sp_data,
+                      const vec2d &density_j, const vec2d &density_k, const double screening_thrs)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density_j.dim<0>() != dim_ao || density_j.dim<1>() != dim_ao ||
+        density_k.dim<0>() != dim_ao || density_k.dim<1>() != dim_ao)
+        throw std::runtime_error("eri4GradientJK(): dimensions of the density matrices don't "
+                                 "match the number of AOs");
+
+    std::span<const Shell> shells = structure.getShellsView();
+
+    size_t n_centers = structure.getNCenters();
+
+    // Density-weighted Schwarz screening: |D| (ab|ab)^1/2 (cd|cd)^1/2, where |D| is the largest
+    // density element multiplying the quartet in the J or K contraction.
+    vec2d schwarz = shellBlockMaxima(eri4Diagonal(structure, sp_data), shells);
+    for (double &val : schwarz)
+        val = std::sqrt(val);
+
+    vec2d dmax_j = shellBlockMaxima(density_j, shells);
+    vec2d dmax_k = shellBlockMaxima(density_k, shells);
+
+    // The tasks, {class, ipair_ab}, are the bra shell pairs of every (ab|cd) class, distributed
+    // over the processes and threads. The cost of a task is estimated by the number of
+    // primitive quartets times the number of spherical quartets before screening.
+    std::vector<ERI4D1Kernel> eri4d1_kernels;
+    std::vector<std::pair<size_t, size_t>> classes;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    std::vector<double> costs;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++)
+        {
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellPairData &sp_data_cd = sp_data[ispdata_cd];
+
+            size_t iclass = classes.size();
+            classes.push_back({ispdata_ab, ispdata_cd});
+            eri4d1_kernels.emplace_back(sp_data_ab, sp_data_cd);
+
+            std::vector<double> cost_cd(sp_data_cd.n_pairs_ + 1, 0);
+            for (size_t ipair_cd = 0; ipair_cd < sp_data_cd.n_pairs_; ipair_cd++)
+                cost_cd[ipair_cd + 1] = cost_cd[ipair_cd] + sp_data_cd.nrs_ppairs_[ipair_cd];
+
+            double n_sph_abcd = numSphericals(sp_data_ab.la_) * numSphericals(sp_data_ab.lb_) *
+                                numSphericals(sp_data_cd.la_) * numSphericals(sp_data_cd.lb_);
+
+            for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+            {
+                size_t bound_cd = (ispdata_ab == ispdata_cd) ? ipair_ab + 1 : sp_data_cd.n_pairs_;
+
+                tasks.push_back({iclass, ipair_ab});
+                costs.push_back(n_sph_abcd * sp_data_ab.nrs_ppairs_[ipair_ab] * cost_cd[bound_cd]);
+            }
+        }
+
+    vec2d gradient_j(Fill(0), n_centers, 3);
+    vec2d gradient_k(Fill(0), n_centers, 3);
+
+    TaskDistributor distributor(costs);
+
+#pragma omp parallel
+    {
+        vec2d gradient_j_omp(Fill(0), n_centers, 3);
+        vec2d gradient_k_omp(Fill(0), n_centers, 3);
+
+        size_t itask;
+        while (distributor.next(itask))
+        {
+            auto [iclass, ipair_ab] = tasks[itask];
+            auto [ispdata_ab, ispdata_cd] = classes[iclass];
+
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellPairData &sp_data_cd = sp_data[ispdata_cd];
+            const ERI4D1Kernel &eri4d1_kernel = eri4d1_kernels[iclass];
+
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            int n_sph_c = numSphericals(sp_data_cd.la_);
+            int n_sph_d = numSphericals(sp_data_cd.lb_);
+
+            size_t bound_cd = (ispdata_ab == ispdata_cd) ? ipair_ab + 1 : sp_data_cd.n_pairs_;
+            for (size_t ipair_cd = 0; ipair_cd < bound_cd; ipair_cd++)
+            {
+                size_t ishell_a = sp_data_ab.shell_idxs_[2 * ipair_ab];
+                size_t ishell_b = sp_data_ab.shell_idxs_[2 * ipair_ab + 1];
+                size_t ishell_c = sp_data_cd.shell_idxs_[2 * ipair_cd];
+                size_t ishell_d = sp_data_cd.shell_idxs_[2 * ipair_cd + 1];
+
+                double dmax = std::max({dmax_j(ishell_a, ishell_b) * dmax_j(ishell_c, ishell_d),
+                                        dmax_k(ishell_a, ishell_c) * dmax_k(ishell_b, ishell_d),
+                                        dmax_k(ishell_a, ishell_d) * dmax_k(ishell_b, ishell_c)});
+                double bound = dmax * schwarz(ishell_a, ishell_b) * schwarz(ishell_c, ishell_d);
+                if (bound < screening_thrs)
+                    continue;
+
+                std::array<vec4d, 9> eri4_batch =
+                        eri4d1_kernel.derivativesABC(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd);
+
+                size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
+                size_t ofs_d = sp_data_cd.offsets_sph_[2 * ipair_cd + 1];
+
+                // Degeneracy of the shell quartet within the 8-fold permutational symmetry.
+                double deg = 0.5;
+                if (ishell_a != ishell_b)
+                    deg *= 2;
+                if (ishell_c != ishell_d)
+                    deg *= 2;
+                if (ispdata_ab != ispdata_cd || ipair_ab != ipair_cd)
+                    deg *= 2;
+
+                // Only the A, B and C derivatives are contracted, the D derivative follows from
+                // translational invariance.
+                std::array<double, 9> contr_j{};
+                std::array<double, 9> contr_k{};
+                for (int ia = 0, idx = 0; ia < n_sph_a; ia++)
+                    for (int ib = 0; ib < n_sph_b; ib++)
+                        for (int ic = 0; ic < n_sph_c; ic++)
+                            for (int id = 0; id < n_sph_d; id++, idx++)
+                            {
+                                size_t mu = ofs_a + ia;
+                                size_t nu = ofs_b + ib;
+                                size_t ka = ofs_c + ic;
+                                size_t ta = ofs_d + id;
+
+                                double weight_j = density_j(mu, nu) * density_j(ka, ta);
+                                double weight_k = 0.5 * (density_k(mu, ka) * density_k(nu, ta) +
+                                                         density_k(mu, ta) * density_k(nu, ka));
+
+                                for (int ideriv = 0; ideriv < 9; ideriv++)
+                                {
+                                    double integral = eri4_batch[ideriv][idx];
+                                    contr_j[ideriv] += weight_j * integral;
+                                    contr_k[ideriv] += weight_k * integral;
+                                }
+                            }
+
+                std::array<size_t, 3> atoms{sp_data_ab.atomic_idxs_[2 * ipair_ab],
+                                            sp_data_ab.atomic_idxs_[2 * ipair_ab + 1],
+                                            sp_data_cd.atomic_idxs_[2 * ipair_cd]};
+                size_t atom_d = sp_data_cd.atomic_idxs_[2 * ipair_cd + 1];
+                for (int icenter = 0; icenter < 3; icenter++)
+                    for (int icart = 0; icart < 3; icart++)
+                    {
+                        double grad_j = deg * contr_j[3 * icenter + icart];
+                        double grad_k = deg * contr_k[3 * icenter + icart];
+
+                        gradient_j_omp(atoms[icenter], icart) += grad_j;
+                        gradient_k_omp(atoms[icenter], icart) += grad_k;
+                        gradient_j_omp(atom_d, icart) -= grad_j;
+                        gradient_k_omp(atom_d, icart) -= grad_k;
+                    }
+            }
+        }
+
+#pragma omp critical
+        {
+            gradient_j += gradient_j_omp;
+            gradient_k += gradient_k_omp;
+        }
+    }
+
+    allReduceSum(&gradient_j[0], gradient_j.size());
+    allReduceSum(&gradient_k[0], gradient_k.size());
+
+    return {gradient_j, gradient_k};
+}
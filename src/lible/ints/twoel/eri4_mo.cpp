@@ -0,0 +1,649 @@
+#include <lible/ints/ints.hpp>
+#include <lible/ints/twoel/eri_kernels.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _LIBLE_USE_MKL_
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Returns the index of the pair p >= q in the packed lower triangle.
+    constexpr size_t idxPair(const size_t p, const size_t q)
+    {
+        return p * (p + 1) / 2 + q;
+    }
+
+    /// Shell pairs of all the classes in one list, ordered by the class and then by the pair
+    /// index. The shell quartets are calculated for the pairs P >= Q in this order.
+    struct ShellPairList
+    {
+        /// {class, pair index in the class} of every shell pair.
+        std::vector<std::pair<size_t, size_t>> pairs_;
+        /// Position of the first shell pair of every class in the list.
+        std::vector<size_t> offsets_;
+        /// AO pair rows of every shell pair, see aoPairRows().
+        std::vector<std::vector<std::pair<size_t, int>>> rows_;
+        /// Position of the first row of every shell pair among all the rows. The last element
+        /// is the total number of rows.
+        std::vector<size_t> offsets_rows_;
+    };
+
+    /// Half-transformed integrals, (mu nu|rs) with mu >= nu, for the MOs r in
+    /// [ofs_r, ofs_r + n_r) and s <= r. These are the packed rs columns [ofs_rs, ofs_rs + n_rs),
+    /// stored as (mu nu, rs). With `block_rows`, the rows are instead those of the current block
+    /// of shell pairs, in the order of the list.
+    struct HalfTransformed
+    {
+        size_t ofs_r_{};
+        size_t n_r_{};
+        size_t ofs_rs_{};
+        size_t n_rs_{};
+        bool block_rows_{};
+        std::vector<double> ints_;
+    };
+
+    /// Returns the AO pairs of the shell pair `ipair_ab` as {mu nu, ab}, where mu nu is the
+    /// position of the pair mu >= nu in the packed lower triangle and ab the position in the
+    /// shell pair block. The pairs with mu < nu of a shell with itself are skipped.
+    std::vector<std::pair<size_t, int>> aoPairRows(size_t ipair_ab,
+                                                   const ShellPairData &sp_data_ab);
+
+    /// Creates the list of all the shell pairs.
+    ShellPairList shellPairList(const std::vector<ShellPairData> &sp_datas);
+
+    /// Returns the number of doubles in the buffers of a thread in quarterTransform(),
+    /// halfTransform() and secondHalfTransform() for `n_r` MOs r at a time.
+    size_t threadBufferSize(const std::vector<ShellPairData> &sp_datas, size_t dim_ao,
+                            size_t n_mo, size_t n_r);
+
+    /// Calculates the quarter-transformed integrals, X(mu nu, ka, r) = sum_ta (mu nu|ka ta) C_ta,r,
+    /// for the MOs r of `half` and the rows of the shell pairs [begin, end) of the list, stored
+    /// as (row, ka, r). The bra shell pairs P of the block are calculated with all the ket shell
+    /// pairs Q, except for the Q > P of the same block. A quartet (P|Q) with Q < P in the block
+    /// is added to the rows of both shell pairs. The ket shell pairs of a class are gathered
+    /// into one buffer, so that their rows are transformed with one DGEMM per class.
+    void quarterTransform(size_t begin, size_t end, const ShellPairList &sp_list,
+                          const std::vector<ShellPairData> &sp_datas,
+                          const std::vector<std::vector<ERI4Kernel>> &eri4_kernels,
+                          const vec2d &mo_coeffs, const HalfTransformed &half,
+                          std::vector<double> &ints_x);
+
+    /// Calculates the half-transformed integrals, (mu nu|rs) = sum_ka C_ka,s X(mu nu, ka, r),
+    /// for the rows of the shell pairs [begin, end) of the list and stores them in `half`.
+    void halfTransform(size_t begin, size_t end, const ShellPairList &sp_list,
+                       const std::vector<double> &ints_x, const vec2d &mo_coeffs,
+                       HalfTransformed &half);
+
+    /// Calculates the second half of the transformation, (pq|rs) = sum_{mu nu} C_mu,p C_nu,q
+    /// (mu nu|rs), for the rs columns of `half` and stores the (pq|rs) with pq >= rs in the
+    /// packed output.
+    void secondHalfTransform(const HalfTransformed &half, const vec2d &mo_coeffs,
+                             std::vector<double> &eri4_mo);
+}
+
+std::vector<std::pair<size_t, int>> lints::aoPairRows(const size_t ipair_ab,
+                                                      const ShellPairData &sp_data_ab)
+{
+    int n_sph_a = numSphericals(sp_data_ab.la_);
+    int n_sph_b = numSphericals(sp_data_ab.lb_);
+
+    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+    bool same_shell = sp_data_ab.shell_idxs_[2 * ipair_ab] ==
+                      sp_data_ab.shell_idxs_[2 * ipair_ab + 1];
+
+    std::vector<std::pair<size_t, int>> rows;
+    for (int ia = 0, ab = 0; ia < n_sph_a; ia++)
+        for (int ib = 0; ib < n_sph_b; ib++, ab++)
+        {
+            if (same_shell && ib > ia)
+                continue;
+
+            size_t mu = ofs_a + ia;
+            size_t nu = ofs_b + ib;
+            rows.push_back({idxPair(std::max(mu, nu), std::min(mu, nu)), ab});
+        }
+
+    return rows;
+}
+
+lints::ShellPairList lints::shellPairList(const std::vector<ShellPairData> &sp_datas)
+{
+    ShellPairList sp_list;
+    sp_list.offsets_rows_.push_back(0);
+    for (size_t ispdata = 0; ispdata < sp_datas.size(); ispdata++)
+    {
+        sp_list.offsets_.push_back(sp_list.pairs_.size());
+        for (size_t ipair = 0; ipair < sp_datas[ispdata].n_pairs_; ipair++)
+        {
+            sp_list.pairs_.push_back({ispdata, ipair});
+            sp_list.rows_.push_back(aoPairRows(ipair, sp_datas[ispdata]));
+            sp_list.offsets_rows_.push_back(sp_list.offsets_rows_.back() +
+                                            sp_list.rows_.back().size());
+        }
+    }
+
+    return sp_list;
+}
+
+size_t lints::threadBufferSize(const std::vector<ShellPairData> &sp_datas, const size_t dim_ao,
+                               const size_t n_mo, const size_t n_r)
+{
+    size_t size_quarter = 0;
+    for (const ShellPairData &sp_data_ab : sp_datas)
+        for (const ShellPairData &sp_data_cd : sp_datas)
+        {
+            size_t n_sph_a = numSphericals(sp_data_ab.la_);
+            size_t n_sph_b = numSphericals(sp_data_ab.lb_);
+            size_t n_ab = n_sph_a * n_sph_b;
+            size_t n_cd = numSphericals(sp_data_cd.la_) * numSphericals(sp_data_cd.lb_);
+            size_t n_pairs_cd = sp_data_cd.n_pairs_;
+
+            // X of the bra, the transposed batch, and the gathered and transformed class.
+            size_t size = dim_ao * n_ab * n_r + n_ab * n_cd + 2 * n_pairs_cd * n_ab * n_cd +
+                          n_pairs_cd * n_cd * (n_sph_a + n_sph_b) * n_r;
+
+            size_quarter = std::max(size_quarter, size);
+        }
+
+    size_t size_half = n_r * n_mo;
+    size_t size_second_half = dim_ao * dim_ao + dim_ao * n_mo + n_mo * n_mo;
+
+    return std::max({size_quarter, size_half, size_second_half});
+}
+
+void lints::quarterTransform(const size_t begin, const size_t end, const ShellPairList &sp_list,
+                             const std::vector<ShellPairData> &sp_datas,
+                             const std::vector<std::vector<ERI4Kernel>> &eri4_kernels,
+                             const vec2d &mo_coeffs, const HalfTransformed &half,
+                             std::vector<double> &ints_x)
+{
+    size_t dim_ao = mo_coeffs.dim<0>();
+    size_t n_mo = mo_coeffs.dim<1>();
+    size_t ofs_r = half.ofs_r_;
+    int n_r = int(half.n_r_);
+
+    size_t ofs_row_block = sp_list.offsets_rows_[begin];
+    size_t n_rows_block = sp_list.offsets_rows_[end] - ofs_row_block;
+    ints_x.assign(n_rows_block * dim_ao * n_r, 0);
+
+    // Adds the (n_ka, r) block to X(row, ka, r) of the given row of the block.
+    auto addToX = [&](const size_t irow, const size_t ofs_ka, const int n_ka, const double *block)
+    {
+        double *x = &ints_x[((irow - ofs_row_block) * dim_ao + ofs_ka) * n_r];
+        for (int i = 0; i < n_ka * n_r; i++)
+        {
+#pragma omp atomic
+            x[i] += block[i];
+        }
+    };
+
+#pragma omp parallel
+    {
+        std::vector<double> ints_x_ab;
+        std::vector<double> batch_t;
+        std::vector<double> ints_class_a;
+        std::vector<double> ints_class_b;
+        std::vector<double> ints_class_ar;
+        std::vector<double> ints_class_br;
+
+#pragma omp for schedule(dynamic)
+        for (size_t ipair = begin; ipair < end; ipair++)
+        {
+            auto [ispdata_ab, ipair_ab] = sp_list.pairs_[ipair];
+            const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            int n_ab = n_sph_a * n_sph_b;
+
+            size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+            size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+            bool same_shell_ab = sp_data_ab.shell_idxs_[2 * ipair_ab] ==
+                                 sp_data_ab.shell_idxs_[2 * ipair_ab + 1];
+
+            // X(ka, ab, r) of the bra shell pair.
+            ints_x_ab.assign(dim_ao * n_ab * n_r, 0);
+            for (size_t ispdata_cd = 0; ispdata_cd < sp_datas.size(); ispdata_cd++)
+            {
+                const ShellPairData &sp_data_cd = sp_datas[ispdata_cd];
+                const ERI4Kernel &eri4_kernel = eri4_kernels[ispdata_ab][ispdata_cd];
+
+                int n_sph_c = numSphericals(sp_data_cd.la_);
+                int n_sph_d = numSphericals(sp_data_cd.lb_);
+                int n_cd = n_sph_c * n_sph_d;
+                int n_abcd = n_ab * n_cd;
+
+                // The ket pairs in [ofs_block, ipair) of the list are added to the rows of both
+                // pairs and the ket pairs in [ipair, end) are left to their own tasks.
+                size_t ofs_cd = sp_list.offsets_[ispdata_cd];
+                size_t end_cd = ofs_cd + sp_data_cd.n_pairs_;
+                size_t ofs_block = std::clamp(begin, ofs_cd, end_cd) - ofs_cd;
+                size_t bound_both = std::clamp(ipair, ofs_cd, end_cd) - ofs_cd;
+                size_t ofs_skip = std::clamp(ipair + 1, ofs_cd, end_cd) - ofs_cd;
+                size_t bound_skip = std::clamp(end, ofs_cd, end_cd) - ofs_cd;
+                size_t n_both = bound_both - ofs_block;
+
+                ints_class_a.resize(n_both * n_abcd);
+                ints_class_b.resize(n_both * n_abcd);
+                batch_t.resize(n_abcd);
+                for (size_t ipair_cd = 0; ipair_cd < sp_data_cd.n_pairs_; ipair_cd++)
+                {
+                    if (ipair_cd >= ofs_skip && ipair_cd < bound_skip)
+                        continue;
+
+                    vec4d eri4_batch = eri4_kernel(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd);
+
+                    size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
+                    size_t ofs_d = sp_data_cd.offsets_sph_[2 * ipair_cd + 1];
+
+                    // X(ka, ab, r) += sum_ta (ab|ka ta) C_ta,r
+                    for (int ic = 0; ic < n_sph_c; ic++)
+                        for (int ab = 0; ab < n_ab; ab++)
+                            for (int id = 0; id < n_sph_d; id++)
+                                batch_t[(ic * n_ab + ab) * n_sph_d + id] =
+                                        eri4_batch[(ab * n_sph_c + ic) * n_sph_d + id];
+
+                    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n_sph_c * n_ab, n_r,
+                                n_sph_d, 1.0, &batch_t[0], n_sph_d, &mo_coeffs(ofs_d, ofs_r),
+                                int(n_mo), 1.0, &ints_x_ab[ofs_c * n_ab * n_r], n_r);
+
+                    // The (ab|ta ka) for the shell pairs of different shells.
+                    if (sp_data_cd.shell_idxs_[2 * ipair_cd] !=
+                        sp_data_cd.shell_idxs_[2 * ipair_cd + 1])
+                    {
+                        for (int id = 0; id < n_sph_d; id++)
+                            for (int ab = 0; ab < n_ab; ab++)
+                                for (int ic = 0; ic < n_sph_c; ic++)
+                                    batch_t[(id * n_ab + ab) * n_sph_c + ic] =
+                                            eri4_batch[(ab * n_sph_c + ic) * n_sph_d + id];
+
+                        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n_sph_d * n_ab,
+                                    n_r, n_sph_c, 1.0, &batch_t[0], n_sph_c,
+                                    &mo_coeffs(ofs_c, ofs_r), int(n_mo), 1.0,
+                                    &ints_x_ab[ofs_d * n_ab * n_r], n_r);
+                    }
+
+                    if (ipair_cd < ofs_block || ipair_cd >= bound_both)
+                        continue;
+
+                    // (cd, a, b) and (cd, b, a) of the ket pairs in the block.
+                    size_t icd = ipair_cd - ofs_block;
+                    for (int ia = 0; ia < n_sph_a; ia++)
+                        for (int ib = 0; ib < n_sph_b; ib++)
+                            for (int cd = 0; cd < n_cd; cd++)
+                            {
+                                double integral = eri4_batch[(ia * n_sph_b + ib) * n_cd + cd];
+                                ints_class_a[((icd * n_cd + cd) * n_sph_a + ia) * n_sph_b + ib] =
+                                        integral;
+                                ints_class_b[((icd * n_cd + cd) * n_sph_b + ib) * n_sph_a + ia] =
+                                        integral;
+                            }
+                }
+
+                if (n_both == 0)
+                    continue;
+
+                // X(ka ta, mu, r) += sum_nu (mu nu|ka ta) C_nu,r for the whole class.
+                ints_class_ar.resize(n_both * n_cd * n_sph_a * n_r);
+                cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                            int(n_both) * n_cd * n_sph_a, n_r, n_sph_b, 1.0, &ints_class_a[0],
+                            n_sph_b, &mo_coeffs(ofs_b, ofs_r), int(n_mo), 0.0, &ints_class_ar[0],
+                            n_r);
+
+                if (!same_shell_ab)
+                {
+                    ints_class_br.resize(n_both * n_cd * n_sph_b * n_r);
+                    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                                int(n_both) * n_cd * n_sph_b, n_r, n_sph_a, 1.0,
+                                &ints_class_b[0], n_sph_a, &mo_coeffs(ofs_a, ofs_r), int(n_mo),
+                                0.0, &ints_class_br[0], n_r);
+                }
+
+                for (size_t icd = 0; icd < n_both; icd++)
+                {
+                    size_t ipair_list = ofs_cd + ofs_block + icd;
+                    for (size_t irow = 0; irow < sp_list.rows_[ipair_list].size(); irow++)
+                    {
+                        size_t row = sp_list.offsets_rows_[ipair_list] + irow;
+                        int cd = sp_list.rows_[ipair_list][irow].second;
+
+                        addToX(row, ofs_a, n_sph_a,
+                               &ints_class_ar[(icd * n_cd + cd) * n_sph_a * n_r]);
+                        if (!same_shell_ab)
+                            addToX(row, ofs_b, n_sph_b,
+                                   &ints_class_br[(icd * n_cd + cd) * n_sph_b * n_r]);
+                    }
+                }
+            }
+
+            for (size_t irow = 0; irow < sp_list.rows_[ipair].size(); irow++)
+            {
+                size_t row = sp_list.offsets_rows_[ipair] + irow;
+                int ab = sp_list.rows_[ipair][irow].second;
+
+                double *x = &ints_x[(row - ofs_row_block) * dim_ao * n_r];
+                for (size_t ka = 0; ka < dim_ao; ka++)
+                    for (int r = 0; r < n_r; r++)
+                    {
+#pragma omp atomic
+                        x[ka * n_r + r] += ints_x_ab[(ka * n_ab + ab) * n_r + r];
+                    }
+            }
+        }
+    }
+}
+
+void lints::halfTransform(const size_t begin, const size_t end, const ShellPairList &sp_list,
+                          const std::vector<double> &ints_x, const vec2d &mo_coeffs,
+                          HalfTransformed &half)
+{
+    size_t dim_ao = mo_coeffs.dim<0>();
+    size_t n_mo = mo_coeffs.dim<1>();
+    size_t n_r = half.n_r_;
+
+    size_t ofs_row_block = sp_list.offsets_rows_[begin];
+
+#pragma omp parallel
+    {
+        std::vector<double> ints_y(n_r * n_mo);
+
+#pragma omp for schedule(dynamic)
+        for (size_t ipair = begin; ipair < end; ipair++)
+            for (size_t irow = 0; irow < sp_list.rows_[ipair].size(); irow++)
+            {
+                size_t row = sp_list.offsets_rows_[ipair] + irow;
+                size_t munu = sp_list.rows_[ipair][irow].first;
+                size_t row_half = half.block_rows_ ? row - ofs_row_block : munu;
+
+                // Y(r, s) = sum_ka X(mu nu, ka, r) C_ka,s
+                cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, int(n_r), int(n_mo),
+                            int(dim_ao), 1.0, &ints_x[(row - ofs_row_block) * dim_ao * n_r],
+                            int(n_r), &mo_coeffs[0], int(n_mo), 0.0, &ints_y[0], int(n_mo));
+
+                for (size_t r = 0; r < n_r; r++)
+                    for (size_t s = 0; s <= half.ofs_r_ + r; s++)
+                    {
+                        size_t rs = idxPair(half.ofs_r_ + r, s);
+                        half.ints_[row_half * half.n_rs_ + rs - half.ofs_rs_] =
+                                ints_y[r * n_mo + s];
+                    }
+            }
+    }
+}
+
+void lints::secondHalfTransform(const HalfTransformed &half, const vec2d &mo_coeffs,
+                                std::vector<double> &eri4_mo)
+{
+    size_t dim_ao = mo_coeffs.dim<0>();
+    size_t n_mo = mo_coeffs.dim<1>();
+
+#pragma omp parallel
+    {
+        vec2d ints_ao(Fill(0), dim_ao, dim_ao);
+        vec2d ints_half(Fill(0), dim_ao, n_mo);
+        vec2d ints_mo(Fill(0), n_mo, n_mo);
+
+#pragma omp for schedule(dynamic)
+        for (size_t irs = 0; irs < half.n_rs_; irs++)
+        {
+            for (size_t mu = 0; mu < dim_ao; mu++)
+                for (size_t nu = 0; nu <= mu; nu++)
+                {
+                    double integral = half.ints_[idxPair(mu, nu) * half.n_rs_ + irs];
+                    ints_ao(mu, nu) = integral;
+                    ints_ao(nu, mu) = integral;
+                }
+
+            cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, int(dim_ao), int(n_mo),
+                        int(dim_ao), 1.0, &ints_ao[0], int(dim_ao), &mo_coeffs[0], int(n_mo),
+                        0.0, &ints_half[0], int(n_mo));
+
+            cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, int(n_mo), int(n_mo),
+                        int(dim_ao), 1.0, &mo_coeffs[0], int(n_mo), &ints_half[0], int(n_mo),
+                        0.0, &ints_mo[0], int(n_mo));
+
+            size_t rs = half.ofs_rs_ + irs;
+            for (size_t p = 0; p < n_mo; p++)
+                for (size_t q = 0; q <= p; q++)
+                {
+                    size_t pq = idxPair(p, q);
+                    if (pq >= rs)
+                        eri4_mo[idxPair(pq, rs)] = ints_mo(p, q);
+                }
+        }
+    }
+}
+
+std::vector<double> lints::eri4MO(const Structure &structure, const vec2d &mo_coeffs,
+                                  const double max_memory_mb, const std::string &scratch_dir)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (mo_coeffs.dim<0>() != dim_ao)
+        throw std::runtime_error("eri4MO(): the number of rows of the MO coefficients doesn't "
+                                 "match the number of AOs");
+
+    size_t n_mo = mo_coeffs.dim<1>();
+    if (n_mo == 0)
+        throw std::runtime_error("eri4MO(): no MOs given");
+
+    size_t n_ao_pairs = dim_ao * (dim_ao + 1) / 2;
+    size_t n_mo_pairs = n_mo * (n_mo + 1) / 2;
+
+    std::vector<ShellPairData> sp_datas = shellPairData(true, structure);
+    ShellPairList sp_list = shellPairList(sp_datas);
+    size_t n_classes = sp_datas.size();
+    size_t n_pairs = sp_list.pairs_.size();
+
+    // The E-coefficients of every class are calculated once and shared by the kernels, which are
+    // constructed only for the bra classes of the current block.
+    size_t size_ecoeffs = 0;
+    std::vector<std::shared_ptr<const std::vector<double>>> ecoeffs_bra(n_classes);
+    std::vector<std::shared_ptr<const std::vector<double>>> ecoeffs_ket(n_classes);
+    for (size_t ispdata = 0; ispdata < n_classes; ispdata++)
+    {
+        ecoeffs_bra[ispdata] = ecoeffsShared(sp_datas[ispdata], false);
+        ecoeffs_ket[ispdata] = ecoeffsShared(sp_datas[ispdata], true);
+        size_ecoeffs += ecoeffs_bra[ispdata]->size() + ecoeffs_ket[ispdata]->size();
+    }
+
+    std::vector<std::vector<ERI4Kernel>> eri4_kernels(n_classes);
+    auto blockKernels = [&](const size_t begin, const size_t end)
+    {
+        size_t ispdata_first = sp_list.pairs_[begin].first;
+        size_t ispdata_last = sp_list.pairs_[end - 1].first;
+        for (size_t ispdata_ab = 0; ispdata_ab < n_classes; ispdata_ab++)
+        {
+            if (ispdata_ab < ispdata_first || ispdata_ab > ispdata_last)
+                eri4_kernels[ispdata_ab] = {};
+            else if (eri4_kernels[ispdata_ab].empty())
+                for (size_t ispdata_cd = 0; ispdata_cd < n_classes; ispdata_cd++)
+                    eri4_kernels[ispdata_ab].emplace_back(sp_datas[ispdata_ab],
+                                                          sp_datas[ispdata_cd],
+                                                          ecoeffs_bra[ispdata_ab],
+                                                          ecoeffs_ket[ispdata_cd]);
+        }
+    };
+
+    // Returns the end of the block of the bra shell pairs from `begin` whose rows fit into
+    // `n_rows_fit`. Every block has at least one shell pair.
+    auto blockEnd = [&](const size_t begin, const double n_rows_fit)
+    {
+        size_t end = begin + 1;
+        while (end < n_pairs &&
+               double(sp_list.offsets_rows_[end + 1] - sp_list.offsets_rows_[begin]) <= n_rows_fit)
+            end++;
+
+        return end;
+    };
+
+    // The MOs r are split into batches whose half-transformed integrals and the buffers of the
+    // threads take at most half of the memory that is left from the E-coefficients. The rest goes
+    // to the quarter-transformed integrals of a block of the bra shell pairs. Every batch has at
+    // least one MO.
+    double max_size = max_memory_mb * 1024 * 1024 / sizeof(double) - double(size_ecoeffs);
+    size_t n_threads = size_t(omp_get_max_threads());
+    auto batchSize = [&](const size_t ofs_r, const size_t n_r)
+    {
+        return double(n_ao_pairs * (idxPair(ofs_r + n_r, 0) - idxPair(ofs_r, 0)) +
+                      n_threads * threadBufferSize(sp_datas, dim_ao, n_mo, n_r));
+    };
+
+    auto batchR = [&](const size_t ofs_r)
+    {
+        size_t n_r = 1;
+        while (ofs_r + n_r < n_mo && batchSize(ofs_r, n_r + 1) <= max_size / 2)
+            n_r++;
+
+        return n_r;
+    };
+
+    std::vector<double> eri4_mo(n_mo_pairs * (n_mo_pairs + 1) / 2, 0);
+    std::vector<double> ints_x;
+    if (scratch_dir.empty() || batchR(0) == n_mo)
+    {
+        // The integrals are recalculated for every batch.
+        for (size_t ofs_r = 0; ofs_r < n_mo;)
+        {
+            size_t n_r = batchR(ofs_r);
+
+            HalfTransformed half;
+            half.ofs_r_ = ofs_r;
+            half.n_r_ = n_r;
+            half.ofs_rs_ = idxPair(ofs_r, 0);
+            half.n_rs_ = idxPair(ofs_r + n_r, 0) - half.ofs_rs_;
+            half.ints_.assign(n_ao_pairs * half.n_rs_, 0);
+
+            double n_rows_fit = (max_size - batchSize(ofs_r, n_r)) / double(dim_ao * n_r);
+            for (size_t begin = 0; begin < n_pairs;)
+            {
+                size_t end = blockEnd(begin, n_rows_fit);
+                blockKernels(begin, end);
+
+                quarterTransform(begin, end, sp_list, sp_datas, eri4_kernels, mo_coeffs, half,
+                                 ints_x);
+
+                halfTransform(begin, end, sp_list, ints_x, mo_coeffs, half);
+
+                begin = end;
+            }
+            ints_x = {};
+
+            secondHalfTransform(half, mo_coeffs, eri4_mo);
+
+            ofs_r += n_r;
+        }
+
+        return eri4_mo;
+    }
+
+    // The half-transformed integrals are calculated once for all the MOs and staged on disk. The
+    // bra shell pairs are split into blocks whose quarter- and half-transformed integrals fit
+    // into the memory, and the second half is done by batches of the rs columns. The batches
+    // are stored one after another in the file, each as (mu nu, rs).
+    double size_buffers = double(n_threads * threadBufferSize(sp_datas, dim_ao, n_mo, n_mo));
+    double n_rs_fit = (max_size - size_buffers) / double(n_ao_pairs);
+    size_t n_rs_batch = n_rs_fit < 1 ? 1 : std::min(size_t(n_rs_fit), n_mo_pairs);
+
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    std::filesystem::path scratch_file = std::filesystem::path(scratch_dir) /
+                                         std::format("lible_eri4_mo_{}.tmp", stamp);
+
+    std::fstream file(scratch_file, std::ios::in | std::ios::out | std::ios::binary |
+                                        std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error(std::format("eri4MO(): could not open the scratch file {}",
+                                             scratch_file.string()));
+
+    HalfTransformed half;
+    half.n_r_ = n_mo;
+    half.n_rs_ = n_mo_pairs;
+    half.block_rows_ = true;
+
+    double n_rows_fit = (max_size - size_buffers) / double(dim_ao * n_mo + n_mo_pairs);
+    for (size_t begin = 0; begin < n_pairs;)
+    {
+        size_t end = blockEnd(begin, n_rows_fit);
+        blockKernels(begin, end);
+
+        size_t ofs_row_block = sp_list.offsets_rows_[begin];
+        half.ints_.assign((sp_list.offsets_rows_[end] - ofs_row_block) * n_mo_pairs, 0);
+
+        quarterTransform(begin, end, sp_list, sp_datas, eri4_kernels, mo_coeffs, half, ints_x);
+
+        halfTransform(begin, end, sp_list, ints_x, mo_coeffs, half);
+
+        for (size_t ofs_rs = 0; ofs_rs < n_mo_pairs; ofs_rs += n_rs_batch)
+        {
+            size_t n_rs = std::min(n_rs_batch, n_mo_pairs - ofs_rs);
+            for (size_t ipair = begin; ipair < end; ipair++)
+                for (size_t irow = 0; irow < sp_list.rows_[ipair].size(); irow++)
+                {
+                    size_t row = sp_list.offsets_rows_[ipair] + irow - ofs_row_block;
+                    size_t pos = n_ao_pairs * ofs_rs + sp_list.rows_[ipair][irow].first * n_rs;
+                    const double *ints_row = &half.ints_[row * n_mo_pairs + ofs_rs];
+
+                    file.seekp(std::streamoff(pos * sizeof(double)));
+                    file.write(reinterpret_cast<const char *>(ints_row),
+                               std::streamsize(n_rs * sizeof(double)));
+                }
+        }
+
+        begin = end;
+    }
+    ints_x = {};
+    eri4_kernels = {};
+
+    if (!file)
+        throw std::runtime_error("eri4MO(): writing the scratch file failed");
+
+    half.block_rows_ = false;
+    for (size_t ofs_rs = 0; ofs_rs < n_mo_pairs; ofs_rs += n_rs_batch)
+    {
+        half.ofs_rs_ = ofs_rs;
+        half.n_rs_ = std::min(n_rs_batch, n_mo_pairs - ofs_rs);
+        half.ints_.resize(n_ao_pairs * half.n_rs_);
+
+        file.seekg(std::streamoff(n_ao_pairs * ofs_rs * sizeof(double)));
+        file.read(reinterpret_cast<char *>(&half.ints_[0]),
+                  std::streamsize(half.ints_.size() * sizeof(double)));
+        if (!file)
+            throw std::runtime_error("eri4MO(): reading the scratch file failed");
+
+        secondHalfTransform(half, mo_coeffs, eri4_mo);
+    }
+
+    file.close();
+    std::filesystem::remove(scratch_file);
+
+    return eri4_mo;
+}
+
+lible::vec4d lints::unpackERI4MO(const size_t n_mo, const std::vector<double> &eri4_mo)
+{
+    size_t n_mo_pairs = n_mo * (n_mo + 1) / 2;
+    if (eri4_mo.size() != n_mo_pairs * (n_mo_pairs + 1) / 2)
+        throw std::runtime_error("unpackERI4MO(): the size of the packed integrals doesn't "
+                                 "match the number of MOs");
+
+    vec4d eri4(Fill(0), n_mo);
+    for (size_t p = 0; p < n_mo; p++)
+        for (size_t q = 0; q < n_mo; q++)
+            for (size_t r = 0; r < n_mo; r++)
+                for (size_t s = 0; s < n_mo; s++)
+                    eri4(p, q, r, s) = eri4_mo[idxPackedERI4MO(p, q, r, s)];
+
+    return eri4;
+}
@@ -40,13 +40,16 @@ lible::vec4d lints::eri4KernelFun(const size_t ipair_ab, const size_t ipair_cd,
     const double *xyz_b = &sp_data_ab.coords_[6 * ipair_ab + 3];
     const double *xyz_c = &sp_data_cd.coords_[6 * ipair_cd];
     const double *xyz_d = &sp_data_cd.coords_[6 * ipair_cd + 3];
-    const double *ecoeffs_ab = &eri4_kernel->ecoeffs_bra_[ofs_E_ab];
-    const double *ecoeffs_cd = &eri4_kernel->ecoeffs_ket_[ofs_E_cd];
+    const double *ecoeffs_ab = &(*eri4_kernel->ecoeffs_bra_)[ofs_E_ab];
+    const double *ecoeffs_cd = &(*eri4_kernel->ecoeffs_ket_)[ofs_E_cd];
 
     // SHARK integrals
     std::vector<std::array<int, 3>> hermite_idxs_bra = getHermiteGaussianIdxs(lab);
     std::vector<std::array<int, 3>> hermite_idxs_ket = getHermiteGaussianIdxs(lcd);
 
+    LIBLE_INSTRUMENT(instrumentation::Counters &counters = instrumentation::current();)
+    LIBLE_INSTRUMENT(using instrumentation::time_point_t;)
+
     vec4d eri4_batch(Fill(0), n_sph_a, n_sph_b, n_sph_c, n_sph_d);
     for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
     {
@@ -80,6 +83,8 @@ lible::vec4d lints::eri4KernelFun(const size_t ipair_ab, const size_t ipair_cd,
                 xyz_p[2] - xyz_q[2]
             };
 
+            LIBLE_INSTRUMENT(time_point_t start_rints = instrumentation::now();)
+
             double dx{xyz_pq[0]}, dy{xyz_pq[1]}, dz{xyz_pq[2]};
             double x = alpha * (dx * dx + dy * dy + dz * dz);
             std::vector<double> fnx = calcBoysF(labcd, x, eri4_kernel->boys_grid_);
@@ -88,13 +93,22 @@ lible::vec4d lints::eri4KernelFun(const size_t ipair_ab, const size_t ipair_cd,
             std::vector<double> rints = calcRIntsMatrix(labcd, fac, alpha, &xyz_pq[0], &fnx[0],
                                                         hermite_idxs_bra, hermite_idxs_ket);
 
+            LIBLE_INSTRUMENT(counters.time_rints_ += instrumentation::since(start_rints);)
+            LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
             size_t ofs_e1_cd = icd * n_ecoeffs_cd;
             shark_mm_ket(n_hermite_ab, n_sph_cd, n_hermite_cd, &rints[0], &ecoeffs_cd[ofs_e1_cd],
                          &R_x_E[0]);
+
+            LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
         }
+        LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
         size_t ofs_ecoeffs_ab = iab * n_ecoeffs_ab;
         shark_mm_bra(n_sph_ab, n_sph_cd, n_hermite_ab, &ecoeffs_ab[ofs_ecoeffs_ab], &R_x_E[0],
                      &eri4_batch[0]);
+
+        LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
     }
 
     return eri4_batch;
@@ -131,13 +145,16 @@ lible::vec3d lints::eri3KernelFun(const size_t ipair_ab, const size_t ishell_c,
     const double *coords_a = &sp_data_ab.coords_[6 * ipair_ab];
     const double *coords_b = &sp_data_ab.coords_[6 * ipair_ab + 3];
     const double *coords_c = &sh_data_c.coords_[3 * ishell_c];
-    const double *ecoeffs_ab = &eri3_kernel->ecoeffs_bra_[ofs_E_ab];
+    const double *ecoeffs_ab = &(*eri3_kernel->ecoeffs_bra_)[ofs_E_ab];
     const double *ecoeffs_c = &eri3_kernel->ecoeffs_ket_[ofs_E_c];
 
     // SHARK integrals
     std::vector<std::array<int, 3>> hermite_idxs_bra = getHermiteGaussianIdxs(lab);
     std::vector<std::array<int, 3>> hermite_idxs_ket = getHermiteGaussianIdxs(lc);
 
+    LIBLE_INSTRUMENT(instrumentation::Counters &counters = instrumentation::current();)
+    LIBLE_INSTRUMENT(using instrumentation::time_point_t;)
+
     vec3d eri3_batch(Fill(0), n_sph_a, n_sph_b, n_sph_c);
     for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
     {
@@ -163,6 +180,8 @@ lible::vec3d lints::eri3KernelFun(const size_t ipair_ab, const size_t ishell_c,
                 xyz_p[2] - coords_c[2]
             };
 
+            LIBLE_INSTRUMENT(time_point_t start_rints = instrumentation::now();)
+
             double dx{xyz_pc[0]}, dy{xyz_pc[1]}, dz{xyz_pc[2]};
             double x = alpha * (dx * dx + dy * dy + dz * dz);
             std::vector<double> fnx = calcBoysF(labc, x, eri3_kernel->boys_grid_);
@@ -171,13 +190,22 @@ lible::vec3d lints::eri3KernelFun(const size_t ipair_ab, const size_t ishell_c,
             std::vector<double> rints = calcRIntsMatrix(labc, fac, alpha, &xyz_pc[0], &fnx[0],
                                                         hermite_idxs_bra, hermite_idxs_ket);
 
+            LIBLE_INSTRUMENT(counters.time_rints_ += instrumentation::since(start_rints);)
+            LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
             size_t ofs_e0_c = ic * n_ecoeffs_c;
             shark_mm_ket(n_hermite_ab, n_sph_c, n_hermite_c, &rints[0], &ecoeffs_c[ofs_e0_c],
                          &R_x_E[0]);
+
+            LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
         }
+        LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
         size_t ofs_ecoeffs_ab = iab * n_ecoeffs_ab;
         shark_mm_bra(n_sph_ab, n_sph_c, n_hermite_ab, &ecoeffs_ab[ofs_ecoeffs_ab], &R_x_E[0],
                      &eri3_batch[0]);
+
+        LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
     }
 
     return eri3_batch;
@@ -579,10 +607,10 @@ std::array<lible::vec3d, 9> lints::eri3d1KernelFun(const size_t ipair_ab, const
     return eri3_batch;
 }
 
-std::array<lible::vec4d, 12> lints::eri4d1KernelFun(const size_t ipair_ab, const size_t ipair_cd,
-                                                    const ShellPairData &sp_data_ab,
-                                                    const ShellPairData &sp_data_cd,
-                                                    const ERI4D1Kernel *eri4d1_kernel)
+std::array<lible::vec4d, 9> lints::eri4d1KernelFun(const size_t ipair_ab, const size_t ipair_cd,
+                                                   const ShellPairData &sp_data_ab,
+                                                   const ShellPairData &sp_data_cd,
+                                                   const ERI4D1Kernel *eri4d1_kernel)
 {
     int la = sp_data_ab.la_;
     int lb = sp_data_ab.lb_;
@@ -630,8 +658,8 @@ std::array<lible::vec4d, 12> lints::eri4d1KernelFun(const size_t ipair_ab, const
     std::vector<std::array<int, 3>> hermite_idxs_bra = getHermiteGaussianIdxs(lab);
     std::vector<std::array<int, 3>> hermite_idxs_ket = getHermiteGaussianIdxs(lcd);
 
-    std::array<vec4d, 12> eri4_batch;
-    for (int ideriv = 0; ideriv < 12; ideriv++)
+    std::array<vec4d, 9> eri4_batch;
+    for (int ideriv = 0; ideriv < 9; ideriv++)
         eri4_batch[ideriv] = vec4d(Fill(0), n_sph_a, n_sph_b, n_sph_c, n_sph_d);
 
     for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
@@ -739,10 +767,6 @@ std::array<lible::vec4d, 12> lints::eri4d1KernelFun(const size_t ipair_ab, const
         shark_mm_bra(m, n, k, &ecoeffs0_ab[ofs_e0_ab], &R_x_E[6 * n_R_x_E], &eri4_batch[8][0]);
     }
 
-    // D
-    for (int ideriv = 9; ideriv < 12; ideriv++)
-        eri4_batch[ideriv] = -1 * (eri4_batch[ideriv - 9] + eri4_batch[ideriv - 6] + eri4_batch[ideriv - 3]);
-
     return eri4_batch;
 }
 
@@ -57,10 +57,10 @@ namespace lible::ints
 
     /// ERI4 first derivative kernel function for arbitrary L. Based on
     /// https://doi.org/10.1002/jcc.26942 and https://doi.org/10.1007/BF01132826.
-    std::array<vec4d, 12> eri4d1KernelFun(size_t ipair_ab, size_t ipair_cd,
-                                          const ShellPairData &sp_data_ab,
-                                          const ShellPairData &sp_data_cd,
-                                          const ERI4D1Kernel *eri4d1_kernel);
+    std::array<vec4d, 9> eri4d1KernelFun(size_t ipair_ab, size_t ipair_cd,
+                                         const ShellPairData &sp_data_ab,
+                                         const ShellPairData &sp_data_cd,
+                                         const ERI4D1Kernel *eri4d1_kernel);
 
     /// ERI3 first derivative kernel function for arbitrary L. Based on
     /// https://doi.org/10.1002/jcc.26942 and https://doi.org/10.1007/BF01132826.
@@ -97,6 +97,23 @@ namespace lible::ints
                                           const ShellData &sh_data_c,
                                           const ERI3SOCKernel *eri3soc_kernel);
 
+    // ERI kernels based on the Rys quadrature
+
+    /// ERI4 kernel function for arbitrary L using the Rys quadrature. Based on
+    /// https://doi.org/10.1002/jcc.540040206 and https://doi.org/10.1063/1.432807.
+    vec4d eri4KernelFunRys(size_t ipair_ab, size_t ipair_cd, const ShellPairData &sp_data_ab,
+                           const ShellPairData &sp_data_cd, const ERI4Kernel *eri4_kernel);
+
+    /// ERI3 kernel function for arbitrary L using the Rys quadrature. Based on
+    /// https://doi.org/10.1002/jcc.540040206 and https://doi.org/10.1063/1.432807.
+    vec3d eri3KernelFunRys(size_t ipair_ab, size_t ishell_c, const ShellPairData &sp_data_ab,
+                           const ShellData &sh_data_c, const ERI3Kernel *eri3_kernel);
+
+    /// ERI2 kernel function for arbitrary L using the Rys quadrature. Based on
+    /// https://doi.org/10.1002/jcc.540040206 and https://doi.org/10.1063/1.432807.
+    vec2d eri2KernelFunRys(size_t ishell_a, size_t ishell_b, const ShellData &sh_data_a,
+                           const ShellData &sh_data_b, const ERI2Kernel *eri2_kernel);
+
     // Templated ERI kernels for limited L
 
     /// ERI4 kernel function for specific L. Based on eqs. (25) and (26) from
@@ -134,13 +151,16 @@ namespace lible::ints
         const double *xyz_b = &sp_data_ab.coords_[6 * ipair_ab + 3];
         const double *xyz_c = &sp_data_cd.coords_[6 * ipair_cd];
         const double *xyz_d = &sp_data_cd.coords_[6 * ipair_cd + 3];
-        const double *ecoeffs_ab = &eri4_kernel->ecoeffs_bra_[ofs_E_ab];
-        const double *ecoeffs_cd = &eri4_kernel->ecoeffs_ket_[ofs_E_cd];
+        const double *ecoeffs_ab = &(*eri4_kernel->ecoeffs_bra_)[ofs_E_ab];
+        const double *ecoeffs_cd = &(*eri4_kernel->ecoeffs_ket_)[ofs_E_cd];
 
         // SHARK integrals
         std::array<double, labcd + 1> fnx;
         BoysF2<labcd> boys_f;
 
+        LIBLE_INSTRUMENT(instrumentation::Counters &counters = instrumentation::current();)
+        LIBLE_INSTRUMENT(using instrumentation::time_point_t;)
+
         vec4d eri4_batch(Fill(0), n_sph_a, n_sph_b, n_sph_c, n_sph_d);
         std::array<double, n_hermite_ab * n_hermite_cd> rints;
         for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
@@ -175,6 +195,8 @@ namespace lible::ints
                     xyz_p[2] - xyz_q[2]
                 };
 
+                LIBLE_INSTRUMENT(time_point_t start_rints = instrumentation::now();)
+
                 double dx{xyz_pq[0]}, dy{xyz_pq[1]}, dz{xyz_pq[2]};
                 double x = alpha * (dx * dx + dy * dy + dz * dz);
                 boys_f.calcFnx(x, &fnx[0]);
@@ -182,11 +204,20 @@ namespace lible::ints
                 double fac = 2.0 * std::pow(M_PI, 2.5) / (p * q * std::sqrt(p + q));
                 calcRInts_ERI<lab, lcd>(alpha, fac, &fnx[0], &xyz_pq[0], &rints[0]);
 
+                LIBLE_INSTRUMENT(counters.time_rints_ += instrumentation::since(start_rints);)
+                LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
                 int ofs_ecoeffs_cd = icd * n_ecoeffs_cd;
                 shark_mm_ket2<lab, lc, ld>(&rints[0], &ecoeffs_cd[ofs_ecoeffs_cd], &R_x_E[0]);
+
+                LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
             }
+            LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
             int ofs_ecoeffs_ab = iab * n_ecoeffs_ab;
             shark_mm_bra2<la, lb, lc, ld>(&ecoeffs_ab[ofs_ecoeffs_ab], &R_x_E[0], &eri4_batch[0]);
+
+            LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
         }
 
         return eri4_batch;
@@ -224,13 +255,16 @@ namespace lible::ints
         const double *coords_b = &sp_data_ab.coords_[6 * ipair_ab + 3];
         const double *coords_c = &sh_data_c.coords_[3 * ishell_c];
         const double *exps_c = &sh_data_c.exps_[cofs_c];
-        const double *ecoeffs_ab = &eri3_kernel->ecoeffs_bra_[ofs_E_ab];
+        const double *ecoeffs_ab = &(*eri3_kernel->ecoeffs_bra_)[ofs_E_ab];
         const double *ecoeffs_c = &eri3_kernel->ecoeffs_ket_[ofs_E_c];
 
         // SHARK integrals
         std::array<double, labc + 1> fnx;
         BoysF2<labc> boys_f;
 
+        LIBLE_INSTRUMENT(instrumentation::Counters &counters = instrumentation::current();)
+        LIBLE_INSTRUMENT(using instrumentation::time_point_t;)
+
         vec3d eri3_batch(Fill(0), n_sph_a, n_sph_b, n_sph_c);
         std::array<double, n_hermite_ab * n_hermite_c> rints;
         for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
@@ -257,6 +291,8 @@ namespace lible::ints
                     xyz_p[2] - coords_c[2]
                 };
 
+                LIBLE_INSTRUMENT(time_point_t start_rints = instrumentation::now();)
+
                 double dx{xyz_pc[0]}, dy{xyz_pc[1]}, dz{xyz_pc[2]};
                 double x = alpha * (dx * dx + dy * dy + dz * dz);
                 boys_f.calcFnx(x, &fnx[0]);
@@ -264,11 +300,20 @@ namespace lible::ints
                 double fac = (2.0 * std::pow(M_PI, 2.5) / (p * c * std::sqrt(p + c)));
                 calcRInts_ERI<lab, lc>(alpha, fac, &fnx[0], &xyz_pc[0], &rints[0]);
 
+                LIBLE_INSTRUMENT(counters.time_rints_ += instrumentation::since(start_rints);)
+                LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
                 int ofs_ecoeffs_c = ic * n_ecoeffs_c;
                 shark_mm_ket1<lab, lc>(&rints[0], &ecoeffs_c[ofs_ecoeffs_c], &R_x_E[0]);
+
+                LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
             }
+            LIBLE_INSTRUMENT(time_point_t start_shark = instrumentation::now();)
+
             int ofs_ecoeffs_ab = iab * n_ecoeffs_ab;
             shark_mm_bra2<la, lb, lc>(&ecoeffs_ab[ofs_ecoeffs_ab], &R_x_E[0], &eri3_batch[0]);
+
+            LIBLE_INSTRUMENT(counters.time_shark_ += instrumentation::since(start_shark);)
         }
 
         return eri3_batch;
@@ -348,10 +393,10 @@ namespace lible::ints
     /// ERI4 first derivative kernel function for specific L. Based on
     /// https://doi.org/10.1002/jcc.26942 and https://doi.org/10.1007/BF01132826.
     template <int la, int lb, int lc, int ld>
-    std::array<vec4d, 12> eri4d1KernelFun(const size_t ipair_ab, const size_t ipair_cd,
-                                          const ShellPairData &sp_data_ab,
-                                          const ShellPairData &sp_data_cd,
-                                          const ERI4D1Kernel *eri4d1_kernel)
+    std::array<vec4d, 9> eri4d1KernelFun(const size_t ipair_ab, const size_t ipair_cd,
+                                         const ShellPairData &sp_data_ab,
+                                         const ShellPairData &sp_data_cd,
+                                         const ERI4D1Kernel *eri4d1_kernel)
     {
         // Compile-time data
         constexpr int lab = la + lb;
@@ -395,8 +440,8 @@ namespace lible::ints
         std::array<double, labcd + 2> fnx;
         BoysF2<labcd + 1> boys_f;
 
-        std::array<vec4d, 12> eri4_batch;
-        for (int ideriv = 0; ideriv < 12; ideriv++)
+        std::array<vec4d, 9> eri4_batch;
+        for (int ideriv = 0; ideriv < 9; ideriv++)
             eri4_batch[ideriv] = vec4d(Fill(0), n_sph_a, n_sph_b, n_sph_c, n_sph_d);
 
         std::array<double, 4 * n_rints> rints;
@@ -507,10 +552,6 @@ namespace lible::ints
             shark_mm_bra2<la, lb, lc, ld>(&ecoeffs0_ab[ofs_ecoeffs0_ab], &R_x_E[6 * n_R_x_E], &eri4_batch[8][0]);
         }
 
-        // D
-        for (int ideriv = 9; ideriv < 12; ideriv++)
-            eri4_batch[ideriv] = -1 * (eri4_batch[ideriv - 9] + eri4_batch[ideriv - 6] + eri4_batch[ideriv - 3]);
-
         return eri4_batch;
     }
 
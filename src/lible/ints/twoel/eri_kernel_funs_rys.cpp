@@ -0,0 +1,469 @@
+#include <lible/ints/defs.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/spherical_trafo.hpp>
+#include <lible/ints/twoel/eri_kernel_funs.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Calculates the two-dimensional Rys integrals I(i, k), i <= lab, k <= lcd, for one root by
+    /// the vertical recurrence relations. Based on eqs. (13)-(16) from
+    /// https://doi.org/10.1002/jcc.540040206.
+    void rysInts2D(int lab, int lcd, double B00, double B10, double B01, double C00,
+                   double D00, double *ints_2d);
+
+    /// Transfers the angular momentum from I(i, k) to I(ia, ib, ic, id) in one Cartesian
+    /// direction using the horizontal recurrence relation.
+    void rysHRR(int la, int lb, int lc, int ld, double AB, double CD, const double *ints_2d,
+                double *scratch, double *ints_out);
+
+    /// Adds the Cartesian ERIs over a single primitive quartet, multiplied by `fac`, into
+    /// `eri_cart`. Two-center and three-center integrals are obtained by setting b = 0 or d = 0
+    /// and the corresponding centre equal to A or C.
+    void rysPrimitiveQuartet(int la, int lb, int lc, int ld, double a, double b, double c,
+                             double d, const double *xyz_a, const double *xyz_b,
+                             const double *xyz_c, const double *xyz_d, double fac,
+                             const RysGrid &rys_grid, const RysCartIdxs &cart_idxs,
+                             double *scratch, double *eri_cart);
+
+    /// Transforms the middle index of a (n_left, n_cart(l), n_right) tensor to the spherical
+    /// basis, (n_left, n_sph(l), n_right), with the CSR table of l.
+    void trafoMiddleIndex(int n_left, int l, int n_right, const double *ints_cart,
+                          double *ints_sph);
+
+    /// Transforms the Cartesian (ab|cd) batch of the class to the spherical basis and multiplies
+    /// in the AO norms. The intermediates are kept in thread-local buffers.
+    void trafoERICart2Sph(const RysCartIdxs &cart_idxs, const double *eri_cart,
+                          const double *norms_a, const double *norms_b, const double *norms_c,
+                          const double *norms_d, double *eri_sph);
+
+    /// Returns the thread-local buffer for the Rys kernels with at least `size` elements. The
+    /// kernels use the buffers {0: scratch, 1: Cartesian batch, 2-3: transformation}.
+    double *rysBuffer(int ibuffer, size_t size);
+}
+
+lints::RysCartIdxs::RysCartIdxs(const int la, const int lb, const int lc, const int ld,
+                                const int n_roots)
+    : la_(la), lb_(lb), lc_(lc), ld_(ld)
+{
+    auto cart_exps_a = cartExps(la);
+    auto cart_exps_b = cartExps(lb);
+    auto cart_exps_c = cartExps(lc);
+    auto cart_exps_d = cartExps(ld);
+
+    n_cart_abcd_ = cart_exps_a.size() * cart_exps_b.size() * cart_exps_c.size() *
+                   cart_exps_d.size();
+    n_tab_ = (la + 1) * (lb + 1) * (lc + 1) * (ld + 1);
+
+    // 2D ints | HRR work space | (x, y, z) tables for all roots.
+    int lab = la + lb;
+    int lcd = lc + ld;
+    scratch_size_ = (lab + 1) * (lcd + 1) + (lab + 1) * (lb + 1) * (lcd + 1) +
+                    (lcd + 1) * (ld + 1) + 3 * n_roots * n_tab_;
+
+    idxs_x_.resize(n_cart_abcd_);
+    idxs_y_.resize(n_cart_abcd_);
+    idxs_z_.resize(n_cart_abcd_);
+
+    auto index = [&](int ia, int ib, int ic, int id)
+    {
+        return ((ia * (lb + 1) + ib) * (lc + 1) + ic) * (ld + 1) + id;
+    };
+
+    int idx = 0;
+    for (const auto &[ia, ja, ka] : cart_exps_a)
+        for (const auto &[ib, jb, kb] : cart_exps_b)
+            for (const auto &[ic, jc, kc] : cart_exps_c)
+                for (const auto &[id, jd, kd] : cart_exps_d)
+                {
+                    idxs_x_[idx] = index(ia, ib, ic, id);
+                    idxs_y_[idx] = index(ja, jb, jc, jd);
+                    idxs_z_[idx] = index(ka, kb, kc, kd);
+                    idx++;
+                }
+}
+
+void lints::rysInts2D(const int lab, const int lcd, const double B00, const double B10,
+                      const double B01, const double C00, const double D00, double *ints_2d)
+{
+    int n_k = lcd + 1;
+
+    ints_2d[0] = 1.0;
+    if (lab > 0)
+        ints_2d[n_k] = C00;
+    for (int i = 1; i < lab; i++)
+        ints_2d[(i + 1) * n_k] = C00 * ints_2d[i * n_k] + i * B10 * ints_2d[(i - 1) * n_k];
+
+    for (int i = 0; i <= lab; i++)
+        for (int k = 0; k < lcd; k++)
+        {
+            double val = D00 * ints_2d[i * n_k + k];
+            if (k > 0)
+                val += k * B01 * ints_2d[i * n_k + k - 1];
+            if (i > 0)
+                val += i * B00 * ints_2d[(i - 1) * n_k + k];
+
+            ints_2d[i * n_k + k + 1] = val;
+        }
+}
+
+void lints::rysHRR(const int la, const int lb, const int lc, const int ld, const double AB,
+                   const double CD, const double *ints_2d, double *scratch, double *ints_out)
+{
+    int lab = la + lb;
+    int lcd = lc + ld;
+    int n_k = lcd + 1;
+
+    // Bra: I(i, j, k) from I(i + 1, j - 1, k) + AB * I(i, j - 1, k), stored as (i, j, k).
+    double *ints_ijk = scratch;
+    auto ijk = [&](int i, int j, int k) -> double &
+    {
+        return ints_ijk[(i * (lb + 1) + j) * n_k + k];
+    };
+
+    for (int i = 0; i <= lab; i++)
+        for (int k = 0; k <= lcd; k++)
+            ijk(i, 0, k) = ints_2d[i * n_k + k];
+
+    for (int j = 1; j <= lb; j++)
+        for (int i = 0; i <= lab - j; i++)
+            for (int k = 0; k <= lcd; k++)
+                ijk(i, j, k) = ijk(i + 1, j - 1, k) + AB * ijk(i, j - 1, k);
+
+    // Ket: I(ia, ib, k, l) from I(ia, ib, k + 1, l - 1) + CD * I(ia, ib, k, l - 1).
+    double *ints_kl = scratch + (lab + 1) * (lb + 1) * n_k;
+    auto kl = [&](int k, int l) -> double &
+    {
+        return ints_kl[k * (ld + 1) + l];
+    };
+
+    for (int ia = 0; ia <= la; ia++)
+        for (int ib = 0; ib <= lb; ib++)
+        {
+            for (int k = 0; k <= lcd; k++)
+                kl(k, 0) = ijk(ia, ib, k);
+
+            for (int l = 1; l <= ld; l++)
+                for (int k = 0; k <= lcd - l; k++)
+                    kl(k, l) = kl(k + 1, l - 1) + CD * kl(k, l - 1);
+
+            double *out = &ints_out[(ia * (lb + 1) + ib) * (lc + 1) * (ld + 1)];
+            for (int ic = 0; ic <= lc; ic++)
+                for (int id = 0; id <= ld; id++)
+                    out[ic * (ld + 1) + id] = kl(ic, id);
+        }
+}
+
+void lints::rysPrimitiveQuartet(const int la, const int lb, const int lc, const int ld,
+                                const double a, const double b, const double c, const double d,
+                                const double *xyz_a, const double *xyz_b, const double *xyz_c,
+                                const double *xyz_d, const double fac, const RysGrid &rys_grid,
+                                const RysCartIdxs &cart_idxs, double *scratch,
+                                double *eri_cart)
+{
+    int lab = la + lb;
+    int lcd = lc + ld;
+    int n_roots = rys_grid.getNRoots();
+    int n_2d = (lab + 1) * (lcd + 1);
+    int n_tab = cart_idxs.n_tab_;
+
+    double p = a + b;
+    double q = c + d;
+    double pq = p + q;
+    double rho = p * q / pq;
+
+    std::array<double, 3> xyz_p, xyz_q, xyz_pq;
+    double dist_ab = 0, dist_cd = 0, dist_pq = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        xyz_p[i] = (a * xyz_a[i] + b * xyz_b[i]) / p;
+        xyz_q[i] = (c * xyz_c[i] + d * xyz_d[i]) / q;
+        xyz_pq[i] = xyz_p[i] - xyz_q[i];
+
+        dist_ab += (xyz_a[i] - xyz_b[i]) * (xyz_a[i] - xyz_b[i]);
+        dist_cd += (xyz_c[i] - xyz_d[i]) * (xyz_c[i] - xyz_d[i]);
+        dist_pq += xyz_pq[i] * xyz_pq[i];
+    }
+
+    double Kab = std::exp(-a * b / p * dist_ab);
+    double Kcd = std::exp(-c * d / q * dist_cd);
+    double prefac = fac * Kab * Kcd * 2.0 * std::pow(M_PI, 2.5) / (p * q * std::sqrt(pq));
+
+    double x = rho * dist_pq;
+    std::array<double, _max_rys_roots_> roots, weights;
+    rys_grid.calcRootsWeights(x, &roots[0], &weights[0]);
+
+    // Layout of the scratch: 2D ints | HRR work space | (x, y, z) tables for all roots.
+    double *ints_2d = scratch;
+    double *work = &scratch[n_2d];
+    double *tables = &scratch[n_2d + (lab + 1) * (lb + 1) * (lcd + 1) + (lcd + 1) * (ld + 1)];
+
+    for (int iroot = 0; iroot < n_roots; iroot++)
+    {
+        double u = roots[iroot];
+        double B00 = 0.5 * u / pq;
+        double B10 = 0.5 / p - 0.5 * u * q / (p * pq);
+        double B01 = 0.5 / q - 0.5 * u * p / (q * pq);
+
+        for (int icart = 0; icart < 3; icart++)
+        {
+            double C00 = (xyz_p[icart] - xyz_a[icart]) - u * q / pq * xyz_pq[icart];
+            double D00 = (xyz_q[icart] - xyz_c[icart]) + u * p / pq * xyz_pq[icart];
+
+            rysInts2D(lab, lcd, B00, B10, B01, C00, D00, ints_2d);
+
+            double *table = &tables[(iroot * 3 + icart) * n_tab];
+            rysHRR(la, lb, lc, ld, xyz_a[icart] - xyz_b[icart], xyz_c[icart] - xyz_d[icart],
+                   ints_2d, work, table);
+        }
+
+        // The weight and prefactor are multiplied into the x-direction.
+        double *table_x = &tables[(iroot * 3) * n_tab];
+        double wfac = weights[iroot] * prefac;
+        for (int i = 0; i < n_tab; i++)
+            table_x[i] *= wfac;
+    }
+
+    for (int iabcd = 0; iabcd < cart_idxs.n_cart_abcd_; iabcd++)
+    {
+        int idx_x = cart_idxs.idxs_x_[iabcd];
+        int idx_y = cart_idxs.idxs_y_[iabcd];
+        int idx_z = cart_idxs.idxs_z_[iabcd];
+
+        double sum = 0;
+        for (int iroot = 0; iroot < n_roots; iroot++)
+        {
+            const double *table = &tables[iroot * 3 * n_tab];
+            sum += table[idx_x] * table[n_tab + idx_y] * table[2 * n_tab + idx_z];
+        }
+
+        eri_cart[iabcd] += sum;
+    }
+}
+
+void lints::trafoMiddleIndex(const int n_left, const int l, const int n_right,
+                             const double *ints_cart, double *ints_sph)
+{
+    int n_cart = numCartesians(l);
+    SphTrafoCSRView trafo = sphTrafoCSR(l);
+
+    std::fill(ints_sph, ints_sph + n_left * trafo.n_sph_ * n_right, 0);
+    for (int i = 0; i < n_left; i++)
+        for (int mu = 0; mu < trafo.n_sph_; mu++)
+        {
+            double *out = &ints_sph[(i * trafo.n_sph_ + mu) * n_right];
+            for (int k = trafo.row_ptrs_[mu]; k < trafo.row_ptrs_[mu + 1]; k++)
+            {
+                double val = trafo.vals_[k];
+                const double *in = &ints_cart[(i * n_cart + trafo.cart_idxs_[k]) * n_right];
+                for (int j = 0; j < n_right; j++)
+                    out[j] += val * in[j];
+            }
+        }
+}
+
+void lints::trafoERICart2Sph(const RysCartIdxs &cart_idxs, const double *eri_cart,
+                             const double *norms_a, const double *norms_b,
+                             const double *norms_c, const double *norms_d, double *eri_sph)
+{
+    int la = cart_idxs.la_;
+    int lb = cart_idxs.lb_;
+    int lc = cart_idxs.lc_;
+    int ld = cart_idxs.ld_;
+
+    int n_cart_a = numCartesians(la);
+    int n_cart_b = numCartesians(lb);
+    int n_cart_c = numCartesians(lc);
+    int n_sph_a = numSphericals(la);
+    int n_sph_b = numSphericals(lb);
+    int n_sph_c = numSphericals(lc);
+    int n_sph_d = numSphericals(ld);
+
+    // The Cartesian batch is the largest intermediate.
+    size_t size = cart_idxs.n_cart_abcd_;
+    double *eri_1 = rysBuffer(2, size);
+    double *eri_2 = rysBuffer(3, size);
+
+    trafoMiddleIndex(n_cart_a * n_cart_b * n_cart_c, ld, 1, eri_cart, eri_1);
+    trafoMiddleIndex(n_cart_a * n_cart_b, lc, n_sph_d, eri_1, eri_2);
+    trafoMiddleIndex(n_cart_a, lb, n_sph_c * n_sph_d, eri_2, eri_1);
+    trafoMiddleIndex(1, la, n_sph_b * n_sph_c * n_sph_d, eri_1, eri_sph);
+
+    for (int ia = 0, idx = 0; ia < n_sph_a; ia++)
+        for (int ib = 0; ib < n_sph_b; ib++)
+            for (int ic = 0; ic < n_sph_c; ic++)
+                for (int id = 0; id < n_sph_d; id++, idx++)
+                    eri_sph[idx] *= norms_a[ia] * norms_b[ib] * norms_c[ic] * norms_d[id];
+}
+
+double *lints::rysBuffer(const int ibuffer, const size_t size)
+{
+    thread_local std::array<std::vector<double>, 4> buffers;
+
+    std::vector<double> &buffer = buffers[ibuffer];
+    if (buffer.size() < size)
+        buffer.resize(size);
+
+    return buffer.data();
+}
+
+lible::vec4d lints::eri4KernelFunRys(const size_t ipair_ab, const size_t ipair_cd,
+                                     const ShellPairData &sp_data_ab,
+                                     const ShellPairData &sp_data_cd,
+                                     const ERI4Kernel *eri4_kernel)
+{
+    int la = sp_data_ab.la_;
+    int lb = sp_data_ab.lb_;
+    int lc = sp_data_cd.la_;
+    int ld = sp_data_cd.lb_;
+
+    const RysGrid &rys_grid = eri4_kernel->rys_grid_;
+    const RysCartIdxs &cart_idxs = eri4_kernel->rys_cart_idxs_;
+
+    // Read-in data
+    size_t ofs_prim_ab = sp_data_ab.offsets_primitives_[ipair_ab];
+    size_t ofs_prim_cd = sp_data_cd.offsets_primitives_[ipair_cd];
+    const double *exps_ab = &sp_data_ab.exps_[ofs_prim_ab];
+    const double *exps_cd = &sp_data_cd.exps_[ofs_prim_cd];
+    const double *coeffs_ab = &sp_data_ab.coeffs_[ofs_prim_ab];
+    const double *coeffs_cd = &sp_data_cd.coeffs_[ofs_prim_cd];
+
+    const double *xyz_a = &sp_data_ab.coords_[6 * ipair_ab];
+    const double *xyz_b = &sp_data_ab.coords_[6 * ipair_ab + 3];
+    const double *xyz_c = &sp_data_cd.coords_[6 * ipair_cd];
+    const double *xyz_d = &sp_data_cd.coords_[6 * ipair_cd + 3];
+
+    const double *norms_a = &sp_data_ab.norms_[sp_data_ab.offsets_norms_[2 * ipair_ab]];
+    const double *norms_b = &sp_data_ab.norms_[sp_data_ab.offsets_norms_[2 * ipair_ab + 1]];
+    const double *norms_c = &sp_data_cd.norms_[sp_data_cd.offsets_norms_[2 * ipair_cd]];
+    const double *norms_d = &sp_data_cd.norms_[sp_data_cd.offsets_norms_[2 * ipair_cd + 1]];
+
+    // Rys quadrature integrals
+    double *scratch = rysBuffer(0, cart_idxs.scratch_size_);
+    double *eri4_cart = rysBuffer(1, cart_idxs.n_cart_abcd_);
+    std::fill(eri4_cart, eri4_cart + cart_idxs.n_cart_abcd_, 0);
+    for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
+        for (size_t icd = 0; icd < sp_data_cd.nrs_ppairs_[ipair_cd]; icd++)
+        {
+            double a = exps_ab[iab * 2];
+            double b = exps_ab[iab * 2 + 1];
+            double c = exps_cd[icd * 2];
+            double d = exps_cd[icd * 2 + 1];
+
+            double fac = coeffs_ab[iab * 2] * coeffs_ab[iab * 2 + 1] * coeffs_cd[icd * 2] *
+                         coeffs_cd[icd * 2 + 1];
+
+            rysPrimitiveQuartet(la, lb, lc, ld, a, b, c, d, xyz_a, xyz_b, xyz_c, xyz_d, fac,
+                                rys_grid, cart_idxs, scratch, eri4_cart);
+        }
+
+    vec4d eri4_batch(Fill(0), numSphericals(la), numSphericals(lb), numSphericals(lc),
+                     numSphericals(ld));
+    trafoERICart2Sph(cart_idxs, eri4_cart, norms_a, norms_b, norms_c, norms_d, &eri4_batch[0]);
+
+    return eri4_batch;
+}
+
+lible::vec3d lints::eri3KernelFunRys(const size_t ipair_ab, const size_t ishell_c,
+                                     const ShellPairData &sp_data_ab, const ShellData &sh_data_c,
+                                     const ERI3Kernel *eri3_kernel)
+{
+    int la = sp_data_ab.la_;
+    int lb = sp_data_ab.lb_;
+    int lc = sh_data_c.l_;
+
+    const RysGrid &rys_grid = eri3_kernel->rys_grid_;
+    const RysCartIdxs &cart_idxs = eri3_kernel->rys_cart_idxs_;
+
+    // Read-in data
+    size_t cdepth_c = sh_data_c.cdepths_[ishell_c];
+    size_t cofs_c = sh_data_c.coffsets_[ishell_c];
+    size_t ofs_prim = sp_data_ab.offsets_primitives_[ipair_ab];
+
+    const double *exps_ab = &sp_data_ab.exps_[ofs_prim];
+    const double *coeffs_ab = &sp_data_ab.coeffs_[ofs_prim];
+    const double *exps_c = &sh_data_c.exps_[cofs_c];
+    const double *coeffs_c = &sh_data_c.coeffs_[cofs_c];
+
+    const double *xyz_a = &sp_data_ab.coords_[6 * ipair_ab];
+    const double *xyz_b = &sp_data_ab.coords_[6 * ipair_ab + 3];
+    const double *xyz_c = &sh_data_c.coords_[3 * ishell_c];
+
+    const double *norms_a = &sp_data_ab.norms_[sp_data_ab.offsets_norms_[2 * ipair_ab]];
+    const double *norms_b = &sp_data_ab.norms_[sp_data_ab.offsets_norms_[2 * ipair_ab + 1]];
+    const double *norms_c = &sh_data_c.norms_[sh_data_c.offsets_norms_[ishell_c]];
+    const double norm_d = 1.0;
+
+    // Rys quadrature integrals
+    double *scratch = rysBuffer(0, cart_idxs.scratch_size_);
+    double *eri3_cart = rysBuffer(1, cart_idxs.n_cart_abcd_);
+    std::fill(eri3_cart, eri3_cart + cart_idxs.n_cart_abcd_, 0);
+    for (size_t iab = 0; iab < sp_data_ab.nrs_ppairs_[ipair_ab]; iab++)
+        for (size_t ic = 0; ic < cdepth_c; ic++)
+        {
+            double a = exps_ab[iab * 2];
+            double b = exps_ab[iab * 2 + 1];
+            double c = exps_c[ic];
+
+            double fac = coeffs_ab[iab * 2] * coeffs_ab[iab * 2 + 1] * coeffs_c[ic];
+
+            rysPrimitiveQuartet(la, lb, lc, 0, a, b, c, 0, xyz_a, xyz_b, xyz_c, xyz_c, fac,
+                                rys_grid, cart_idxs, scratch, eri3_cart);
+        }
+
+    vec3d eri3_batch(Fill(0), numSphericals(la), numSphericals(lb), numSphericals(lc));
+    trafoERICart2Sph(cart_idxs, eri3_cart, norms_a, norms_b, norms_c, &norm_d, &eri3_batch[0]);
+
+    return eri3_batch;
+}
+
+lible::vec2d lints::eri2KernelFunRys(const size_t ishell_a, const size_t ishell_b,
+                                     const ShellData &sh_data_a, const ShellData &sh_data_b,
+                                     const ERI2Kernel *eri2_kernel)
+{
+    int la = sh_data_a.l_;
+    int lb = sh_data_b.l_;
+
+    const RysGrid &rys_grid = eri2_kernel->rys_grid_;
+    const RysCartIdxs &cart_idxs = eri2_kernel->rys_cart_idxs_;
+
+    // Read-in data
+    size_t cdepth_a = sh_data_a.cdepths_[ishell_a];
+    size_t cdepth_b = sh_data_b.cdepths_[ishell_b];
+    size_t cofs_a = sh_data_a.coffsets_[ishell_a];
+    size_t cofs_b = sh_data_b.coffsets_[ishell_b];
+
+    const double *exps_a = &sh_data_a.exps_[cofs_a];
+    const double *exps_b = &sh_data_b.exps_[cofs_b];
+    const double *coeffs_a = &sh_data_a.coeffs_[cofs_a];
+    const double *coeffs_b = &sh_data_b.coeffs_[cofs_b];
+    const double *xyz_a = &sh_data_a.coords_[3 * ishell_a];
+    const double *xyz_b = &sh_data_b.coords_[3 * ishell_b];
+
+    const double *norms_a = &sh_data_a.norms_[sh_data_a.offsets_norms_[ishell_a]];
+    const double *norms_b = &sh_data_b.norms_[sh_data_b.offsets_norms_[ishell_b]];
+    const double norm_s = 1.0;
+
+    // Rys quadrature integrals
+    double *scratch = rysBuffer(0, cart_idxs.scratch_size_);
+    double *eri2_cart = rysBuffer(1, cart_idxs.n_cart_abcd_);
+    std::fill(eri2_cart, eri2_cart + cart_idxs.n_cart_abcd_, 0);
+    for (size_t ia = 0; ia < cdepth_a; ia++)
+        for (size_t ib = 0; ib < cdepth_b; ib++)
+        {
+            double fac = coeffs_a[ia] * coeffs_b[ib];
+
+            rysPrimitiveQuartet(la, 0, lb, 0, exps_a[ia], 0, exps_b[ib], 0, xyz_a, xyz_a, xyz_b,
+                                xyz_b, fac, rys_grid, cart_idxs, scratch, eri2_cart);
+        }
+
+    vec2d eri2_batch(Fill(0), numSphericals(la), numSphericals(lb));
+    trafoERICart2Sph(cart_idxs, eri2_cart, norms_a, &norm_s, norms_b, &norm_s, &eri2_batch[0]);
+
+    return eri2_batch;
+}
@@ -3,6 +3,7 @@
 #include <lible/ints/twoel/eri_kernels.hpp>
 
 #include <tuple>
+#include <utility>
 
 namespace lints = lible::ints;
 
@@ -32,6 +33,17 @@ namespace lible::ints
     vec2d eri2KernelFun(size_t ishell_a, size_t ishell_b, const ShellData &sh_data_a,
                         const ShellData &sh_data_b, const ERI2Kernel *eri2_kernel);
 
+    // Rys quadrature ERI kernels
+
+    vec4d eri4KernelFunRys(size_t ipair_ab, size_t ipair_cd, const ShellPairData &sp_data_ab,
+                           const ShellPairData &sp_data_cd, const ERI4Kernel *eri4_kernel);
+
+    vec3d eri3KernelFunRys(size_t ipair_ab, size_t ishell_c, const ShellPairData &sp_data_ab,
+                           const ShellData &sh_data_c, const ERI3Kernel *eri3_kernel);
+
+    vec2d eri2KernelFunRys(size_t ishell_a, size_t ishell_b, const ShellData &sh_data_a,
+                           const ShellData &sh_data_b, const ERI2Kernel *eri2_kernel);
+
     const std::map<std::tuple<int, int, int, int>, eri4_kernelfun_t> eri4_kernelfuns{
         {{0, 0, 0, 0}, eri4KernelFun<0, 0, 0, 0>},
         {{0, 0, 1, 0}, eri4KernelFun<0, 0, 1, 0>},
@@ -414,15 +426,15 @@ namespace lible::ints
 
     // 4-center
     template <int la, int lb, int lc, int ld>
-    std::array<vec4d, 12> eri4d1KernelFun(size_t ipair_ab, size_t ipair_cd,
-                                          const ShellPairData &sp_data_ab,
-                                          const ShellPairData &sp_data_cd,
-                                          const ERI4D1Kernel *eri4d1_kernel);
+    std::array<vec4d, 9> eri4d1KernelFun(size_t ipair_ab, size_t ipair_cd,
+                                         const ShellPairData &sp_data_ab,
+                                         const ShellPairData &sp_data_cd,
+                                         const ERI4D1Kernel *eri4d1_kernel);
 
-    std::array<vec4d, 12> eri4d1KernelFun(size_t ipair_ab, size_t ipair_cd,
-                                          const ShellPairData &sp_data_ab,
-                                          const ShellPairData &sp_data_cd,
-                                          const ERI4D1Kernel *eri4d1_kernel);
+    std::array<vec4d, 9> eri4d1KernelFun(size_t ipair_ab, size_t ipair_cd,
+                                         const ShellPairData &sp_data_ab,
+                                         const ShellPairData &sp_data_cd,
+                                         const ERI4D1Kernel *eri4d1_kernel);
 
     template <int la, int lb, int lc, int ld>
     std::array<vec4d, 3> eri4socKernelFun(size_t ipair_ab, size_t ipair_cd,
@@ -1098,17 +1110,38 @@ namespace lible::ints
     };
 }
 
-lints::ERI4Kernel::ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd)
+lints::ERI4Kernel::ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd,
+                              const ERIBackend backend)
+    : ERI4Kernel(sp_data_ab, sp_data_cd,
+                 backend == ERIBackend::rys ? nullptr : ecoeffsShared(sp_data_ab, false),
+                 backend == ERIBackend::rys ? nullptr : ecoeffsShared(sp_data_cd, true), backend)
 {
-    ecoeffs_bra_ = ecoeffsSHARK(sp_data_ab, false);
-    ecoeffs_ket_ = ecoeffsSHARK(sp_data_cd, true);
+}
 
+lints::ERI4Kernel::ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd,
+                              std::shared_ptr<const std::vector<double>> ecoeffs_bra,
+                              std::shared_ptr<const std::vector<double>> ecoeffs_ket,
+                              const ERIBackend backend)
+    : backend_(backend)
+{
     auto [la, lb] = sp_data_ab.getLPair();
     auto [lc, ld] = sp_data_cd.getLPair();
     int labcd = la + lb + lc + ld;
+
+    if (backend == ERIBackend::rys)
+    {
+        rys_grid_ = RysGrid(labcd / 2 + 1);
+        rys_cart_idxs_ = RysCartIdxs(la, lb, lc, ld, rys_grid_.getNRoots());
+        eri4_kernelfun_ = eri4KernelFunRys;
+        return;
+    }
+
+    ecoeffs_bra_ = std::move(ecoeffs_bra);
+    ecoeffs_ket_ = std::move(ecoeffs_ket);
+
     boys_grid_ = BoysGrid(labcd);
 
-    if (labcd <= _max_l_rollout_)
+    if (labcd <= _max_l_rollout_ && backend == ERIBackend::shark)
         eri4_kernelfun_ = eri4_kernelfuns.at({la, lb, lc, ld});
     else
         eri4_kernelfun_ = [](const size_t ipair_ab, const size_t ipair_cd,
@@ -1119,17 +1152,61 @@ lints::ERI4Kernel::ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairDa
         };
 }
 
-lints::ERI3Kernel::ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c)
+void lints::ERI4Kernel::updateCoordinates(const ShellPairData &sp_data_ab,
+                                          const ShellPairData &sp_data_cd)
 {
-    ecoeffs_bra_ = ecoeffsSHARK(sp_data_ab, false);
-    ecoeffs_ket_ = ecoeffsSHARK(sh_data_c, true);
+    if (backend_ == ERIBackend::rys)
+        return;
+
+    updateCoordinates(ecoeffsShared(sp_data_ab, false), ecoeffsShared(sp_data_cd, true));
+}
+
+void lints::ERI4Kernel::updateCoordinates(std::shared_ptr<const std::vector<double>> ecoeffs_bra,
+                                          std::shared_ptr<const std::vector<double>> ecoeffs_ket)
+{
+    if (backend_ == ERIBackend::rys)
+        return;
+
+    ecoeffs_bra_ = std::move(ecoeffs_bra);
+    ecoeffs_ket_ = std::move(ecoeffs_ket);
+}
+
+std::shared_ptr<const std::vector<double>> lints::ecoeffsShared(const ShellPairData &sp_data,
+                                                                const bool transpose)
+{
+    return std::make_shared<const std::vector<double>>(ecoeffsSHARK(sp_data, transpose));
+}
+
+lints::ERI3Kernel::ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c,
+                              const ERIBackend backend)
+    : ERI3Kernel(sp_data_ab, sh_data_c,
+                 backend == ERIBackend::rys ? nullptr : ecoeffsShared(sp_data_ab), backend)
+{
+}
 
+lints::ERI3Kernel::ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c,
+                              std::shared_ptr<const std::vector<double>> ecoeffs_bra,
+                              const ERIBackend backend)
+    : backend_(backend)
+{
     auto [la, lb] = sp_data_ab.getLPair();
     int lc = sh_data_c.l_;
     int labc = la + lb + lc;
+
+    if (backend == ERIBackend::rys)
+    {
+        rys_grid_ = RysGrid(labc / 2 + 1);
+        rys_cart_idxs_ = RysCartIdxs(la, lb, lc, 0, rys_grid_.getNRoots());
+        eri3_kernelfun_ = eri3KernelFunRys;
+        return;
+    }
+
+    ecoeffs_bra_ = std::move(ecoeffs_bra);
+    ecoeffs_ket_ = ecoeffsSHARK(sh_data_c, true);
+
     boys_grid_ = BoysGrid(labc);
 
-    if (labc <= _max_l_rollout_)
+    if (labc <= _max_l_rollout_ && backend == ERIBackend::shark)
         eri3_kernelfun_ = eri3_kernelfuns.at({la, lb, lc});
     else
         eri3_kernelfun_ = [](const size_t ipair_ab, const size_t ish_c,
@@ -1140,17 +1217,47 @@ lints::ERI3Kernel::ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &
                           };
 }
 
-lints::ERI2Kernel::ERI2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b)
+void lints::ERI3Kernel::updateCoordinates(const ShellPairData &sp_data_ab,
+                                          const ShellData &sh_data_c)
 {
-    ecoeffs_bra_ = ecoeffsSHARK(sh_data_a, false);
-    ecoeffs_ket_ = ecoeffsSHARK(sh_data_b, true);
+    if (backend_ == ERIBackend::rys)
+        return;
+
+    updateCoordinates(sh_data_c, ecoeffsShared(sp_data_ab));
+}
+
+void lints::ERI3Kernel::updateCoordinates(const ShellData &sh_data_c,
+                                          std::shared_ptr<const std::vector<double>> ecoeffs_bra)
+{
+    if (backend_ == ERIBackend::rys)
+        return;
 
+    ecoeffs_bra_ = std::move(ecoeffs_bra);
+    ecoeffs_ket_ = ecoeffsSHARK(sh_data_c, true);
+}
+
+lints::ERI2Kernel::ERI2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b,
+                              const ERIBackend backend)
+    : backend_(backend)
+{
     int la = sh_data_a.l_;
     int lb = sh_data_b.l_;
     int lab = la + lb;
+
+    if (backend == ERIBackend::rys)
+    {
+        rys_grid_ = RysGrid(lab / 2 + 1);
+        rys_cart_idxs_ = RysCartIdxs(la, 0, lb, 0, rys_grid_.getNRoots());
+        eri2_kernelfun_ = eri2KernelFunRys;
+        return;
+    }
+
+    ecoeffs_bra_ = ecoeffsSHARK(sh_data_a, false);
+    ecoeffs_ket_ = ecoeffsSHARK(sh_data_b, true);
+
     boys_grid_ = BoysGrid(lab);
 
-    if (lab <= _max_l_rollout_)
+    if (lab <= _max_l_rollout_ && backend == ERIBackend::shark)
         eri2_kernelfun_ = eri2_kernelfuns.at({la, lb});
     else
         eri2_kernelfun_ = [](const size_t ish_a, const size_t ish_b,
@@ -1161,12 +1268,18 @@ lints::ERI2Kernel::ERI2Kernel(const ShellData &sh_data_a, const ShellData &sh_da
         };
 }
 
+void lints::ERI2Kernel::updateCoordinates(const ShellData &sh_data_a, const ShellData &sh_data_b)
+{
+    if (backend_ == ERIBackend::rys)
+        return;
+
+    ecoeffs_bra_ = ecoeffsSHARK(sh_data_a, false);
+    ecoeffs_ket_ = ecoeffsSHARK(sh_data_b, true);
+}
+
 lints::ERI4D1Kernel::ERI4D1Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd)
 {
-    ecoeffs0_bra_ = ecoeffsSHARK(sp_data_ab, false);
-    ecoeffs1_bra_ = ecoeffsD1SHARK(sp_data_ab, false);
-    ecoeffs0_ket_ = ecoeffsSHARK(sp_data_cd, true);
-    ecoeffs1_ket_ = ecoeffsD1SHARK(sp_data_cd, true);
+    updateCoordinates(sp_data_ab, sp_data_cd);
 
     auto [la, lb] = sp_data_ab.getLPair();
     auto [lc, ld] = sp_data_cd.getLPair();
@@ -1178,17 +1291,44 @@ lints::ERI4D1Kernel::ERI4D1Kernel(const ShellPairData &sp_data_ab, const ShellPa
     else
         eri4d1_kernelfun_ = [](const size_t ipair_ab, const size_t ipair_cd,
                                const ShellPairData &spd_ab, const ShellPairData &spd_cd,
-                               const ERI4D1Kernel *eri4d1_kernel) -> std::array<vec4d, 12>
+                               const ERI4D1Kernel *eri4d1_kernel) -> std::array<vec4d, 9>
         {
             return eri4d1KernelFun(ipair_ab, ipair_cd, spd_ab, spd_cd, eri4d1_kernel);
         };
 }
 
-lints::ERI3D1Kernel::ERI3D1Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c)
+void lints::ERI4D1Kernel::updateCoordinates(const ShellPairData &sp_data_ab,
+                                            const ShellPairData &sp_data_cd)
 {
     ecoeffs0_bra_ = ecoeffsSHARK(sp_data_ab, false);
     ecoeffs1_bra_ = ecoeffsD1SHARK(sp_data_ab, false);
-    ecoeffs0_ket_ = ecoeffsSHARK(sh_data_c, true);
+    ecoeffs0_ket_ = ecoeffsSHARK(sp_data_cd, true);
+    ecoeffs1_ket_ = ecoeffsD1SHARK(sp_data_cd, true);
+}
+
+std::array<lible::vec4d, 12> lints::ERI4D1Kernel::operator()(const size_t ipair_ab,
+                                                            const size_t ipair_cd,
+                                                            const ShellPairData &sp_data_ab,
+                                                            const ShellPairData &sp_data_cd) const
+{
+    std::array<vec4d, 9> eri4_batch_abc = derivativesABC(ipair_ab, ipair_cd, sp_data_ab,
+                                                         sp_data_cd);
+
+    std::array<vec4d, 12> eri4_batch;
+    for (int ideriv = 0; ideriv < 9; ideriv++)
+        eri4_batch[ideriv] = std::move(eri4_batch_abc[ideriv]);
+
+    // D
+    for (int ideriv = 9; ideriv < 12; ideriv++)
+        eri4_batch[ideriv] = -1 * (eri4_batch[ideriv - 9] + eri4_batch[ideriv - 6] +
+                                   eri4_batch[ideriv - 3]);
+
+    return eri4_batch;
+}
+
+lints::ERI3D1Kernel::ERI3D1Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c)
+{
+    updateCoordinates(sp_data_ab, sh_data_c);
 
     auto [la, lb] = sp_data_ab.getLPair();
     int lc = sh_data_c.l_;
@@ -1206,10 +1346,17 @@ lints::ERI3D1Kernel::ERI3D1Kernel(const ShellPairData &sp_data_ab, const ShellDa
         };
 }
 
+void lints::ERI3D1Kernel::updateCoordinates(const ShellPairData &sp_data_ab,
+                                            const ShellData &sh_data_c)
+{
+    ecoeffs0_bra_ = ecoeffsSHARK(sp_data_ab, false);
+    ecoeffs1_bra_ = ecoeffsD1SHARK(sp_data_ab, false);
+    ecoeffs0_ket_ = ecoeffsSHARK(sh_data_c, true);
+}
+
 lints::ERI2D1Kernel::ERI2D1Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b)
 {
-    ecoeffs_bra_ = ecoeffsSHARK(sh_data_a, false);
-    ecoeffs_ket_ = ecoeffsSHARK(sh_data_b, true);
+    updateCoordinates(sh_data_a, sh_data_b);
 
     int la = sh_data_a.l_;
     int lb = sh_data_b.l_;
@@ -1227,10 +1374,15 @@ lints::ERI2D1Kernel::ERI2D1Kernel(const ShellData &sh_data_a, const ShellData &s
         };
 }
 
-lints::ERI2D2Kernel::ERI2D2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b)
+void lints::ERI2D1Kernel::updateCoordinates(const ShellData &sh_data_a, const ShellData &sh_data_b)
 {
     ecoeffs_bra_ = ecoeffsSHARK(sh_data_a, false);
     ecoeffs_ket_ = ecoeffsSHARK(sh_data_b, true);
+}
+
+lints::ERI2D2Kernel::ERI2D2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b)
+{
+    updateCoordinates(sh_data_a, sh_data_b);
 
     int la = sh_data_a.l_;
     int lb = sh_data_b.l_;
@@ -1248,10 +1400,15 @@ lints::ERI2D2Kernel::ERI2D2Kernel(const ShellData &sh_data_a, const ShellData &s
         };
 }
 
+void lints::ERI2D2Kernel::updateCoordinates(const ShellData &sh_data_a, const ShellData &sh_data_b)
+{
+    ecoeffs_bra_ = ecoeffsSHARK(sh_data_a, false);
+    ecoeffs_ket_ = ecoeffsSHARK(sh_data_b, true);
+}
+
 lints::ERI4SOCKernel::ERI4SOCKernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd)
 {
-    ecoeffs1_bra_ = ecoeffsD1SHARK(sp_data_ab, false);
-    ecoeffs0_ket_ = ecoeffsSHARK(sp_data_cd, true);
+    updateCoordinates(sp_data_ab, sp_data_cd);
 
     auto [la, lb] = sp_data_ab.getLPair();
     auto [lc, ld] = sp_data_cd.getLPair();
@@ -1269,10 +1426,16 @@ lints::ERI4SOCKernel::ERI4SOCKernel(const ShellPairData &sp_data_ab, const Shell
         };
 }
 
-lints::ERI3SOCKernel::ERI3SOCKernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c)
+void lints::ERI4SOCKernel::updateCoordinates(const ShellPairData &sp_data_ab,
+                                             const ShellPairData &sp_data_cd)
 {
     ecoeffs1_bra_ = ecoeffsD1SHARK(sp_data_ab, false);
-    ecoeffs0_ket_ = ecoeffsSHARK(sh_data_c, true);
+    ecoeffs0_ket_ = ecoeffsSHARK(sp_data_cd, true);
+}
+
+lints::ERI3SOCKernel::ERI3SOCKernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c)
+{
+    updateCoordinates(sp_data_ab, sh_data_c);
 
     auto [la, lb] = sp_data_ab.getLPair();
     int lc = sh_data_c.l_;
@@ -1288,4 +1451,11 @@ lints::ERI3SOCKernel::ERI3SOCKernel(const ShellPairData &sp_data_ab, const Shell
         {
             return eri3socKernelFun(ipair_ab, ish_c, spd_ab, shd_c, eri3soc_kernel);
         };
-}
\ No newline at end of file
+}
+
+void lints::ERI3SOCKernel::updateCoordinates(const ShellPairData &sp_data_ab,
+                                             const ShellData &sh_data_c)
+{
+    ecoeffs1_bra_ = ecoeffsD1SHARK(sp_data_ab, false);
+    ecoeffs0_ket_ = ecoeffsSHARK(sh_data_c, true);
+}
@@ -2,12 +2,47 @@
 
 #include <lible/types.hpp>
 #include <lible/ints/boys_function.hpp>
+#include <lible/ints/rys_quadrature.hpp>
 #include <lible/ints/shell_pair_data.hpp>
 
 #include <functional>
+#include <memory>
 
 namespace lible::ints
 {
+    /// Method for evaluating the ERIs of an L class. The McMurchie-Davidson/SHARK scheme is the
+    /// default and uses the templated kernels up to `_max_l_rollout_`. The generic SHARK kernel
+    /// can be forced with `shark_generic`. The Rys quadrature can be faster for classes with high
+    /// total L.
+    enum class ERIBackend
+    {
+        shark,
+        shark_generic,
+        rys,
+    };
+
+    /// Data of an L class for the Rys quadrature kernels, constructed once per class: the
+    /// indices of the Cartesian Gaussian quartets into the one-dimensional Rys integral tables,
+    /// (ia, ib, ic, id), in the three Cartesian directions, and the scratch size of a primitive
+    /// quartet.
+    struct RysCartIdxs
+    {
+        RysCartIdxs() = default;
+
+        RysCartIdxs(int la, int lb, int lc, int ld, int n_roots);
+
+        int la_{};
+        int lb_{};
+        int lc_{};
+        int ld_{};
+        int n_cart_abcd_{};
+        int n_tab_{};
+        int scratch_size_{};
+        std::vector<int> idxs_x_;
+        std::vector<int> idxs_y_;
+        std::vector<int> idxs_z_;
+    };
+
     struct ERI4Kernel;
     struct ERI3Kernel;
     struct ERI2Kernel;
@@ -33,7 +68,7 @@ namespace lible::ints
         size_t ishell_a, size_t ishell_b, const ShellData &sp_data_a,
         const ShellData &sh_data_b, const ERI2Kernel *eri2_kernel)>;
 
-    using eri4d1_kernelfun_t = std::function<std::array<vec4d, 12>(
+    using eri4d1_kernelfun_t = std::function<std::array<vec4d, 9>(
         size_t ipair_ab, size_t ipair_cd, const ShellPairData &sp_data_ab,
         const ShellPairData &sp_data_cd, const ERI4D1Kernel *eri4d1_kernel)>;
 
@@ -59,7 +94,23 @@ namespace lible::ints
 
     struct ERI4Kernel
     {
-        ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
+        ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd,
+                   ERIBackend backend = ERIBackend::shark);
+
+        /// Uses the bra and ket E-coefficients from ecoeffsShared(sp_data_ab, false) and
+        /// ecoeffsShared(sp_data_cd, true) instead of calculating them.
+        ERI4Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd,
+                   std::shared_ptr<const std::vector<double>> ecoeffs_bra,
+                   std::shared_ptr<const std::vector<double>> ecoeffs_ket,
+                   ERIBackend backend = ERIBackend::shark);
+
+        /// Recalculates the E-coefficients after the coordinates in the shell pair data have
+        /// been refreshed, e.g., by updateShellPairData(). The Boys and Rys grids are kept.
+        void updateCoordinates(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
+
+        /// Uses the refreshed E-coefficients from ecoeffsShared() instead of calculating them.
+        void updateCoordinates(std::shared_ptr<const std::vector<double>> ecoeffs_bra,
+                               std::shared_ptr<const std::vector<double>> ecoeffs_ket);
 
         vec4d operator()(const size_t ipair_ab, const size_t ipair_cd,
                          const ShellPairData &sp_data_ab,
@@ -68,16 +119,40 @@ namespace lible::ints
             return eri4_kernelfun_(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd, this);
         }
 
-        std::vector<double> ecoeffs_bra_;
-        std::vector<double> ecoeffs_ket_;
+        std::shared_ptr<const std::vector<double>> ecoeffs_bra_;
+        std::shared_ptr<const std::vector<double>> ecoeffs_ket_;
         eri4_kernelfun_t eri4_kernelfun_;
 
+        ERIBackend backend_;
         BoysGrid boys_grid_;
+        RysGrid rys_grid_;
+        RysCartIdxs rys_cart_idxs_;
     };
 
+    /// Returns ecoeffsSHARK(sp_data, transpose) in a shared pointer. These can be shared between
+    /// the ERI4 and ERI3 kernels of the different classes with the same bra or ket class.
+    std::shared_ptr<const std::vector<double>> ecoeffsShared(const ShellPairData &sp_data,
+                                                             bool transpose = false);
+
     struct ERI3Kernel
     {
-        ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c);
+        ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c,
+                   ERIBackend backend = ERIBackend::shark);
+
+        /// Uses the bra E-coefficients from ecoeffsShared(sp_data_ab) instead of calculating them.
+        ERI3Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c,
+                   std::shared_ptr<const std::vector<double>> ecoeffs_bra,
+                   ERIBackend backend = ERIBackend::shark);
+
+        /// Recalculates the E-coefficients after the coordinates in the shell data have been
+        /// refreshed, e.g., by updateShellPairData() and updateShellDataAux(). The Boys and Rys
+        /// grids are kept.
+        void updateCoordinates(const ShellPairData &sp_data_ab, const ShellData &sh_data_c);
+
+        /// Uses the refreshed bra E-coefficients from ecoeffsShared() instead of calculating
+        /// them.
+        void updateCoordinates(const ShellData &sh_data_c,
+                               std::shared_ptr<const std::vector<double>> ecoeffs_bra);
 
         vec3d operator()(const size_t ipair_ab, const size_t ishell_c,
                          const ShellPairData &sp_data_ab,
@@ -86,16 +161,24 @@ namespace lible::ints
             return eri3_kernelfun_(ipair_ab, ishell_c, sp_data_ab, sh_data_c, this);
         }
 
-        std::vector<double> ecoeffs_bra_;
+        std::shared_ptr<const std::vector<double>> ecoeffs_bra_;
         std::vector<double> ecoeffs_ket_;
         eri3_kernelfun_t eri3_kernelfun_;
 
+        ERIBackend backend_;
         BoysGrid boys_grid_;
+        RysGrid rys_grid_;
+        RysCartIdxs rys_cart_idxs_;
     };
 
     struct ERI2Kernel
     {
-        ERI2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b);
+        ERI2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b,
+                   ERIBackend backend = ERIBackend::shark);
+
+        /// Recalculates the E-coefficients after the coordinates in the shell data have been
+        /// refreshed, e.g., by updateShellDataAux(). The Boys and Rys grids are kept.
+        void updateCoordinates(const ShellData &sh_data_a, const ShellData &sh_data_b);
 
         vec2d operator()(const size_t ishell_a, const size_t ishell_b,
                          const ShellData &sh_data_a,
@@ -108,16 +191,30 @@ namespace lible::ints
         std::vector<double> ecoeffs_ket_;
         eri2_kernelfun_t eri2_kernelfun_;
 
+        ERIBackend backend_;
         BoysGrid boys_grid_;
+        RysGrid rys_grid_;
+        RysCartIdxs rys_cart_idxs_;
     };
 
     struct ERI4D1Kernel
     {
         ERI4D1Kernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
 
-        std::array<vec4d, 12> operator()(const size_t ipair_ab, const size_t ipair_cd,
+        /// Recalculates the E-coefficients after the coordinates in the shell pair data have
+        /// been refreshed, e.g., by updateShellPairData().
+        void updateCoordinates(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
+
+        /// Returns the derivatives with respect to all four centers, {Ax, Ay, Az, ..., Dz}.
+        std::array<vec4d, 12> operator()(size_t ipair_ab, size_t ipair_cd,
                                          const ShellPairData &sp_data_ab,
-                                         const ShellPairData &sp_data_cd) const
+                                         const ShellPairData &sp_data_cd) const;
+
+        /// Returns the derivatives with respect to A, B and C, {Ax, Ay, Az, ..., Cz}. The D
+        /// derivative is -(A + B + C), so contractions can apply it to the contracted values.
+        std::array<vec4d, 9> derivativesABC(const size_t ipair_ab, const size_t ipair_cd,
+                                            const ShellPairData &sp_data_ab,
+                                            const ShellPairData &sp_data_cd) const
         {
             return eri4d1_kernelfun_(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd, this);
         }
@@ -135,6 +232,10 @@ namespace lible::ints
     {
         ERI3D1Kernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c);
 
+        /// Recalculates the E-coefficients after the coordinates in the shell data have been
+        /// refreshed, e.g., by updateShellPairData() and updateShellDataAux().
+        void updateCoordinates(const ShellPairData &sp_data_ab, const ShellData &sh_data_c);
+
         std::array<vec3d, 9> operator()(const size_t ipair_ab, const size_t ishell_c,
                                         const ShellPairData &sp_data_ab,
                                         const ShellData &sh_data_c) const
@@ -154,6 +255,10 @@ namespace lible::ints
     {
         ERI2D1Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b);
 
+        /// Recalculates the E-coefficients after the coordinates in the shell data have been
+        /// refreshed, e.g., by updateShellDataAux().
+        void updateCoordinates(const ShellData &sh_data_a, const ShellData &sh_data_b);
+
         std::array<vec2d, 6> operator()(const size_t ishell_a, const size_t ishell_b,
                                         const ShellData &sh_data_a,
                                         const ShellData &sh_data_b) const
@@ -172,6 +277,10 @@ namespace lible::ints
     {
         ERI2D2Kernel(const ShellData &sh_data_a, const ShellData &sh_data_b);
 
+        /// Recalculates the E-coefficients after the coordinates in the shell data have been
+        /// refreshed, e.g., by updateShellDataAux().
+        void updateCoordinates(const ShellData &sh_data_a, const ShellData &sh_data_b);
+
         arr2d<vec2d, 6, 6> operator()(const size_t ishell_a, const size_t ishell_b,
                                       const ShellData &sh_data_a,
                                       const ShellData &sh_data_b) const
@@ -190,6 +299,10 @@ namespace lible::ints
     {
         ERI4SOCKernel(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
 
+        /// Recalculates the E-coefficients after the coordinates in the shell pair data have
+        /// been refreshed, e.g., by updateShellPairData().
+        void updateCoordinates(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
+
         std::array<vec4d, 3> operator()(const size_t ipair_ab, const size_t ipair_cd,
                                         const ShellPairData &sp_data_ab,
                                         const ShellPairData &sp_data_cd) const
@@ -208,6 +321,10 @@ namespace lible::ints
     {
         ERI3SOCKernel(const ShellPairData &sp_data_ab, const ShellData &sh_data_c);
 
+        /// Recalculates the E-coefficients after the coordinates in the shell data have been
+        /// refreshed, e.g., by updateShellPairData() and updateShellDataAux().
+        void updateCoordinates(const ShellPairData &sp_data_ab, const ShellData &sh_data_c);
+
         std::array<vec3d, 3> operator()(const size_t ipair_ab, const size_t ishell_c,
                                         const ShellPairData &sp_data_ab,
                                         const ShellData &sh_data_c) const
@@ -5,10 +5,10 @@ template lible::vec4d lible::ints::eri4KernelFun<0, 0, 0, 0>(const size_t ipair_
                                                              const ShellPairData &sp_data_cd,
                                                              const ERI4Kernel *eri4_kernel);
 
-template std::array<lible::vec4d, 12> lible::ints::eri4d1KernelFun<0, 0, 0, 0>(const size_t ipair_ab, const size_t ipair_cd,
-                                                                               const ShellPairData &sh_data_ab,
-                                                                               const ShellPairData &sp_data_cd,
-                                                                               const ERI4D1Kernel *eri4d1_kernel);
+template std::array<lible::vec4d, 9> lible::ints::eri4d1KernelFun<0, 0, 0, 0>(const size_t ipair_ab, const size_t ipair_cd,
+                                                                              const ShellPairData &sh_data_ab,
+                                                                              const ShellPairData &sp_data_cd,
+                                                                              const ERI4D1Kernel *eri4d1_kernel);
 
 template std::array<lible::vec4d, 3> lible::ints::eri4socKernelFun<0, 0, 0, 0>(const size_t ipair_ab, const size_t ipair_cd,
                                                                                 const ShellPairData &sh_data_ab,
@@ -0,0 +1,191 @@
+#include <lible/ints/single_precision.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/twoel/eri_kernels.hpp>
+
+#include <stdexcept>
+#include <utility>
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Number of auxiliary functions in the B-tensor blocks converted at once.
+    constexpr size_t n_Q_block_sp = 128;
+
+    /// Stores the rows (mu nu) and (nu mu) of the shell pair `ipair_ab` from `rows`, given as
+    /// (ab, n_cols) in double precision.
+    void setPairRows(size_t ipair_ab, const ShellPairData &sp_data_ab, size_t dim_ao,
+                     const std::vector<double> &rows, SinglePrecisionMatrix &matrix);
+}
+
+void lints::setPairRows(const size_t ipair_ab, const ShellPairData &sp_data_ab,
+                        const size_t dim_ao, const std::vector<double> &rows,
+                        SinglePrecisionMatrix &matrix)
+{
+    int n_sph_a = numSphericals(sp_data_ab.la_);
+    int n_sph_b = numSphericals(sp_data_ab.lb_);
+    size_t n_cols = matrix.getNCols();
+
+    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+    for (int ia = 0, ab = 0; ia < n_sph_a; ia++)
+        for (int ib = 0; ib < n_sph_b; ib++, ab++)
+        {
+            size_t mu = ofs_a + ia;
+            size_t nu = ofs_b + ib;
+
+            matrix.setRow(mu * dim_ao + nu, &rows[ab * n_cols]);
+            matrix.setRow(nu * dim_ao + mu, &rows[ab * n_cols]);
+        }
+}
+
+lints::SinglePrecisionMatrix lints::eri3SinglePrecision(const Structure &structure)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("RI approximation is not enabled!");
+
+    std::vector<ShellData> sh_datas = shellDataAux(structure);
+    std::vector<ShellPairData> sp_datas = shellPairData(true, structure);
+
+    // The tasks, {class, ipair_ab}, are the shell pairs of every bra class, each calculated for
+    // all the auxiliary shells.
+    std::vector<std::vector<ERI3Kernel>> eri3_kernels(sp_datas.size());
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_datas.size(); ispdata_ab++)
+    {
+        auto ecoeffs_bra = ecoeffsShared(sp_datas[ispdata_ab]);
+        for (const ShellData &sh_data_c : sh_datas)
+            eri3_kernels[ispdata_ab].emplace_back(sp_datas[ispdata_ab], sh_data_c, ecoeffs_bra);
+
+        for (size_t ipair_ab = 0; ipair_ab < sp_datas[ispdata_ab].n_pairs_; ipair_ab++)
+            tasks.push_back({ispdata_ab, ipair_ab});
+    }
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    SinglePrecisionMatrix eri3(dim_ao * dim_ao, dim_ao_aux);
+
+#pragma omp parallel
+    {
+        std::vector<double> rows;
+
+#pragma omp for schedule(dynamic)
+        for (size_t itask = 0; itask < tasks.size(); itask++)
+        {
+            auto [ispdata_ab, ipair_ab] = tasks[itask];
+
+            const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+            int n_ab = numSphericals(sp_data_ab.la_) * numSphericals(sp_data_ab.lb_);
+
+            // (ab, P)
+            rows.assign(n_ab * dim_ao_aux, 0);
+            for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++)
+            {
+                const ShellData &sh_data_c = sh_datas[ishdata_c];
+                const ERI3Kernel &eri3_kernel = eri3_kernels[ispdata_ab][ishdata_c];
+
+                int n_sph_c = numSphericals(sh_data_c.l_);
+                for (size_t ishell_c = 0; ishell_c < sh_data_c.n_shells_; ishell_c++)
+                {
+                    vec3d eri3_batch = eri3_kernel(ipair_ab, ishell_c, sp_data_ab, sh_data_c);
+
+                    size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
+                    for (int ab = 0; ab < n_ab; ab++)
+                        for (int ic = 0; ic < n_sph_c; ic++)
+                            rows[ab * dim_ao_aux + ofs_c + ic] = eri3_batch[ab * n_sph_c + ic];
+                }
+            }
+
+            setPairRows(ipair_ab, sp_data_ab, dim_ao, rows, eri3);
+        }
+    }
+
+    return eri3;
+}
+
+lints::SinglePrecisionMatrix lints::eri4SinglePrecision(const Structure &structure)
+{
+    std::vector<ShellPairData> sp_datas = shellPairData(true, structure);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_sq = dim_ao * dim_ao;
+    SinglePrecisionMatrix eri4(dim_ao_sq, dim_ao_sq);
+
+    // Same task layout as in eri4(), the (ab|cd) with ab >= cd are stored in all eight places.
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_datas.size(); ispdata_ab++)
+        for (size_t ispdata_cd = 0; ispdata_cd <= ispdata_ab; ispdata_cd++)
+        {
+            const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+            const ShellPairData &sp_data_cd = sp_datas[ispdata_cd];
+
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            int n_sph_c = numSphericals(sp_data_cd.la_);
+            int n_sph_d = numSphericals(sp_data_cd.lb_);
+
+            ERI4Kernel eri4_kernel(sp_data_ab, sp_data_cd);
+
+#pragma omp parallel for schedule(dynamic)
+            for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+            {
+                size_t bound_cd = (ispdata_ab == ispdata_cd) ? ipair_ab + 1 : sp_data_cd.n_pairs_;
+                for (size_t ipair_cd = 0; ipair_cd < bound_cd; ipair_cd++)
+                {
+                    vec4d eri4_batch = eri4_kernel(ipair_ab, ipair_cd, sp_data_ab, sp_data_cd);
+
+                    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                    size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
+                    size_t ofs_d = sp_data_cd.offsets_sph_[2 * ipair_cd + 1];
+
+                    for (int ia = 0; ia < n_sph_a; ia++)
+                        for (int ib = 0; ib < n_sph_b; ib++)
+                            for (int ic = 0; ic < n_sph_c; ic++)
+                                for (int id = 0; id < n_sph_d; id++)
+                                {
+                                    size_t mu = ofs_a + ia;
+                                    size_t nu = ofs_b + ib;
+                                    size_t ka = ofs_c + ic;
+                                    size_t ta = ofs_d + id;
+
+                                    size_t munu = mu * dim_ao + nu;
+                                    size_t numu = nu * dim_ao + mu;
+                                    size_t kata = ka * dim_ao + ta;
+                                    size_t taka = ta * dim_ao + ka;
+
+                                    double integral = eri4_batch(ia, ib, ic, id);
+                                    eri4.set(munu, kata, integral);
+                                    eri4.set(munu, taka, integral);
+                                    eri4.set(numu, kata, integral);
+                                    eri4.set(numu, taka, integral);
+                                    eri4.set(kata, munu, integral);
+                                    eri4.set(kata, numu, integral);
+                                    eri4.set(taka, munu, integral);
+                                    eri4.set(taka, numu, integral);
+                                }
+                }
+            }
+        }
+
+    return eri4;
+}
+
+lints::SinglePrecisionMatrix
+lints::riBTensorMOSinglePrecision(const Structure &structure, const RIMetric &metric,
+                                  const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                                  const double max_memory_mb, const std::string &scratch_dir)
+{
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_pq = mo_coeffs_p.dim<1>() * mo_coeffs_q.dim<1>();
+
+    SinglePrecisionMatrix b_tensor(dim_ao_aux, n_pq);
+    riBTensorMO(structure, metric, mo_coeffs_p, mo_coeffs_q, n_Q_block_sp,
+                [&](const size_t ofs_Q, const size_t n_Q, const double *b_block)
+                {
+                    for (size_t iQ = 0; iQ < n_Q; iQ++)
+                        b_tensor.setRow(ofs_Q + iQ, &b_block[iQ * n_pq]);
+                },
+                max_memory_mb, scratch_dir);
+
+    return b_tensor;
+}
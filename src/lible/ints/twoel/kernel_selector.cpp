@@ -0,0 +1,133 @@
+#include <lible/ints/twoel/kernel_selector.hpp>
+
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace lints = lible::ints;
+
+lints::KernelSelector::KernelSelector(const std::string &tuning_file)
+{
+    std::ifstream file(tuning_file, std::ios::in);
+    if (!file)
+        throw std::runtime_error(std::format("KernelSelector::KernelSelector(): could not open "
+                                             "the tuning file {}", tuning_file));
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream iss(line);
+
+        int la, lb, lc, ld, depth_bucket;
+        std::string backend;
+        if (!(iss >> la >> lb >> lc >> ld >> depth_bucket >> backend))
+            throw std::runtime_error(std::format("KernelSelector::KernelSelector(): invalid "
+                                                 "line in the tuning file: {}", line));
+
+        set(la, lb, lc, ld, depth_bucket, eriBackendFromString(backend));
+    }
+}
+
+lints::ERIBackend lints::KernelSelector::select(const int la, const int lb, const int lc,
+                                                const int ld, const int depth_bucket) const
+{
+    if (auto it = selections_.find({la, lb, lc, ld, depth_bucket}); it != selections_.end())
+        return it->second;
+
+    // (ab|cd) = (cd|ab), so the swapped class is timed the same.
+    if (auto it = selections_.find({lc, ld, la, lb, depth_bucket}); it != selections_.end())
+        return it->second;
+
+    return ERIBackend::shark;
+}
+
+lints::ERIBackend lints::KernelSelector::select(const ShellPairData &sp_data_ab,
+                                                const ShellPairData &sp_data_cd) const
+{
+    auto [la, lb] = sp_data_ab.getLPair();
+    auto [lc, ld] = sp_data_cd.getLPair();
+
+    return select(la, lb, lc, ld, depthBucket(sp_data_ab, sp_data_cd));
+}
+
+void lints::KernelSelector::set(const int la, const int lb, const int lc, const int ld,
+                                const int depth_bucket, const ERIBackend backend)
+{
+    selections_[{la, lb, lc, ld, depth_bucket}] = backend;
+}
+
+void lints::KernelSelector::write(const std::string &tuning_file) const
+{
+    std::ofstream file(tuning_file, std::ios::out);
+    if (!file)
+        throw std::runtime_error(std::format("KernelSelector::write(): could not open the "
+                                             "tuning file {}", tuning_file));
+
+    file << "# la lb lc ld depth_bucket backend\n";
+    for (const auto &[key, backend] : selections_)
+    {
+        auto [la, lb, lc, ld, depth_bucket] = key;
+        file << std::format("{} {} {} {} {} {}\n", la, lb, lc, ld, depth_bucket,
+                            eriBackendString(backend));
+    }
+}
+
+size_t lints::KernelSelector::size() const
+{
+    return selections_.size();
+}
+
+int lints::KernelSelector::depthBucket(const double n_primitives_abcd)
+{
+    if (n_primitives_abcd <= 1)
+        return 0;
+    if (n_primitives_abcd <= 16)
+        return 1;
+    if (n_primitives_abcd <= 256)
+        return 2;
+
+    return 3;
+}
+
+int lints::KernelSelector::depthBucket(const ShellPairData &sp_data_ab,
+                                       const ShellPairData &sp_data_cd)
+{
+    if (sp_data_ab.n_pairs_ == 0 || sp_data_cd.n_pairs_ == 0)
+        return 0;
+
+    double n_ppairs_ab = double(sp_data_ab.n_ppairs_) / sp_data_ab.n_pairs_;
+    double n_ppairs_cd = double(sp_data_cd.n_ppairs_) / sp_data_cd.n_pairs_;
+
+    return depthBucket(n_ppairs_ab * n_ppairs_cd);
+}
+
+std::string lints::eriBackendString(const ERIBackend backend)
+{
+    switch (backend)
+    {
+        case ERIBackend::shark:
+            return "shark";
+        case ERIBackend::shark_generic:
+            return "shark_generic";
+        case ERIBackend::rys:
+            return "rys";
+        default:
+            throw std::runtime_error("eriBackendString(): unknown backend");
+    }
+}
+
+lints::ERIBackend lints::eriBackendFromString(const std::string &name)
+{
+    if (name == "shark")
+        return ERIBackend::shark;
+    if (name == "shark_generic")
+        return ERIBackend::shark_generic;
+    if (name == "rys")
+        return ERIBackend::rys;
+
+    throw std::runtime_error(std::format("eriBackendFromString(): unknown backend {}", name));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <lible/ints/twoel/eri_kernels.hpp>
+
+#include <map>
+#include <string>
+#include <tuple>
+
+namespace lible::ints
+{
+    /// Class for choosing the ERI4 kernel variant per (la, lb, lc, ld) and primitive depth bucket.
+    /// The selections are independent of any particular structure and can be written to and read
+    /// from a tuning file, e.g., produced by `eri4Autotune()`. Classes without a selection fall
+    /// back to the default SHARK kernel.
+    class KernelSelector
+    {
+    public:
+        /// Default ctor. Selects the default SHARK kernel for every class.
+        KernelSelector() = default;
+
+        /// Reads the selections from the given tuning file.
+        explicit KernelSelector(const std::string &tuning_file);
+
+        /// Returns the selected backend for the given class and primitive depth bucket.
+        ERIBackend select(int la, int lb, int lc, int ld, int depth_bucket) const;
+
+        /// Returns the selected backend for the class given by the shell pair datas.
+        ERIBackend select(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd) const;
+
+        /// Sets the backend for the given class and primitive depth bucket.
+        void set(int la, int lb, int lc, int ld, int depth_bucket, ERIBackend backend);
+
+        /// Writes the selections to the given tuning file.
+        void write(const std::string &tuning_file) const;
+
+        /// Returns the number of selections.
+        size_t size() const;
+
+        /// Returns the primitive depth bucket for the average number of primitive quartets per
+        /// shell quartet: 0 for uncontracted, 1 up to 16, 2 up to 256 and 3 above that.
+        static int depthBucket(double n_primitives_abcd);
+
+        /// Returns the primitive depth bucket of the class given by the shell pair datas.
+        static int depthBucket(const ShellPairData &sp_data_ab, const ShellPairData &sp_data_cd);
+
+    private:
+        /// Selected backends as (la, lb, lc, ld, depth_bucket) -> backend.
+        std::map<std::tuple<int, int, int, int, int>, ERIBackend> selections_;
+    };
+
+    /// Returns the name of the backend as used in the tuning files.
+    std::string eriBackendString(ERIBackend backend);
+
+    /// Returns the backend corresponding to the name used in the tuning files.
+    ERIBackend eriBackendFromString(const std::string &name);
+}
@@ -0,0 +1,366 @@
+#include <lible/ints/twoel/ri_metric.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/twoel/eri_kernels.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _LIBLE_USE_MKL_
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Calculates the three-index integrals (pq|P) = sum_{ab} C_a,p C_b,q (ab|P) for the p in
+    /// [ofs_p, ofs_p + n_p) and returns them as (pq, P). The (ab|P) of one auxiliary shell at a
+    /// time are transformed with DGEMM straight from the shell pair batches to (p nu|P), and
+    /// then to (pq|P). The kernels are given as [ispdata_ab][ishdata_c].
+    std::vector<double> eri3MOBatch(const Structure &structure,
+                                    const std::vector<ShellPairData> &sp_datas,
+                                    const std::vector<ShellData> &sh_datas_aux,
+                                    const std::vector<std::vector<ERI3Kernel>> &eri3_kernels,
+                                    const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                                    size_t ofs_p, size_t n_p);
+
+    /// Checks the arguments of the B-tensor functions and returns the number of the p indices
+    /// in a batch, such that the (pq|P) of the batch and the (p nu|P) of the threads fit into
+    /// `max_memory_mb`.
+    size_t batchSizeBTensor(const Structure &structure, const RIMetric &metric,
+                            const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                            double max_memory_mb);
+
+    /// Runs over the batches of `n_p_batch` p indices and hands the B-tensor of each batch,
+    /// (pq, Q), to `transfer`.
+    template <typename F>
+    void riBTensorBatches(const Structure &structure, const RIMetric &metric,
+                          const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q, size_t n_p_batch,
+                          F transfer);
+
+    /// Writes the B-tensor of a batch of the p indices, (pq, Q), to the file holding the full
+    /// B-tensor as (Q, p, q).
+    void writeBTensorBatch(const std::vector<double> &b_batch, size_t ofs_p, size_t n_p,
+                           size_t n_p_total, size_t n_q, size_t dim_ao_aux, std::fstream &file);
+}
+
+std::vector<double> lints::eri3MOBatch(const Structure &structure,
+                                       const std::vector<ShellPairData> &sp_datas,
+                                       const std::vector<ShellData> &sh_datas_aux,
+                                       const std::vector<std::vector<ERI3Kernel>> &eri3_kernels,
+                                       const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                                       const size_t ofs_p, const size_t n_p)
+{
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_p_total = mo_coeffs_p.dim<1>();
+    size_t n_q = mo_coeffs_q.dim<1>();
+
+    // The tasks, {class, ishell_c}, are the auxiliary shells of every class.
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t ishdata_c = 0; ishdata_c < sh_datas_aux.size(); ishdata_c++)
+        for (size_t ishell_c = 0; ishell_c < sh_datas_aux[ishdata_c].n_shells_; ishell_c++)
+            tasks.push_back({ishdata_c, ishell_c});
+
+    std::vector<double> eri3_mo(n_p * n_q * dim_ao_aux, 0);
+
+#pragma omp parallel
+    {
+        std::vector<double> ints_half;
+        std::vector<double> eri3_trans;
+
+#pragma omp for schedule(dynamic)
+        for (size_t itask = 0; itask < tasks.size(); itask++)
+        {
+            auto [ishdata_c, ishell_c] = tasks[itask];
+
+            const ShellData &sh_data_c = sh_datas_aux[ishdata_c];
+            int n_sph_c = numSphericals(sh_data_c.l_);
+            int ld_half = int(dim_ao) * n_sph_c;
+
+            // (p, nu, c)
+            ints_half.assign(n_p * dim_ao * n_sph_c, 0);
+            for (size_t ispdata_ab = 0; ispdata_ab < sp_datas.size(); ispdata_ab++)
+            {
+                const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+                const ERI3Kernel &eri3_kernel = eri3_kernels[ispdata_ab][ishdata_c];
+
+                int n_sph_a = numSphericals(sp_data_ab.la_);
+                int n_sph_b = numSphericals(sp_data_ab.lb_);
+                for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+                {
+                    vec3d eri3_batch = eri3_kernel(ipair_ab, ishell_c, sp_data_ab, sh_data_c);
+
+                    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+
+                    // (p b|c) += sum_a C_a,p (ab|c)
+                    cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, int(n_p),
+                                n_sph_b * n_sph_c, n_sph_a, 1.0, &mo_coeffs_p(ofs_a, ofs_p),
+                                int(n_p_total), eri3_batch.memptr(), n_sph_b * n_sph_c, 1.0,
+                                &ints_half[ofs_b * n_sph_c], ld_half);
+
+                    // The diagonal shell pairs hold both (ab|c) and (ba|c).
+                    if (ofs_a == ofs_b)
+                        continue;
+
+                    eri3_trans.resize(n_sph_a * n_sph_b * n_sph_c);
+                    for (int ia = 0; ia < n_sph_a; ia++)
+                        for (int ib = 0; ib < n_sph_b; ib++)
+                            for (int ic = 0; ic < n_sph_c; ic++)
+                                eri3_trans[(ib * n_sph_a + ia) * n_sph_c + ic] =
+                                        eri3_batch(ia, ib, ic);
+
+                    // (p a|c) += sum_b C_b,p (ab|c)
+                    cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, int(n_p),
+                                n_sph_a * n_sph_c, n_sph_b, 1.0, &mo_coeffs_p(ofs_b, ofs_p),
+                                int(n_p_total), &eri3_trans[0], n_sph_a * n_sph_c, 1.0,
+                                &ints_half[ofs_a * n_sph_c], ld_half);
+                }
+            }
+
+            // (pq|c) = sum_nu C_nu,q (p nu|c), written to the (pq, P) of the shell c.
+            size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
+            for (size_t ip = 0; ip < n_p; ip++)
+                cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, int(n_q), n_sph_c,
+                            int(dim_ao), 1.0, &mo_coeffs_q[0], int(n_q),
+                            &ints_half[ip * dim_ao * n_sph_c], n_sph_c, 0.0,
+                            &eri3_mo[ip * n_q * dim_ao_aux + ofs_c], int(dim_ao_aux));
+        }
+    }
+
+    return eri3_mo;
+}
+
+size_t lints::batchSizeBTensor(const Structure &structure, const RIMetric &metric,
+                               const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                               const double max_memory_mb)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("riBTensorMO(): RI approximation is not enabled");
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    if (mo_coeffs_p.dim<0>() != dim_ao || mo_coeffs_q.dim<0>() != dim_ao)
+        throw std::runtime_error("riBTensorMO(): the number of rows of the MO coefficients "
+                                 "doesn't match the number of AOs");
+
+    if (metric.getDim() != dim_ao_aux)
+        throw std::runtime_error("riBTensorMO(): the dimension of the metric doesn't match the "
+                                 "number of auxiliary AOs");
+
+    size_t n_p = mo_coeffs_p.dim<1>();
+    size_t n_q = mo_coeffs_q.dim<1>();
+    if (n_p == 0 || n_q == 0)
+        throw std::runtime_error("riBTensorMO(): no MOs given");
+
+    // Per p index: the (pq|P) of the batch and the (p nu|c) of every thread.
+    size_t n_threads = omp_get_max_threads();
+    size_t n_sph_c_max = numSphericals(structure.getMaxLAux());
+    size_t n_per_p = n_q * dim_ao_aux + n_threads * dim_ao * n_sph_c_max;
+
+    double n_p_fit = max_memory_mb * 1024 * 1024 / (sizeof(double) * n_per_p);
+
+    return std::clamp(size_t(n_p_fit), size_t(1), n_p);
+}
+
+template <typename F>
+void lints::riBTensorBatches(const Structure &structure, const RIMetric &metric,
+                             const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                             const size_t n_p_batch, F transfer)
+{
+    size_t n_p = mo_coeffs_p.dim<1>();
+    size_t n_q = mo_coeffs_q.dim<1>();
+
+    std::vector<ShellData> sh_datas_aux = shellDataAux(structure);
+    std::vector<ShellPairData> sp_datas = shellPairData(true, structure);
+
+    // The kernels are reused for all the batches and the kernels of a bra class share its
+    // E-coefficients.
+    std::vector<std::vector<ERI3Kernel>> eri3_kernels(sp_datas.size());
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_datas.size(); ispdata_ab++)
+    {
+        auto ecoeffs_bra = ecoeffsShared(sp_datas[ispdata_ab]);
+        for (const ShellData &sh_data_c : sh_datas_aux)
+            eri3_kernels[ispdata_ab].emplace_back(sp_datas[ispdata_ab], sh_data_c, ecoeffs_bra);
+    }
+
+    for (size_t ofs_p = 0; ofs_p < n_p; ofs_p += n_p_batch)
+    {
+        size_t n_p_cur = std::min(n_p_batch, n_p - ofs_p);
+
+        std::vector<double> b_batch = eri3MOBatch(structure, sp_datas, sh_datas_aux,
+                                                  eri3_kernels, mo_coeffs_p, mo_coeffs_q,
+                                                  ofs_p, n_p_cur);
+
+        // B_{pq,Q} = sum_P (pq|P) (P|Q)^-1/2
+        metric.applyInverseSqrt(n_p_cur * n_q, &b_batch[0]);
+
+        transfer(ofs_p, n_p_cur, b_batch);
+    }
+}
+
+void lints::writeBTensorBatch(const std::vector<double> &b_batch, const size_t ofs_p,
+                              const size_t n_p, const size_t n_p_total, const size_t n_q,
+                              const size_t dim_ao_aux, std::fstream &file)
+{
+    std::vector<double> buffer(n_p * n_q);
+    for (size_t Q = 0; Q < dim_ao_aux; Q++)
+    {
+        for (size_t pq = 0; pq < n_p * n_q; pq++)
+            buffer[pq] = b_batch[pq * dim_ao_aux + Q];
+
+        size_t pos = (Q * n_p_total + ofs_p) * n_q;
+        file.seekp(std::streamoff(pos * sizeof(double)));
+        file.write(reinterpret_cast<const char *>(&buffer[0]),
+                   std::streamsize(buffer.size() * sizeof(double)));
+    }
+
+    if (!file)
+        throw std::runtime_error("riBTensorMO(): writing the B-tensor file failed");
+}
+
+void lints::riBTensorMO(const Structure &structure, const RIMetric &metric,
+                        const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                        const size_t n_Q_block, const BTensorCallback &callback,
+                        const double max_memory_mb, const std::string &scratch_dir)
+{
+    if (n_Q_block == 0)
+        throw std::runtime_error("riBTensorMO(): the block size is zero");
+
+    size_t n_p_batch = batchSizeBTensor(structure, metric, mo_coeffs_p, mo_coeffs_q,
+                                        max_memory_mb);
+
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_p = mo_coeffs_p.dim<1>();
+    size_t n_q = mo_coeffs_q.dim<1>();
+    size_t n_pq = n_p * n_q;
+
+    if (n_p_batch < n_p && scratch_dir.empty())
+        throw std::runtime_error("riBTensorMO(): the B-tensor doesn't fit into the memory and "
+                                 "no scratch directory is given");
+
+    std::filesystem::path scratch_file;
+    std::fstream file;
+    riBTensorBatches(structure, metric, mo_coeffs_p, mo_coeffs_q, n_p_batch,
+                     [&](const size_t ofs_p, const size_t n_p_cur,
+                         const std::vector<double> &b_batch)
+                     {
+                         // All the p indices in one batch, so the blocks are handed over
+                         // directly.
+                         if (n_p_cur == n_p)
+                         {
+                             std::vector<double> b_block;
+                             for (size_t ofs_Q = 0; ofs_Q < dim_ao_aux; ofs_Q += n_Q_block)
+                             {
+                                 size_t n_Q = std::min(n_Q_block, dim_ao_aux - ofs_Q);
+
+                                 b_block.resize(n_Q * n_pq);
+                                 for (size_t iQ = 0; iQ < n_Q; iQ++)
+                                     for (size_t pq = 0; pq < n_pq; pq++)
+                                         b_block[iQ * n_pq + pq] =
+                                                 b_batch[pq * dim_ao_aux + ofs_Q + iQ];
+
+                                 callback(ofs_Q, n_Q, &b_block[0]);
+                             }
+
+                             return;
+                         }
+
+                         if (!file.is_open())
+                         {
+                             auto stamp = std::chrono::steady_clock::now().time_since_epoch();
+                             scratch_file = std::filesystem::path(scratch_dir) /
+                                            std::format("lible_btensor_{}.tmp", stamp.count());
+
+                             file.open(scratch_file, std::ios::in | std::ios::out |
+                                                         std::ios::binary | std::ios::trunc);
+                             if (!file.is_open())
+                                 throw std::runtime_error(
+                                     std::format("riBTensorMO(): could not open the scratch "
+                                                 "file {}", scratch_file.string()));
+                         }
+
+                         writeBTensorBatch(b_batch, ofs_p, n_p_cur, n_p, n_q, dim_ao_aux, file);
+                     });
+
+    if (!file.is_open())
+        return;
+
+    // The staged B-tensor is stored as (Q, p, q), so each block is read in one go.
+    std::vector<double> b_block;
+    for (size_t ofs_Q = 0; ofs_Q < dim_ao_aux; ofs_Q += n_Q_block)
+    {
+        size_t n_Q = std::min(n_Q_block, dim_ao_aux - ofs_Q);
+
+        b_block.resize(n_Q * n_pq);
+        file.seekg(std::streamoff(ofs_Q * n_pq * sizeof(double)));
+        file.read(reinterpret_cast<char *>(&b_block[0]),
+                  std::streamsize(b_block.size() * sizeof(double)));
+        if (!file)
+            throw std::runtime_error("riBTensorMO(): reading the scratch file failed");
+
+        callback(ofs_Q, n_Q, &b_block[0]);
+    }
+
+    file.close();
+    std::filesystem::remove(scratch_file);
+}
+
+lible::vec3d lints::riBTensorMO(const Structure &structure, const RIMetric &metric,
+                                const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                                const double max_memory_mb)
+{
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_p = mo_coeffs_p.dim<1>();
+    size_t n_q = mo_coeffs_q.dim<1>();
+
+    size_t n_p_batch = batchSizeBTensor(structure, metric, mo_coeffs_p, mo_coeffs_q,
+                                        max_memory_mb);
+
+    vec3d b_tensor(Fill(0), dim_ao_aux, n_p, n_q);
+    riBTensorBatches(structure, metric, mo_coeffs_p, mo_coeffs_q, n_p_batch,
+                     [&](const size_t ofs_p, const size_t n_p_cur,
+                         const std::vector<double> &b_batch)
+                     {
+                         for (size_t ip = 0; ip < n_p_cur; ip++)
+                             for (size_t q = 0; q < n_q; q++)
+                                 for (size_t Q = 0; Q < dim_ao_aux; Q++)
+                                     b_tensor(Q, ofs_p + ip, q) =
+                                             b_batch[(ip * n_q + q) * dim_ao_aux + Q];
+                     });
+
+    return b_tensor;
+}
+
+void lints::riBTensorMOFile(const Structure &structure, const RIMetric &metric,
+                            const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                            const std::string &file_name, const double max_memory_mb)
+{
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_p = mo_coeffs_p.dim<1>();
+    size_t n_q = mo_coeffs_q.dim<1>();
+
+    size_t n_p_batch = batchSizeBTensor(structure, metric, mo_coeffs_p, mo_coeffs_q,
+                                        max_memory_mb);
+
+    std::fstream file(file_name, std::ios::in | std::ios::out | std::ios::binary |
+                                     std::ios::trunc);
+    if (!file.is_open())
+        throw std::runtime_error(std::format("riBTensorMOFile(): could not open the file {}",
+                                             file_name));
+
+    riBTensorBatches(structure, metric, mo_coeffs_p, mo_coeffs_q, n_p_batch,
+                     [&](const size_t ofs_p, const size_t n_p_cur,
+                         const std::vector<double> &b_batch)
+                     {
+                         writeBTensorBatch(b_batch, ofs_p, n_p_cur, n_p, n_q, dim_ao_aux, file);
+                     });
+}
@@ -0,0 +1,521 @@
+#include <lible/ints/distributed.hpp>
+#include <lible/ints/ints.hpp>
+#include <lible/ints/twoel/eri_kernels.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef _LIBLE_USE_MKL_
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Number of auxiliary functions in the blocks of the RI-K intermediate.
+    constexpr size_t n_P_block_k = 64;
+
+    /// Calculates sum_{mu nu P} w(mu, nu, P) d/dR (mu nu|P) as (atom, xyz), where the weight w is
+    /// assumed to be symmetric in mu and nu. The derivative batches are contracted on the fly.
+    /// The auxiliary shells are processed in blocks of at most `n_P_block` functions, or of one
+    /// shell if it is larger. Before the tasks of a block, `set_block(ofs_P, n_P)` is called
+    /// outside of the parallel region, and the weight is only evaluated for the P of that block.
+    template <typename F, typename G>
+    vec2d eri3GradientContracted(const Structure &structure,
+                                 const std::vector<ShellPairData> &sp_data,
+                                 const std::vector<ShellData> &sh_datas, size_t n_P_block,
+                                 G set_block, F weight);
+
+    /// Calculates sum_{PQ} w(P, Q) d/dR (P|Q) as (atom, xyz), where the weight w is assumed to be
+    /// symmetric. The derivative batches are contracted on the fly.
+    template <typename F>
+    vec2d eri2GradientContracted(const Structure &structure,
+                                 const std::vector<ShellData> &sh_datas, F weight);
+}
+
+template <typename F, typename G>
+lible::vec2d lints::eri3GradientContracted(const Structure &structure,
+                                           const std::vector<ShellPairData> &sp_data,
+                                           const std::vector<ShellData> &sh_datas,
+                                           const size_t n_P_block, G set_block, F weight)
+{
+    // The auxiliary shells, {ofs_P, ishdata_c, ishell_c}, in the order of their functions.
+    std::vector<std::array<size_t, 3>> shells_c;
+    for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++)
+        for (size_t ishell_c = 0; ishell_c < sh_datas[ishdata_c].n_shells_; ishell_c++)
+            shells_c.push_back({sh_datas[ishdata_c].offsets_sph_[ishell_c], ishdata_c, ishell_c});
+    std::sort(shells_c.begin(), shells_c.end());
+
+    // The blocks of auxiliary shells given by the shells of every class, {ofs_P, n_P}.
+    std::vector<std::vector<std::vector<size_t>>> blocks_shells_c;
+    std::vector<std::pair<size_t, size_t>> blocks;
+    for (const auto &[ofs_P, ishdata_c, ishell_c] : shells_c)
+    {
+        size_t dim_c = numSphericals(sh_datas[ishdata_c].l_);
+        if (blocks.empty() || blocks.back().second + dim_c > n_P_block)
+        {
+            blocks.push_back({ofs_P, 0});
+            blocks_shells_c.emplace_back(sh_datas.size());
+        }
+
+        blocks.back().second += dim_c;
+        blocks_shells_c.back()[ishdata_c].push_back(ishell_c);
+    }
+
+    std::vector<ERI3D1Kernel> eri3d1_kernels;
+    std::vector<std::pair<size_t, size_t>> classes;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_data.size(); ispdata_ab++)
+        for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++)
+        {
+            classes.push_back({ispdata_ab, ishdata_c});
+            eri3d1_kernels.emplace_back(sp_data[ispdata_ab], sh_datas[ishdata_c]);
+        }
+
+    size_t n_centers = structure.getNCenters();
+
+    vec2d gradient(Fill(0), n_centers, 3);
+
+    for (size_t iblock = 0; iblock < blocks.size(); iblock++)
+    {
+        const std::vector<std::vector<size_t>> &block_shells_c = blocks_shells_c[iblock];
+
+        set_block(blocks[iblock].first, blocks[iblock].second);
+
+        // The tasks, {class, ipair_ab}, are the shell pairs of every (ab|c) class with shells c
+        // in the block, distributed over the processes and threads.
+        std::vector<std::pair<size_t, size_t>> tasks;
+        std::vector<double> costs;
+        for (size_t iclass = 0; iclass < classes.size(); iclass++)
+        {
+            auto [ispdata_ab, ishdata_c] = classes[iclass];
+            if (block_shells_c[ishdata_c].empty())
+                continue;
+
+            const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+            const ShellData &sh_data_c = sh_datas[ishdata_c];
+
+            double cost_c = 0;
+            for (size_t ishell_c : block_shells_c[ishdata_c])
+                cost_c += sh_data_c.cdepths_[ishell_c];
+            cost_c *= numSphericals(sp_data_ab.la_) * numSphericals(sp_data_ab.lb_) *
+                      numSphericals(sh_data_c.l_);
+
+            for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+            {
+                tasks.push_back({iclass, ipair_ab});
+                costs.push_back(sp_data_ab.nrs_ppairs_[ipair_ab] * cost_c);
+            }
+        }
+
+        TaskDistributor distributor(costs);
+
+#pragma omp parallel
+        {
+            vec2d gradient_omp(Fill(0), n_centers, 3);
+
+            size_t itask;
+            while (distributor.next(itask))
+            {
+                auto [iclass, ipair_ab] = tasks[itask];
+                auto [ispdata_ab, ishdata_c] = classes[iclass];
+
+                const ShellPairData &sp_data_ab = sp_data[ispdata_ab];
+                const ShellData &sh_data_c = sh_datas[ishdata_c];
+                const ERI3D1Kernel &eri3d1_kernel = eri3d1_kernels[iclass];
+
+                int n_sph_a = numSphericals(sp_data_ab.la_);
+                int n_sph_b = numSphericals(sp_data_ab.lb_);
+                int n_sph_c = numSphericals(sh_data_c.l_);
+
+                size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                size_t atom_a = sp_data_ab.atomic_idxs_[2 * ipair_ab];
+                size_t atom_b = sp_data_ab.atomic_idxs_[2 * ipair_ab + 1];
+
+                double deg = (sp_data_ab.shell_idxs_[2 * ipair_ab] ==
+                              sp_data_ab.shell_idxs_[2 * ipair_ab + 1]) ? 1.0 : 2.0;
+
+                for (size_t ishell_c : block_shells_c[ishdata_c])
+                {
+                    std::array<vec3d, 9> eri3_batch = eri3d1_kernel(ipair_ab, ishell_c,
+                                                                     sp_data_ab, sh_data_c);
+
+                    size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
+                    size_t atom_c = sh_data_c.atomic_idxs_[ishell_c];
+
+                    // Only the A and C derivatives are contracted, the B derivative follows from
+                    // translational invariance.
+                    std::array<double, 6> contr{};
+                    for (int ia = 0, idx = 0; ia < n_sph_a; ia++)
+                        for (int ib = 0; ib < n_sph_b; ib++)
+                            for (int ic = 0; ic < n_sph_c; ic++, idx++)
+                            {
+                                double w = weight(ofs_a + ia, ofs_b + ib, ofs_c + ic);
+                                for (int icart = 0; icart < 3; icart++)
+                                {
+                                    contr[icart] += w * eri3_batch[icart][idx];
+                                    contr[3 + icart] += w * eri3_batch[6 + icart][idx];
+                                }
+                            }
+
+                    for (int icart = 0; icart < 3; icart++)
+                    {
+                        gradient_omp(atom_a, icart) += deg * contr[icart];
+                        gradient_omp(atom_c, icart) += deg * contr[3 + icart];
+                        gradient_omp(atom_b, icart) -= deg * (contr[icart] + contr[3 + icart]);
+                    }
+                }
+            }
+
+#pragma omp critical
+            {
+                gradient += gradient_omp;
+            }
+        }
+    }
+
+    allReduceSum(&gradient[0], gradient.size());
+
+    return gradient;
+}
+
+template <typename F>
+lible::vec2d lints::eri2GradientContracted(const Structure &structure,
+                                           const std::vector<ShellData> &sh_datas, F weight)
+{
+    // The tasks, {class, ishell_a}, are the shells a of every (a|b) class, distributed over the
+    // processes and threads.
+    std::vector<ERI2D1Kernel> eri2d1_kernels;
+    std::vector<std::pair<size_t, size_t>> classes;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    std::vector<double> costs;
+    for (size_t ishdata_a = 0; ishdata_a < sh_datas.size(); ishdata_a++)
+        for (size_t ishdata_b = 0; ishdata_b <= ishdata_a; ishdata_b++)
+        {
+            const ShellData &sh_data_a = sh_datas[ishdata_a];
+            const ShellData &sh_data_b = sh_datas[ishdata_b];
+
+            size_t iclass = classes.size();
+            classes.push_back({ishdata_a, ishdata_b});
+            eri2d1_kernels.emplace_back(sh_data_a, sh_data_b);
+
+            double cost_b = 0;
+            for (size_t ishell_b = 0; ishell_b < sh_data_b.n_shells_; ishell_b++)
+                cost_b += sh_data_b.cdepths_[ishell_b];
+            cost_b *= numSphericals(sh_data_a.l_) * numSphericals(sh_data_b.l_);
+
+            for (size_t ishell_a = 0; ishell_a < sh_data_a.n_shells_; ishell_a++)
+            {
+                tasks.push_back({iclass, ishell_a});
+                costs.push_back(sh_data_a.cdepths_[ishell_a] * cost_b);
+            }
+        }
+
+    size_t n_centers = structure.getNCenters();
+
+    vec2d gradient(Fill(0), n_centers, 3);
+
+    TaskDistributor distributor(costs);
+
+#pragma omp parallel
+    {
+        vec2d gradient_omp(Fill(0), n_centers, 3);
+
+        size_t itask;
+        while (distributor.next(itask))
+        {
+            auto [iclass, ishell_a] = tasks[itask];
+            auto [ishdata_a, ishdata_b] = classes[iclass];
+
+            const ShellData &sh_data_a = sh_datas[ishdata_a];
+            const ShellData &sh_data_b = sh_datas[ishdata_b];
+            const ERI2D1Kernel &eri2d1_kernel = eri2d1_kernels[iclass];
+
+            int n_sph_a = numSphericals(sh_data_a.l_);
+            int n_sph_b = numSphericals(sh_data_b.l_);
+
+            size_t bound_b = (ishdata_a == ishdata_b) ? ishell_a + 1 : sh_data_b.n_shells_;
+            for (size_t ishell_b = 0; ishell_b < bound_b; ishell_b++)
+            {
+                size_t atom_a = sh_data_a.atomic_idxs_[ishell_a];
+                size_t atom_b = sh_data_b.atomic_idxs_[ishell_b];
+                if (atom_a == atom_b)
+                    continue;
+
+                std::array<vec2d, 6> eri2_batch = eri2d1_kernel(ishell_a, ishell_b, sh_data_a,
+                                                                sh_data_b);
+
+                size_t ofs_a = sh_data_a.offsets_sph_[ishell_a];
+                size_t ofs_b = sh_data_b.offsets_sph_[ishell_b];
+
+                // Only the A derivative is contracted, B = -A.
+                std::array<double, 3> contr{};
+                for (int ia = 0, idx = 0; ia < n_sph_a; ia++)
+                    for (int ib = 0; ib < n_sph_b; ib++, idx++)
+                    {
+                        double w = weight(ofs_a + ia, ofs_b + ib);
+                        for (int icart = 0; icart < 3; icart++)
+                            contr[icart] += w * eri2_batch[icart][idx];
+                    }
+
+                for (int icart = 0; icart < 3; icart++)
+                {
+                    gradient_omp(atom_a, icart) += 2 * contr[icart];
+                    gradient_omp(atom_b, icart) -= 2 * contr[icart];
+                }
+            }
+        }
+
+#pragma omp critical
+        {
+            gradient += gradient_omp;
+        }
+    }
+
+    allReduceSum(&gradient[0], gradient.size());
+
+    return gradient;
+}
+
+lible::vec2d lints::eri2Hessian(const Structure &structure, const vec2d &weight)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("eri2Hessian(): RI approximation is not enabled");
+
+    size_t dim_ao_aux = structure.getDimAOAux();
+    if (weight.dim<0>() != dim_ao_aux || weight.dim<1>() != dim_ao_aux)
+        throw std::runtime_error("eri2Hessian(): dimensions of the weight matrix don't match "
+                                 "the number of auxiliary AOs");
+
+    std::vector<ShellData> sh_datas = shellDataAux(structure);
+
+    // The tasks, {class, ishell_a}, are the shells a of every (a|b) class, distributed over the
+    // processes and threads.
+    std::vector<ERI2D2Kernel> eri2d2_kernels;
+    std::vector<std::pair<size_t, size_t>> classes;
+    std::vector<std::pair<size_t, size_t>> tasks;
+    std::vector<double> costs;
+    for (size_t ishdata_a = 0; ishdata_a < sh_datas.size(); ishdata_a++)
+        for (size_t ishdata_b = 0; ishdata_b <= ishdata_a; ishdata_b++)
+        {
+            const ShellData &sh_data_a = sh_datas[ishdata_a];
+            const ShellData &sh_data_b = sh_datas[ishdata_b];
+
+            size_t iclass = classes.size();
+            classes.push_back({ishdata_a, ishdata_b});
+            eri2d2_kernels.emplace_back(sh_data_a, sh_data_b);
+
+            double cost_b = 0;
+            for (size_t ishell_b = 0; ishell_b < sh_data_b.n_shells_; ishell_b++)
+                cost_b += sh_data_b.cdepths_[ishell_b];
+            cost_b *= numSphericals(sh_data_a.l_) * numSphericals(sh_data_b.l_);
+
+            for (size_t ishell_a = 0; ishell_a < sh_data_a.n_shells_; ishell_a++)
+            {
+                tasks.push_back({iclass, ishell_a});
+                costs.push_back(sh_data_a.cdepths_[ishell_a] * cost_b);
+            }
+        }
+
+    size_t n_coords = 3 * structure.getNCenters();
+
+    vec2d hessian(Fill(0), n_coords, n_coords);
+
+    TaskDistributor distributor(costs);
+
+#pragma omp parallel
+    {
+        vec2d hessian_omp(Fill(0), n_coords, n_coords);
+
+        size_t itask;
+        while (distributor.next(itask))
+        {
+            auto [iclass, ishell_a] = tasks[itask];
+            auto [ishdata_a, ishdata_b] = classes[iclass];
+
+            const ShellData &sh_data_a = sh_datas[ishdata_a];
+            const ShellData &sh_data_b = sh_datas[ishdata_b];
+            const ERI2D2Kernel &eri2d2_kernel = eri2d2_kernels[iclass];
+
+            int n_sph_a = numSphericals(sh_data_a.l_);
+            int n_sph_b = numSphericals(sh_data_b.l_);
+
+            size_t bound_b = (ishdata_a == ishdata_b) ? ishell_a + 1 : sh_data_b.n_shells_;
+            for (size_t ishell_b = 0; ishell_b < bound_b; ishell_b++)
+            {
+                size_t atom_a = sh_data_a.atomic_idxs_[ishell_a];
+                size_t atom_b = sh_data_b.atomic_idxs_[ishell_b];
+                if (atom_a == atom_b)
+                    continue;
+
+                arr2d<vec2d, 6, 6> eri2_batch = eri2d2_kernel(ishell_a, ishell_b, sh_data_a,
+                                                              sh_data_b);
+
+                size_t ofs_a = sh_data_a.offsets_sph_[ishell_a];
+                size_t ofs_b = sh_data_b.offsets_sph_[ishell_b];
+
+                // Only the AA block is contracted, AB = BA = -AA and BB = AA.
+                arr2d<double, 3, 3> contr{};
+                for (int ia = 0, idx = 0; ia < n_sph_a; ia++)
+                    for (int ib = 0; ib < n_sph_b; ib++, idx++)
+                    {
+                        double w = weight(ofs_a + ia, ofs_b + ib);
+                        for (int ideriv = 0; ideriv < 3; ideriv++)
+                            for (int jderiv = 0; jderiv < 3; jderiv++)
+                                contr[ideriv][jderiv] += w * eri2_batch[ideriv][jderiv][idx];
+                    }
+
+                for (int ideriv = 0; ideriv < 3; ideriv++)
+                    for (int jderiv = 0; jderiv < 3; jderiv++)
+                    {
+                        double val = 2 * contr[ideriv][jderiv];
+                        hessian_omp(3 * atom_a + ideriv, 3 * atom_a + jderiv) += val;
+                        hessian_omp(3 * atom_a + ideriv, 3 * atom_b + jderiv) -= val;
+                        hessian_omp(3 * atom_b + ideriv, 3 * atom_a + jderiv) -= val;
+                        hessian_omp(3 * atom_b + ideriv, 3 * atom_b + jderiv) += val;
+                    }
+            }
+        }
+
+#pragma omp critical
+        {
+            hessian += hessian_omp;
+        }
+    }
+
+    allReduceSum(&hessian[0], hessian.size());
+
+    return hessian;
+}
+
+lible::vec2d lints::riGradientJ(const Structure &structure, const vec2d &density,
+                                const std::vector<double> &coeffs_fit)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("riGradientJ(): RI approximation is not enabled");
+
+    return riGradientJ(structure, shellPairData(true, structure), shellDataAux(structure),
+                       density, coeffs_fit);
+}
+
+lible::vec2d lints::riGradientJ(const Structure &structure,
+                                const std::vector<ShellPairData> &sp_data,
+                                const std::vector<ShellData> &sh_datas, const vec2d &density,
+                                const std::vector<double> &coeffs_fit)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("riGradientJ(): RI approximation is not enabled");
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("riGradientJ(): dimensions of the density matrix don't match "
+                                 "the number of AOs");
+
+    if (coeffs_fit.size() != dim_ao_aux)
+        throw std::runtime_error("riGradientJ(): number of fitting coefficients doesn't match "
+                                 "the number of auxiliary AOs");
+
+    vec2d gradient = eri3GradientContracted(structure, sp_data, sh_datas, dim_ao_aux,
+                                            [](size_t, size_t) {},
+                                            [&](size_t mu, size_t nu, size_t P)
+                                            {
+                                                return density(mu, nu) * coeffs_fit[P];
+                                            });
+
+    vec2d gradient_metric = eri2GradientContracted(structure, sh_datas,
+                                                   [&](size_t P, size_t Q)
+                                                   {
+                                                       return coeffs_fit[P] * coeffs_fit[Q];
+                                                   });
+
+    gradient -= 0.5 * gradient_metric;
+
+    return gradient;
+}
+
+lible::vec2d lints::riGradientK(const Structure &structure, const vec2d &density,
+                                const vec3d &coeffs_fit)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("riGradientK(): RI approximation is not enabled");
+
+    return riGradientK(structure, shellPairData(true, structure), shellDataAux(structure),
+                       density, coeffs_fit);
+}
+
+lible::vec2d lints::riGradientK(const Structure &structure,
+                                const std::vector<ShellPairData> &sp_data,
+                                const std::vector<ShellData> &sh_datas, const vec2d &density,
+                                const vec3d &coeffs_fit)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("riGradientK(): RI approximation is not enabled");
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("riGradientK(): dimensions of the density matrix don't match "
+                                 "the number of AOs");
+
+    if (coeffs_fit.dim<0>() != dim_ao || coeffs_fit.dim<1>() != dim_ao ||
+        coeffs_fit.dim<2>() != dim_ao_aux)
+        throw std::runtime_error("riGradientK(): dimensions of the fitting coefficients don't "
+                                 "match the number of AOs");
+
+    int n = int(dim_ao);
+    int n_aux = int(dim_ao_aux);
+
+    // gamma_{mu nu, P} = sum_{ka ta} D_{mu ka} D_{nu ta} C_{ka ta, P} is formed for one block
+    // of P at a time, just before the block is contracted with the derivative integrals, and
+    // gamma_{PQ} = sum_{mu nu} C_{mu nu, P} gamma_{mu nu, Q} is accumulated column-block-wise.
+    vec2d gamma_metric(Fill(0), dim_ao_aux, dim_ao_aux);
+    std::vector<double> C_x_D;
+    std::vector<double> gamma;
+    size_t ofs_gamma = 0;
+    size_t n_gamma = 0;
+
+    auto set_block = [&](const size_t ofs_P, const size_t n_P)
+    {
+        ofs_gamma = ofs_P;
+        n_gamma = n_P;
+        int n_b = int(n_P);
+
+        // (ka, nu, P) = sum_ta D_{nu ta} C_{ka ta, P}
+        C_x_D.resize(dim_ao * dim_ao * n_P);
+#pragma omp parallel for
+        for (int ka = 0; ka < n; ka++)
+            cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n_b, n, 1.0, &density[0], n,
+                        &coeffs_fit(ka, 0, ofs_P), n_aux, 0.0, &C_x_D[size_t(ka) * n * n_b], n_b);
+
+        gamma.resize(dim_ao * dim_ao * n_P);
+        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n * n_b, n, 1.0, &density[0], n,
+                    C_x_D.data(), n * n_b, 0.0, gamma.data(), n * n_b);
+
+        cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, n_aux, n_b, n * n, 1.0,
+                    &coeffs_fit[0], n_aux, gamma.data(), n_b, 0.0, &gamma_metric(0, ofs_P),
+                    n_aux);
+    };
+
+    vec2d gradient = eri3GradientContracted(structure, sp_data, sh_datas, n_P_block_k,
+                                            set_block,
+                                            [&](size_t mu, size_t nu, size_t P)
+                                            {
+                                                return gamma[(mu * dim_ao + nu) * n_gamma +
+                                                             P - ofs_gamma];
+                                            });
+
+    vec2d gradient_metric = eri2GradientContracted(structure, sh_datas,
+                                                   [&](size_t P, size_t Q)
+                                                   {
+                                                       return 0.5 * (gamma_metric(P, Q) +
+                                                                     gamma_metric(Q, P));
+                                                   });
+
+    gradient -= 0.5 * gradient_metric;
+
+    return gradient;
+}
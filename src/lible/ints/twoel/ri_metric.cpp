@@ -0,0 +1,214 @@
+#include <lible/ints/twoel/ri_metric.hpp>
+#include <lible/ints/ints.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _LIBLE_USE_MKL_
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+
+namespace lints = lible::ints;
+
+// LAPACK routines, provided by both MKL and OpenBLAS.
+extern "C"
+{
+    void dpotrf_(const char *uplo, const int *n, double *a, const int *lda, int *info);
+
+    void dsyevd_(const char *jobz, const char *uplo, const int *n, double *a, const int *lda,
+                 double *w, double *work, const int *lwork, int *iwork, const int *liwork,
+                 int *info);
+}
+
+namespace lible::ints
+{
+    /// Number of rows multiplied at once by the inverse square root, limiting the size of the
+    /// intermediate.
+    constexpr size_t n_rows_block = 1024;
+}
+
+lints::RIMetric::RIMetric(const Structure &structure, const double lindep_thrs)
+    : lindep_thrs_(lindep_thrs)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("RIMetric(): RI approximation is not enabled");
+
+    // The diagonal is cheap, O(n_aux), so a broken auxiliary basis is caught before the
+    // O(n_aux^2) metric and the O(n_aux^3) factorization.
+    std::vector<double> diagonal = eri2Diagonal(structure);
+
+    factorize(eri2(structure), std::move(diagonal));
+}
+
+lints::RIMetric::RIMetric(vec2d metric, const double lindep_thrs)
+    : lindep_thrs_(lindep_thrs)
+{
+    if (metric.dim<0>() != metric.dim<1>())
+        throw std::runtime_error("RIMetric(): the metric is not square");
+
+    std::vector<double> diagonal(metric.dim<0>());
+    for (size_t P = 0; P < diagonal.size(); P++)
+        diagonal[P] = metric(P, P);
+
+    factorize(std::move(metric), std::move(diagonal));
+}
+
+void lints::RIMetric::factorize(vec2d metric, std::vector<double> diagonal)
+{
+    dim_ = metric.dim<0>();
+
+    if (diagonal.size() != dim_)
+        throw std::runtime_error("RIMetric(): the diagonal doesn't match the metric");
+
+    for (size_t P = 0; P < dim_; P++)
+        if (!(diagonal[P] > 0) || !std::isfinite(diagonal[P]))
+            throw std::runtime_error("RIMetric(): the metric has a non-positive diagonal "
+                                     "element");
+
+    // The row-major metric is the column-major transpose, so the upper triangle factor from
+    // LAPACK, U^T U, is the lower triangle factor L L^T in row-major.
+    vec2d factor = metric;
+    int n = int(dim_);
+    int info = 0;
+    dpotrf_("U", &n, &factor[0], &n, &info);
+
+    bool lindep = info != 0;
+    for (size_t P = 0; P < dim_ && !lindep; P++)
+        if (factor(P, P) * factor(P, P) < lindep_thrs_ * diagonal[P])
+            lindep = true;
+
+    if (lindep)
+    {
+        factorizeEigen(metric);
+        return;
+    }
+
+    for (size_t P = 0; P < dim_; P++)
+        for (size_t Q = P + 1; Q < dim_; Q++)
+            factor(P, Q) = 0;
+
+    is_cholesky_ = true;
+    rank_ = dim_;
+    factor_ = std::move(factor);
+}
+
+void lints::RIMetric::factorizeEigen(const vec2d &metric)
+{
+    vec2d eigvecs = metric;
+    std::vector<double> eigvals(dim_);
+
+    int n = int(dim_);
+    int info = 0;
+    int lwork = -1, liwork = -1;
+    double lwork_opt = 0;
+    int liwork_opt = 0;
+    dsyevd_("V", "U", &n, &eigvecs[0], &n, &eigvals[0], &lwork_opt, &lwork, &liwork_opt, &liwork,
+            &info);
+
+    lwork = int(lwork_opt);
+    liwork = liwork_opt;
+    std::vector<double> work(lwork);
+    std::vector<int> iwork(liwork);
+    dsyevd_("V", "U", &n, &eigvecs[0], &n, &eigvals[0], &work[0], &lwork, &iwork[0], &liwork,
+            &info);
+
+    if (info != 0)
+        throw std::runtime_error("RIMetric(): diagonalization of the metric failed");
+
+    // The eigenvectors are the columns in column-major, so the rows of `eigvecs` in row-major.
+    // The eigenvalues are in ascending order.
+    double eigval_thrs = lindep_thrs_ * eigvals[dim_ - 1];
+
+    size_t ofs = 0;
+    while (ofs < dim_ && eigvals[ofs] <= eigval_thrs)
+        ofs++;
+
+    rank_ = dim_ - ofs;
+    if (rank_ == 0)
+        throw std::runtime_error("RIMetric(): the metric has no eigenvalues above the "
+                                 "threshold");
+
+    // W = U s^-1/4, so that W W^T = U s^-1/2 U^T
+    vec2d scaled(Fill(0), rank_, dim_);
+    for (size_t k = 0; k < rank_; k++)
+    {
+        double fac = 1.0 / std::sqrt(std::sqrt(eigvals[ofs + k]));
+        for (size_t P = 0; P < dim_; P++)
+            scaled(k, P) = fac * eigvecs(ofs + k, P);
+    }
+
+    int r = int(rank_);
+    factor_ = vec2d(Fill(0), dim_, dim_);
+    cblas_dgemm(CblasRowMajor, CblasTrans, CblasNoTrans, n, n, r, 1.0, &scaled[0], n,
+                &scaled[0], n, 0.0, &factor_[0], n);
+
+    is_cholesky_ = false;
+}
+
+void lints::RIMetric::solve(const size_t n_rows, double *rhs) const
+{
+    if (!is_cholesky_)
+    {
+        applyInverseSqrt(n_rows, rhs);
+        applyInverseSqrt(n_rows, rhs);
+        return;
+    }
+
+    // X L L^T = R
+    int n = int(dim_);
+    cblas_dtrsm(CblasRowMajor, CblasRight, CblasLower, CblasTrans, CblasNonUnit, int(n_rows), n,
+                1.0, &factor_[0], n, rhs, n);
+    cblas_dtrsm(CblasRowMajor, CblasRight, CblasLower, CblasNoTrans, CblasNonUnit, int(n_rows), n,
+                1.0, &factor_[0], n, rhs, n);
+}
+
+void lints::RIMetric::applyInverseSqrt(const size_t n_rows, double *rhs) const
+{
+    int n = int(dim_);
+    if (is_cholesky_)
+    {
+        // X L^T = R
+        cblas_dtrsm(CblasRowMajor, CblasRight, CblasLower, CblasTrans, CblasNonUnit, int(n_rows),
+                    n, 1.0, &factor_[0], n, rhs, n);
+        return;
+    }
+
+    if (n_rows == 0)
+        return;
+
+    std::vector<double> block(std::min(n_rows, n_rows_block) * dim_);
+    for (size_t irow = 0; irow < n_rows; irow += n_rows_block)
+    {
+        size_t n_rows_ = std::min(n_rows_block, n_rows - irow);
+        double *rhs_block = &rhs[irow * dim_];
+
+        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, int(n_rows_), n, n, 1.0,
+                    rhs_block, n, &factor_[0], n, 0.0, &block[0], n);
+
+        std::copy(block.begin(), block.begin() + n_rows_ * dim_, rhs_block);
+    }
+}
+
+bool lints::RIMetric::isCholesky() const
+{
+    return is_cholesky_;
+}
+
+size_t lints::RIMetric::getDim() const
+{
+    return dim_;
+}
+
+size_t lints::RIMetric::getRank() const
+{
+    return rank_;
+}
+
+const lible::vec2d &lints::RIMetric::getFactor() const
+{
+    return factor_;
+}
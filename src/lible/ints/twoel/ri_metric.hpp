@@ -0,0 +1,110 @@
+#pragma once
+
+#include <lible/types.hpp>
+#include <lible/ints/structure.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lible::ints
+{
+    /// Class for the factorized RI metric, (P|Q), of the auxiliary basis set. The metric is
+    /// factorized once in the ctor and the factors are reused by all the solves. By default,
+    /// the metric is Cholesky-decomposed with LAPACK, (P|Q) = L L^T. If the decomposition fails,
+    /// or a pivot relative to its diagonal element, L_PP^2 / (P|P), falls below the linear
+    /// dependency threshold, the metric is diagonalized instead, (P|Q) = U s U^T, and the
+    /// eigenvalues below the threshold times the largest one are discarded. The solves then
+    /// use the pseudo-inverse.
+    class RIMetric
+    {
+    public:
+        /// Default ctor.
+        RIMetric() = default;
+
+        /// Calculates the metric with `eri2()` and factorizes it. The diagonal from
+        /// `eri2Diagonal()` is checked before the metric is calculated and is used as the
+        /// reference for the pivots. Throws if the RI approximation is not enabled for the
+        /// structure, or if a diagonal element is not positive.
+        explicit RIMetric(const Structure &structure, double lindep_thrs = 1e-10);
+
+        /// Factorizes the given symmetric metric.
+        explicit RIMetric(vec2d metric, double lindep_thrs = 1e-10);
+
+        /// Solves X (P|Q) = R for the rows of R, (n_rows, dim_ao_aux), in place. All the rows
+        /// are handled together with level 3 BLAS.
+        void solve(size_t n_rows, double *rhs) const;
+
+        /// Multiplies the rows of R, (n_rows, dim_ao_aux), by the inverse square root of the
+        /// metric in place, X = R (P|Q)^-1/2, such that X X^T = R (P|Q)^-1 R^T. For the
+        /// Cholesky factorization, L^-T is used in place of the symmetric inverse square root.
+        /// Used, for example, for the RI B-tensor, B_{ab,Q} = sum_P (ab|P) (P|Q)^-1/2.
+        void applyInverseSqrt(size_t n_rows, double *rhs) const;
+
+        /// Returns true if the metric is Cholesky-decomposed, false if it is diagonalized.
+        bool isCholesky() const;
+
+        /// Returns the dimension of the metric.
+        size_t getDim() const;
+
+        /// Returns the number of retained eigenvalues, or the dimension for the Cholesky
+        /// decomposition.
+        size_t getRank() const;
+
+        /// Returns the Cholesky factor L in the lower triangle, or the symmetric inverse square
+        /// root, U s^-1/2 U^T, if the metric is diagonalized.
+        const vec2d &getFactor() const;
+
+    private:
+        /// Threshold for the linear dependencies.
+        double lindep_thrs_{};
+        /// Whether the metric is Cholesky-decomposed.
+        bool is_cholesky_{};
+        /// Dimension of the metric.
+        size_t dim_{};
+        /// Number of retained eigenvalues.
+        size_t rank_{};
+        /// Cholesky factor or the inverse square root.
+        vec2d factor_;
+
+        /// Factorizes the metric, first trying the Cholesky decomposition. The pivots are
+        /// compared to the given diagonal of the metric.
+        void factorize(vec2d metric, std::vector<double> diagonal);
+
+        /// Diagonalizes the metric and forms the inverse square root.
+        void factorizeEigen(const vec2d &metric);
+    };
+
+    /// Callback receiving a block of the RI B-tensor, B^Q_pq for Q in [ofs_Q, ofs_Q + n_Q),
+    /// stored as (n_Q, n_p, n_q).
+    using BTensorCallback = std::function<void(size_t ofs_Q, size_t n_Q, const double *b_block)>;
+
+    /// Calculates the RI B-tensor in the MO basis, B^Q_pq = sum_P (pq|P) [(P|Q)^-1/2]_PQ, for the
+    /// MO coefficients C_p, (dim_ao, n_p), and C_q, (dim_ao, n_q), e.g., the occupied and the
+    /// virtual orbitals. The (ab|P) are calculated with ERI3Kernel one auxiliary shell at a time
+    /// and transformed to (pq|P) with DGEMM, so the AO three-index tensor is never stored. The
+    /// metric factor from `metric` is applied to the (pq|P) of a batch of the p indices, sized
+    /// such that the (pq|P) and the half-transformed (p nu|P) of the threads fit into
+    /// `max_memory_mb`, and the B-tensor is handed to `callback` in blocks of at most
+    /// `n_Q_block` auxiliary functions. If more than one batch of the p indices is needed, the
+    /// B-tensor is staged in a file in `scratch_dir` before the blocks are handed over, and an
+    /// exception is thrown before any work if no `scratch_dir` is given. OMP parallelized.
+    void riBTensorMO(const Structure &structure, const RIMetric &metric,
+                     const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q, size_t n_Q_block,
+                     const BTensorCallback &callback, double max_memory_mb = 1024,
+                     const std::string &scratch_dir = "");
+
+    /// Calculates the RI B-tensor in the MO basis, as in `riBTensorMO()` above, and returns it
+    /// in memory as (dim_ao_aux, n_p, n_q).
+    vec3d riBTensorMO(const Structure &structure, const RIMetric &metric,
+                      const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                      double max_memory_mb = 1024);
+
+    /// Calculates the RI B-tensor in the MO basis, as in `riBTensorMO()` above, and writes it
+    /// to the binary file `file_name` as (dim_ao_aux, n_p, n_q) doubles, such that every block
+    /// of the Q indices is contiguous.
+    void riBTensorMOFile(const Structure &structure, const RIMetric &metric,
+                         const vec2d &mo_coeffs_p, const vec2d &mo_coeffs_q,
+                         const std::string &file_name, double max_memory_mb = 1024);
+}
@@ -0,0 +1,401 @@
+#include <lible/ints/ints.hpp>
+#include <lible/ints/twoel/ri_metric.hpp>
+#include <lible/ints/twoel/eri_kernels.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _LIBLE_USE_MKL_
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+
+namespace lints = lible::ints;
+
+namespace lible::ints
+{
+    /// Returns J - 3/2 (A - A^T) for each Cartesian component. The exchange-type term
+    /// sum_{ka ta} D_{ka ta} (ta nu|mu ka) equals -A_{nu mu} because the SOC integrals are
+    /// antisymmetric in the first pair, so only A is accumulated.
+    std::array<vec2d, 3> assembleSOMF(const std::array<vec2d, 3> &coulomb,
+                                      const std::array<vec2d, 3> &exchange);
+
+    /// Splits the auxiliary functions into blocks of whole shells with at most `n_Q_max`
+    /// functions, or one shell if it is larger, and returns them as {ofs_Q, n_Q}.
+    std::vector<std::pair<size_t, size_t>> auxBlocksSOMF(const std::vector<ShellData> &sh_datas,
+                                                         size_t n_Q_max);
+}
+
+std::vector<std::pair<size_t, size_t>>
+lints::auxBlocksSOMF(const std::vector<ShellData> &sh_datas, const size_t n_Q_max)
+{
+    // {offset, number of functions} of every shell in the order of the functions.
+    std::vector<std::pair<size_t, size_t>> shells;
+    for (const ShellData &sh_data : sh_datas)
+        for (size_t ishell = 0; ishell < sh_data.n_shells_; ishell++)
+            shells.push_back({sh_data.offsets_sph_[ishell], numSphericals(sh_data.l_)});
+
+    std::sort(shells.begin(), shells.end());
+
+    std::vector<std::pair<size_t, size_t>> blocks;
+    for (const auto &[ofs, n_sph] : shells)
+    {
+        if (!blocks.empty() && blocks.back().second + n_sph <= n_Q_max)
+            blocks.back().second += n_sph;
+        else
+            blocks.push_back({ofs, n_sph});
+    }
+
+    return blocks;
+}
+
+std::array<lible::vec2d, 3> lints::assembleSOMF(const std::array<vec2d, 3> &coulomb,
+                                                 const std::array<vec2d, 3> &exchange)
+{
+    size_t dim_ao = coulomb[0].dim<0>();
+
+    std::array<vec2d, 3> somf;
+    for (int icart = 0; icart < 3; icart++)
+    {
+        somf[icart] = coulomb[icart];
+        for (size_t mu = 0; mu < dim_ao; mu++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                somf[icart](mu, nu) -= 1.5 * (exchange[icart](mu, nu) -
+                                              exchange[icart](nu, mu));
+    }
+
+    return somf;
+}
+
+std::array<lible::vec2d, 3> lints::spinOrbitMeanField(const Structure &structure,
+                                                       const vec2d &density)
+{
+    size_t dim_ao = structure.getDimAO();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("spinOrbitMeanField(): dimensions of the density matrix don't "
+                                 "match the number of AOs");
+
+    std::vector<ShellPairData> sp_datas = shellPairData(true, structure);
+
+    std::array<vec2d, 3> coulomb, exchange;
+    for (int icart = 0; icart < 3; icart++)
+    {
+        coulomb[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+        exchange[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+    }
+
+    // The SOC integrals (ab|cd) are antisymmetric in ab and symmetric in cd, but there is no
+    // bra-ket symmetry, so every unique ab is combined with every unique cd.
+    for (const auto &sp_data_ab : sp_datas)
+        for (const auto &sp_data_cd : sp_datas)
+        {
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            int n_sph_c = numSphericals(sp_data_cd.la_);
+            int n_sph_d = numSphericals(sp_data_cd.lb_);
+
+            ERI4SOCKernel eri4soc_kernel(sp_data_ab, sp_data_cd);
+
+#pragma omp parallel
+            {
+                std::array<vec2d, 3> coulomb_omp, exchange_omp;
+                for (int icart = 0; icart < 3; icart++)
+                {
+                    coulomb_omp[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+                    exchange_omp[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+                }
+
+#pragma omp for schedule(dynamic)
+                for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+                {
+                    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                    bool diag_ab = sp_data_ab.shell_idxs_[2 * ipair_ab] ==
+                                   sp_data_ab.shell_idxs_[2 * ipair_ab + 1];
+
+                    for (size_t ipair_cd = 0; ipair_cd < sp_data_cd.n_pairs_; ipair_cd++)
+                    {
+                        size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
+                        size_t ofs_d = sp_data_cd.offsets_sph_[2 * ipair_cd + 1];
+                        bool diag_cd = sp_data_cd.shell_idxs_[2 * ipair_cd] ==
+                                       sp_data_cd.shell_idxs_[2 * ipair_cd + 1];
+
+                        std::array<vec4d, 3> eri4_batch = eri4soc_kernel(ipair_ab, ipair_cd,
+                                                                         sp_data_ab, sp_data_cd);
+
+                        // J_{pq} += D_{rs} (pq|rs), A_{ps} += D_{qr} (pq|rs) over the images
+                        // (pq|rs) = (pq|sr) = -(qp|rs) = -(qp|sr) of the unique integrals.
+                        auto accumulate = [&](size_t p, size_t q, size_t r, size_t s,
+                                              const std::array<double, 3> &vals)
+                        {
+                            double d_rs = density(r, s);
+                            double d_qr = density(q, r);
+                            for (int icart = 0; icart < 3; icart++)
+                            {
+                                coulomb_omp[icart](p, q) += d_rs * vals[icart];
+                                exchange_omp[icart](p, s) += d_qr * vals[icart];
+                            }
+                        };
+
+                        for (int ia = 0, idx = 0; ia < n_sph_a; ia++)
+                            for (int ib = 0; ib < n_sph_b; ib++)
+                                for (int ic = 0; ic < n_sph_c; ic++)
+                                    for (int id = 0; id < n_sph_d; id++, idx++)
+                                    {
+                                        std::array<double, 3> vals{eri4_batch[0][idx],
+                                                                   eri4_batch[1][idx],
+                                                                   eri4_batch[2][idx]};
+                                        std::array<double, 3> vals_neg{-vals[0], -vals[1],
+                                                                       -vals[2]};
+
+                                        size_t mu = ofs_a + ia, nu = ofs_b + ib;
+                                        size_t ka = ofs_c + ic, ta = ofs_d + id;
+
+                                        accumulate(mu, nu, ka, ta, vals);
+                                        if (!diag_cd)
+                                            accumulate(mu, nu, ta, ka, vals);
+
+                                        if (!diag_ab)
+                                        {
+                                            accumulate(nu, mu, ka, ta, vals_neg);
+                                            if (!diag_cd)
+                                                accumulate(nu, mu, ta, ka, vals_neg);
+                                        }
+                                    }
+                    }
+                }
+
+#pragma omp critical
+                {
+                    for (int icart = 0; icart < 3; icart++)
+                    {
+                        coulomb[icart] += coulomb_omp[icart];
+                        exchange[icart] += exchange_omp[icart];
+                    }
+                }
+            }
+        }
+
+    return assembleSOMF(coulomb, exchange);
+}
+
+std::array<lible::vec2d, 3> lints::spinOrbitMeanFieldRI(const Structure &structure,
+                                                         const vec2d &density,
+                                                         const double max_memory_mb)
+{
+    if (structure.getUseRI() == false)
+        throw std::runtime_error("spinOrbitMeanFieldRI(): RI approximation is not enabled");
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    if (density.dim<0>() != dim_ao || density.dim<1>() != dim_ao)
+        throw std::runtime_error("spinOrbitMeanFieldRI(): dimensions of the density matrix don't "
+                                 "match the number of AOs");
+
+    int n = int(dim_ao);
+    int n_aux = int(dim_ao_aux);
+    size_t dim_ao_sq = dim_ao * dim_ao;
+
+    std::vector<ShellData> sh_datas = shellDataAux(structure);
+    std::vector<ShellPairData> sp_datas = shellPairData(true, structure);
+
+    // The tasks, {class, ipair_ab}, are the shell pairs of every class. A shell pair writes
+    // only to the rows mu nu and nu mu of its shells, so the threads write to the shared
+    // intermediates directly.
+    std::vector<std::vector<ERI3Kernel>> eri3_kernels(sp_datas.size());
+    std::vector<std::vector<ERI3SOCKernel>> eri3soc_kernels(sp_datas.size());
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t ispdata_ab = 0; ispdata_ab < sp_datas.size(); ispdata_ab++)
+    {
+        const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+
+        auto ecoeffs_bra = ecoeffsShared(sp_data_ab);
+        for (const ShellData &sh_data_c : sh_datas)
+        {
+            eri3_kernels[ispdata_ab].emplace_back(sp_data_ab, sh_data_c, ecoeffs_bra);
+            eri3soc_kernels[ispdata_ab].emplace_back(sp_data_ab, sh_data_c);
+        }
+
+        for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+            tasks.push_back({ispdata_ab, ipair_ab});
+    }
+
+    // Per fitted auxiliary function Q: the three W_{mu ka, Q}, (ta nu|Q), Y_{ka nu, Q} and a
+    // row of the inverse metric.
+    double n_Q_fit = max_memory_mb * 1024 * 1024 /
+                     (sizeof(double) * (5 * dim_ao_sq + dim_ao_aux));
+    std::vector<std::pair<size_t, size_t>> blocks = auxBlocksSOMF(sh_datas, size_t(n_Q_fit));
+
+    RIMetric metric(structure);
+
+    std::array<vec2d, 3> coulomb, exchange;
+    for (int icart = 0; icart < 3; icart++)
+    {
+        coulomb[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+        exchange[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+    }
+
+    // gamma_Q = sum_{ka ta} D_{ka ta} (ka ta|Q), c_P = sum_Q (P|Q)^-1 gamma_Q
+    std::vector<double> coeffs_fit_j(dim_ao_aux, 0);
+
+    for (size_t iblock = 0; iblock < blocks.size(); iblock++)
+    {
+        auto [ofs_Q, n_Q] = blocks[iblock];
+        int n_Q_int = int(n_Q);
+
+        // (ta nu|Q) of the block, stored as (ta, Q, nu).
+        std::vector<double> eri3_block(dim_ao_sq * n_Q, 0);
+#pragma omp parallel for schedule(dynamic)
+        for (size_t itask = 0; itask < tasks.size(); itask++)
+        {
+            auto [ispdata_ab, ipair_ab] = tasks[itask];
+
+            const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+            size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+
+            for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++)
+            {
+                const ShellData &sh_data_c = sh_datas[ishdata_c];
+                const ERI3Kernel &eri3_kernel = eri3_kernels[ispdata_ab][ishdata_c];
+
+                int n_sph_c = numSphericals(sh_data_c.l_);
+                for (size_t ishell_c = 0; ishell_c < sh_data_c.n_shells_; ishell_c++)
+                {
+                    size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
+                    if (ofs_c < ofs_Q || ofs_c >= ofs_Q + n_Q)
+                        continue;
+
+                    vec3d eri3_batch = eri3_kernel(ipair_ab, ishell_c, sp_data_ab, sh_data_c);
+
+                    for (int ia = 0; ia < n_sph_a; ia++)
+                        for (int ib = 0; ib < n_sph_b; ib++)
+                            for (int ic = 0; ic < n_sph_c; ic++)
+                            {
+                                size_t mu = ofs_a + ia, nu = ofs_b + ib, Q = ofs_c + ic - ofs_Q;
+                                double val = eri3_batch(ia, ib, ic);
+
+                                eri3_block[(mu * n_Q + Q) * dim_ao + nu] = val;
+                                eri3_block[(nu * n_Q + Q) * dim_ao + mu] = val;
+                            }
+                }
+            }
+        }
+
+#pragma omp parallel for
+        for (size_t Q = 0; Q < n_Q; Q++)
+        {
+            double gamma_Q = 0;
+            for (size_t ta = 0; ta < dim_ao; ta++)
+                for (size_t nu = 0; nu < dim_ao; nu++)
+                    gamma_Q += density(ta, nu) * eri3_block[(ta * n_Q + Q) * dim_ao + nu];
+
+            coeffs_fit_j[ofs_Q + Q] = gamma_Q;
+        }
+
+        // Y_{ka Q nu} = sum_ta D_{ka ta} (ta nu|Q)
+        std::vector<double> d_x_eri3(dim_ao_sq * n_Q);
+        cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n * n_Q_int, n, 1.0,
+                    &density[0], n, &eri3_block[0], n * n_Q_int, 0.0, &d_x_eri3[0],
+                    n * n_Q_int);
+
+        // (P|Q)^-1 for the Q of the block, stored as (Q, P).
+        std::vector<double> metric_inv(n_Q * dim_ao_aux, 0);
+        for (size_t Q = 0; Q < n_Q; Q++)
+            metric_inv[Q * dim_ao_aux + ofs_Q + Q] = 1;
+        metric.solve(n_Q, &metric_inv[0]);
+
+        // The Coulomb term is added with the last block, when all of gamma is known.
+        bool add_coulomb = iblock + 1 == blocks.size();
+        if (add_coulomb)
+            metric.solve(1, &coeffs_fit_j[0]);
+
+        // W_{mu ka, Q} = sum_P (mu ka|P)_SOC (P|Q)^-1, stored as (mu, ka, Q), and
+        // J_{mu ka} += c_P (mu ka|P)_SOC, over the images (mu ka|P) = -(ka mu|P).
+        std::array<std::vector<double>, 3> soc_fit;
+        for (int icart = 0; icart < 3; icart++)
+            soc_fit[icart].assign(dim_ao_sq * n_Q, 0);
+
+#pragma omp parallel for schedule(dynamic)
+        for (size_t itask = 0; itask < tasks.size(); itask++)
+        {
+            auto [ispdata_ab, ipair_ab] = tasks[itask];
+
+            const ShellPairData &sp_data_ab = sp_datas[ispdata_ab];
+            int n_sph_a = numSphericals(sp_data_ab.la_);
+            int n_sph_b = numSphericals(sp_data_ab.lb_);
+            size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+            size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+            bool diag_ab = sp_data_ab.shell_idxs_[2 * ipair_ab] ==
+                           sp_data_ab.shell_idxs_[2 * ipair_ab + 1];
+
+            for (size_t ishdata_c = 0; ishdata_c < sh_datas.size(); ishdata_c++)
+            {
+                const ShellData &sh_data_c = sh_datas[ishdata_c];
+                const ERI3SOCKernel &eri3soc_kernel = eri3soc_kernels[ispdata_ab][ishdata_c];
+
+                int n_sph_c = numSphericals(sh_data_c.l_);
+                int n_bc = n_sph_b * n_sph_c;
+                for (size_t ishell_c = 0; ishell_c < sh_data_c.n_shells_; ishell_c++)
+                {
+                    size_t ofs_c = sh_data_c.offsets_sph_[ishell_c];
+
+                    std::array<vec3d, 3> eri3_batch = eri3soc_kernel(ipair_ab, ishell_c,
+                                                                     sp_data_ab, sh_data_c);
+
+                    for (int icart = 0; icart < 3; icart++)
+                    {
+                        const double *eri3_soc = eri3_batch[icart].memptr();
+                        double *soc_fit_icart = &soc_fit[icart][0];
+
+                        for (int ia = 0; ia < n_sph_a; ia++)
+                            cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, n_sph_b,
+                                        n_Q_int, n_sph_c, 1.0, &eri3_soc[ia * n_bc], n_sph_c,
+                                        &metric_inv[ofs_c], n_aux, 1.0,
+                                        &soc_fit_icart[((ofs_a + ia) * dim_ao + ofs_b) * n_Q],
+                                        n_Q_int);
+
+                        if (!diag_ab)
+                            for (int ib = 0; ib < n_sph_b; ib++)
+                                cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasTrans, n_sph_a,
+                                            n_Q_int, n_sph_c, -1.0, &eri3_soc[ib * n_sph_c],
+                                            n_bc, &metric_inv[ofs_c], n_aux, 1.0,
+                                            &soc_fit_icart[((ofs_b + ib) * dim_ao + ofs_a) *
+                                                           n_Q],
+                                            n_Q_int);
+
+                        if (!add_coulomb)
+                            continue;
+
+                        for (int ia = 0; ia < n_sph_a; ia++)
+                            for (int ib = 0; ib < n_sph_b; ib++)
+                            {
+                                double val = 0;
+                                for (int ic = 0; ic < n_sph_c; ic++)
+                                    val += eri3_soc[ia * n_bc + ib * n_sph_c + ic] *
+                                           coeffs_fit_j[ofs_c + ic];
+
+                                size_t mu = ofs_a + ia, ka = ofs_b + ib;
+                                coulomb[icart](mu, ka) += val;
+                                if (!diag_ab)
+                                    coulomb[icart](ka, mu) -= val;
+                            }
+                    }
+                }
+            }
+        }
+
+        // A_{mu nu} += sum_{ka Q} W_{mu, ka Q} Y_{ka Q, nu}
+        for (int icart = 0; icart < 3; icart++)
+            cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n * n_Q_int, 1.0,
+                        &soc_fit[icart][0], n * n_Q_int, &d_x_eri3[0], n, 1.0,
+                        &exchange[icart][0], n);
+    }
+
+    return assembleSOMF(coulomb, exchange);
+}
@@ -42,6 +42,16 @@ namespace lible::ints
         return (l + 1) * (l + 2) / 2;
     }
 
+    /// Calculates the total number of Cartesian Gaussians for 0,...,l.
+    constexpr int numCartesiansSum(const int l)
+    {
+        int sum = 0;
+        for (int n = 0; n <= l; n++)
+            sum += numCartesians(n);
+
+        return sum;
+    }
+
     /// Calculates the number of Hermite Gaussian triplets for 0,...,l.
     constexpr int numHermites(const int l)
     {
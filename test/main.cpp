@@ -33,6 +33,8 @@ int main(int argc, char **argv)
         success = lible::tests::kineticEnergyD1Kernel();
     else if (test_name == "nuclearAttraction")
         success = lible::tests::nuclearAttraction();
+    else if (test_name == "coreHamiltonian")
+        success = lible::tests::coreHamiltonian();
     else if (test_name == "nuclearAttractionErf")
         success = lible::tests::nuclearAttractionErf();
     else if (test_name == "externalCharges")
@@ -77,10 +79,14 @@ int main(int argc, char **argv)
         success = lible::tests::dipoleMoment();
     else if (test_name == "dipoleMomentKernel")
         success = lible::tests::dipoleMomentKernel();
+    else if (test_name == "multipoleMoment")
+        success = lible::tests::multipoleMoment();
     else if (test_name == "spinOrbitCoupling1El")
         success = lible::tests::spinOrbitCoupling1El();
     else if (test_name == "spinOrbitCoupling1ElKernel")
         success = lible::tests::spinOrbitCoupling1ElKernel();
+    else if (test_name == "pVpIntegrals")
+        success = lible::tests::pVpIntegrals();
     else if (test_name == "eri2Diagonal")
         success = lible::tests::eri2Diagonal();
     else if (test_name == "eri2")
@@ -91,6 +97,8 @@ int main(int argc, char **argv)
         success = lible::tests::eri3();
     else if (test_name == "eri4")
         success = lible::tests::eri4();
+    else if (test_name == "eri4MO")
+        success = lible::tests::eri4MO();
     else if (test_name == "basisForAtom")
         success = lible::tests::basisForAtom();
     else if (test_name == "basisForAtomAux")
@@ -101,6 +109,8 @@ int main(int argc, char **argv)
         success = lible::tests::basisForAtomsAux();
     else if (test_name == "sphericalTrafo")
         success = lible::tests::sphericalTrafo();
+    else if (test_name == "trafo2SphericalBatch")
+        success = lible::tests::trafo2SphericalBatch();
     else if (test_name == "deployERI4Kernel")
         success = lible::tests::deployERI4Kernel();
     else if (test_name == "deployERI3Kernel")
@@ -119,6 +129,52 @@ int main(int argc, char **argv)
         success = lible::tests::deployERI4SOCKernel();
     else if (test_name == "deployERI3SOCKernel")
         success = lible::tests::deployERI3SOCKernel();
+    else if (test_name == "deployERI4KernelRys")
+        success = lible::tests::deployERI4KernelRys();
+    else if (test_name == "deployERI3KernelRys")
+        success = lible::tests::deployERI3KernelRys();
+    else if (test_name == "deployERI2KernelRys")
+        success = lible::tests::deployERI2KernelRys();
+    else if (test_name == "kernelSelector")
+        success = lible::tests::kernelSelector();
+    else if (test_name == "pointGroupSymmetry")
+        success = lible::tests::pointGroupSymmetry();
+    else if (test_name == "eri4GradientJK")
+        success = lible::tests::eri4GradientJK();
+    else if (test_name == "riGradientJK")
+        success = lible::tests::riGradientJK();
+    else if (test_name == "oneElectronGradients")
+        success = lible::tests::oneElectronGradients();
+    else if (test_name == "hessians")
+        success = lible::tests::hessians();
+    else if (test_name == "electrostaticPotential")
+        success = lible::tests::electrostaticPotential();
+    else if (test_name == "aoCollocation")
+        success = lible::tests::aoCollocation();
+    else if (test_name == "spinOrbitMeanField")
+        success = lible::tests::spinOrbitMeanField();
+    else if (test_name == "riMetric")
+        success = lible::tests::riMetric();
+    else if (test_name == "riBTensorMO")
+        success = lible::tests::riBTensorMO();
+    else if (test_name == "singlePrecision")
+        success = lible::tests::singlePrecision();
+    else if (test_name == "taskDistributor")
+        success = lible::tests::taskDistributor();
+    else if (test_name == "basisLibraryCache")
+        success = lible::tests::basisLibraryCache();
+    else if (test_name == "basisBundle")
+        success = lible::tests::basisBundle();
+    else if (test_name == "structureShellViews")
+        success = lible::tests::structureShellViews();
+    else if (test_name == "structureUpdateCoordinates")
+        success = lible::tests::structureUpdateCoordinates();
+    else if (test_name == "eriUpdateCoordinates")
+        success = lible::tests::eriUpdateCoordinates();
+    else if (test_name == "instrumentationCounters")
+        success = lible::tests::instrumentationCounters();
+    else if (test_name == "instrumentationClassIds")
+        success = lible::tests::instrumentationClassIds();
     else if (test_name == "ecoeffsRecurrence1")
         success = lible::tests::ecoeffsRecurrence1();
     else if (test_name == "ecoeffsRecurrence2")
@@ -131,6 +187,8 @@ int main(int argc, char **argv)
         success = lible::tests::ecoeffsPrimitivePair();
     else if (test_name == "ecoeffsPrimitivePair_n1")
         success = lible::tests::ecoeffsPrimitivePair_n1();
+    else if (test_name == "ecoeffsPrimitivePairC")
+        success = lible::tests::ecoeffsPrimitivePairC();
     else if (test_name == "ecoeffsShell")
         success = lible::tests::ecoeffsShell();
     else if (test_name == "calcBoysF")
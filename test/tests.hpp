@@ -18,6 +18,8 @@ namespace lible::tests
 
     bool nuclearAttraction();
 
+    bool coreHamiltonian();
+
     bool nuclearAttractionErf();
 
     bool externalCharges();
@@ -40,10 +42,14 @@ namespace lible::tests
 
     bool dipoleMomentKernel();
 
+    bool multipoleMoment();
+
     bool spinOrbitCoupling1El();
 
     bool spinOrbitCoupling1ElKernel();
 
+    bool pVpIntegrals();
+
     bool eri2Diagonal();
 
     bool eri2();
@@ -54,6 +60,8 @@ namespace lible::tests
 
     bool eri4();
 
+    bool eri4MO();
+
     bool basisForAtom();
 
     bool basisForAtomAux();
@@ -68,6 +76,8 @@ namespace lible::tests
 
     bool sphericalTrafo();
 
+    bool trafo2SphericalBatch();
+
     bool deployERI4Kernel();
 
     bool deployERI3Kernel();
@@ -86,6 +96,51 @@ namespace lible::tests
 
     bool deployERI3SOCKernel();
 
+    bool deployERI4KernelRys();
+
+    bool deployERI3KernelRys();
+
+    bool deployERI2KernelRys();
+
+    bool kernelSelector();
+
+    bool pointGroupSymmetry();
+
+    bool eri4GradientJK();
+
+    bool riGradientJK();
+
+    bool oneElectronGradients();
+
+    bool hessians();
+
+    bool electrostaticPotential();
+
+    bool aoCollocation();
+
+    bool spinOrbitMeanField();
+
+    bool riMetric();
+
+    bool riBTensorMO();
+
+    bool singlePrecision();
+
+    bool taskDistributor();
+
+    bool basisLibraryCache();
+
+    bool basisBundle();
+
+    bool structureShellViews();
+
+    bool structureUpdateCoordinates();
+    bool eriUpdateCoordinates();
+
+    bool instrumentationCounters();
+
+    bool instrumentationClassIds();
+
     bool ecoeffsRecurrence1();
 
     bool ecoeffsRecurrence2();
@@ -98,6 +153,8 @@ namespace lible::tests
 
     bool ecoeffsPrimitivePair_n1();
 
+    bool ecoeffsPrimitivePairC();
+
     bool ecoeffsShell();
 
     bool calcBoysF();
@@ -1,10 +1,23 @@
 #include <tests.hpp>
 #include <available_basis_sets.hpp>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <ostream>
 
+#include <lible/ints/basis_bundle.hpp>
+#include <lible/ints/basis_sets.hpp>
+#include <lible/ints/cart_exps.hpp>
+#include <lible/ints/defs.hpp>
+#include <lible/ints/distributed.hpp>
+#include <lible/ints/ecoeffs.hpp>
+#include <lible/ints/instrumentation.hpp>
 #include <lible/ints/ints.hpp>
+#include <lible/ints/twoel/ri_metric.hpp>
+#include <lible/ints/single_precision.hpp>
+#include <lible/ints/spherical_trafo.hpp>
 
+#include <algorithm>
 #include <vector>
 
 namespace ltests = lible::tests;
@@ -58,6 +71,17 @@ namespace lible::tests
         {5.167, 1.714, -8.641}
     };
 
+    // Ethylene in the D2h standard orientation
+    std::vector<int> atomic_nrs_c2h4_d2h{6, 6, 1, 1, 1, 1};
+    std::vector<std::array<double, 3>> coords_c2h4_d2h{
+        {0.0, 0.0, 0.6695},
+        {0.0, 0.0, -0.6695},
+        {0.0, 0.9289, 1.2321},
+        {0.0, -0.9289, 1.2321},
+        {0.0, 0.9289, -1.2321},
+        {0.0, -0.9289, -1.2321}
+    };
+
     // H2O
     std::vector<int> atomic_nrs_h2o{8, 1, 1};
     std::vector<std::array<double, 3>> coords_h2o{
@@ -118,6 +142,65 @@ namespace lible::tests
         {0, 1, 1},
         {0, 0, 2}
     };
+
+    /// Tolerance of the comparisons against central finite differences, relative to the largest
+    /// analytic component.
+    static const double tol_fd = 1e-7;
+
+    /// Returns the largest absolute value in the array.
+    static double maxAbs(const vec2d &arr)
+    {
+        double max_abs = 0;
+        for (size_t i = 0; i < arr.size(); i++)
+            max_abs = std::max(max_abs, std::fabs(arr[i]));
+
+        return max_abs;
+    }
+
+    /// Returns the central finite differences of the values from `energy_fn`, called with a copy
+    /// of the structure whose atoms are moved by +-1e-4 Angstrom with updateCoordinates(). The
+    /// derivatives are with respect to the atomic coordinates in bohr, as
+    /// (3 * iatom + icart, ivalue).
+    template <typename F>
+    static vec2d finiteDifferenceGradient(const lints::Structure &structure, F energy_fn)
+    {
+        const double step = 1e-4; // Angstrom
+
+        size_t n_atoms = structure.getNAtoms();
+        std::vector<std::array<double, 3>> coords(n_atoms);
+        for (size_t iatom = 0; iatom < n_atoms; iatom++)
+            for (int icart = 0; icart < 3; icart++)
+                coords[iatom][icart] = structure.getCoordsAtom(iatom)[icart] /
+                                       lints::_ang_to_bohr_;
+
+        lints::Structure structure_disp = structure;
+
+        vec2d gradient;
+        double step_bohr = 2 * step * lints::_ang_to_bohr_;
+        for (size_t iatom = 0; iatom < n_atoms; iatom++)
+            for (int icart = 0; icart < 3; icart++)
+            {
+                std::vector<std::array<double, 3>> coords_plus = coords;
+                std::vector<std::array<double, 3>> coords_minus = coords;
+                coords_plus[iatom][icart] += step;
+                coords_minus[iatom][icart] -= step;
+
+                structure_disp.updateCoordinates(coords_plus);
+                std::vector<double> values_plus = energy_fn(structure_disp);
+
+                structure_disp.updateCoordinates(coords_minus);
+                std::vector<double> values_minus = energy_fn(structure_disp);
+
+                if (gradient.size() == 0)
+                    gradient = vec2d(Fill(0), 3 * n_atoms, values_plus.size());
+
+                for (size_t ivalue = 0; ivalue < values_plus.size(); ivalue++)
+                    gradient(3 * iatom + icart, ivalue) = (values_plus[ivalue] -
+                                                           values_minus[ivalue]) / step_bohr;
+            }
+
+        return gradient;
+    }
 }
 
 bool ltests::numCartesians()
@@ -318,6 +401,40 @@ bool ltests::nuclearAttraction()
     return false;
 }
 
+bool ltests::coreHamiltonian()
+{
+    lints::Structure structure("cc-pvdz", atomic_nrs_c2h4, coords_c2h4);
+
+    std::array<double, 3> origin{0.1, -0.2, 0.3};
+    lints::CoreHamiltonian core_hamiltonian = lints::coreHamiltonian(origin, structure);
+
+    std::vector<std::pair<vec2d, vec2d>> ints_pairs{
+        {core_hamiltonian.overlap_, lints::overlap(structure)},
+        {core_hamiltonian.kinetic_energy_, lints::kineticEnergy(structure)},
+        {core_hamiltonian.nuclear_attraction_, lints::nuclearAttraction(structure)}
+    };
+
+    std::array<vec2d, 3> dipole_moment = lints::dipoleMoment(origin, structure);
+    for (int icart = 0; icart < 3; icart++)
+        ints_pairs.emplace_back(core_hamiltonian.dipole_moment_[icart], dipole_moment[icart]);
+
+    for (const auto &[ints, ints_ref] : ints_pairs)
+        for (size_t i = 0; i < ints_ref.size(); i++)
+            if (std::fabs(ints.memptr()[i] - ints_ref.memptr()[i]) > tol)
+                return false;
+
+    lints::CoreHamiltonian core_hamiltonian_nodip = lints::coreHamiltonian(structure);
+    if (core_hamiltonian_nodip.dipole_moment_[0].size() != 0)
+        return false;
+
+    for (size_t i = 0; i < ints_pairs[2].second.size(); i++)
+        if (std::fabs(core_hamiltonian_nodip.nuclear_attraction_.memptr()[i] -
+                      ints_pairs[2].second.memptr()[i]) > tol)
+            return false;
+
+    return true;
+}
+
 bool ltests::nuclearAttractionErf()
 {
     const double correct_answer = 257.523987741588;
@@ -639,6 +756,91 @@ bool ltests::dipoleMomentKernel()
     return false;
 }
 
+bool ltests::multipoleMoment()
+{
+    // The multipole moments are summed in a different order than the overlap and dipole
+    // moment integrals.
+    const double tol_moments = 1e-10;
+
+    lints::Structure structure("cc-pvdz", atomic_nrs_c2h6, coords_c2h6);
+
+    std::array<double, 3> origin{0.1, -0.2, 0.3};
+    std::array<double, 3> origin_shifted{-0.4, 0.5, 0.2};
+    double dx = origin[0] - origin_shifted[0];
+
+    std::vector<vec2d> moments = lints::multipoleMoment(3, origin, structure);
+    std::vector<vec2d> moments_shifted = lints::multipoleMoment(3, origin_shifted, structure);
+    if (moments.size() != 20)
+        return false;
+
+    vec2d overlap = lints::overlap(structure);
+    std::array<vec2d, 3> dipole_moment = lints::dipoleMoment(origin, structure);
+
+    // Positions of x, xx and xxx
+    size_t idx_x = 1, idx_xx = 4, idx_xxx = 10;
+    for (size_t i = 0; i < overlap.size(); i++)
+    {
+        if (std::fabs(moments[0].memptr()[i] - overlap.memptr()[i]) > tol_moments)
+            return false;
+
+        for (int icart = 0; icart < 3; icart++)
+            if (std::fabs(moments[1 + icart].memptr()[i] - dipole_moment[icart].memptr()[i]) >
+                tol_moments)
+                return false;
+
+        // (x - x_O')^n expanded around x_O
+        double s = moments[0].memptr()[i];
+        double x = moments[idx_x].memptr()[i];
+        double xx = moments[idx_xx].memptr()[i];
+        double xxx = moments[idx_xxx].memptr()[i];
+
+        double xx_shifted = xx + 2 * dx * x + dx * dx * s;
+        double xxx_shifted = xxx + 3 * dx * xx + 3 * dx * dx * x + dx * dx * dx * s;
+        if (std::fabs(moments_shifted[idx_xx].memptr()[i] - xx_shifted) > tol_moments ||
+            std::fabs(moments_shifted[idx_xxx].memptr()[i] - xxx_shifted) > tol_moments)
+            return false;
+    }
+
+    // The origin shift identity is satisfied also with an error in the Hermite moment
+    // recurrence, so the moments between primitive s-functions are compared against the
+    // analytic ones, <a|(x - x_O)^n|b> = S_ab M_n(X) with X = P_x - x_O and
+    //   M_2 = X^2 + 1/(2p), M_3 = X^3 + 3 X/(2p), M_4 = X^4 + 6 X^2/(2p) + 3/(2p)^2.
+    lints::basis_atoms_t basis_atoms{{1, {{0, {0.8}, {1.0}}}}, {1, {{0, {1.3}, {1.0}}}}};
+    lints::Structure structure_s(basis_atoms, {1, 1}, {{0.0, 0.1, -0.2}, {0.3, 0.7, 0.4}});
+
+    std::vector<vec2d> moments_s = lints::multipoleMoment(4, origin, structure_s);
+    vec2d overlap_s = lints::overlap(structure_s);
+
+    std::span<const lints::Shell> shells_s = structure_s.getShellsView();
+    double a = shells_s[0].exps_[0];
+    double b = shells_s[1].exps_[0];
+    double p = a + b;
+
+    // Positions of xx, yy, zz, xxx, yyy, zzz, xxxx, yyyy and zzzz
+    std::array<size_t, 3> idxs_2{4, 7, 9};
+    std::array<size_t, 3> idxs_3{10, 16, 19};
+    std::array<size_t, 3> idxs_4{20, 30, 34};
+    for (int icart = 0; icart < 3; icart++)
+    {
+        double X = (a * shells_s[0].xyz_coords_[icart] + b * shells_s[1].xyz_coords_[icart]) / p -
+                   origin[icart];
+        double s_ab = overlap_s(0, 1);
+
+        std::array<double, 3> moments_ref{X * X + 1 / (2 * p), X * X * X + 3 * X / (2 * p),
+                                          X * X * X * X + 6 * X * X / (2 * p) +
+                                              3 / (4 * p * p)};
+        std::array<double, 3> moments_ab{moments_s[idxs_2[icart]](0, 1),
+                                         moments_s[idxs_3[icart]](0, 1),
+                                         moments_s[idxs_4[icart]](0, 1)};
+
+        for (int n = 0; n < 3; n++)
+            if (std::fabs(moments_ab[n] - s_ab * moments_ref[n]) > tol_moments)
+                return false;
+    }
+
+    return true;
+}
+
 bool ltests::spinOrbitCoupling1El()
 {
     const double correct_answer = 86318.844650089319;
@@ -691,6 +893,59 @@ bool ltests::spinOrbitCoupling1ElKernel()
     return false;
 }
 
+bool ltests::pVpIntegrals()
+{
+    // Since the basis functions depend on r - A, the pVp integrals between the functions of
+    // different atoms are p_i V p_j = d^2 V_mu,nu / dA_i dB_j, which is checked against the
+    // finite differences of the nuclear attraction integrals with fixed charges.
+    const double h = 1e-4;
+
+    lints::Structure structure("def2-svp", atomic_nrs_h2o, coords_h2o);
+
+    std::vector<std::array<double, 4>> charges = structure.getZs();
+    arr2d<vec2d, 3, 3> pvp = lints::pVpIntegrals(structure);
+
+    // The atomic orbitals of the atoms 0 and 1.
+    std::array<std::vector<size_t>, 2> aos_atoms;
+    for (const lints::Shell &shell : structure.getShellsView())
+        if (shell.idx_atom_ < 2)
+            for (size_t mu = 0; mu < shell.dim_sph_; mu++)
+                aos_atoms[shell.idx_atom_].push_back(shell.ofs_sph_ + mu);
+
+    double h_bohr = h * lints::_ang_to_bohr_;
+    double max_diff = 0;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            std::array<vec2d, 4> v_ints;
+            std::array<std::pair<int, int>, 4> signs{{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+            for (int k = 0; k < 4; k++)
+            {
+                std::vector<std::array<double, 3>> coords = coords_h2o;
+                coords[0][i] += signs[k].first * h;
+                coords[1][j] += signs[k].second * h;
+
+                lints::Structure structure_disp("def2-svp", atomic_nrs_h2o, coords);
+
+                v_ints[k] = lints::externalCharges(charges, structure_disp);
+            }
+
+            for (size_t mu : aos_atoms[0])
+                for (size_t nu : aos_atoms[1])
+                {
+                    double d2v = (v_ints[0](mu, nu) - v_ints[1](mu, nu) - v_ints[2](mu, nu) +
+                                  v_ints[3](mu, nu)) / (4 * h_bohr * h_bohr);
+
+                    max_diff = std::max(max_diff, std::fabs(pvp[i][j](mu, nu) - d2v));
+                }
+        }
+
+    if (max_diff < 1e-5)
+        return true;
+
+    return false;
+}
+
 bool ltests::eri2()
 {
     const double correct_answer = 8801.334703460838;
@@ -763,6 +1018,81 @@ bool ltests::eri4()
     return false;
 }
 
+bool ltests::eri4MO()
+{
+    // The transformed integrals are compared against the transformation of the full ERI4
+    // tensor. The memory limits are set low enough to split the bra shell pairs into blocks,
+    // and with no memory at all, into single shell pairs and single MOs.
+    lints::Structure structure("def2-svp", atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t n_mo = 6;
+
+    vec2d mo_coeffs(Fill(0), dim_ao, n_mo);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t p = 0; p < n_mo; p++)
+            mo_coeffs(mu, p) = std::cos(0.3 * double((mu + 1) * (p + 2))) / std::sqrt(dim_ao);
+
+    vec4d eri4 = lints::eri4(structure);
+
+    vec4d eri4_a(Fill(0), n_mo, dim_ao, dim_ao, dim_ao);
+    for (size_t p = 0; p < n_mo; p++)
+        for (size_t mu = 0; mu < dim_ao; mu++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t ka = 0; ka < dim_ao; ka++)
+                    for (size_t ta = 0; ta < dim_ao; ta++)
+                        eri4_a(p, nu, ka, ta) += mo_coeffs(mu, p) * eri4(mu, nu, ka, ta);
+
+    vec4d eri4_b(Fill(0), n_mo, n_mo, dim_ao, dim_ao);
+    for (size_t p = 0; p < n_mo; p++)
+        for (size_t q = 0; q < n_mo; q++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t ka = 0; ka < dim_ao; ka++)
+                    for (size_t ta = 0; ta < dim_ao; ta++)
+                        eri4_b(p, q, ka, ta) += mo_coeffs(nu, q) * eri4_a(p, nu, ka, ta);
+
+    vec4d eri4_c(Fill(0), n_mo, n_mo, n_mo, dim_ao);
+    for (size_t p = 0; p < n_mo; p++)
+        for (size_t q = 0; q < n_mo; q++)
+            for (size_t r = 0; r < n_mo; r++)
+                for (size_t ka = 0; ka < dim_ao; ka++)
+                    for (size_t ta = 0; ta < dim_ao; ta++)
+                        eri4_c(p, q, r, ta) += mo_coeffs(ka, r) * eri4_b(p, q, ka, ta);
+
+    vec4d eri4_ref(Fill(0), n_mo);
+    for (size_t p = 0; p < n_mo; p++)
+        for (size_t q = 0; q < n_mo; q++)
+            for (size_t r = 0; r < n_mo; r++)
+                for (size_t s = 0; s < n_mo; s++)
+                    for (size_t ta = 0; ta < dim_ao; ta++)
+                        eri4_ref(p, q, r, s) += mo_coeffs(ta, s) * eri4_c(p, q, r, ta);
+
+    // The quarter-transformed integrals alone take about 0.33 MB. With the scratch directory,
+    // the half-transformed integrals are staged on disk instead of recalculating the integrals.
+    double max_memory_mb = 0.1;
+    std::string scratch_dir = std::filesystem::temp_directory_path().string();
+
+    std::vector<std::vector<double>> eri4_mos{
+            lints::eri4MO(structure, mo_coeffs),
+            lints::eri4MO(structure, mo_coeffs, max_memory_mb),
+            lints::eri4MO(structure, mo_coeffs, 0),
+            lints::eri4MO(structure, mo_coeffs, max_memory_mb, scratch_dir),
+            lints::eri4MO(structure, mo_coeffs, 0, scratch_dir)};
+
+    double max_diff = 0;
+    for (const std::vector<double> &eri4_mo : eri4_mos)
+    {
+        vec4d eri4_unpacked = lints::unpackERI4MO(n_mo, eri4_mo);
+        for (size_t i = 0; i < eri4_ref.size(); i++)
+            max_diff = std::max(max_diff, std::fabs(eri4_unpacked[i] - eri4_ref[i]));
+    }
+
+    if (max_diff < tol)
+        return true;
+
+    return false;
+}
+
 bool ltests::basisForAtom()
 {
     const double correct_answer = 107960921.709905013442;
@@ -870,6 +1200,62 @@ bool ltests::sphericalTrafo()
     return false;
 }
 
+bool ltests::trafo2SphericalBatch()
+{
+    // The batched transformation with the compile-time tables is compared against a dense
+    // transformation built from sphericalTrafo() for all the supported angular momenta.
+    const size_t n_blocks = 3;
+
+    double max_diff = 0;
+    for (int la = 0; la <= lints::max_l_sph_trafo; la++)
+        for (int lb = 0; lb <= lints::max_l_sph_trafo; lb++)
+        {
+            int n_cart_a = lints::numCartesians(la);
+            int n_cart_b = lints::numCartesians(lb);
+            int n_sph_a = lints::numSphericals(la);
+            int n_sph_b = lints::numSphericals(lb);
+
+            vec2d trafo_a(Fill(0), n_sph_a, n_cart_a);
+            for (const auto &[mu, mu_, val] : lints::sphericalTrafo(la))
+                trafo_a(mu, mu_) = val;
+
+            vec2d trafo_b(Fill(0), n_sph_b, n_cart_b);
+            for (const auto &[nu, nu_, val] : lints::sphericalTrafo(lb))
+                trafo_b(nu, nu_) = val;
+
+            std::vector<double> ints_cart(n_blocks * n_cart_a * n_cart_b);
+            for (size_t i = 0; i < ints_cart.size(); i++)
+                ints_cart[i] = std::sin(0.1 * double(i + 1));
+
+            std::vector<double> ints_sph(n_blocks * n_sph_a * n_sph_b);
+            lints::trafo2SphericalBatch(la, lb, n_blocks, ints_cart.data(), ints_sph.data());
+
+            for (size_t iblock = 0; iblock < n_blocks; iblock++)
+            {
+                const double *block_cart = &ints_cart[iblock * n_cart_a * n_cart_b];
+                const double *block_sph = &ints_sph[iblock * n_sph_a * n_sph_b];
+                for (int mu = 0; mu < n_sph_a; mu++)
+                    for (int nu = 0; nu < n_sph_b; nu++)
+                    {
+                        double ref = 0;
+                        for (int mu_ = 0; mu_ < n_cart_a; mu_++)
+                            for (int nu_ = 0; nu_ < n_cart_b; nu_++)
+                                ref += trafo_a(mu, mu_) * trafo_b(nu, nu_) *
+                                       block_cart[mu_ * n_cart_b + nu_];
+
+                        double scale = std::max(1.0, std::fabs(ref));
+                        double diff = std::fabs(block_sph[mu * n_sph_b + nu] - ref) / scale;
+                        max_diff = std::max(max_diff, diff);
+                    }
+            }
+        }
+
+    if (max_diff < tol)
+        return true;
+
+    return false;
+}
+
 bool ltests::deployERI4Kernel()
 {
     const double correct_answer = 8246.711763197583;
@@ -1147,129 +1533,1761 @@ bool ltests::deployERI3SOCKernel()
     return false;
 }
 
-bool ltests::ecoeffsRecurrence1()
+bool ltests::deployERI4KernelRys()
 {
-    const double correct_answer = 181021.807437296084;
+    const double tol_rys = 1e-10;
 
-    vec2d ecoeffs = lints::ecoeffsRecurrence1(19.0034512342, 4);
+    lints::Structure structure("def2-tzvp", atomic_nrs_h2o, coords_h2o);
 
-    double sum_ecoeffs = 0;
-    for (double ecoeff : ecoeffs)
-        sum_ecoeffs += std::fabs(ecoeff);
+    std::vector<lints::ShellPairData> shell_pair_datas = lints::shellPairData(true, structure);
 
-    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+    double max_diff = 0;
+    for (const lints::ShellPairData &sp_data_ab : shell_pair_datas)
+        for (const lints::ShellPairData &sp_data_cd : shell_pair_datas)
+        {
+            lints::ERI4Kernel eri4_kernel(sp_data_ab, sp_data_cd);
+            lints::ERI4Kernel eri4_kernel_rys(sp_data_ab, sp_data_cd, lints::ERIBackend::rys);
+            for (size_t ipair1 = 0; ipair1 < sp_data_ab.n_pairs_; ipair1++)
+                for (size_t ipair2 = 0; ipair2 < sp_data_cd.n_pairs_; ipair2++)
+                {
+                    vec4d eri4_batch = eri4_kernel(ipair1, ipair2, sp_data_ab, sp_data_cd);
+                    vec4d eri4_batch_rys = eri4_kernel_rys(ipair1, ipair2, sp_data_ab,
+                                                           sp_data_cd);
+
+                    for (size_t i = 0; i < eri4_batch.size(); i++)
+                        max_diff = std::max(max_diff,
+                                            std::fabs(eri4_batch[i] - eri4_batch_rys[i]));
+                }
+        }
+
+    if (max_diff < tol_rys)
         return true;
 
     return false;
 }
 
-bool ltests::ecoeffsRecurrence2()
+bool ltests::deployERI3KernelRys()
 {
-    const double correct_answer = 0.218834692700;
+    const double tol_rys = 1e-10;
 
-    vec3d ecoeffs = lints::ecoeffsRecurrence2(0.0023445, 1.123621, 2, 3, 0.5113241, 1.2345123,
-                                              0.003451234);
+    lints::Structure structure("def2-tzvp", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
 
-    double sum_ecoeffs = 0;
-    for (double ecoeff : ecoeffs)
-        sum_ecoeffs += std::fabs(ecoeff);
+    std::vector<lints::ShellPairData> shell_pair_datas = lints::shellPairData(false, structure);
+    std::vector<lints::ShellData> shell_datas = lints::shellDataAux(structure);
 
-    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+    double max_diff = 0;
+    for (const lints::ShellPairData &sp_data_ab : shell_pair_datas)
+        for (const lints::ShellData &sh_data_c : shell_datas)
+        {
+            lints::ERI3Kernel eri3_kernel(sp_data_ab, sh_data_c);
+            lints::ERI3Kernel eri3_kernel_rys(sp_data_ab, sh_data_c, lints::ERIBackend::rys);
+            for (size_t ipair = 0; ipair < sp_data_ab.n_pairs_; ipair++)
+                for (size_t ishell = 0; ishell < sh_data_c.n_shells_; ishell++)
+                {
+                    vec3d eri3_batch = eri3_kernel(ipair, ishell, sp_data_ab, sh_data_c);
+                    vec3d eri3_batch_rys = eri3_kernel_rys(ipair, ishell, sp_data_ab, sh_data_c);
+
+                    for (size_t i = 0; i < eri3_batch.size(); i++)
+                        max_diff = std::max(max_diff,
+                                            std::fabs(eri3_batch[i] - eri3_batch_rys[i]));
+                }
+        }
+
+    if (max_diff < tol_rys)
         return true;
 
     return false;
 }
 
-bool ltests::ecoeffsRecurrence2_n1()
+bool ltests::deployERI2KernelRys()
 {
-    const double correct_answer = 0.053908505303;
+    const double tol_rys = 1e-10;
 
-    double a = 0.0023445;
-    double b = 1.123621;
-    int la = 2;
-    int lb = 3;
-    double PA = 0.5113241;
-    double PB = 1.2345123;
-    double Kab = 0.003451234;
-    double A = -0.571235891;
-    double B = 1.612357121;
+    lints::Structure structure("def2-svp", "def2-qzvp-rifit", atomic_nrs_o3, coords_o3);
 
-    vec3d ecoeffs = lints::ecoeffsRecurrence2(a, b, la, lb, PA, PB, Kab);
-    vec3d ecoeffs1 = lints::ecoeffsRecurrence2_n1(a, b, la, lb, A, B, ecoeffs);
+    std::vector<lints::ShellData> shell_datas = lints::shellDataAux(structure);
 
-    double sum_ecoeffs = 0;
-    for (double ecoeff : ecoeffs1)
-        sum_ecoeffs += std::fabs(ecoeff);
+    double max_diff = 0;
+    for (const lints::ShellData &sh_data_a : shell_datas)
+        for (const lints::ShellData &sh_data_b : shell_datas)
+        {
+            lints::ERI2Kernel eri2_kernel(sh_data_a, sh_data_b);
+            lints::ERI2Kernel eri2_kernel_rys(sh_data_a, sh_data_b, lints::ERIBackend::rys);
+            for (size_t ishell_a = 0; ishell_a < sh_data_a.n_shells_; ishell_a++)
+                for (size_t ishell_b = 0; ishell_b < sh_data_b.n_shells_; ishell_b++)
+                {
+                    vec2d eri2_batch = eri2_kernel(ishell_a, ishell_b, sh_data_a, sh_data_b);
+                    vec2d eri2_batch_rys = eri2_kernel_rys(ishell_a, ishell_b, sh_data_a,
+                                                           sh_data_b);
 
-    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+                    for (size_t i = 0; i < eri2_batch.size(); i++)
+                        max_diff = std::max(max_diff,
+                                            std::fabs(eri2_batch[i] - eri2_batch_rys[i]));
+                }
+        }
+
+    if (max_diff < tol_rys)
         return true;
 
     return false;
 }
 
-bool ltests::ecoeffsPrimitive()
+bool ltests::kernelSelector()
 {
-    const double correct_answer = 3.002442449382;
+    const double tol_rys = 1e-10;
 
-    std::array<vec2d, 3> ecoeffs = lints::ecoeffsPrimitive(1230.02342162, 4);
+    lints::Structure structure("def2-svp", atomic_nrs_h2o, coords_h2o);
 
-    double sum_ecoeffs = 0;
-    for (int icart = 0; icart < 3; icart++)
-        for (size_t i = 0; i < ecoeffs[icart].size(); i++)
-            sum_ecoeffs += std::fabs(ecoeffs[icart][i]);
+    std::string tuning_file = (std::filesystem::temp_directory_path() /
+                               "lible_test_eri4_tuning.txt").string();
 
-    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+    lints::KernelSelector kernel_selector = lints::eri4Autotune(structure, tuning_file);
+    lints::KernelSelector kernel_selector_file(tuning_file);
+    std::filesystem::remove(tuning_file);
+
+    if (kernel_selector.size() == 0 || kernel_selector.size() != kernel_selector_file.size())
+        return false;
+
+    std::vector<lints::ShellPairData> shell_pair_datas = lints::shellPairData(true, structure);
+    for (const lints::ShellPairData &sp_data_ab : shell_pair_datas)
+        for (const lints::ShellPairData &sp_data_cd : shell_pair_datas)
+            if (kernel_selector.select(sp_data_ab, sp_data_cd) !=
+                kernel_selector_file.select(sp_data_ab, sp_data_cd))
+                return false;
+
+    vec4d eri4 = lints::eri4(structure);
+    vec4d eri4_tuned = lints::eri4(structure, kernel_selector_file);
+
+    double max_diff = 0;
+    for (size_t i = 0; i < eri4.size(); i++)
+        max_diff = std::max(max_diff, std::fabs(eri4[i] - eri4_tuned[i]));
+
+    if (max_diff < tol_rys)
         return true;
 
     return false;
 }
 
-bool ltests::ecoeffsPrimitivePair()
+bool ltests::pointGroupSymmetry()
 {
-    const double correct_answer = 16.100457827896;
+    auto maxDiff = [](const auto &ints, const auto &ints_symm)
+    {
+        double max_diff = 0;
+        for (size_t i = 0; i < ints.size(); i++)
+            max_diff = std::max(max_diff, std::fabs(ints[i] - ints_symm[i]));
 
-    std::array<double, 3> xyz_a{0, 1.5, 0};
-    std::array<double, 3> xyz_b{1.0, 0, -1.0};
+        return max_diff;
+    };
 
-    std::array<vec3d, 3> ecoeffs =
-            lints::ecoeffsPrimitivePair(1230.02342162, 0.0023445, 4, 3, xyz_a.data(), xyz_b.data());
+    lints::Structure structure_h2o("def2-svp", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+    lints::Structure structure_c2h4("def2-svp", atomic_nrs_c2h4_d2h, coords_c2h4_d2h);
+    lints::Structure structure_c2h6("def2-svp", atomic_nrs_c2h6, coords_c2h6);
 
-    double sum_ecoeffs = 0;
-    for (int icart = 0; icart < 3; icart++)
-        for (double ecoeff : ecoeffs[icart])
-            sum_ecoeffs += std::fabs(ecoeff);
+    lints::PointGroup point_group_h2o = lints::pointGroup(structure_h2o);
+    lints::PointGroup point_group_c2h4 = lints::pointGroup(structure_c2h4);
+    lints::PointGroup point_group_c2h6 = lints::pointGroup(structure_c2h6);
 
-    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+    if (point_group_h2o.name_ != "C2v" || point_group_c2h4.name_ != "D2h" ||
+        point_group_c2h6.name_ != "C1")
+        return false;
+
+    double max_diff = 0;
+    max_diff = std::max(max_diff, maxDiff(lints::overlap(structure_h2o),
+                                          lints::overlap(structure_h2o, point_group_h2o)));
+    max_diff = std::max(max_diff, maxDiff(lints::kineticEnergy(structure_h2o),
+                                          lints::kineticEnergy(structure_h2o, point_group_h2o)));
+    max_diff = std::max(max_diff, maxDiff(lints::nuclearAttraction(structure_h2o),
+                                          lints::nuclearAttraction(structure_h2o,
+                                                                   point_group_h2o)));
+    max_diff = std::max(max_diff, maxDiff(lints::eri3(structure_h2o),
+                                          lints::eri3(structure_h2o, point_group_h2o)));
+    max_diff = std::max(max_diff, maxDiff(lints::eri4(structure_h2o),
+                                          lints::eri4(structure_h2o, point_group_h2o)));
+    max_diff = std::max(max_diff, maxDiff(lints::overlap(structure_c2h4),
+                                          lints::overlap(structure_c2h4, point_group_c2h4)));
+    max_diff = std::max(max_diff, maxDiff(lints::eri4(structure_c2h4),
+                                          lints::eri4(structure_c2h4, point_group_c2h4)));
+
+    if (max_diff < tol)
         return true;
 
     return false;
 }
 
-bool ltests::ecoeffsPrimitivePair_n1()
+bool ltests::eri4GradientJK()
 {
-    const double correct_answer = 21.712096988812;
+    // Compared against central finite differences with a fixed AO density, relative to the
+    // largest gradient component.
+    lints::Structure structure("def2-svp", atomic_nrs_h2o, coords_h2o);
 
-    std::array<double, 3> xyz_a{0, 1.5, 0};
-    std::array<double, 3> xyz_b{1.0, 0, -1.0};
+    vec2d density = lints::overlap(structure);
+    size_t dim_ao = structure.getDimAO();
 
-    double a = 1230.02342162;
-    double b = 0.0023445;
-    int la = 4;
-    int lb = 3;
-    double A[3] = {0.571235891, 1.612357121, -0.234512341};
-    double B[3] = {1.2345123, -0.5113241, 0.003451234};
+    auto [gradient_j, gradient_k] = lints::eri4GradientJK(structure, density, density);
 
-    std::array<vec3d, 3> ecoeffs0 =
-            lints::ecoeffsPrimitivePair(a, b, la, lb, xyz_a.data(), xyz_b.data());
-    std::array<vec3d, 3> ecoeffs1 =
-            lints::ecoeffsPrimitivePair_n1(a, b, la, lb, A, B, ecoeffs0);
+    auto energiesJK = [&](const lints::Structure &structure_disp)
+    {
+        vec4d eri4 = lints::eri4(structure_disp);
+
+        double energy_j = 0, energy_k = 0;
+        for (size_t mu = 0; mu < dim_ao; mu++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t ka = 0; ka < dim_ao; ka++)
+                    for (size_t ta = 0; ta < dim_ao; ta++)
+                    {
+                        energy_j += 0.5 * density(mu, nu) * density(ka, ta) * eri4(mu, nu, ka, ta);
+                        energy_k += 0.5 * density(mu, ka) * density(nu, ta) * eri4(mu, nu, ka, ta);
+                    }
+
+        return std::vector<double>{energy_j, energy_k};
+    };
 
-    double sum_ecoeffs = 0;
-    for (int icart = 0; icart < 3; icart++)
-        for (double ecoeff : ecoeffs1[icart])
-            sum_ecoeffs += std::fabs(ecoeff);
+    vec2d gradient_fd = finiteDifferenceGradient(structure, energiesJK);
 
-    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+    double scale_j = std::max(1.0, maxAbs(gradient_j));
+    double scale_k = std::max(1.0, maxAbs(gradient_k));
+
+    double max_diff = 0;
+    for (size_t i = 0; i < gradient_j.size(); i++)
+    {
+        max_diff = std::max(max_diff, std::fabs(gradient_fd(i, 0) - gradient_j[i]) / scale_j);
+        max_diff = std::max(max_diff, std::fabs(gradient_fd(i, 1) - gradient_k[i]) / scale_k);
+    }
+
+    if (max_diff < tol_fd)
+        return true;
+
+    return false;
+}
+
+bool ltests::riGradientJK()
+{
+    // The RI gradients are the partial derivatives of the RI-J and RI-K energy functionals at
+    // fixed fitting coefficients, so they are compared against central finite differences of
+    // the functionals with fixed AO density and coefficients.
+    std::string basis_set = "def2-svp";
+    std::string basis_set_aux = "def2-universal-jkfit";
+    lints::Structure structure(basis_set, basis_set_aux, atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+
+    vec2d density = lints::overlap(structure);
+    vec3d coeffs_fit_k = lints::eri3(structure);
+
+    std::vector<double> coeffs_fit_j(dim_ao_aux, 0);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t nu = 0; nu < dim_ao; nu++)
+            for (size_t P = 0; P < dim_ao_aux; P++)
+                coeffs_fit_j[P] += density(mu, nu) * coeffs_fit_k(mu, nu, P);
+
+    // gamma_{mu nu, P} = sum_{ka ta} D_{mu ka} D_{nu ta} C_{ka ta, P}
+    vec3d D_x_C(Fill(0), dim_ao, dim_ao, dim_ao_aux);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t ka = 0; ka < dim_ao; ka++)
+            for (size_t ta = 0; ta < dim_ao; ta++)
+                for (size_t P = 0; P < dim_ao_aux; P++)
+                    D_x_C(mu, ta, P) += density(mu, ka) * coeffs_fit_k(ka, ta, P);
+
+    vec3d gamma(Fill(0), dim_ao, dim_ao, dim_ao_aux);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t nu = 0; nu < dim_ao; nu++)
+            for (size_t ta = 0; ta < dim_ao; ta++)
+                for (size_t P = 0; P < dim_ao_aux; P++)
+                    gamma(mu, nu, P) += density(nu, ta) * D_x_C(mu, ta, P);
+
+    vec2d gamma_metric(Fill(0), dim_ao_aux, dim_ao_aux);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t nu = 0; nu < dim_ao; nu++)
+            for (size_t P = 0; P < dim_ao_aux; P++)
+                for (size_t Q = 0; Q < dim_ao_aux; Q++)
+                    gamma_metric(P, Q) += coeffs_fit_k(mu, nu, P) * gamma(mu, nu, Q);
+
+    vec2d gradient_j = lints::riGradientJ(structure, density, coeffs_fit_j);
+    vec2d gradient_k = lints::riGradientK(structure, density, coeffs_fit_k);
+
+    auto energiesJK = [&](const lints::Structure &structure_disp)
+    {
+        vec3d eri3 = lints::eri3(structure_disp);
+        vec2d eri2 = lints::eri2(structure_disp);
+
+        double energy_j = 0, energy_k = 0;
+        for (size_t mu = 0; mu < dim_ao; mu++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t P = 0; P < dim_ao_aux; P++)
+                {
+                    energy_j += coeffs_fit_j[P] * density(mu, nu) * eri3(mu, nu, P);
+                    energy_k += gamma(mu, nu, P) * eri3(mu, nu, P);
+                }
+
+        for (size_t P = 0; P < dim_ao_aux; P++)
+            for (size_t Q = 0; Q < dim_ao_aux; Q++)
+            {
+                energy_j -= 0.5 * coeffs_fit_j[P] * eri2(P, Q) * coeffs_fit_j[Q];
+                energy_k -= 0.5 * gamma_metric(P, Q) * eri2(P, Q);
+            }
+
+        return std::vector<double>{energy_j, energy_k};
+    };
+
+    vec2d gradient_fd = finiteDifferenceGradient(structure, energiesJK);
+
+    double scale_j = std::max(1.0, maxAbs(gradient_j));
+    double scale_k = std::max(1.0, maxAbs(gradient_k));
+
+    double max_diff = 0;
+    for (size_t i = 0; i < gradient_j.size(); i++)
+    {
+        max_diff = std::max(max_diff, std::fabs(gradient_fd(i, 0) - gradient_j[i]) / scale_j);
+        max_diff = std::max(max_diff, std::fabs(gradient_fd(i, 1) - gradient_k[i]) / scale_k);
+    }
+
+    if (max_diff < tol_fd)
+        return true;
+
+    return false;
+}
+
+bool ltests::oneElectronGradients()
+{
+    // The contracted one-electron gradients are compared against central finite differences of
+    // the integrals contracted with a fixed density, for the atoms and the point charges.
+    auto contract = [](const vec2d &ints, const vec2d &density)
+    {
+        double energy = 0;
+        for (size_t i = 0; i < ints.size(); i++)
+            energy += ints[i] * density[i];
+
+        return energy;
+    };
+
+    std::string basis_set = "def2-svp";
+    lints::Structure structure(basis_set, atomic_nrs_h2o, coords_h2o);
+
+    std::vector<std::array<double, 4>> point_charges{
+        {1.7, -0.4, 2.1, 0.8},
+        {-2.3, 1.5, -0.6, -0.5}
+    };
+
+    vec2d density = lints::overlap(structure);
+
+    vec2d gradient_s = lints::overlapGradient(structure, density);
+    vec2d gradient_t = lints::kineticEnergyGradient(structure, density);
+    vec2d gradient_v = lints::nuclearAttractionGradient(structure, density);
+    auto [gradient_c, gradient_charges] = lints::externalChargesGradient(point_charges, structure,
+                                                                         density);
+
+    auto energies = [&](const lints::Structure &structure_disp)
+    {
+        return std::vector<double>{
+            contract(lints::overlap(structure_disp), density),
+            contract(lints::kineticEnergy(structure_disp), density),
+            contract(lints::nuclearAttraction(structure_disp), density),
+            contract(lints::externalCharges(point_charges, structure_disp), density)
+        };
+    };
+
+    vec2d gradient_fd = finiteDifferenceGradient(structure, energies);
+
+    std::array<const vec2d *, 4> gradients{&gradient_s, &gradient_t, &gradient_v, &gradient_c};
+
+    double max_diff = 0;
+    for (size_t ivalue = 0; ivalue < gradients.size(); ivalue++)
+    {
+        const vec2d &gradient = *gradients[ivalue];
+        double scale = std::max(1.0, maxAbs(gradient));
+        for (size_t i = 0; i < gradient.size(); i++)
+            max_diff = std::max(max_diff, std::fabs(gradient_fd(i, ivalue) - gradient[i]) / scale);
+    }
+
+    // The point charge coordinates are in bohr.
+    const double step = 1e-4;
+    double scale_charges = std::max(1.0, maxAbs(gradient_charges));
+    for (size_t icharge = 0; icharge < point_charges.size(); icharge++)
+        for (int icart = 0; icart < 3; icart++)
+        {
+            std::vector<std::array<double, 4>> charges_plus = point_charges;
+            std::vector<std::array<double, 4>> charges_minus = point_charges;
+            charges_plus[icharge][icart] += step;
+            charges_minus[icharge][icart] -= step;
+
+            double energy_plus = contract(lints::externalCharges(charges_plus, structure), density);
+            double energy_minus = contract(lints::externalCharges(charges_minus, structure),
+                                           density);
+
+            double fd = (energy_plus - energy_minus) / (2 * step);
+            max_diff = std::max(max_diff, std::fabs(fd - gradient_charges(icharge, icart)) /
+                                          scale_charges);
+        }
+
+    if (max_diff < tol_fd)
+        return true;
+
+    return false;
+}
+
+bool ltests::hessians()
+{
+    // The contracted Hessians are compared against central finite differences of the analytic
+    // gradients with a fixed density or weight. The sum rule from the translational invariance,
+    // sum over the atoms of each Hessian column vanishing, is checked as well.
+    const double tol_sum = 1e-10;
+
+    std::string basis_set = "def2-svp";
+    std::string basis_set_aux = "def2-universal-jkfit";
+    lints::Structure structure(basis_set, basis_set_aux, atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_atoms = atomic_nrs_h2o.size();
+    size_t n_coords = 3 * n_atoms;
+
+    vec2d density = lints::overlap(structure);
+
+    std::vector<double> coeffs_fit(dim_ao_aux);
+    for (size_t P = 0; P < dim_ao_aux; P++)
+        coeffs_fit[P] = 0.1 * std::cos(double(P));
+
+    vec2d weight(Fill(0), dim_ao_aux, dim_ao_aux);
+    for (size_t P = 0; P < dim_ao_aux; P++)
+        for (size_t Q = 0; Q < dim_ao_aux; Q++)
+            weight(P, Q) = coeffs_fit[P] * coeffs_fit[Q];
+
+    // The RI-J gradient with a zero density is -1/2 sum_PQ c_P d/dR (P|Q) c_Q.
+    vec2d density_zero(Fill(0), dim_ao, dim_ao);
+
+    vec2d hessian_s = lints::overlapHessian(structure, density);
+    vec2d hessian_t = lints::kineticEnergyHessian(structure, density);
+    vec2d hessian_m = lints::eri2Hessian(structure, weight);
+    for (size_t i = 0; i < hessian_m.size(); i++)
+        hessian_m[i] *= -0.5;
+
+    if (hessian_s.dim<0>() != n_coords || hessian_s.dim<1>() != n_coords)
+        return false;
+
+    // The gradients of the three operators one after another.
+    auto gradients = [&](const lints::Structure &structure_disp)
+    {
+        std::vector<double> values;
+        for (const vec2d &gradient : {lints::overlapGradient(structure_disp, density),
+                                      lints::kineticEnergyGradient(structure_disp, density),
+                                      lints::riGradientJ(structure_disp, density_zero,
+                                                         coeffs_fit)})
+            values.insert(values.end(), &gradient[0], &gradient[0] + gradient.size());
+
+        return values;
+    };
+
+    vec2d hessian_fd = finiteDifferenceGradient(structure, gradients);
+
+    std::array<const vec2d *, 3> hessians{&hessian_s, &hessian_t, &hessian_m};
+
+    double max_diff = 0;
+    for (size_t iops = 0; iops < hessians.size(); iops++)
+    {
+        const vec2d &hessian = *hessians[iops];
+        double scale = std::max(1.0, maxAbs(hessian));
+        for (size_t i = 0; i < n_coords; i++)
+            for (size_t j = 0; j < n_coords; j++)
+            {
+                double diff = hessian_fd(i, iops * n_coords + j) - hessian(i, j);
+                max_diff = std::max(max_diff, std::fabs(diff) / scale);
+            }
+    }
+
+    double max_sum = 0;
+    for (const vec2d *hessian : hessians)
+        for (size_t i = 0; i < n_coords; i++)
+            for (int jcart = 0; jcart < 3; jcart++)
+            {
+                double sum = 0;
+                for (size_t jatom = 0; jatom < n_atoms; jatom++)
+                    sum += (*hessian)(i, 3 * jatom + jcart);
+
+                max_sum = std::max(max_sum, std::fabs(sum));
+            }
+
+    if (max_diff < tol_fd && max_sum < tol_sum)
+        return true;
+
+    return false;
+}
+
+bool ltests::electrostaticPotential()
+{
+    // The potential is compared against the external charge integrals contracted with a fixed
+    // density, and the field against the derivatives with respect to the charge positions.
+    // The basis set has g-functions, so both the rolled-out and generic paths are used.
+    const double tol_esp = 1e-10;
+
+    lints::Structure structure("def2-qzvp", atomic_nrs_h2o, coords_h2o);
+
+    vec2d density = lints::overlap(structure);
+
+    std::vector<std::array<double, 3>> points;
+    std::vector<std::array<double, 4>> unit_charges;
+    for (int ipoint = 0; ipoint < 70; ipoint++)
+    {
+        std::array<double, 3> point{-3.1 + 0.09 * ipoint, 2.2 - 0.05 * ipoint,
+                                    0.4 + 0.03 * ipoint};
+        points.push_back(point);
+        unit_charges.push_back({point[0], point[1], point[2], 1.0});
+    }
+
+    lints::ElectrostaticPotential esp = lints::electrostaticPotential(points, structure, density,
+                                                                      true, 0);
+    lints::ElectrostaticPotential esp_nofield = lints::electrostaticPotential(points, structure,
+                                                                              density);
+    if (!esp_nofield.field_.empty())
+        return false;
+
+    auto [gradient_atoms, gradient_charges] = lints::externalChargesGradient(unit_charges,
+                                                                             structure, density);
+
+    for (size_t ipoint = 0; ipoint < points.size(); ipoint++)
+    {
+        vec2d ints = lints::externalCharges({unit_charges[ipoint]}, structure);
+
+        double potential = 0;
+        for (size_t i = 0; i < ints.size(); i++)
+            potential += ints[i] * density[i];
+
+        if (std::fabs(esp.potential_[ipoint] - potential) > tol_esp ||
+            std::fabs(esp_nofield.potential_[ipoint] - potential) > tol_esp)
+            return false;
+
+        for (int icart = 0; icart < 3; icart++)
+            if (std::fabs(esp.field_[ipoint][icart] + gradient_charges(ipoint, icart)) > tol_esp)
+                return false;
+    }
+
+    return true;
+}
+
+bool ltests::aoCollocation()
+{
+    // The values are compared against a direct evaluation from the shell data, and the
+    // gradients and Laplacians against finite differences of the values. The basis set has
+    // g-functions and the points are more than 64, so several blocks and L values are used.
+    const double tol_values = 1e-12;
+    const double tol_fd = 1e-6;
+    const double step = 1e-4;
+
+    lints::Structure structure("def2-qzvp", atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+
+    std::vector<std::array<double, 3>> points;
+    for (int ipoint = 0; ipoint < 100; ipoint++)
+        points.push_back({-3.1 + 0.06 * ipoint, 2.2 - 0.04 * ipoint, 0.4 + 0.02 * ipoint});
+
+    lints::AOCollocation collocation = lints::aoCollocation(points, structure, true, true);
+    lints::AOCollocation collocation_noscreen = lints::aoCollocation(points, structure, false,
+                                                                     false, 0);
+    if (collocation_noscreen.values_.dim<0>() != points.size() ||
+        collocation_noscreen.values_.dim<1>() != dim_ao ||
+        collocation_noscreen.gradients_[0].size() != 0 ||
+        collocation_noscreen.laplacians_.size() != 0)
+        return false;
+
+    for (const lints::Shell &shell : structure.getShellsView())
+    {
+        auto sph_trafo = lints::sphericalTrafo(shell.l_);
+        for (size_t ipoint = 0; ipoint < points.size(); ipoint++)
+        {
+            double x = points[ipoint][0] - shell.xyz_coords_[0];
+            double y = points[ipoint][1] - shell.xyz_coords_[1];
+            double z = points[ipoint][2] - shell.xyz_coords_[2];
+
+            double radial = 0;
+            for (size_t iprim = 0; iprim < shell.exps_.size(); iprim++)
+                radial += shell.coeffs_[iprim] * shell.norms_prim_[iprim] *
+                          std::exp(-shell.exps_[iprim] * (x * x + y * y + z * z));
+
+            std::vector<double> values(shell.dim_sph_, 0);
+            for (const auto &[mu, mu_, val] : sph_trafo)
+            {
+                auto [i, j, k, _] = lints::cart_exps[shell.l_][mu_];
+                values[mu] += shell.norms_[mu] * val * std::pow(x, i) * std::pow(y, j) *
+                              std::pow(z, k) * radial;
+            }
+
+            for (size_t mu = 0; mu < shell.dim_sph_; mu++)
+            {
+                size_t iao = shell.ofs_sph_ + mu;
+                if (std::fabs(collocation_noscreen.values_(ipoint, iao) - values[mu]) >
+                    tol_values)
+                    return false;
+
+                if (std::fabs(collocation.values_(ipoint, iao) - values[mu]) > tol_values)
+                    return false;
+            }
+        }
+    }
+
+    // Central differences for the gradients and the Laplacians.
+    for (size_t ipoint = 0; ipoint < points.size(); ipoint++)
+    {
+        std::vector<double> laplacians(dim_ao, 0);
+        for (int icart = 0; icart < 3; icart++)
+        {
+            std::vector<std::array<double, 3>> points_pm{points[ipoint], points[ipoint]};
+            points_pm[0][icart] += step;
+            points_pm[1][icart] -= step;
+
+            vec2d values_pm = lints::aoCollocation(points_pm, structure, false, false, 0).values_;
+
+            for (size_t iao = 0; iao < dim_ao; iao++)
+            {
+                double value = collocation.values_(ipoint, iao);
+                double fd = (values_pm(0, iao) - values_pm(1, iao)) / (2 * step);
+                double gradient = collocation.gradients_[icart](ipoint, iao);
+                if (std::fabs(fd - gradient) > tol_fd * std::max(1.0, std::fabs(gradient)))
+                    return false;
+
+                laplacians[iao] += (values_pm(0, iao) - 2 * value + values_pm(1, iao)) /
+                                   (step * step);
+            }
+        }
+
+        for (size_t iao = 0; iao < dim_ao; iao++)
+        {
+            double laplacian = collocation.laplacians_(ipoint, iao);
+            if (std::fabs(laplacians[iao] - laplacian) >
+                tol_fd * std::max(1.0, std::fabs(laplacian)))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool ltests::spinOrbitMeanField()
+{
+    // The SOMF matrices are compared against the ones assembled from the full SOC integral
+    // tensor. The RI variant is compared against the same reference with a looser tolerance
+    // that accounts for the fitting error.
+    const double tol_somf = 1e-10;
+    const double tol_somf_ri = 5e-3;
+
+    lints::Structure structure("def2-svp", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+
+    vec2d density = lints::overlap(structure);
+
+    std::array<vec4d, 3> eri4soc;
+    for (int icart = 0; icart < 3; icart++)
+        eri4soc[icart] = vec4d(Fill(0), dim_ao, dim_ao, dim_ao, dim_ao);
+
+    std::vector<lints::ShellPairData> shell_pair_datas = lints::shellPairData(false, structure);
+    for (const lints::ShellPairData &sp_data_ab : shell_pair_datas)
+        for (const lints::ShellPairData &sp_data_cd : shell_pair_datas)
+        {
+            lints::ERI4SOCKernel eri4soc_kernel(sp_data_ab, sp_data_cd);
+
+            int n_sph_a = lints::numSphericals(sp_data_ab.la_);
+            int n_sph_b = lints::numSphericals(sp_data_ab.lb_);
+            int n_sph_c = lints::numSphericals(sp_data_cd.la_);
+            int n_sph_d = lints::numSphericals(sp_data_cd.lb_);
+            for (size_t ipair_ab = 0; ipair_ab < sp_data_ab.n_pairs_; ipair_ab++)
+                for (size_t ipair_cd = 0; ipair_cd < sp_data_cd.n_pairs_; ipair_cd++)
+                {
+                    std::array<vec4d, 3> eri4_batch = eri4soc_kernel(ipair_ab, ipair_cd,
+                                                                     sp_data_ab, sp_data_cd);
+
+                    size_t ofs_a = sp_data_ab.offsets_sph_[2 * ipair_ab];
+                    size_t ofs_b = sp_data_ab.offsets_sph_[2 * ipair_ab + 1];
+                    size_t ofs_c = sp_data_cd.offsets_sph_[2 * ipair_cd];
+                    size_t ofs_d = sp_data_cd.offsets_sph_[2 * ipair_cd + 1];
+                    for (int icart = 0; icart < 3; icart++)
+                        for (int ia = 0; ia < n_sph_a; ia++)
+                            for (int ib = 0; ib < n_sph_b; ib++)
+                                for (int ic = 0; ic < n_sph_c; ic++)
+                                    for (int id = 0; id < n_sph_d; id++)
+                                        eri4soc[icart](ofs_a + ia, ofs_b + ib, ofs_c + ic,
+                                                       ofs_d + id) =
+                                                eri4_batch[icart](ia, ib, ic, id);
+                }
+        }
+
+    std::array<vec2d, 3> somf_ref;
+    for (int icart = 0; icart < 3; icart++)
+    {
+        somf_ref[icart] = vec2d(Fill(0), dim_ao, dim_ao);
+        for (size_t mu = 0; mu < dim_ao; mu++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t ka = 0; ka < dim_ao; ka++)
+                    for (size_t ta = 0; ta < dim_ao; ta++)
+                        somf_ref[icart](mu, nu) += density(ka, ta) *
+                                                   (eri4soc[icart](mu, nu, ka, ta) -
+                                                    1.5 * eri4soc[icart](mu, ka, ta, nu) -
+                                                    1.5 * eri4soc[icart](ta, nu, mu, ka));
+    }
+
+    std::array<vec2d, 3> somf = lints::spinOrbitMeanField(structure, density);
+    std::array<vec2d, 3> somf_ri = lints::spinOrbitMeanFieldRI(structure, density);
+
+    // Memory for about 20 fitted auxiliary functions at a time.
+    double max_memory_mb = 20 * 5.0 * dim_ao * dim_ao * sizeof(double) / (1024 * 1024);
+    std::array<vec2d, 3> somf_ri_blocks = lints::spinOrbitMeanFieldRI(structure, density,
+                                                                      max_memory_mb);
+
+    double max_ref = 0, max_diff = 0, max_diff_ri = 0, max_diff_blocks = 0;
+    for (int icart = 0; icart < 3; icart++)
+        for (size_t i = 0; i < somf_ref[icart].size(); i++)
+        {
+            max_ref = std::max(max_ref, std::fabs(somf_ref[icart][i]));
+            max_diff = std::max(max_diff, std::fabs(somf[icart][i] - somf_ref[icart][i]));
+            max_diff_ri = std::max(max_diff_ri, std::fabs(somf_ri[icart][i] - somf_ref[icart][i]));
+            max_diff_blocks = std::max(max_diff_blocks,
+                                       std::fabs(somf_ri_blocks[icart][i] - somf_ri[icart][i]));
+        }
+
+    if (max_diff < tol_somf * std::max(1.0, max_ref) && max_diff_ri < tol_somf_ri * max_ref &&
+        max_diff_blocks < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::riMetric()
+{
+    // The solves are checked by multiplying back with the metric. The eigenvalue fallback is
+    // triggered by duplicating an auxiliary function, which makes the metric singular, and
+    // checked with right-hand sides in the range of the metric.
+    const double tol_solve = 1e-10;
+    const double tol_lindep = 1e-8;
+
+    lints::Structure structure("def2-svp", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao_aux = structure.getDimAOAux();
+    vec2d metric = lints::eri2(structure);
+
+    lints::RIMetric ri_metric(structure);
+    if (!ri_metric.isCholesky() || ri_metric.getDim() != dim_ao_aux ||
+        ri_metric.getRank() != dim_ao_aux)
+        return false;
+
+    // R = metric + 1, so X = R (P|Q)^-1 is not trivial.
+    size_t n_rows = 20;
+    vec2d rhs(Fill(0), n_rows, dim_ao_aux);
+    for (size_t irow = 0; irow < n_rows; irow++)
+        for (size_t P = 0; P < dim_ao_aux; P++)
+            rhs(irow, P) = metric(irow, P) + 1.0 / (1 + irow + P);
+
+    vec2d solution = rhs;
+    ri_metric.solve(n_rows, solution.memptr());
+
+    for (size_t irow = 0; irow < n_rows; irow++)
+        for (size_t Q = 0; Q < dim_ao_aux; Q++)
+        {
+            double product = 0;
+            for (size_t P = 0; P < dim_ao_aux; P++)
+                product += solution(irow, P) * metric(P, Q);
+
+            if (std::fabs(product - rhs(irow, Q)) > tol_solve)
+                return false;
+        }
+
+    // X X^T = R (P|Q)^-1 R^T
+    vec2d half = rhs;
+    ri_metric.applyInverseSqrt(n_rows, half.memptr());
+
+    for (size_t irow = 0; irow < n_rows; irow++)
+        for (size_t jrow = 0; jrow < n_rows; jrow++)
+        {
+            double gram = 0, gram_ref = 0;
+            for (size_t P = 0; P < dim_ao_aux; P++)
+            {
+                gram += half(irow, P) * half(jrow, P);
+                gram_ref += solution(irow, P) * rhs(jrow, P);
+            }
+
+            if (std::fabs(gram - gram_ref) > tol_solve)
+                return false;
+        }
+
+    // Metric with the first auxiliary function duplicated at the end.
+    size_t dim_lindep = dim_ao_aux + 1;
+    auto idx = [&](size_t P) { return P < dim_ao_aux ? P : 0; };
+
+    vec2d metric_lindep(Fill(0), dim_lindep, dim_lindep);
+    for (size_t P = 0; P < dim_lindep; P++)
+        for (size_t Q = 0; Q < dim_lindep; Q++)
+            metric_lindep(P, Q) = metric(idx(P), idx(Q));
+
+    lints::RIMetric ri_metric_lindep(metric_lindep);
+    if (ri_metric_lindep.isCholesky() || ri_metric_lindep.getRank() != dim_ao_aux)
+        return false;
+
+    vec2d rhs_lindep(Fill(0), n_rows, dim_lindep);
+    for (size_t irow = 0; irow < n_rows; irow++)
+        for (size_t P = 0; P < dim_lindep; P++)
+            rhs_lindep(irow, P) = metric_lindep(irow, P) + metric_lindep(irow + 1, P);
+
+    vec2d solution_lindep = rhs_lindep;
+    ri_metric_lindep.solve(n_rows, solution_lindep.memptr());
+
+    for (size_t irow = 0; irow < n_rows; irow++)
+        for (size_t Q = 0; Q < dim_lindep; Q++)
+        {
+            double product = 0;
+            for (size_t P = 0; P < dim_lindep; P++)
+                product += solution_lindep(irow, P) * metric_lindep(P, Q);
+
+            if (std::fabs(product - rhs_lindep(irow, Q)) > tol_lindep)
+                return false;
+        }
+
+    return true;
+}
+
+bool ltests::riBTensorMO()
+{
+    // The B-tensor is compared against the one from the full ERI3 tensor for every output. The
+    // memory limit is set low enough to split the p indices into batches.
+    lints::Structure structure("def2-svp", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t n_p = 5;
+    size_t n_q = 7;
+
+    vec2d mo_coeffs_p(Fill(0), dim_ao, n_p);
+    vec2d mo_coeffs_q(Fill(0), dim_ao, n_q);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+    {
+        for (size_t p = 0; p < n_p; p++)
+            mo_coeffs_p(mu, p) = std::cos(0.3 * double((mu + 1) * (p + 2))) / std::sqrt(dim_ao);
+
+        for (size_t q = 0; q < n_q; q++)
+            mo_coeffs_q(mu, q) = std::sin(0.7 * double((mu + 3) * (q + 1))) / std::sqrt(dim_ao);
+    }
+
+    lints::RIMetric ri_metric(structure);
+
+    vec3d eri3 = lints::eri3(structure);
+
+    vec3d eri3_half(Fill(0), n_p, dim_ao, dim_ao_aux);
+    for (size_t p = 0; p < n_p; p++)
+        for (size_t mu = 0; mu < dim_ao; mu++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t P = 0; P < dim_ao_aux; P++)
+                    eri3_half(p, nu, P) += mo_coeffs_p(mu, p) * eri3(mu, nu, P);
+
+    vec3d b_ref(Fill(0), n_p, n_q, dim_ao_aux);
+    for (size_t p = 0; p < n_p; p++)
+        for (size_t q = 0; q < n_q; q++)
+            for (size_t nu = 0; nu < dim_ao; nu++)
+                for (size_t P = 0; P < dim_ao_aux; P++)
+                    b_ref(p, q, P) += mo_coeffs_q(nu, q) * eri3_half(p, nu, P);
+
+    ri_metric.applyInverseSqrt(n_p * n_q, b_ref.memptr());
+
+    // Memory for at most two of the p indices, less with the buffers of the threads.
+    double max_memory_mb = 2.5 * n_q * dim_ao_aux * sizeof(double) / (1024 * 1024);
+    std::string scratch_dir = std::filesystem::temp_directory_path().string();
+    size_t n_Q_block = 17;
+
+    double max_diff = 0;
+    auto compare = [&](const vec3d &b_tensor)
+    {
+        for (size_t Q = 0; Q < dim_ao_aux; Q++)
+            for (size_t p = 0; p < n_p; p++)
+                for (size_t q = 0; q < n_q; q++)
+                    max_diff = std::max(max_diff, std::fabs(b_tensor(Q, p, q) - b_ref(p, q, Q)));
+    };
+
+    compare(lints::riBTensorMO(structure, ri_metric, mo_coeffs_p, mo_coeffs_q));
+    compare(lints::riBTensorMO(structure, ri_metric, mo_coeffs_p, mo_coeffs_q, max_memory_mb));
+
+    for (double memory_mb : {1024.0, max_memory_mb})
+    {
+        vec3d b_tensor(Fill(0), dim_ao_aux, n_p, n_q);
+        size_t n_Q_total = 0;
+        bool blocks_ok = true;
+        lints::riBTensorMO(structure, ri_metric, mo_coeffs_p, mo_coeffs_q, n_Q_block,
+                           [&](const size_t ofs_Q, const size_t n_Q, const double *b_block)
+                           {
+                               blocks_ok = blocks_ok && ofs_Q == n_Q_total &&
+                                           n_Q <= n_Q_block;
+
+                               std::copy(b_block, b_block + n_Q * n_p * n_q,
+                                         &b_tensor(ofs_Q, 0, 0));
+                               n_Q_total += n_Q;
+                           },
+                           memory_mb, scratch_dir);
+
+        if (!blocks_ok || n_Q_total != dim_ao_aux)
+            return false;
+
+        compare(b_tensor);
+    }
+
+    // Without a scratch directory the batched B-tensor is rejected before any work.
+    bool called = false;
+    bool thrown = false;
+    try
+    {
+        lints::riBTensorMO(structure, ri_metric, mo_coeffs_p, mo_coeffs_q, n_Q_block,
+                           [&](const size_t, const size_t, const double *) { called = true; },
+                           max_memory_mb);
+    }
+    catch (const std::runtime_error &)
+    {
+        thrown = true;
+    }
+
+    if (!thrown || called)
+        return false;
+
+    std::filesystem::path file_name = std::filesystem::temp_directory_path() /
+                                      "lible_test_btensor.bin";
+    lints::riBTensorMOFile(structure, ri_metric, mo_coeffs_p, mo_coeffs_q, file_name.string(),
+                           max_memory_mb);
+
+    vec3d b_tensor_file(Fill(0), dim_ao_aux, n_p, n_q);
+    std::ifstream file(file_name, std::ios::binary);
+    file.read(reinterpret_cast<char *>(b_tensor_file.memptr()),
+              std::streamsize(b_tensor_file.size() * sizeof(double)));
+    bool read_ok = bool(file);
+    file.close();
+    std::filesystem::remove(file_name);
+
+    if (!read_ok)
+        return false;
+
+    compare(b_tensor_file);
+
+    if (max_diff < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::singlePrecision()
+{
+    // The single precision tensors are checked with the error reports against the double
+    // precision ones, and the tiled contractions against the double precision contractions.
+    // The errors are bounded by 2^-24 relative to the largest magnitude in each row.
+    const double tol_row = 6e-8;
+    const double tol_contraction = 1e-7;
+
+    lints::Structure structure("def2-svp", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+    size_t dim_ao_sq = dim_ao * dim_ao;
+
+    vec2d density(Fill(0), dim_ao, dim_ao);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t nu = 0; nu < dim_ao; nu++)
+            density(mu, nu) = std::cos(0.2 * double(mu + nu)) / (1.0 + std::fabs(double(mu) - nu));
+
+    auto relativeError = [](const std::vector<double> &values, const std::vector<double> &ref)
+    {
+        double max_diff = 0, max_ref = 0;
+        for (size_t i = 0; i < ref.size(); i++)
+        {
+            max_diff = std::max(max_diff, std::fabs(values[i] - ref[i]));
+            max_ref = std::max(max_ref, std::fabs(ref[i]));
+        }
+
+        return max_diff / max_ref;
+    };
+
+    auto reportOk = [&](const lints::SinglePrecisionMatrix &matrix, const double *reference)
+    {
+        lints::SinglePrecisionError error = matrix.errorReport(reference);
+
+        size_t memory_dp = matrix.getNRows() * matrix.getNCols() * sizeof(double);
+        return error.max_rel_row_ < tol_row && error.rel_norm_ < tol_row &&
+               matrix.getMemoryBytes() < 0.51 * memory_dp + matrix.getNRows() * sizeof(double);
+    };
+
+    // ERI3, gamma_P = sum_ab (ab|P) D_ab and J_ab = sum_P (ab|P) gamma_P.
+    vec3d eri3 = lints::eri3(structure);
+    lints::SinglePrecisionMatrix eri3_sp = lints::eri3SinglePrecision(structure);
+    if (!reportOk(eri3_sp, eri3.memptr()))
+        return false;
+
+    std::vector<double> gamma(dim_ao_aux, 0), gamma_ref(dim_ao_aux, 0);
+    for (size_t ab = 0; ab < dim_ao_sq; ab++)
+        for (size_t P = 0; P < dim_ao_aux; P++)
+            gamma_ref[P] += eri3[ab * dim_ao_aux + P] * density[ab];
+
+    eri3_sp.multiplyTrans(1, density.memptr(), gamma.data());
+    if (relativeError(gamma, gamma_ref) > tol_contraction)
+        return false;
+
+    std::vector<double> fock(dim_ao_sq, 0), fock_ref(dim_ao_sq, 0);
+    for (size_t ab = 0; ab < dim_ao_sq; ab++)
+        for (size_t P = 0; P < dim_ao_aux; P++)
+            fock_ref[ab] += eri3[ab * dim_ao_aux + P] * gamma_ref[P];
+
+    eri3_sp.multiply(1, gamma_ref.data(), fock.data());
+    if (relativeError(fock, fock_ref) > tol_contraction)
+        return false;
+
+    // ERI4, J_ab = sum_cd (ab|cd) D_cd.
+    vec4d eri4 = lints::eri4(structure);
+    lints::SinglePrecisionMatrix eri4_sp = lints::eri4SinglePrecision(structure);
+    if (!reportOk(eri4_sp, eri4.memptr()))
+        return false;
+
+    std::fill(fock_ref.begin(), fock_ref.end(), 0);
+    for (size_t ab = 0; ab < dim_ao_sq; ab++)
+        for (size_t cd = 0; cd < dim_ao_sq; cd++)
+            fock_ref[ab] += eri4[ab * dim_ao_sq + cd] * density[cd];
+
+    eri4_sp.multiply(1, density.memptr(), fock.data());
+    if (relativeError(fock, fock_ref) > tol_contraction)
+        return false;
+
+    // RI factors, the metric factor and the B-tensor, (Q, pq).
+    lints::RIMetric ri_metric(structure);
+    lints::SinglePrecisionMatrix factor_sp(ri_metric.getFactor());
+    if (!reportOk(factor_sp, ri_metric.getFactor().memptr()))
+        return false;
+
+    size_t n_p = 4;
+    size_t n_q = 6;
+    vec2d mo_coeffs_p(Fill(0), dim_ao, n_p);
+    vec2d mo_coeffs_q(Fill(0), dim_ao, n_q);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+    {
+        for (size_t p = 0; p < n_p; p++)
+            mo_coeffs_p(mu, p) = std::cos(0.3 * double((mu + 1) * (p + 2))) / std::sqrt(dim_ao);
+
+        for (size_t q = 0; q < n_q; q++)
+            mo_coeffs_q(mu, q) = std::sin(0.7 * double((mu + 3) * (q + 1))) / std::sqrt(dim_ao);
+    }
+
+    vec3d b_tensor = lints::riBTensorMO(structure, ri_metric, mo_coeffs_p, mo_coeffs_q);
+    lints::SinglePrecisionMatrix b_tensor_sp =
+            lints::riBTensorMOSinglePrecision(structure, ri_metric, mo_coeffs_p, mo_coeffs_q);
+    if (!reportOk(b_tensor_sp, b_tensor.memptr()))
+        return false;
+
+    // (pq|rs) = sum_Q B^Q_pq B^Q_rs with the B-tensor upcast in tiles.
+    size_t n_pq = n_p * n_q;
+    std::vector<double> eri4_ri(n_pq * n_pq, 0), eri4_ri_ref(n_pq * n_pq, 0);
+    for (size_t pq = 0; pq < n_pq; pq++)
+        for (size_t rs = 0; rs < n_pq; rs++)
+            for (size_t Q = 0; Q < dim_ao_aux; Q++)
+                eri4_ri_ref[pq * n_pq + rs] += b_tensor[Q * n_pq + pq] * b_tensor[Q * n_pq + rs];
+
+    b_tensor_sp.multiplyTrans(n_pq, b_tensor.memptr(), eri4_ri.data());
+    if (relativeError(eri4_ri, eri4_ri_ref) > tol_contraction)
+        return false;
+
+    // A matrix wider than a tile is split into tiles of the rows and the columns. The
+    // contractions are compared against the upcast matrix to check only the tiling.
+    size_t n_rows_wide = 100;
+    size_t n_cols_wide = 40000;
+    std::vector<double> wide(n_rows_wide * n_cols_wide);
+    for (size_t i = 0; i < wide.size(); i++)
+        wide[i] = std::sin(0.37 * double(i)) * std::exp(-1e-5 * double(i % n_cols_wide));
+
+    lints::SinglePrecisionMatrix wide_sp(n_rows_wide, n_cols_wide, wide.data());
+    if (wide_sp.getNRowsTile() < 64 || wide_sp.getNColsTile() >= n_cols_wide)
+        return false;
+
+    std::vector<double> x(n_cols_wide), y(n_rows_wide);
+    for (size_t col = 0; col < n_cols_wide; col++)
+        x[col] = std::cos(0.11 * double(col));
+    for (size_t row = 0; row < n_rows_wide; row++)
+        y[row] = std::cos(0.23 * double(row));
+
+    std::vector<double> wide_upcast = wide_sp.toDouble();
+    std::vector<double> wide_x(n_rows_wide, 0), wide_x_ref(n_rows_wide, 0);
+    std::vector<double> wide_y(n_cols_wide, 0), wide_y_ref(n_cols_wide, 0);
+    for (size_t row = 0; row < n_rows_wide; row++)
+        for (size_t col = 0; col < n_cols_wide; col++)
+        {
+            wide_x_ref[row] += wide_upcast[row * n_cols_wide + col] * x[col];
+            wide_y_ref[col] += wide_upcast[row * n_cols_wide + col] * y[row];
+        }
+
+    wide_sp.multiply(1, x.data(), wide_x.data());
+    wide_sp.multiplyTrans(1, y.data(), wide_y.data());
+    if (relativeError(wide_x, wide_x_ref) > tol || relativeError(wide_y, wide_y_ref) > tol)
+        return false;
+
+    return true;
+}
+
+bool ltests::taskDistributor()
+{
+    // Every task has to be handed out exactly once over all processes and threads, and the
+    // static partitions have to be balanced to within the largest task.
+    const size_t n_tasks = 1000;
+
+    std::vector<double> costs(n_tasks);
+    for (size_t itask = 0; itask < n_tasks; itask++)
+        costs[itask] = double((itask * 37) % 101 + 1);
+
+    std::vector<double> counts(n_tasks, 0);
+    {
+        lints::TaskDistributor distributor(costs);
+
+#pragma omp parallel
+        {
+            size_t itask;
+            while (distributor.next(itask))
+            {
+#pragma omp atomic
+                counts[itask] += 1;
+            }
+        }
+
+        double max_load = 0, min_load = std::numeric_limits<double>::max();
+        std::vector<bool> assigned(n_tasks, false);
+        for (int rank = 0; rank < lints::numProcesses(); rank++)
+        {
+            double load = 0;
+            for (size_t itask : distributor.partition(rank))
+            {
+                if (assigned[itask])
+                    return false;
+
+                assigned[itask] = true;
+                load += costs[itask];
+            }
+
+            max_load = std::max(max_load, load);
+            min_load = std::min(min_load, load);
+        }
+
+        if (std::find(assigned.begin(), assigned.end(), false) != assigned.end())
+            return false;
+
+        if (max_load - min_load > *std::max_element(costs.begin(), costs.end()))
+            return false;
+    }
+
+    lints::allReduceSum(&counts[0], counts.size());
+
+    for (double count : counts)
+        if (count != 1)
+            return false;
+
+    return true;
+}
+
+bool ltests::basisLibraryCache()
+{
+    // The cached basis sets have to match the file and stay the same over repeated, concurrent
+    // and post-clearing loads.
+    lints::BasisAtom basis_h = lints::basisForAtom(1, "def2-svp");
+    if (basis_h.basis_shells_.size() != 3)
+        return false;
+
+    std::vector<int> ls{0, 0, 1};
+    std::vector<std::vector<double>> exps{{1.3010700999999999e+01, 1.9622572000000000e+00,
+                                           4.4453796000000001e-01},
+                                          {1.2194961999999999e-01},
+                                          {8.0000000000000004e-01}};
+    std::vector<std::vector<double>> coeffs{{1.9682158000000002e-02, 1.3796523999999999e-01,
+                                             4.7831934999999998e-01},
+                                            {1.0}, {1.0}};
+    for (size_t ishell = 0; ishell < 3; ishell++)
+    {
+        const lints::BasisShell &shell = basis_h.basis_shells_[ishell];
+        if (shell.l_ != ls[ishell] || shell.exps_ != exps[ishell] ||
+            shell.coeffs_ != coeffs[ishell])
+            return false;
+    }
+
+    auto sameBasis = [](const lints::basis_atoms_t &a, const lints::basis_atoms_t &b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t iatom = 0; iatom < a.size(); iatom++)
+        {
+            if (a[iatom].atomic_nr_ != b[iatom].atomic_nr_ ||
+                a[iatom].basis_shells_.size() != b[iatom].basis_shells_.size())
+                return false;
+
+            for (size_t ishell = 0; ishell < a[iatom].basis_shells_.size(); ishell++)
+            {
+                const lints::BasisShell &sa = a[iatom].basis_shells_[ishell];
+                const lints::BasisShell &sb = b[iatom].basis_shells_[ishell];
+                if (sa.l_ != sb.l_ || sa.exps_ != sb.exps_ || sa.coeffs_ != sb.coeffs_)
+                    return false;
+            }
+        }
+
+        return true;
+    };
+
+    lints::basis_atoms_t reference = lints::basisForAtoms(atomic_nrs_c2h6, "cc-pvtz");
+    lints::basis_atoms_t reference_aux = lints::basisForAtomsAux(atomic_nrs_c2h6,
+                                                                 "cc-pvtz-rifit");
+
+    bool success = true;
+#pragma omp parallel for
+    for (int i = 0; i < 16; i++)
+    {
+        bool same = sameBasis(reference, lints::basisForAtoms(atomic_nrs_c2h6, "cc-pvtz")) &&
+                    sameBasis(reference_aux,
+                              lints::basisForAtomsAux(atomic_nrs_c2h6, "cc-pvtz-rifit"));
+        if (!same)
+        {
+#pragma omp atomic write
+            success = false;
+        }
+    }
+
+    lints::clearBasisSetCache();
+    if (!sameBasis(reference, lints::basisForAtoms(atomic_nrs_c2h6, "cc-pvtz")))
+        return false;
+
+    return success;
+}
+
+bool ltests::basisBundle()
+{
+    // Bundles two basis sets from the library files and checks that the views of the bundle
+    // reproduce the parsed files and the basis sets returned by basisForAtom().
+    std::vector<std::pair<std::string, bool>> names{{"def2-svp", false},
+                                                    {"cc-pvdz-rifit", true}};
+
+    std::vector<lints::BundledBasisSet> basis_sets;
+    for (const auto &[name, aux] : names)
+    {
+        std::string path = aux ? lints::auxBasisPath(name) : lints::basisPath(name);
+        lints::BasisFile basis_file = lints::readBasisFile(path);
+
+        lints::BundledBasisSet basis_set{name, aux, {}};
+        for (const auto &[atomic_nr, offsets] : basis_file.offsets_)
+            basis_set.basis_atoms_.push_back(lints::parseBasisAtom(atomic_nr, name, basis_file));
+
+        basis_sets.push_back(basis_set);
+    }
+
+    std::vector<std::byte> blob = lints::writeBasisBundle(basis_sets);
+    lints::BasisBundle bundle(blob);
+
+    if (!bundle.contains("def2-svp", false) || bundle.contains("def2-svp", true) ||
+        bundle.contains("cc-pvdz", false))
+        return false;
+
+    if (bundle.basisSets(true).size() != 1 || bundle.basisSets(true)[0] != "cc-pvdz-rifit")
+        return false;
+
+    if (!bundle.shells("def2-svp", false, 0).empty())
+        return false;
+
+    for (size_t iset = 0; iset < names.size(); iset++)
+    {
+        const auto &[name, aux] = names[iset];
+        if (bundle.elements(name, aux).size() != basis_sets[iset].basis_atoms_.size())
+            return false;
+
+        for (const lints::BasisAtom &basis_atom : basis_sets[iset].basis_atoms_)
+        {
+            auto shells = bundle.shells(name, aux, basis_atom.atomic_nr_);
+            if (shells.size() != basis_atom.basis_shells_.size())
+                return false;
+
+            for (size_t ishell = 0; ishell < shells.size(); ishell++)
+            {
+                const lints::BasisShell &basis_shell = basis_atom.basis_shells_[ishell];
+
+                auto exps = bundle.exps(shells[ishell]);
+                auto coeffs = bundle.coeffs(shells[ishell]);
+                if (shells[ishell].l_ != basis_shell.l_ ||
+                    !std::ranges::equal(exps, basis_shell.exps_) ||
+                    !std::ranges::equal(coeffs, basis_shell.coeffs_))
+                    return false;
+
+                // The views point into the bundle.
+                auto *ptr = reinterpret_cast<const std::byte *>(exps.data());
+                if (ptr < blob.data() || ptr >= blob.data() + blob.size())
+                    return false;
+            }
+        }
+    }
+
+    lints::basis_atoms_t basis_atoms = lints::basisForAtoms(atomic_nrs_c2h6, "def2-svp");
+    for (const lints::BasisAtom &basis_atom : basis_atoms)
+    {
+        auto shells = bundle.shells("def2-svp", false, basis_atom.atomic_nr_);
+        if (shells.size() != basis_atom.basis_shells_.size())
+            return false;
+
+        for (size_t ishell = 0; ishell < shells.size(); ishell++)
+            if (!std::ranges::equal(bundle.exps(shells[ishell]),
+                                    basis_atom.basis_shells_[ishell].exps_))
+                return false;
+    }
+
+    return true;
+}
+
+bool ltests::structureShellViews()
+{
+    // The shell views have to refer to the shells kept in the structure and give the same shell
+    // pair data as the copies.
+    lints::Structure structure("cc-pvdz", "cc-pvdz-rifit", atomic_nrs_c2h6, coords_c2h6);
+
+    std::span<const lints::Shell> shells_view = structure.getShellsView();
+    std::vector<lints::Shell> shells = structure.getShells();
+    if (shells_view.size() != shells.size() ||
+        structure.getShellsViewAux().size() != structure.getShellsAux().size())
+        return false;
+
+    for (size_t ishell = 0; ishell < shells.size(); ishell++)
+        if (shells_view[ishell].xyz_coords_ != shells[ishell].xyz_coords_)
+            return false;
+
+    // A copy of the structure has its own shells, so its view has to point elsewhere.
+    lints::Structure structure_copy = structure;
+    if (structure_copy.getShellsView().data() == shells_view.data())
+        return false;
+
+    // The view taken before moving the atoms has to stay valid and show the moved shells, which
+    // is only the case if it points to the shells kept in the structure.
+    std::vector<std::array<double, 3>> coords_moved = coords_c2h6;
+    for (auto &xyz : coords_moved)
+        xyz[2] += 0.5;
+
+    structure.updateCoordinates(coords_moved);
+    std::vector<lints::Shell> shells_moved = structure.getShells();
+    if (structure.getShellsView().data() != shells_view.data())
+        return false;
+
+    for (size_t ishell = 0; ishell < shells.size(); ishell++)
+        if (shells_view[ishell].xyz_coords_ != shells_moved[ishell].xyz_coords_ ||
+            shells_view[ishell].xyz_coords_ == shells[ishell].xyz_coords_)
+            return false;
+
+    for (const auto &[l, shells] : structure.getShellsMapView())
+    {
+        std::span<const lints::Shell> shells_l = structure.getShellsLView(l);
+        if (shells_l.data() != shells.data() || shells_l.size() != structure.getShellsL(l).size())
+            return false;
+    }
+
+    for (int la = 0; la <= structure.getMaxL(); la++)
+        for (int lb = 0; lb <= la; lb++)
+        {
+            lints::ShellPairData sp_view(true, la, lb, structure.getShellsLView(la),
+                                         structure.getShellsLView(lb));
+            lints::ShellPairData sp_copy(true, la, lb, structure.getShellsL(la),
+                                         structure.getShellsL(lb));
+
+            if (sp_view.n_pairs_ != sp_copy.n_pairs_ || sp_view.n_ppairs_ != sp_copy.n_ppairs_ ||
+                sp_view.exps_ != sp_copy.exps_ || sp_view.coeffs_ != sp_copy.coeffs_ ||
+                sp_view.coords_ != sp_copy.coords_ || sp_view.norms_ != sp_copy.norms_)
+                return false;
+        }
+
+    return true;
+}
+
+bool ltests::structureUpdateCoordinates()
+{
+    // Moving the atoms of a structure and refreshing its shell pair data has to give the same
+    // data and integrals as constructing everything at the new geometry. The second geometry
+    // pulls one hydrogen far away so that the screening outcome changes.
+    lints::Structure structure("cc-pvdz", "cc-pvdz-rifit", atomic_nrs_c2h6, coords_c2h6);
+    std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+    std::vector<lints::ShellData> sh_data_aux = lints::shellDataAux(structure);
+
+    std::vector<std::array<double, 3>> coords_shifted = coords_c2h6;
+    for (size_t iatom = 0; iatom < coords_shifted.size(); iatom++)
+        for (int icart = 0; icart < 3; icart++)
+            coords_shifted[iatom][icart] += 0.01 * double((iatom + icart) % 3) - 0.01;
+
+    std::vector<std::array<double, 3>> coords_stretched = coords_shifted;
+    coords_stretched[0][0] += 30.0;
+
+    for (const auto &coords : {coords_shifted, coords_stretched})
+    {
+        structure.updateCoordinates(coords);
+        lints::updateShellPairData(structure, sp_data);
+        lints::updateShellDataAux(structure, sh_data_aux);
+
+        lints::Structure structure_ref("cc-pvdz", "cc-pvdz-rifit", atomic_nrs_c2h6, coords);
+        std::vector<lints::ShellPairData> sp_data_ref = lints::shellPairData(true, structure_ref);
+        std::vector<lints::ShellData> sh_data_aux_ref = lints::shellDataAux(structure_ref);
+
+        for (size_t iatom = 0; iatom < structure.getNAtoms(); iatom++)
+            if (structure.getCoordsAtom(iatom) != structure_ref.getCoordsAtom(iatom))
+                return false;
+
+        for (size_t ipair = 0; ipair < sp_data.size(); ipair++)
+        {
+            const lints::ShellPairData &a = sp_data[ipair];
+            const lints::ShellPairData &b = sp_data_ref[ipair];
+            if (a.n_pairs_ != b.n_pairs_ || a.n_ppairs_ != b.n_ppairs_ || a.coords_ != b.coords_ ||
+                a.exps_ != b.exps_ || a.coeffs_ != b.coeffs_ || a.offsets_sph_ != b.offsets_sph_)
+                return false;
+        }
+
+        for (size_t il = 0; il < sh_data_aux.size(); il++)
+            if (sh_data_aux[il].coords_ != sh_data_aux_ref[il].coords_)
+                return false;
+
+        lible::vec2d overlap = lints::overlap(structure);
+        lible::vec2d overlap_ref = lints::overlap(structure_ref);
+        for (size_t mu = 0; mu < structure.getDimAO(); mu++)
+            for (size_t nu = 0; nu < structure.getDimAO(); nu++)
+                if (std::fabs(overlap(mu, nu) - overlap_ref(mu, nu)) > tol)
+                    return false;
+    }
+
+    return true;
+}
+
+bool ltests::eriUpdateCoordinates()
+{
+    // The ERIs and their gradients from the shell data and kernels kept across moving the atoms
+    // have to match those from a structure constructed at the new geometry. The second geometry
+    // pulls one hydrogen far away so that the screening outcome changes.
+    lints::Structure structure("def2-SVP", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+    std::vector<lints::ShellPairData> sp_data = lints::shellPairData(true, structure);
+    std::vector<lints::ShellData> sh_data_aux = lints::shellDataAux(structure);
+    std::vector<lints::ERI4Kernel> eri4_kernels = lints::eri4Kernels(sp_data);
+    std::vector<lints::ERI3Kernel> eri3_kernels = lints::eri3Kernels(sp_data, sh_data_aux);
+    std::vector<lints::ERI2Kernel> eri2_kernels = lints::eri2Kernels(sh_data_aux);
+
+    size_t dim_ao = structure.getDimAO();
+    size_t dim_ao_aux = structure.getDimAOAux();
+
+    lible::vec2d density(lible::Fill(0), dim_ao, dim_ao);
+    for (size_t mu = 0; mu < dim_ao; mu++)
+        for (size_t nu = 0; nu < dim_ao; nu++)
+            density(mu, nu) = 1.0 / (1.0 + double(mu + nu) + std::fabs(double(mu) - double(nu)));
+
+    std::vector<double> coeffs_fit(dim_ao_aux);
+    for (size_t P = 0; P < dim_ao_aux; P++)
+        coeffs_fit[P] = std::cos(double(P));
+
+    auto equal = [](const auto &a, const auto &b)
+    {
+        if (a.size() != b.size())
+            return false;
+
+        for (size_t i = 0; i < a.size(); i++)
+            if (std::fabs(a[i] - b[i]) > tol)
+                return false;
+
+        return true;
+    };
+
+    std::vector<std::array<double, 3>> coords_shifted = coords_h2o;
+    for (size_t iatom = 0; iatom < coords_shifted.size(); iatom++)
+        for (int icart = 0; icart < 3; icart++)
+            coords_shifted[iatom][icart] += 0.01 * double((iatom + icart) % 3) - 0.01;
+
+    std::vector<std::array<double, 3>> coords_stretched = coords_shifted;
+    coords_stretched[1][0] += 30.0;
+
+    for (const auto &coords : {coords_shifted, coords_stretched})
+    {
+        structure.updateCoordinates(coords);
+        lints::updateShellPairData(structure, sp_data);
+        lints::updateShellDataAux(structure, sh_data_aux);
+        lints::updateERI4Kernels(sp_data, eri4_kernels);
+        lints::updateERI3Kernels(sp_data, sh_data_aux, eri3_kernels);
+        lints::updateERI2Kernels(sh_data_aux, eri2_kernels);
+
+        lints::Structure structure_ref("def2-SVP", "def2-universal-jkfit", atomic_nrs_h2o, coords);
+
+        if (!equal(lints::eri4(structure, sp_data, eri4_kernels), lints::eri4(structure_ref)) ||
+            !equal(lints::eri3(structure, sp_data, sh_data_aux, eri3_kernels),
+                   lints::eri3(structure_ref)) ||
+            !equal(lints::eri2(structure, sh_data_aux, eri2_kernels), lints::eri2(structure_ref)))
+            return false;
+
+        auto [gradient_j, gradient_k] = lints::eri4GradientJK(structure, sp_data, density,
+                                                              density);
+        auto [gradient_j_ref, gradient_k_ref] = lints::eri4GradientJK(structure_ref, density,
+                                                                      density);
+        if (!equal(gradient_j, gradient_j_ref) || !equal(gradient_k, gradient_k_ref))
+            return false;
+
+        lible::vec2d gradient_ri = lints::riGradientJ(structure, sp_data, sh_data_aux, density,
+                                                      coeffs_fit);
+        if (!equal(gradient_ri, lints::riGradientJ(structure_ref, density, coeffs_fit)))
+            return false;
+    }
+
+    return true;
+}
+
+bool ltests::instrumentationCounters()
+{
+    namespace linst = lints::instrumentation;
+
+    linst::reset();
+
+    lints::Structure structure("def2-SVP", "def2-universal-jkfit", atomic_nrs_h2o, coords_h2o);
+
+    lints::eri4(structure);
+    lints::eri3(structure);
+
+    if constexpr (!linst::enabled())
+        return linst::counters().empty() && linst::threadTimes("eri4").empty();
+
+    size_t n_shells = structure.getShellsView().size();
+    size_t n_shells_aux = structure.getShellsViewAux().size();
+    size_t n_pairs = n_shells * (n_shells + 1) / 2;
+
+    linst::Counters counters_eri4 = linst::counters("eri4");
+    linst::Counters counters_eri3 = linst::counters("eri3");
+
+    // Every shell tuple is evaluated once, and every primitive tuple calls the Boys function
+    // once with the SHARK kernels.
+    if (counters_eri4.n_shell_tuples_ != n_pairs * (n_pairs + 1) / 2 ||
+        counters_eri3.n_shell_tuples_ != n_pairs * n_shells_aux)
+        return false;
+
+    for (const linst::Counters &counters : {counters_eri4, counters_eri3})
+    {
+        size_t n_boys = counters.n_boys_zero_ + counters.n_boys_grid_ +
+                        counters.n_boys_asymptotic_;
+        if (counters.n_screened_ != 0 || n_boys != counters.n_prim_tuples_)
+            return false;
+
+        if (counters.time_rints_ + counters.time_shark_ + counters.time_scatter_ >
+            counters.time_busy_)
+            return false;
+    }
+
+    // The class counters add up to the totals.
+    size_t n_quartets = 0;
+    for (const auto &[key, counters] : linst::counters())
+        if (key.first == "eri4")
+            n_quartets += counters.n_shell_tuples_;
+
+    if (n_quartets != counters_eri4.n_shell_tuples_ || linst::threadTimes("eri3").empty())
+        return false;
+
+    std::string json = linst::countersJSON();
+    if (json.find("\"eri4\"") == std::string::npos || json.find("\"eri3\"") == std::string::npos)
+        return false;
+
+    linst::reset();
+
+    return linst::counters().empty();
+}
+
+bool ltests::instrumentationClassIds()
+{
+    namespace linst = lints::instrumentation;
+
+    linst::reset();
+
+    // The ids are resolved once per class and are the same for the same class.
+    linst::class_id_t class_id_a = linst::classId("test", {0, 1});
+    linst::class_id_t class_id_b = linst::classId("test", {1, 0});
+    if (class_id_a == class_id_b || linst::classId("test", {0, 1}) != class_id_a)
+        return false;
+
+    // Every task sets its class by the id, the counts of the threads are merged per class.
+    size_t n_tasks = 100;
+#pragma omp parallel for
+    for (size_t itask = 0; itask < n_tasks; itask++)
+    {
+        linst::Counters &counters = linst::setClass(itask % 2 == 0 ? class_id_a : class_id_b);
+        counters.n_shell_tuples_++;
+        linst::current().n_prim_tuples_ += 2;
+        linst::unsetClass();
+    }
+    linst::mergeThreads();
+
+    std::map<linst::class_key_t, linst::Counters> counters = linst::counters();
+    for (const std::vector<int> &ls : {std::vector<int>{0, 1}, std::vector<int>{1, 0}})
+    {
+        const linst::Counters &counters_class = counters.at({"test", ls});
+        if (counters_class.n_shell_tuples_ != n_tasks / 2 ||
+            counters_class.n_prim_tuples_ != n_tasks)
+            return false;
+    }
+
+    // The drivers count into the classes registered by the same lookup.
+    if constexpr (linst::enabled())
+    {
+        lints::Structure structure("def2-SVP", atomic_nrs_h2o, coords_h2o);
+
+        linst::class_id_t class_id_ssss = linst::classId("eri4", {0, 0, 0, 0});
+        lints::eri4(structure);
+        if (linst::classId("eri4", {0, 0, 0, 0}) != class_id_ssss ||
+            linst::counters().at({"eri4", {0, 0, 0, 0}}).n_shell_tuples_ == 0)
+            return false;
+    }
+
+    linst::reset();
+
+    return linst::counters().empty();
+}
+
+bool ltests::ecoeffsRecurrence1()
+{
+    const double correct_answer = 181021.807437296084;
+
+    vec2d ecoeffs = lints::ecoeffsRecurrence1(19.0034512342, 4);
+
+    double sum_ecoeffs = 0;
+    for (double ecoeff : ecoeffs)
+        sum_ecoeffs += std::fabs(ecoeff);
+
+    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::ecoeffsRecurrence2()
+{
+    const double correct_answer = 0.218834692700;
+
+    vec3d ecoeffs = lints::ecoeffsRecurrence2(0.0023445, 1.123621, 2, 3, 0.5113241, 1.2345123,
+                                              0.003451234);
+
+    double sum_ecoeffs = 0;
+    for (double ecoeff : ecoeffs)
+        sum_ecoeffs += std::fabs(ecoeff);
+
+    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::ecoeffsRecurrence2_n1()
+{
+    const double correct_answer = 0.053908505303;
+
+    double a = 0.0023445;
+    double b = 1.123621;
+    int la = 2;
+    int lb = 3;
+    double PA = 0.5113241;
+    double PB = 1.2345123;
+    double Kab = 0.003451234;
+    double A = -0.571235891;
+    double B = 1.612357121;
+
+    vec3d ecoeffs = lints::ecoeffsRecurrence2(a, b, la, lb, PA, PB, Kab);
+    vec3d ecoeffs1 = lints::ecoeffsRecurrence2_n1(a, b, la, lb, A, B, ecoeffs);
+
+    double sum_ecoeffs = 0;
+    for (double ecoeff : ecoeffs1)
+        sum_ecoeffs += std::fabs(ecoeff);
+
+    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::ecoeffsPrimitive()
+{
+    const double correct_answer = 3.002442449382;
+
+    std::array<vec2d, 3> ecoeffs = lints::ecoeffsPrimitive(1230.02342162, 4);
+
+    double sum_ecoeffs = 0;
+    for (int icart = 0; icart < 3; icart++)
+        for (size_t i = 0; i < ecoeffs[icart].size(); i++)
+            sum_ecoeffs += std::fabs(ecoeffs[icart][i]);
+
+    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::ecoeffsPrimitivePair()
+{
+    const double correct_answer = 16.100457827896;
+
+    std::array<double, 3> xyz_a{0, 1.5, 0};
+    std::array<double, 3> xyz_b{1.0, 0, -1.0};
+
+    std::array<vec3d, 3> ecoeffs =
+            lints::ecoeffsPrimitivePair(1230.02342162, 0.0023445, 4, 3, xyz_a.data(), xyz_b.data());
+
+    double sum_ecoeffs = 0;
+    for (int icart = 0; icart < 3; icart++)
+        for (double ecoeff : ecoeffs[icart])
+            sum_ecoeffs += std::fabs(ecoeff);
+
+    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::ecoeffsPrimitivePair_n1()
+{
+    const double correct_answer = 21.712096988812;
+
+    std::array<double, 3> xyz_a{0, 1.5, 0};
+    std::array<double, 3> xyz_b{1.0, 0, -1.0};
+
+    double a = 1230.02342162;
+    double b = 0.0023445;
+    int la = 4;
+    int lb = 3;
+    double A[3] = {0.571235891, 1.612357121, -0.234512341};
+    double B[3] = {1.2345123, -0.5113241, 0.003451234};
+
+    std::array<vec3d, 3> ecoeffs0 =
+            lints::ecoeffsPrimitivePair(a, b, la, lb, xyz_a.data(), xyz_b.data());
+    std::array<vec3d, 3> ecoeffs1 =
+            lints::ecoeffsPrimitivePair_n1(a, b, la, lb, A, B, ecoeffs0);
+
+    double sum_ecoeffs = 0;
+    for (int icart = 0; icart < 3; icart++)
+        for (double ecoeff : ecoeffs1[icart])
+            sum_ecoeffs += std::fabs(ecoeff);
+
+    if (std::fabs(sum_ecoeffs - correct_answer) < tol)
+        return true;
+
+    return false;
+}
+
+bool ltests::ecoeffsPrimitivePairC()
+{
+    // The compile-time generators, used by the buffered ecoeffsPrimitivePair(), are compared
+    // element by element against the runtime recurrences. The buffer is reused over all the
+    // (la, lb).
+    std::array<double, 3> xyz_a{0, 1.5, 0};
+    std::array<double, 3> xyz_b{1.0, 0, -1.0};
+    double a = 1230.02342162;
+    double b = 0.0023445;
+
+    double max_diff = 0;
+    std::array<vec3d, 3> ecoeffs;
+    for (int la = 0; la <= lints::max_l_ecoeffs; la++)
+        for (int lb = 0; lb <= lints::max_l_ecoeffs; lb++)
+        {
+            auto ecoeffs_ref = lints::ecoeffsPrimitivePair(a, b, la, lb, xyz_a.data(),
+                                                           xyz_b.data());
+
+            lints::ecoeffsPrimitivePair(a, b, la, lb, xyz_a.data(), xyz_b.data(), ecoeffs);
+
+            for (int icart = 0; icart < 3; icart++)
+            {
+                if (ecoeffs[icart].size() != ecoeffs_ref[icart].size())
+                    return false;
+
+                for (size_t i = 0; i < ecoeffs[icart].size(); i++)
+                    max_diff = std::max(max_diff, std::fabs(ecoeffs[icart].memptr()[i] -
+                                                            ecoeffs_ref[icart].memptr()[i]));
+            }
+        }
+
+    if (max_diff < tol)
         return true;
 
     return false;
@@ -1564,6 +3582,7 @@ bool ltests::structureGhost()
     if (structure_w_ghost.getShells().size() == correct_answer_shells &&
         structure_w_ghost.getMaxL() == correct_answer_max_l &&
         structure_w_ghost.getDimAO() == correct_answer_dim_ao &&
+        structure_w_ghost.getNCenters() == 6 && structure_monomer.getNCenters() == 3 &&
         (std::fabs(sum_sints_wo_ghost - correct_answer_wo_ghost_overlap) < tol) &&
         (std::fabs(sum_sints_w_ghost - correct_answer_w_ghost_overlap) < tol) &&
         (std::fabs(sum_sints_w_ghost - sum_sints_wo_ghost) < tol) &&